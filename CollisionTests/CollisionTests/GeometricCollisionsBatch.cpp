@@ -0,0 +1,570 @@
+//
+//  GeometricCollisionsBatch.cpp
+//
+
+#include <cassert>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "GeometricCollisionsBatch.h"
+
+using namespace std;
+namespace
+{
+	// the same tolerance Vector3 uses for isDistanceLessThan
+	const float TOLERANCE_PLUS_ONE_SQUARED = (float)(VECTOR3_NORM_TOLERANCE_PLUS_ONE_SQUARED);
+
+	//
+	//  Lanes
+	//
+	//  A group of LANE_COUNT floats that are operated on
+	//    together, and thin wrappers for the operations needed
+	//    by the kernels below.  Each comparison produces a lane
+	//    mask, which getMask turns into one bit per lane.
+	//
+
+#if defined(__AVX__)
+	const unsigned int LANE_COUNT = 8;
+
+	typedef __m256 Lanes;
+
+	inline Lanes load        (const float a[], unsigned int i)	{	return _mm256_loadu_ps(a + i);	}
+	inline Lanes splat       (float value)	{	return _mm256_set1_ps(value);	}
+	inline Lanes add         (Lanes a, Lanes b)	{	return _mm256_add_ps(a, b);	}
+	inline Lanes sub         (Lanes a, Lanes b)	{	return _mm256_sub_ps(a, b);	}
+	inline Lanes mul         (Lanes a, Lanes b)	{	return _mm256_mul_ps(a, b);	}
+	inline Lanes lanesMax    (Lanes a, Lanes b)	{	return _mm256_max_ps(a, b);	}
+	inline Lanes lanesAbs    (Lanes a)	{	return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);	}
+	inline Lanes both        (Lanes a, Lanes b)	{	return _mm256_and_ps(a, b);	}
+	inline Lanes lessThan    (Lanes a, Lanes b)	{	return _mm256_cmp_ps(a, b, _CMP_LT_OQ);	}
+	inline Lanes lessOrEqual (Lanes a, Lanes b)	{	return _mm256_cmp_ps(a, b, _CMP_LE_OQ);	}
+	inline unsigned int getMask (Lanes a)	{	return (unsigned int)(_mm256_movemask_ps(a));	}
+#elif defined(__SSE2__)
+	const unsigned int LANE_COUNT = 4;
+
+	typedef __m128 Lanes;
+
+	inline Lanes load        (const float a[], unsigned int i)	{	return _mm_loadu_ps(a + i);	}
+	inline Lanes splat       (float value)	{	return _mm_set1_ps(value);	}
+	inline Lanes add         (Lanes a, Lanes b)	{	return _mm_add_ps(a, b);	}
+	inline Lanes sub         (Lanes a, Lanes b)	{	return _mm_sub_ps(a, b);	}
+	inline Lanes mul         (Lanes a, Lanes b)	{	return _mm_mul_ps(a, b);	}
+	inline Lanes lanesMax    (Lanes a, Lanes b)	{	return _mm_max_ps(a, b);	}
+	inline Lanes lanesAbs    (Lanes a)	{	return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);	}
+	inline Lanes both        (Lanes a, Lanes b)	{	return _mm_and_ps(a, b);	}
+	inline Lanes lessThan    (Lanes a, Lanes b)	{	return _mm_cmplt_ps(a, b);	}
+	inline Lanes lessOrEqual (Lanes a, Lanes b)	{	return _mm_cmple_ps(a, b);	}
+	inline unsigned int getMask (Lanes a)	{	return (unsigned int)(_mm_movemask_ps(a));	}
+#else
+	const unsigned int LANE_COUNT = 1;
+#endif
+
+	//
+	//  absolute
+	//  maximum
+	//
+	//  Purpose: Scalar float versions of fabs and max, so that
+	//           the single-element checks do not depend on which
+	//           overloads the standard library provides.
+	//
+
+	inline float absolute (float a)
+	{	return (a < 0.0f) ? -a : a;	}
+	inline float maximum (float a, float b)
+	{	return (a > b) ? a : b;	}
+
+	//
+	//  SphereVsSpheresKernel
+	//  SphereVsCuboidsKernel
+	//  CuboidVsCuboidsKernel
+	//
+	//  Records holding one probe solid and the arrays of solids
+	//    to check it against.  Each provides:
+	//    -> calculateHitMask(i): Check the LANE_COUNT solids
+	//       starting at index i.  Bit j of the result is set if
+	//       solid i + j intersects the probe.
+	//    -> isHit(i): Check the single solid at index i.  This
+	//       handles the elements left over after the last full
+	//       group of LANE_COUNT.
+	//
+
+	struct SphereVsSpheresKernel
+	{
+		float m_x;
+		float m_y;
+		float m_z;
+		float m_radius;
+		const float* ma_x;
+		const float* ma_y;
+		const float* ma_z;
+		const float* ma_radius;
+
+		bool isHit (unsigned int i) const
+		{
+			float dx  = ma_x[i] - m_x;
+			float dy  = ma_y[i] - m_y;
+			float dz  = ma_z[i] - m_z;
+			float sum = ma_radius[i] + m_radius;
+			return dx * dx + dy * dy + dz * dz <= sum * sum * TOLERANCE_PLUS_ONE_SQUARED;
+		}
+
+		unsigned int calculateHitMask (unsigned int i) const
+		{
+#if defined(__AVX__) || defined(__SSE2__)
+			Lanes dx  = sub(load(ma_x, i), splat(m_x));
+			Lanes dy  = sub(load(ma_y, i), splat(m_y));
+			Lanes dz  = sub(load(ma_z, i), splat(m_z));
+			Lanes sum = add(load(ma_radius, i), splat(m_radius));
+			Lanes distance_squared = add(add(mul(dx, dx), mul(dy, dy)), mul(dz, dz));
+			Lanes limit            = mul(mul(sum, sum), splat(TOLERANCE_PLUS_ONE_SQUARED));
+			return getMask(lessOrEqual(distance_squared, limit));
+#else
+			return isHit(i) ? 1 : 0;
+#endif
+		}
+	};
+
+	struct SphereVsCuboidsKernel
+	{
+		float m_x;
+		float m_y;
+		float m_z;
+		float m_radius;
+		const float* ma_x;
+		const float* ma_y;
+		const float* ma_z;
+		const float* ma_size_x;
+		const float* ma_size_y;
+		const float* ma_size_z;
+
+		bool isHit (unsigned int i) const
+		{
+			// distance from the sphere center to the closest
+			//  point in the cuboid along each axis
+			float dx = maximum(absolute(ma_x[i] - m_x) - ma_size_x[i], 0.0f);
+			float dy = maximum(absolute(ma_y[i] - m_y) - ma_size_y[i], 0.0f);
+			float dz = maximum(absolute(ma_z[i] - m_z) - ma_size_z[i], 0.0f);
+			return dx * dx + dy * dy + dz * dz <= m_radius * m_radius * TOLERANCE_PLUS_ONE_SQUARED;
+		}
+
+		unsigned int calculateHitMask (unsigned int i) const
+		{
+#if defined(__AVX__) || defined(__SSE2__)
+			Lanes zero = splat(0.0f);
+			Lanes dx = lanesMax(sub(lanesAbs(sub(load(ma_x, i), splat(m_x))), load(ma_size_x, i)), zero);
+			Lanes dy = lanesMax(sub(lanesAbs(sub(load(ma_y, i), splat(m_y))), load(ma_size_y, i)), zero);
+			Lanes dz = lanesMax(sub(lanesAbs(sub(load(ma_z, i), splat(m_z))), load(ma_size_z, i)), zero);
+			Lanes distance_squared = add(add(mul(dx, dx), mul(dy, dy)), mul(dz, dz));
+			Lanes limit            = splat(m_radius * m_radius * TOLERANCE_PLUS_ONE_SQUARED);
+			return getMask(lessOrEqual(distance_squared, limit));
+#else
+			return isHit(i) ? 1 : 0;
+#endif
+		}
+	};
+
+	struct CuboidVsCuboidsKernel
+	{
+		float m_x;
+		float m_y;
+		float m_z;
+		float m_size_x;
+		float m_size_y;
+		float m_size_z;
+		const float* ma_x;
+		const float* ma_y;
+		const float* ma_z;
+		const float* ma_size_x;
+		const float* ma_size_y;
+		const float* ma_size_z;
+
+		bool isHit (unsigned int i) const
+		{
+			return absolute(ma_x[i] - m_x) < ma_size_x[i] + m_size_x &&
+			       absolute(ma_y[i] - m_y) < ma_size_y[i] + m_size_y &&
+			       absolute(ma_z[i] - m_z) < ma_size_z[i] + m_size_z;
+		}
+
+		unsigned int calculateHitMask (unsigned int i) const
+		{
+#if defined(__AVX__) || defined(__SSE2__)
+			Lanes hit_x = lessThan(lanesAbs(sub(load(ma_x, i), splat(m_x))), add(load(ma_size_x, i), splat(m_size_x)));
+			Lanes hit_y = lessThan(lanesAbs(sub(load(ma_y, i), splat(m_y))), add(load(ma_size_y, i), splat(m_size_y)));
+			Lanes hit_z = lessThan(lanesAbs(sub(load(ma_z, i), splat(m_z))), add(load(ma_size_z, i), splat(m_size_z)));
+			return getMask(both(both(hit_x, hit_y), hit_z));
+#else
+			return isHit(i) ? 1 : 0;
+#endif
+		}
+	};
+
+	//
+	//  getLowestBit
+	//
+	//  Purpose: To determine the index of the lowest set bit in
+	//           mask, which must not be 0.
+	//
+
+	inline unsigned int getLowestBit (unsigned int mask)
+	{
+		assert(mask != 0);
+
+		unsigned int bit = 0;
+		while((mask & 1) == 0)
+		{
+			mask >>= 1;
+			bit++;
+		}
+		return bit;
+	}
+
+	//
+	//  countBits
+	//
+	//  Purpose: To determine how many bits are set in mask.
+	//
+
+	inline unsigned int countBits (unsigned int mask)
+	{
+		unsigned int bit_count = 0;
+		while(mask != 0)
+		{
+			mask &= mask - 1;  // clear lowest set bit
+			bit_count++;
+		}
+		return bit_count;
+	}
+
+	//
+	//  findFirst
+	//  findAll
+	//  markAll
+	//
+	//  Purpose: To run a kernel over count solids and report the
+	//           first hit, a compacted list of hit indexes, or a
+	//           bit mask of hits.  These implement the ...First,
+	//           plain, and ...Mask forms of the public functions.
+	//
+
+	template <class Kernel>
+	unsigned int findFirst (const Kernel& kernel, unsigned int count)
+	{
+		unsigned int i = 0;
+		for(; i + LANE_COUNT <= count; i += LANE_COUNT)
+		{
+			unsigned int mask = kernel.calculateHitMask(i);
+			if(mask != 0)
+				return i + getLowestBit(mask);
+		}
+		for(; i < count; i++)
+		{
+			if(kernel.isHit(i))
+				return i;
+		}
+		return count;
+	}
+
+	template <class Kernel>
+	unsigned int findAll (const Kernel& kernel, unsigned int count,
+	                      unsigned int a_indexes[])
+	{
+		unsigned int hit_count = 0;
+		unsigned int i = 0;
+		for(; i + LANE_COUNT <= count; i += LANE_COUNT)
+		{
+			unsigned int mask = kernel.calculateHitMask(i);
+			while(mask != 0)
+			{
+				a_indexes[hit_count] = i + getLowestBit(mask);
+				hit_count++;
+				mask &= mask - 1;  // clear lowest set bit
+			}
+		}
+		for(; i < count; i++)
+		{
+			if(kernel.isHit(i))
+			{
+				a_indexes[hit_count] = i;
+				hit_count++;
+			}
+		}
+		return hit_count;
+	}
+
+	template <class Kernel>
+	unsigned int markAll (const Kernel& kernel, unsigned int count,
+	                      unsigned int a_mask[])
+	{
+		unsigned int mask_size = GeometricCollisions::getBatchMaskSize(count);
+		for(unsigned int w = 0; w < mask_size; w++)
+			a_mask[w] = 0;
+
+		// LANE_COUNT divides 32, so a group never spans two words
+		unsigned int hit_count = 0;
+		unsigned int i = 0;
+		for(; i + LANE_COUNT <= count; i += LANE_COUNT)
+		{
+			unsigned int mask = kernel.calculateHitMask(i);
+			a_mask[i / 32] |= mask << (i % 32);
+			hit_count += countBits(mask);
+		}
+		for(; i < count; i++)
+		{
+			if(kernel.isHit(i))
+			{
+				a_mask[i / 32] |= 1u << (i % 32);
+				hit_count++;
+			}
+		}
+		return hit_count;
+	}
+
+	//
+	//  makeSphereVsSpheres
+	//  makeSphereVsCuboids
+	//  makeCuboidVsCuboids
+	//
+	//  Purpose: To set up a kernel from the parameters of the
+	//           public functions.
+	//
+
+	SphereVsSpheresKernel makeSphereVsSpheres (const Vector3& sphere_center,
+	                                           double sphere_radius,
+	                                           const float a_x[],
+	                                           const float a_y[],
+	                                           const float a_z[],
+	                                           const float a_radius[])
+	{
+		SphereVsSpheresKernel kernel;
+		kernel.m_x      = (float)(sphere_center.x);
+		kernel.m_y      = (float)(sphere_center.y);
+		kernel.m_z      = (float)(sphere_center.z);
+		kernel.m_radius = (float)(sphere_radius);
+		kernel.ma_x      = a_x;
+		kernel.ma_y      = a_y;
+		kernel.ma_z      = a_z;
+		kernel.ma_radius = a_radius;
+		return kernel;
+	}
+
+	SphereVsCuboidsKernel makeSphereVsCuboids (const Vector3& sphere_center,
+	                                           double sphere_radius,
+	                                           const float a_x[],
+	                                           const float a_y[],
+	                                           const float a_z[],
+	                                           const float a_size_x[],
+	                                           const float a_size_y[],
+	                                           const float a_size_z[])
+	{
+		SphereVsCuboidsKernel kernel;
+		kernel.m_x      = (float)(sphere_center.x);
+		kernel.m_y      = (float)(sphere_center.y);
+		kernel.m_z      = (float)(sphere_center.z);
+		kernel.m_radius = (float)(sphere_radius);
+		kernel.ma_x      = a_x;
+		kernel.ma_y      = a_y;
+		kernel.ma_z      = a_z;
+		kernel.ma_size_x = a_size_x;
+		kernel.ma_size_y = a_size_y;
+		kernel.ma_size_z = a_size_z;
+		return kernel;
+	}
+
+	CuboidVsCuboidsKernel makeCuboidVsCuboids (const Vector3& cuboid_center,
+	                                           const Vector3& cuboid_size,
+	                                           const float a_x[],
+	                                           const float a_y[],
+	                                           const float a_z[],
+	                                           const float a_size_x[],
+	                                           const float a_size_y[],
+	                                           const float a_size_z[])
+	{
+		CuboidVsCuboidsKernel kernel;
+		kernel.m_x      = (float)(cuboid_center.x);
+		kernel.m_y      = (float)(cuboid_center.y);
+		kernel.m_z      = (float)(cuboid_center.z);
+		kernel.m_size_x = (float)(cuboid_size.x);
+		kernel.m_size_y = (float)(cuboid_size.y);
+		kernel.m_size_z = (float)(cuboid_size.z);
+		kernel.ma_x      = a_x;
+		kernel.ma_y      = a_y;
+		kernel.ma_z      = a_z;
+		kernel.ma_size_x = a_size_x;
+		kernel.ma_size_y = a_size_y;
+		kernel.ma_size_z = a_size_z;
+		return kernel;
+	}
+}
+
+
+
+unsigned int GeometricCollisions :: sphereVsSpheresFirst (const Vector3& sphere_center,
+                                                          double sphere_radius,
+                                                          const float a_x[],
+                                                          const float a_y[],
+                                                          const float a_z[],
+                                                          const float a_radius[],
+                                                          unsigned int count)
+{
+	assert(sphere_radius >= 0.0);
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_radius != NULL);
+
+	return findFirst(makeSphereVsSpheres(sphere_center, sphere_radius,
+	                                     a_x, a_y, a_z, a_radius),
+	                 count);
+}
+
+unsigned int GeometricCollisions :: sphereVsSpheres (const Vector3& sphere_center,
+                                                     double sphere_radius,
+                                                     const float a_x[],
+                                                     const float a_y[],
+                                                     const float a_z[],
+                                                     const float a_radius[],
+                                                     unsigned int count,
+                                                     unsigned int a_indexes[])
+{
+	assert(sphere_radius >= 0.0);
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_radius != NULL);
+	assert(count == 0 || a_indexes != NULL);
+
+	return findAll(makeSphereVsSpheres(sphere_center, sphere_radius,
+	                                   a_x, a_y, a_z, a_radius),
+	               count, a_indexes);
+}
+
+unsigned int GeometricCollisions :: sphereVsSpheresMask (const Vector3& sphere_center,
+                                                         double sphere_radius,
+                                                         const float a_x[],
+                                                         const float a_y[],
+                                                         const float a_z[],
+                                                         const float a_radius[],
+                                                         unsigned int count,
+                                                         unsigned int a_mask[])
+{
+	assert(sphere_radius >= 0.0);
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_radius != NULL);
+	assert(count == 0 || a_mask != NULL);
+
+	return markAll(makeSphereVsSpheres(sphere_center, sphere_radius,
+	                                   a_x, a_y, a_z, a_radius),
+	               count, a_mask);
+}
+
+unsigned int GeometricCollisions :: sphereVsCuboids (const Vector3& sphere_center,
+                                                     double sphere_radius,
+                                                     const float a_x[],
+                                                     const float a_y[],
+                                                     const float a_z[],
+                                                     const float a_size_x[],
+                                                     const float a_size_y[],
+                                                     const float a_size_z[],
+                                                     unsigned int count,
+                                                     unsigned int a_indexes[])
+{
+	assert(sphere_radius >= 0.0);
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_size_x != NULL);
+	assert(count == 0 || a_size_y != NULL);
+	assert(count == 0 || a_size_z != NULL);
+	assert(count == 0 || a_indexes != NULL);
+
+	return findAll(makeSphereVsCuboids(sphere_center, sphere_radius,
+	                                   a_x, a_y, a_z,
+	                                   a_size_x, a_size_y, a_size_z),
+	               count, a_indexes);
+}
+
+unsigned int GeometricCollisions :: sphereVsCuboidsMask (const Vector3& sphere_center,
+                                                         double sphere_radius,
+                                                         const float a_x[],
+                                                         const float a_y[],
+                                                         const float a_z[],
+                                                         const float a_size_x[],
+                                                         const float a_size_y[],
+                                                         const float a_size_z[],
+                                                         unsigned int count,
+                                                         unsigned int a_mask[])
+{
+	assert(sphere_radius >= 0.0);
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_size_x != NULL);
+	assert(count == 0 || a_size_y != NULL);
+	assert(count == 0 || a_size_z != NULL);
+	assert(count == 0 || a_mask != NULL);
+
+	return markAll(makeSphereVsCuboids(sphere_center, sphere_radius,
+	                                   a_x, a_y, a_z,
+	                                   a_size_x, a_size_y, a_size_z),
+	               count, a_mask);
+}
+
+unsigned int GeometricCollisions :: cuboidVsCuboids (const Vector3& cuboid_center,
+                                                     const Vector3& cuboid_size,
+                                                     const float a_x[],
+                                                     const float a_y[],
+                                                     const float a_z[],
+                                                     const float a_size_x[],
+                                                     const float a_size_y[],
+                                                     const float a_size_z[],
+                                                     unsigned int count,
+                                                     unsigned int a_indexes[])
+{
+	assert(cuboid_size.isAllComponentsNonNegative());
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_size_x != NULL);
+	assert(count == 0 || a_size_y != NULL);
+	assert(count == 0 || a_size_z != NULL);
+	assert(count == 0 || a_indexes != NULL);
+
+	return findAll(makeCuboidVsCuboids(cuboid_center, cuboid_size,
+	                                   a_x, a_y, a_z,
+	                                   a_size_x, a_size_y, a_size_z),
+	               count, a_indexes);
+}
+
+unsigned int GeometricCollisions :: cuboidVsCuboidsMask (const Vector3& cuboid_center,
+                                                         const Vector3& cuboid_size,
+                                                         const float a_x[],
+                                                         const float a_y[],
+                                                         const float a_z[],
+                                                         const float a_size_x[],
+                                                         const float a_size_y[],
+                                                         const float a_size_z[],
+                                                         unsigned int count,
+                                                         unsigned int a_mask[])
+{
+	assert(cuboid_size.isAllComponentsNonNegative());
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_size_x != NULL);
+	assert(count == 0 || a_size_y != NULL);
+	assert(count == 0 || a_size_z != NULL);
+	assert(count == 0 || a_mask != NULL);
+
+	return markAll(makeCuboidVsCuboids(cuboid_center, cuboid_size,
+	                                   a_x, a_y, a_z,
+	                                   a_size_x, a_size_y, a_size_z),
+	               count, a_mask);
+}
@@ -0,0 +1,298 @@
+//
+//  GeometricCollisionsBatch.h
+//
+//  An extension to the GeometricCollisions module to check one
+//    simple geometric solid against many others at once.  The
+//    many solids are stored as a structure of arrays, with one
+//    contiguous array of floats for each component.  This lets
+//    the checks be performed with SIMD instructions.
+//
+//  SSE2 or AVX instructions are used if the compiler enables
+//    them (__SSE2__ or __AVX__ is defined).  Otherwise, the
+//    checks are performed one at a time.  The results are the
+//    same either way.
+//
+//  Each check gives the same result as the matching function
+//    in GeometricCollisions, except that the positions and
+//    sizes are rounded to floats.  For spheres, this includes
+//    the tolerance used by Vector3, so spheres that are just
+//    touching are treated as intersecting.  A point can be
+//    checked by using a sphere with radius 0.0 or a cuboid
+//    with size Vector3::ZERO.
+//
+//  Each kind of check has up to 3 forms:
+//    -> ...First returns the index of the first solid hit
+//    -> The plain form writes a compacted list of the indexes
+//       of the solids hit
+//    -> ...Mask sets one bit for each solid hit: solid i is
+//       bit (i % 32) of a_mask[i / 32]
+//
+
+#ifndef GEOMETRIC_COLLISIONS_BATCH_H
+#define GEOMETRIC_COLLISIONS_BATCH_H
+
+class Vector3;
+
+
+
+namespace GeometricCollisions
+{
+
+//
+//  getBatchMaskSize
+//
+//  Purpose: To determine how many elements are needed for a bit
+//           mask array for the specified number of solids.
+//  Parameter(s):
+//    <1> count: The number of solids
+//  Precondition(s): N/A
+//  Returns: The number of unsigned ints needed to store one bit
+//           for each of count solids.
+//  Side Effect: N/A
+//
+
+	inline unsigned int getBatchMaskSize (unsigned int count)
+	{	return (count + 31) / 32;	}
+
+//
+//  sphereVsSpheresFirst
+//
+//  Purpose: A function to find the first of a list of spheres
+//           that intersects the specified sphere.
+//  Parameter(s):
+//    <1> sphere_center: The position of the sphere center
+//    <2> sphere_radius: The radius of the sphere
+//    <3> a_x
+//    <4> a_y
+//    <5> a_z: Arrays of the components of the centers of the
+//             spheres to test against
+//    <6> a_radius: An array of the radii of the spheres to test
+//                  against
+//    <7> count: The number of spheres to test against
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//    <2> a_x, a_y, a_z, and a_radius each contain at least
+//        count elements
+//    <3> a_radius[i] >= 0.0 for all i < count
+//  Returns: The lowest index i such that the sphere at position
+//           (a_x[i], a_y[i], a_z[i]) with radius a_radius[i]
+//           intersects the specified sphere, as determined by
+//           sphereVsSphere.  If no sphere intersects it, count
+//           is returned.
+//  Side Effect: N/A
+//
+
+	unsigned int sphereVsSpheresFirst (const Vector3& sphere_center,
+	                                   double sphere_radius,
+	                                   const float a_x[],
+	                                   const float a_y[],
+	                                   const float a_z[],
+	                                   const float a_radius[],
+	                                   unsigned int count);
+
+//
+//  sphereVsSpheres
+//
+//  Purpose: A function to find all of a list of spheres that
+//           intersect the specified sphere.
+//  Parameter(s):
+//    <1> sphere_center: The position of the sphere center
+//    <2> sphere_radius: The radius of the sphere
+//    <3> a_x
+//    <4> a_y
+//    <5> a_z: Arrays of the components of the centers of the
+//             spheres to test against
+//    <6> a_radius: An array of the radii of the spheres to test
+//                  against
+//    <7> count: The number of spheres to test against
+//    <8> a_indexes: An array to fill with the indexes of the
+//                   intersecting spheres
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//    <2> a_x, a_y, a_z, and a_radius each contain at least
+//        count elements
+//    <3> a_radius[i] >= 0.0 for all i < count
+//    <4> a_indexes has room for at least count elements
+//  Returns: The number of spheres that intersect the specified
+//           sphere.
+//  Side Effect: The indexes of the spheres that intersect the
+//               specified sphere are written to the start of
+//               a_indexes in increasing order.
+//
+
+	unsigned int sphereVsSpheres (const Vector3& sphere_center,
+	                              double sphere_radius,
+	                              const float a_x[],
+	                              const float a_y[],
+	                              const float a_z[],
+	                              const float a_radius[],
+	                              unsigned int count,
+	                              unsigned int a_indexes[]);
+
+//
+//  sphereVsSpheresMask
+//
+//  Purpose: A function to mark which of a list of spheres
+//           intersect the specified sphere.
+//  Parameter(s):
+//    <1> sphere_center: The position of the sphere center
+//    <2> sphere_radius: The radius of the sphere
+//    <3> a_x
+//    <4> a_y
+//    <5> a_z: Arrays of the components of the centers of the
+//             spheres to test against
+//    <6> a_radius: An array of the radii of the spheres to test
+//                  against
+//    <7> count: The number of spheres to test against
+//    <8> a_mask: An array to fill with the bit mask
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//    <2> a_x, a_y, a_z, and a_radius each contain at least
+//        count elements
+//    <3> a_radius[i] >= 0.0 for all i < count
+//    <4> a_mask has room for at least getBatchMaskSize(count)
+//        elements
+//  Returns: The number of spheres that intersect the specified
+//           sphere.
+//  Side Effect: The first getBatchMaskSize(count) elements of
+//               a_mask are set so that the bit for each sphere
+//               is 1 if it intersects the specified sphere and
+//               0 otherwise.  Unused bits are set to 0.
+//
+
+	unsigned int sphereVsSpheresMask (const Vector3& sphere_center,
+	                                  double sphere_radius,
+	                                  const float a_x[],
+	                                  const float a_y[],
+	                                  const float a_z[],
+	                                  const float a_radius[],
+	                                  unsigned int count,
+	                                  unsigned int a_mask[]);
+
+//
+//  sphereVsCuboids
+//  sphereVsCuboidsMask
+//
+//  Purpose: To find/mark all of a list of axis-aligned cuboids
+//           that intersect the specified sphere.
+//  Parameter(s):
+//    <1> sphere_center: The position of the sphere center
+//    <2> sphere_radius: The radius of the sphere
+//    <3> a_x
+//    <4> a_y
+//    <5> a_z: Arrays of the components of the centers of the
+//             cuboids to test against
+//    <6> a_size_x
+//    <7> a_size_y
+//    <8> a_size_z: Arrays of the distances from the cuboid
+//                  centers to their faces along each axis
+//    <9> count: The number of cuboids to test against
+//    <10> a_indexes: An array to fill with the indexes of the
+//                    intersecting cuboids
+//         a_mask: An array to fill with the bit mask
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//    <2> a_x, a_y, a_z, a_size_x, a_size_y, and a_size_z each
+//        contain at least count elements
+//    <3> a_size_x[i], a_size_y[i], and a_size_z[i] are all
+//        >= 0.0 for all i < count
+//    <4> a_indexes has room for at least count elements
+//        a_mask has room for at least getBatchMaskSize(count)
+//        elements
+//  Returns: The number of cuboids that intersect the specified
+//           sphere, as determined by sphereVsCuboid.
+//  Side Effect: sphereVsCuboids writes the indexes of the
+//               intersecting cuboids to the start of a_indexes
+//               in increasing order.  sphereVsCuboidsMask sets
+//               the bit for each cuboid in a_mask to 1 if it
+//               intersects the sphere and 0 otherwise.
+//
+
+	unsigned int sphereVsCuboids (const Vector3& sphere_center,
+	                              double sphere_radius,
+	                              const float a_x[],
+	                              const float a_y[],
+	                              const float a_z[],
+	                              const float a_size_x[],
+	                              const float a_size_y[],
+	                              const float a_size_z[],
+	                              unsigned int count,
+	                              unsigned int a_indexes[]);
+	unsigned int sphereVsCuboidsMask (const Vector3& sphere_center,
+	                                  double sphere_radius,
+	                                  const float a_x[],
+	                                  const float a_y[],
+	                                  const float a_z[],
+	                                  const float a_size_x[],
+	                                  const float a_size_y[],
+	                                  const float a_size_z[],
+	                                  unsigned int count,
+	                                  unsigned int a_mask[]);
+
+//
+//  cuboidVsCuboids
+//  cuboidVsCuboidsMask
+//
+//  Purpose: To find/mark all of a list of axis-aligned cuboids
+//           that intersect the specified axis-aligned cuboid.
+//  Parameter(s):
+//    <1> cuboid_center: The position of the cuboid center
+//    <2> cuboid_size: The distance from the cuboid center to
+//                     the faces along each axis
+//    <3> a_x
+//    <4> a_y
+//    <5> a_z: Arrays of the components of the centers of the
+//             cuboids to test against
+//    <6> a_size_x
+//    <7> a_size_y
+//    <8> a_size_z: Arrays of the distances from the cuboid
+//                  centers to their faces along each axis
+//    <9> count: The number of cuboids to test against
+//    <10> a_indexes: An array to fill with the indexes of the
+//                    intersecting cuboids
+//         a_mask: An array to fill with the bit mask
+//  Precondition(s):
+//    <1> cuboid_size.isAllComponentsNonNegative()
+//    <2> a_x, a_y, a_z, a_size_x, a_size_y, and a_size_z each
+//        contain at least count elements
+//    <3> a_size_x[i], a_size_y[i], and a_size_z[i] are all
+//        >= 0.0 for all i < count
+//    <4> a_indexes has room for at least count elements
+//        a_mask has room for at least getBatchMaskSize(count)
+//        elements
+//  Returns: The number of cuboids that intersect the specified
+//           cuboid, as determined by cuboidVsCuboid.
+//  Side Effect: cuboidVsCuboids writes the indexes of the
+//               intersecting cuboids to the start of a_indexes
+//               in increasing order.  cuboidVsCuboidsMask sets
+//               the bit for each cuboid in a_mask to 1 if it
+//               intersects the specified cuboid and 0
+//               otherwise.
+//
+
+	unsigned int cuboidVsCuboids (const Vector3& cuboid_center,
+	                              const Vector3& cuboid_size,
+	                              const float a_x[],
+	                              const float a_y[],
+	                              const float a_z[],
+	                              const float a_size_x[],
+	                              const float a_size_y[],
+	                              const float a_size_z[],
+	                              unsigned int count,
+	                              unsigned int a_indexes[]);
+	unsigned int cuboidVsCuboidsMask (const Vector3& cuboid_center,
+	                                  const Vector3& cuboid_size,
+	                                  const float a_x[],
+	                                  const float a_y[],
+	                                  const float a_z[],
+	                                  const float a_size_x[],
+	                                  const float a_size_y[],
+	                                  const float a_size_z[],
+	                                  unsigned int count,
+	                                  unsigned int a_mask[]);
+
+}  // end of namespace GeometricCollisions
+
+
+
+#endif
@@ -4,13 +4,17 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <chrono>
+#include <algorithm>
 
 #include "../../ObjLibrary/Vector3.h"
 
 #include "GeometricCollisions.h"
+#include "GeometricCollisionsBatch.h"
 #include "NumericTests.h"
 
 using namespace std;
@@ -23,11 +27,218 @@ namespace
 	const string RESULT_IDENTIFIER  = "result:\t";
 
 	const bool DEBUGGING_POINT_VS_SPHERE = false;
+
+	const string BATCH_TITLES[BATCH_SOLIDS_COUNT] =
+	{
+		"Point vs. Sphere",
+		"Sphere vs. Sphere",
+		"Point vs. Cuboid",
+		"Cuboid vs. Cuboid",
+		"Sphere vs. Cuboid",
+	};
+
+	// each trial is repeated until about this many pairs have
+	//  been checked, so the times are long enough to measure
+	const unsigned int BATCH_TIMED_PAIR_COUNT = 200000;
+
+	// the batch functions round to floats, so a pair this close
+	//  to just touching may be reported either way
+	const double BATCH_ROUNDING_TOLERANCE = 1.0e-4;
+
+	// timing results are written here so that the compiler
+	//  cannot remove the timed loops
+	volatile unsigned int g_timing_sink = 0;
+
+	//
+	//  BatchProbe
+	//
+	//  A record for the first solid in a batch trial.  Unused
+	//    dimensions are left as zero.
+	//
+
+	struct BatchProbe
+	{
+		BatchSolids m_solids;
+		Vector3 m_position;
+		double m_radius;
+		Vector3 m_half_size;
+	};
+
+	//
+	//  BatchArrays
+	//
+	//  A record for the second solids in a batch trial, stored
+	//    as a structure of arrays.  For spheres, the radius is
+	//    stored in mv_size_x.
+	//
+
+	struct BatchArrays
+	{
+		vector<Vector3> mv_position;
+		double m_radius;
+		Vector3 m_half_size;
+		vector<float> mv_x;
+		vector<float> mv_y;
+		vector<float> mv_z;
+		vector<float> mv_size_x;
+		vector<float> mv_size_y;
+		vector<float> mv_size_z;
+	};
+
+	//
+	//  checkSingleResized
+	//
+	//  Purpose: To check the probe against second solid i using
+	//           the matching function in GeometricCollisions,
+	//           with the second solid grown by the specified
+	//           amount in every direction.  A negative amount
+	//           shrinks it, but never below size 0.
+	//
+
+	bool checkSingleResized (const BatchProbe& probe,
+	                         const BatchArrays& arrays,
+	                         unsigned int i,
+	                         double change)
+	{
+		const Vector3& pos2 = arrays.mv_position[i];
+		double radius2 = max(arrays.m_radius + change, 0.0);
+		Vector3 half_size2(max(arrays.m_half_size.x + change, 0.0),
+		                   max(arrays.m_half_size.y + change, 0.0),
+		                   max(arrays.m_half_size.z + change, 0.0));
+		switch(probe.m_solids)
+		{
+		case BATCH_POINT_VS_SPHERE:
+			return GeometricCollisions::pointVsSphere(probe.m_position, pos2, radius2);
+		case BATCH_SPHERE_VS_SPHERE:
+			return GeometricCollisions::sphereVsSphere(probe.m_position, probe.m_radius, pos2, radius2);
+		case BATCH_POINT_VS_CUBOID:
+			return GeometricCollisions::pointVsCuboid(probe.m_position, pos2, half_size2);
+		case BATCH_CUBOID_VS_CUBOID:
+			return GeometricCollisions::cuboidVsCuboid(probe.m_position, probe.m_half_size, pos2, half_size2);
+		case BATCH_SPHERE_VS_CUBOID:
+			return GeometricCollisions::sphereVsCuboid(probe.m_position, probe.m_radius, pos2, half_size2);
+		default:
+			assert(false);
+			return false;
+		}
+	}
+
+	//
+	//  checkSingle
+	//
+	//  Purpose: To check the probe against second solid i using
+	//           the matching function in GeometricCollisions.
+	//
+
+	bool checkSingle (const BatchProbe& probe,
+	                  const BatchArrays& arrays,
+	                  unsigned int i)
+	{
+		return checkSingleResized(probe, arrays, i, 0.0);
+	}
+
+	//
+	//  isOnBoundary
+	//
+	//  Purpose: To determine if the probe and second solid i are
+	//           so close to just touching that rounding to floats
+	//           could change whether they intersect.
+	//
+
+	bool isOnBoundary (const BatchProbe& probe,
+	                   const BatchArrays& arrays,
+	                   unsigned int i)
+	{
+		return checkSingleResized(probe, arrays, i,  BATCH_ROUNDING_TOLERANCE) !=
+		       checkSingleResized(probe, arrays, i, -BATCH_ROUNDING_TOLERANCE);
+	}
+
+	//
+	//  checkBatch
+	//  checkBatchMask
+	//
+	//  Purpose: To check the probe against all the second solids
+	//           at once using the matching function in
+	//           GeometricCollisionsBatch.  Points are checked as
+	//           spheres of radius 0 or cuboids of size 0.
+	//
+
+	unsigned int checkBatch (const BatchProbe& probe,
+	                         const BatchArrays& arrays,
+	                         unsigned int a_indexes[])
+	{
+		unsigned int count = arrays.mv_position.size();
+		switch(probe.m_solids)
+		{
+		case BATCH_POINT_VS_SPHERE:
+		case BATCH_SPHERE_VS_SPHERE:
+			return GeometricCollisions::sphereVsSpheres(probe.m_position, probe.m_radius,
+			                                            &arrays.mv_x[0], &arrays.mv_y[0], &arrays.mv_z[0],
+			                                            &arrays.mv_size_x[0],
+			                                            count, a_indexes);
+		case BATCH_POINT_VS_CUBOID:
+		case BATCH_CUBOID_VS_CUBOID:
+			return GeometricCollisions::cuboidVsCuboids(probe.m_position, probe.m_half_size,
+			                                            &arrays.mv_x[0], &arrays.mv_y[0], &arrays.mv_z[0],
+			                                            &arrays.mv_size_x[0], &arrays.mv_size_y[0], &arrays.mv_size_z[0],
+			                                            count, a_indexes);
+		case BATCH_SPHERE_VS_CUBOID:
+			return GeometricCollisions::sphereVsCuboids(probe.m_position, probe.m_radius,
+			                                            &arrays.mv_x[0], &arrays.mv_y[0], &arrays.mv_z[0],
+			                                            &arrays.mv_size_x[0], &arrays.mv_size_y[0], &arrays.mv_size_z[0],
+			                                            count, a_indexes);
+		default:
+			assert(false);
+			return 0;
+		}
+	}
+
+	unsigned int checkBatchMask (const BatchProbe& probe,
+	                             const BatchArrays& arrays,
+	                             unsigned int a_mask[])
+	{
+		unsigned int count = arrays.mv_position.size();
+		switch(probe.m_solids)
+		{
+		case BATCH_POINT_VS_SPHERE:
+		case BATCH_SPHERE_VS_SPHERE:
+			return GeometricCollisions::sphereVsSpheresMask(probe.m_position, probe.m_radius,
+			                                                &arrays.mv_x[0], &arrays.mv_y[0], &arrays.mv_z[0],
+			                                                &arrays.mv_size_x[0],
+			                                                count, a_mask);
+		case BATCH_POINT_VS_CUBOID:
+		case BATCH_CUBOID_VS_CUBOID:
+			return GeometricCollisions::cuboidVsCuboidsMask(probe.m_position, probe.m_half_size,
+			                                                &arrays.mv_x[0], &arrays.mv_y[0], &arrays.mv_z[0],
+			                                                &arrays.mv_size_x[0], &arrays.mv_size_y[0], &arrays.mv_size_z[0],
+			                                                count, a_mask);
+		case BATCH_SPHERE_VS_CUBOID:
+			return GeometricCollisions::sphereVsCuboidsMask(probe.m_position, probe.m_radius,
+			                                                &arrays.mv_x[0], &arrays.mv_y[0], &arrays.mv_z[0],
+			                                                &arrays.mv_size_x[0], &arrays.mv_size_y[0], &arrays.mv_size_z[0],
+			                                                count, a_mask);
+		default:
+			assert(false);
+			return 0;
+		}
+	}
+
+	//
+	//  getSecondsSince
+	//
+	//  Purpose: To determine how many seconds have passed since
+	//           the specified time.
+	//
+
+	double getSecondsSince (const chrono::steady_clock::time_point& start)
+	{
+		return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	}
 }
 
 
 
-void NumericTests :: run (const string& filename)
+bool NumericTests :: run (const string& filename)
 {
 	assert(filename != "");
 
@@ -59,6 +270,40 @@ void NumericTests :: run (const string& filename)
 	cout << setprecision(default_precision);
 
 	fin.close();
+
+	bool is_batch_matching = runBatch(filename);
+	return average_grade >= 1.0 && is_batch_matching;
+}
+
+bool NumericTests :: runBatch (const string& filename)
+{
+	assert(filename != "");
+
+	ifstream fin(filename.c_str());
+
+	streamsize default_precision = std::cout.precision();
+	cout << right << fixed << setprecision(2);
+
+	printBatchTableHeader();
+	bool is_all_matching = true;
+	for(unsigned int s = 0; s < BATCH_SOLIDS_COUNT; s++)
+	{
+		BatchResults results = testBatch(fin, (BatchSolids)(s));
+		printBatchTableRow(BATCH_TITLES[s], results);
+
+		if(results.m_index_mismatch_count != 0 ||
+		   results.m_mask_mismatch_count  != 0)
+		{
+			is_all_matching = false;
+		}
+	}
+	printBatchTableFooter();
+
+	cout.unsetf(ios_base::floatfield | ios_base::adjustfield);
+	cout << setprecision(default_precision);
+
+	fin.close();
+	return is_all_matching;
 }
 
 double NumericTests :: testPointVsSphere (ifstream& r_fin)
@@ -376,6 +621,140 @@ double NumericTests :: testSphereVsCuboid (ifstream& r_fin)
 
 
 
+BatchResults NumericTests :: testBatch (ifstream& r_fin,
+                                       BatchSolids solids)
+{
+	assert(r_fin.is_open());
+	assert(r_fin.good());
+	assert(solids < BATCH_SOLIDS_COUNT);
+
+	bool is_sphere1 = (solids == BATCH_SPHERE_VS_SPHERE || solids == BATCH_SPHERE_VS_CUBOID);
+	bool is_cuboid1 = (solids == BATCH_CUBOID_VS_CUBOID);
+	bool is_sphere2 = (solids == BATCH_POINT_VS_SPHERE  || solids == BATCH_SPHERE_VS_SPHERE);
+
+	BatchResults results;
+	vector<unsigned int> v_indexes;
+	vector<unsigned int> v_mask;
+	vector<bool> v_single;
+
+	int trial_count = readTrialCount(r_fin);
+	for(int trial = 0; trial < trial_count; trial++)
+	{
+		// read the trial
+		BatchProbe probe;
+		probe.m_solids    = solids;
+		probe.m_position  = readPosition(r_fin);
+		probe.m_radius    = 0.0;
+		probe.m_half_size = Vector3::ZERO;
+		if(is_sphere1)
+			probe.m_radius = readDimensionsSphere(r_fin, "size1:");
+		else if(is_cuboid1)
+			probe.m_half_size = readDimensionsCuboid(r_fin, "size1:");
+		else
+			readDimensionsPoint(r_fin, "size1:");
+
+		PositionRange range2 = readPositionRange(r_fin);
+
+		BatchArrays arrays;
+		arrays.m_radius    = 0.0;
+		arrays.m_half_size = Vector3::ZERO;
+		if(is_sphere2)
+			arrays.m_radius = readDimensionsSphere(r_fin, "size2:");
+		else
+			arrays.m_half_size = readDimensionsCuboid(r_fin, "size2:");
+
+		string read_results = readResults(r_fin);
+
+		// lay out the second solids in the same order as the
+		//  results in the file
+		for(int z = 0; z < range2.m_count_z; z++)
+			for(int y = 0; y < range2.m_count_y; y++)
+				for(int x = 0; x < range2.m_count_x; x++)
+				{
+					Vector3 pos2 = calculatePosition(range2.m_min, range2.m_inc, x, y, z);
+					arrays.mv_position.push_back(pos2);
+					arrays.mv_x.push_back((float)(pos2.x));
+					arrays.mv_y.push_back((float)(pos2.y));
+					arrays.mv_z.push_back((float)(pos2.z));
+					if(is_sphere2)
+					{
+						arrays.mv_size_x.push_back((float)(arrays.m_radius));
+						arrays.mv_size_y.push_back(0.0f);
+						arrays.mv_size_z.push_back(0.0f);
+					}
+					else
+					{
+						arrays.mv_size_x.push_back((float)(arrays.m_half_size.x));
+						arrays.mv_size_y.push_back((float)(arrays.m_half_size.y));
+						arrays.mv_size_z.push_back((float)(arrays.m_half_size.z));
+					}
+				}
+		unsigned int count = arrays.mv_position.size();
+		assert(count > 0);
+		assert(read_results.length() == count);
+
+		// compare the batch results to the single results
+		v_single.assign(count, false);
+		for(unsigned int i = 0; i < count; i++)
+			v_single[i] = checkSingle(probe, arrays, i);
+
+		v_indexes.assign(count, 0);
+		unsigned int hit_count = checkBatch(probe, arrays, &v_indexes[0]);
+		vector<bool> v_batch(count, false);
+		for(unsigned int h = 0; h < hit_count; h++)
+		{
+			assert(v_indexes[h] < count);
+			v_batch[v_indexes[h]] = true;
+		}
+
+		v_mask.assign(GeometricCollisions::getBatchMaskSize(count), 0);
+		unsigned int mask_hit_count = checkBatchMask(probe, arrays, &v_mask[0]);
+		if(mask_hit_count != hit_count)
+			results.m_mask_mismatch_count++;
+
+		for(unsigned int i = 0; i < count; i++)
+		{
+			// pairs that are just touching may go either way
+			if(isOnBoundary(probe, arrays, i))
+				continue;
+
+			bool is_in_mask = ((v_mask[i / 32] >> (i % 32)) & 1) != 0;
+			if(v_batch[i] != v_single[i])
+				results.m_index_mismatch_count++;
+			if(is_in_mask != v_single[i])
+				results.m_mask_mismatch_count++;
+			if(v_batch[i] != (read_results[i] == '1'))
+				results.m_file_mismatch_count++;
+		}
+		results.m_pair_count += count;
+
+		// time both ways of checking the same pairs
+		unsigned int repeat_count = BATCH_TIMED_PAIR_COUNT / count + 1;
+		unsigned int hit_total = 0;
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for(unsigned int r = 0; r < repeat_count; r++)
+			for(unsigned int i = 0; i < count; i++)
+				if(checkSingle(probe, arrays, i))
+					hit_total++;
+		results.m_single_seconds += getSecondsSince(start);
+
+		start = chrono::steady_clock::now();
+		for(unsigned int r = 0; r < repeat_count; r++)
+			hit_total += checkBatch(probe, arrays, &v_indexes[0]);
+		results.m_batch_seconds += getSecondsSince(start);
+
+		g_timing_sink = hit_total;
+		results.m_timed_pair_count += (unsigned long long)(repeat_count) * count;
+	}
+
+	assert(r_fin.is_open());
+	assert(r_fin.good());
+	return results;
+}
+
+
+
 int NumericTests :: readTrialCount (ifstream& r_fin)
 {
 	assert(r_fin.is_open());
@@ -607,3 +986,46 @@ void NumericTests :: printTableFooter (double average)
 	cout << endl;
 }
 
+void NumericTests :: printBatchTableHeader ()
+{
+	cout << "+--------------------+---------+-------+-------+-------+----------+----------+---------+" << endl;
+	cout << "| Batch vs. Single Functions                                                           |" << endl;
+	cout << "+--------------------+---------+-----------------------+-------------------------------+" << endl;
+	cout << "|                    |         |       Mismatches      |     Million Pairs / Second    |" << endl;
+	cout << "|       Solids       |  Pairs  +-------+-------+-------+----------+----------+---------+" << endl;
+	cout << "|                    |         | Index |  Mask |  File |  Single  |  Batch   | Speedup |" << endl;
+	cout << "+--------------------+---------+-------+-------+-------+----------+----------+---------+" << endl;
+}
+
+void NumericTests :: printBatchTableRow (const string& title,
+                                         const BatchResults& results)
+{
+	assert(title != "");
+
+	double single_rate = 0.0;
+	double batch_rate  = 0.0;
+	if(results.m_single_seconds > 0.0)
+		single_rate = results.m_timed_pair_count / results.m_single_seconds * 1.0e-6;
+	if(results.m_batch_seconds > 0.0)
+		batch_rate  = results.m_timed_pair_count / results.m_batch_seconds  * 1.0e-6;
+
+	cout <<  "| " << left << setw(18) << title << right;
+	cout << " | " << setw(7) << results.m_pair_count;
+	cout << " | " << setw(5) << results.m_index_mismatch_count;
+	cout << " | " << setw(5) << results.m_mask_mismatch_count;
+	cout << " | " << setw(5) << results.m_file_mismatch_count;
+	cout << " | " << setw(8) << single_rate;
+	cout << " | " << setw(8) << batch_rate;
+	if(single_rate > 0.0)
+		cout << " | " << setw(6) << (batch_rate / single_rate) << "x";
+	else
+		cout << " |     N/A";
+	cout << " |"  << endl;
+}
+
+void NumericTests :: printBatchTableFooter ()
+{
+	cout << "+--------------------+---------+-------+-------+-------+----------+----------+---------+" << endl;
+	cout << endl;
+}
+
@@ -41,6 +41,16 @@
 //        -> All together in a long string
 //           -> no spaces or line breaks
 //
+//  The same input file is also used to check the batch
+//    functions in GeometricCollisionsBatch.  For each trial,
+//    all the positions for the second solid are placed in one
+//    batch and checked against the first solid at once.  The
+//    batch results are compared to the functions in
+//    GeometricCollisions, and the number of pairs of solids
+//    each can check per second is reported.  The batch
+//    functions use floats, so a solid that is within float
+//    rounding of a face can be reported as a mismatch.
+//
 
 
 namespace NumericTests
@@ -87,6 +97,56 @@ struct TestResults
 
 
 
+//
+//  BatchSolids
+//
+//  An enumeration of the combinations of solids in the input
+//    file, in the order they appear.
+//
+
+enum BatchSolids
+{
+	BATCH_POINT_VS_SPHERE,
+	BATCH_SPHERE_VS_SPHERE,
+	BATCH_POINT_VS_CUBOID,
+	BATCH_CUBOID_VS_CUBOID,
+	BATCH_SPHERE_VS_CUBOID,
+	BATCH_SOLIDS_COUNT
+};
+
+
+
+//
+//  BatchResults
+//
+//  A record to keep track of how well the batch functions
+//    agree with the single functions and how fast each is.
+//
+
+struct BatchResults
+{
+	unsigned int m_pair_count;
+	unsigned int m_index_mismatch_count;
+	unsigned int m_mask_mismatch_count;
+	unsigned int m_file_mismatch_count;
+	double m_single_seconds;
+	double m_batch_seconds;
+	unsigned long long m_timed_pair_count;
+
+	BatchResults()
+			: m_pair_count(0),
+			  m_index_mismatch_count(0),
+			  m_mask_mismatch_count(0),
+			  m_file_mismatch_count(0),
+			  m_single_seconds(0.0),
+			  m_batch_seconds(0.0),
+			  m_timed_pair_count(0)
+	{
+	}
+};
+
+
+
 //
 //  run
 //
@@ -96,13 +156,60 @@ struct TestResults
 //    <1> filename: The file to read the test information from
 //  Precondition(s):
 //    <1> filename != ""
-//  Returns: N/A
+//  Returns: Whether every test got full marks and every batch
+//           function gave the same results as the matching
+//           single function.
 //  Side Effect: The numerical tests indicated in file filename
 //               are performed.  The results are printed to
 //               standard output.
 //
 
-	void run (const std::string& filename);
+	bool run (const std::string& filename);
+
+//
+//  runBatch
+//
+//  Purpose: To check the batch functions against the single
+//           functions and display the results and throughput
+//           for all the combinations of solids.
+//  Parameter(s):
+//    <1> filename: The file to read the test information from
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether every batch function gave the same results
+//           as the matching single function.  Pairs that are
+//           so close to just touching that rounding to floats
+//           could change the result are not counted.
+//  Side Effect: The batch tests indicated in file filename are
+//               performed.  The results are printed to standard
+//               output.
+//
+
+	bool runBatch (const std::string& filename);
+
+//
+//  testBatch
+//
+//  Purpose: To check the batch functions for one combination of
+//           solids against the matching single function and
+//           time both.
+//  Parameter(s):
+//    <1> r_fin: A reference to the file to read the test
+//               information from
+//    <2> solids: Which combination of solids to check
+//  Precondition(s):
+//    <1> r_fin.is_open()
+//    <2> r_fin.good()
+//    <3> solids < BATCH_SOLIDS_COUNT
+//    <4> The next part of r_fin is for solids
+//  Returns: The combined results for all the trials.
+//  Side Effect: The trials for solids are read from r_fin and
+//               performed.  The read position for r_fin is
+//               advanced as the values are read.
+//
+
+	BatchResults testBatch (std::ifstream& r_fin,
+	                        BatchSolids solids);
 
 //
 //  testPointVsSphere
@@ -338,6 +445,32 @@ struct TestResults
 
 	void printTableFooter (double average);
 
+//
+//  printBatchTableHeader
+//  printBatchTableRow
+//  printBatchTableFooter
+//
+//  Purpose: To display the output table for the batch tests.
+//           Each row shows one combination of solids: the
+//           number of pairs checked, how many batch results
+//           disagree with the single function (as a list of
+//           indexes and as a bit mask) and with the file, and
+//           how many million pairs per second each checks.
+//  Parameter(s):
+//    <1> title: The name of the combination of solids
+//    <2> results: The results for that combination
+//  Precondition(s):
+//    <1> title != ""
+//  Returns: N/A
+//  Side Effect: The header/row/footer for the batch output
+//               table is printed to standard output.
+//
+
+	void printBatchTableHeader ();
+	void printBatchTableRow (const std::string& title,
+	                         const BatchResults& results);
+	void printBatchTableFooter ();
+
 }	// end of namespace NumericTests
 
 
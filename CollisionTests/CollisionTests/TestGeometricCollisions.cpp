@@ -274,7 +274,10 @@ void keyboard (unsigned char key, int x, int y)
 		break;
 	case 't':
 	case 'T':
-		NumericTests::run("numeric_tests.txt");
+		if(NumericTests::run("numeric_tests.txt"))
+			cout << "All numeric tests passed" << endl;
+		else
+			cout << "SOME NUMERIC TESTS FAILED" << endl;
 		break;
 	}
 }
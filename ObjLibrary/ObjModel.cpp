@@ -29,12 +29,26 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <map>
 #include <vector>
 
 #include "GetGlut.h"
 #include "ObjSettings.h"
+
+#ifdef OBJ_LIBRARY_BINARY_CACHE
+#include <cstdio>	// for rename and remove
+#include <cstring>	// for memcpy
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#endif
 #include "ObjStringParsing.h"
 #include "DisplayList.h"
+#include "VertexBuffer.h"
 #include "Material.h"
 #include "MtlLibrary.h"
 #include "MtlLibraryManager.h"
@@ -55,7 +69,315 @@ namespace
 
 	const bool DEBUGGING = false;
 	const bool DEBUGGING_VERTEX_BUFFER = false;
+
+	//
+	//  VertexBufferKey
+	//
+	//  A record to identify a vertex in a VertexBuffer by the
+	//    vertex, texture coordinate, and normal indexes it was
+	//    made from.  Face vertices with the same key share a
+	//    vertex.
+	//
+
+	struct VertexBufferKey
+	{
+		unsigned int m_vertex;
+		unsigned int m_texture_coordinate;
+		unsigned int m_normal;
+
+		bool operator< (const VertexBufferKey& other) const
+		{
+			if(m_vertex != other.m_vertex)
+				return m_vertex < other.m_vertex;
+			if(m_texture_coordinate != other.m_texture_coordinate)
+				return m_texture_coordinate < other.m_texture_coordinate;
+			return m_normal < other.m_normal;
+		}
+	};
+}
+
+
+#ifdef OBJ_LIBRARY_BINARY_CACHE
+namespace
+{
+	//
+	//  The binary cache file starts with a BinaryCacheHeader.
+	//    It is followed by these sections, in order:
+	//    <1> The name of the OBJ file, padded to a multiple of
+	//        8 bytes
+	//    <2> The material library names and then the mesh
+	//        material names, each stored as an unsigned int
+	//        length followed by the characters, with the whole
+	//        section padded to a multiple of 8 bytes
+	//    <3> The vertexes, texture coordinates, and normals, as
+	//        raw arrays of Vector3, Vector2, and Vector3
+	//    <4> The number of vertexes in each point set, and then
+	//        the vertexes for all point sets
+	//    <5> The number of vertexes in each polyline, and then
+	//        the vertex and texture coordinate indexes for all
+	//        polylines
+	//    <6> The number of faces in each mesh, the number of
+	//        vertexes in each face, and then the vertex, texture
+	//        coordinate, and normal indexes for all faces
+	//
+	//  All values are stored in the native format.  The magic
+	//    number and layout fields are used to reject files
+	//    written on a different kind of computer.
+	//
+
+	const unsigned int BINARY_CACHE_MAGIC   = 0x434a424f;	// "OBJC" on little-endian
+	const unsigned int BINARY_CACHE_VERSION = 1;
+	const unsigned int BINARY_CACHE_LAYOUT  = (unsigned int)(sizeof(Vector3)) |
+	                                          ((unsigned int)(sizeof(Vector2))      <<  8) |
+	                                          ((unsigned int)(sizeof(unsigned int)) << 16);
+
+	struct BinaryCacheHeader
+	{
+		unsigned int m_magic;
+		unsigned int m_version;
+		unsigned int m_header_size;
+		unsigned int m_layout;
+		long long m_source_time;
+		long long m_source_size;
+		unsigned int m_source_name_length;
+		unsigned int m_material_library_count;
+		unsigned int m_vertex_count;
+		unsigned int m_texture_coordinate_count;
+		unsigned int m_normal_count;
+		unsigned int m_point_set_count;
+		unsigned int m_polyline_count;
+		unsigned int m_mesh_count;
+		unsigned int m_face_count;
+		unsigned int m_face_vertex_count;
+	};
+
+	//
+	//  getSourceStamp
+	//
+	//  Purpose: To determine the modification time and size of
+	//           the specified file.
+	//  Parameter(s):
+	//    <1> filename: The name of the file
+	//    <2> r_time: A variable to store the modification time
+	//                in
+	//    <3> r_size: A variable to store the size in
+	//  Precondition(s): N/A
+	//  Returns: Whether file filename exists.
+	//  Side Effect: If file filename exists, its modification
+	//               time and size are stored in r_time and
+	//               r_size.
+	//
+
+	bool getSourceStamp (const string& filename,
+	                     long long& r_time,
+	                     long long& r_size)
+	{
+		struct stat file_status;
+		if(stat(filename.c_str(), &file_status) != 0)
+			return false;
+
+		r_time = (long long)(file_status.st_mtime);
+		r_size = (long long)(file_status.st_size);
+		return true;
+	}
+
+	//
+	//  BinaryCacheFile
+	//
+	//  A class to give read-only access to the contents of a
+	//    binary cache file.  On POSIX systems, the file is
+	//    memory-mapped so that the arrays in it can be copied
+	//    straight into an ObjModel.  Elsewhere, the whole file
+	//    is read into memory.
+	//
+
+	class BinaryCacheFile
+	{
+	public:
+		BinaryCacheFile ()
+				: mp_data(NULL),
+				  m_size(0)
+		{ }
+
+		~BinaryCacheFile ()
+		{
+#ifndef _WIN32
+			if(mp_data != NULL)
+				munmap((void*)(mp_data), m_size);
+#endif
+		}
+
+		bool open (const string& filename)
+		{
+			assert(mp_data == NULL);
+
+#ifndef _WIN32
+			int file_descriptor = ::open(filename.c_str(), O_RDONLY);
+			if(file_descriptor < 0)
+				return false;
+
+			struct stat file_status;
+			if(fstat(file_descriptor, &file_status) != 0 ||
+			   file_status.st_size < (off_t)(sizeof(BinaryCacheHeader)))
+			{
+				close(file_descriptor);
+				return false;
+			}
+
+			void* p_mapped = mmap(NULL, (size_t)(file_status.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+			close(file_descriptor);	// the mapping stays valid
+			if(p_mapped == MAP_FAILED)
+				return false;
+
+			mp_data = (const char*)(p_mapped);
+			m_size  = (size_t)(file_status.st_size);
+#else
+			ifstream input_file(filename.c_str(), ios::in | ios::binary);
+			if(!input_file.is_open())
+				return false;
+
+			input_file.seekg(0, ios::end);
+			streamoff length = input_file.tellg();
+			input_file.seekg(0, ios::beg);
+			if(length < (streamoff)(sizeof(BinaryCacheHeader)))
+				return false;
+
+			// a vector of doubles keeps the contents 8-byte aligned
+			mv_buffer.resize(((size_t)(length) + sizeof(double) - 1) / sizeof(double));
+			if(!input_file.read((char*)(&mv_buffer[0]), length))
+				return false;
+
+			mp_data = (const char*)(&mv_buffer[0]);
+			m_size  = (size_t)(length);
+#endif
+			return true;
+		}
+
+		const char* getData () const
+		{	return mp_data;	}
+
+		size_t getSize () const
+		{	return m_size;	}
+
+	private:
+		BinaryCacheFile (const BinaryCacheFile& original);
+		BinaryCacheFile& operator= (const BinaryCacheFile& original);
+
+	private:
+		const char* mp_data;
+		size_t m_size;
+#ifdef _WIN32
+		vector<double> mv_buffer;
+#endif
+	};
+
+	//
+	//  BinaryCacheReader
+	//
+	//  A class to read the sections of a binary cache file in
+	//    order.  Every read is checked against the end of the
+	//    file, so a truncated or damaged file is rejected
+	//    instead of crashing the program.
+	//
+
+	class BinaryCacheReader
+	{
+	public:
+		BinaryCacheReader (const char* p_data, size_t size)
+				: mp_start(p_data),
+				  mp_next(p_data),
+				  mp_end(p_data + size)
+		{ }
+
+		bool isAtEnd () const
+		{	return mp_next == mp_end;	}
+
+		template <typename T>
+		const T* readArray (size_t count)
+		{
+			if(count > (size_t)(mp_end - mp_next) / sizeof(T))
+				return NULL;
+
+			const T* p_array = (const T*)(mp_next);
+			mp_next += count * sizeof(T);
+			return p_array;
+		}
+
+		template <typename T>
+		bool read (T& r_value)
+		{
+			const T* p_value = readArray<T>(1);
+			if(p_value == NULL)
+				return false;
+			memcpy(&r_value, p_value, sizeof(T));
+			return true;
+		}
+
+		bool readString (string& r_string)
+		{
+			unsigned int length;
+			if(!read(length))
+				return false;
+			const char* a_characters = readArray<char>(length);
+			if(a_characters == NULL)
+				return false;
+			r_string.assign(a_characters, length);
+			return true;
+		}
+
+		bool alignTo8 ()
+		{
+			size_t offset = (size_t)(mp_next - mp_start);
+			size_t padding = (8 - offset % 8) % 8;
+			return readArray<char>(padding) != NULL;
+		}
+
+	private:
+		const char* mp_start;
+		const char* mp_next;
+		const char* mp_end;
+	};
+
+	//
+	//  BinaryCacheWriter
+	//
+	//  A class to build the contents of a binary cache file in
+	//    memory.
+	//
+
+	class BinaryCacheWriter
+	{
+	public:
+		const string& getBuffer () const
+		{	return m_buffer;	}
+
+		void appendBytes (const void* p_bytes, size_t size)
+		{
+			if(size > 0)
+				m_buffer.append((const char*)(p_bytes), size);
+		}
+
+		template <typename T>
+		void append (const T& value)
+		{	appendBytes(&value, sizeof(T));	}
+
+		void appendString (const string& str)
+		{
+			append((unsigned int)(str.size()));
+			appendBytes(str.data(), str.size());
+		}
+
+		void alignTo8 ()
+		{
+			while(m_buffer.size() % 8 != 0)
+				m_buffer.push_back('\0');
+		}
+
+	private:
+		string m_buffer;
+	};
 }
+#endif
 
 
 
@@ -1444,6 +1766,77 @@ DisplayList ObjModel :: getDisplayListMaterialNone () const
 	return list;
 }
 
+VertexBuffer ObjModel :: getVertexBuffer () const
+{
+	assert(isValid());
+	assert(!Material::isMaterialActive());
+
+	// only load the textures used by this model, as in getDisplayList
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+		if(mv_meshes[i].mp_material != NULL)
+			mv_meshes[i].mp_material->loadDisplayTextures();
+
+	VertexBuffer buffer;
+	map<VertexBufferKey, unsigned int> vertex_map;
+	vector<unsigned int> v_face_indexes;
+
+	for(unsigned int s = 0; s < mv_meshes.size(); s++)
+	{
+		buffer.addRange(mv_meshes[s].mp_material);
+
+		for(unsigned int f = 0; f < mv_meshes[s].mv_faces.size(); f++)
+		{
+			const vector<FaceVertex>& v_vertexes = mv_meshes[s].mv_faces[f].mv_vertexes;
+
+			v_face_indexes.clear();
+			for(unsigned int v = 0; v < v_vertexes.size(); v++)
+			{
+				VertexBufferKey key;
+				key.m_vertex             = v_vertexes[v].m_vertex;
+				key.m_texture_coordinate = v_vertexes[v].m_texture_coordinate;
+				key.m_normal             = v_vertexes[v].m_normal;
+
+				map<VertexBufferKey, unsigned int>::iterator found = vertex_map.find(key);
+				if(found != vertex_map.end())
+				{
+					v_face_indexes.push_back(found->second);
+					continue;
+				}
+
+				Vector3 position = mv_vertexes[key.m_vertex];
+				Vector3 normal(0.0, 0.0, 1.0);
+				if(key.m_normal != NO_NORMAL)
+					normal = mv_normals[key.m_normal];
+
+				// flip texture coordinates to match draw()
+				Vector2 texture_coordinates(0.0, 0.0);
+				if(key.m_texture_coordinate != NO_TEXTURE_COORDINATES)
+				{
+					texture_coordinates.x =       mv_texture_coordinates[key.m_texture_coordinate].x;
+					texture_coordinates.y = 1.0 - mv_texture_coordinates[key.m_texture_coordinate].y;
+				}
+
+				unsigned int index = buffer.addVertex((float)(position.x), (float)(position.y), (float)(position.z),
+				                                      (float)(normal.x),   (float)(normal.y),   (float)(normal.z),
+				                                      (float)(texture_coordinates.x), (float)(texture_coordinates.y));
+				vertex_map[key] = index;
+				v_face_indexes.push_back(index);
+			}
+
+			// same triangles as drawing the face as a triangle fan
+			for(unsigned int v = 2; v < v_face_indexes.size(); v++)
+				buffer.addTriangle(v_face_indexes[0], v_face_indexes[v - 1], v_face_indexes[v]);
+		}
+	}
+
+	if(buffer.isEmpty())
+		buffer.addRange(NULL);	// no meshes, but still ready to draw
+	buffer.end();
+
+	assert(!Material::isMaterialActive());
+	return buffer;
+}
+
 void ObjModel ::  save (const string& filename) const
 {
 	assert(filename != "");
@@ -1743,6 +2136,16 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 
 	setFileNameWithPath(filename);
 
+#ifdef OBJ_LIBRARY_BINARY_CACHE
+	if(loadBinaryCache(filename, r_logstream))
+	{
+		validate();
+
+		assert(invariant());
+		return;
+	}
+#endif
+
 	input_file.open(filename.c_str(), ios::in);
 	if(!input_file.is_open())
 	{
@@ -1826,6 +2229,11 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 
 	validate();
 
+#ifdef OBJ_LIBRARY_BINARY_CACHE
+	if(isValid())
+		saveBinaryCache(filename);
+#endif
+
 	assert(invariant());
 }
 
@@ -3324,6 +3732,266 @@ void ObjModel :: removeLastFace (unsigned int mesh)
 	m_valid = false;
 }
 
+bool ObjModel :: loadBinaryCache (const string& filename, ostream& r_logstream)
+{
+	assert(filename != "");
+
+#ifdef OBJ_LIBRARY_BINARY_CACHE
+	long long source_time;
+	long long source_size;
+	if(!getSourceStamp(filename, source_time, source_size))
+		return false;
+
+	BinaryCacheFile cache_file;
+	if(!cache_file.open(filename + OBJ_LIBRARY_BINARY_CACHE_EXTENSION))
+		return false;
+	BinaryCacheReader reader(cache_file.getData(), cache_file.getSize());
+
+	//
+	//  Check that the whole file is usable before changing
+	//    this ObjModel
+	//
+
+	BinaryCacheHeader header;
+	if(!reader.read(header))
+		return false;
+	if(header.m_magic              != BINARY_CACHE_MAGIC   ||
+	   header.m_version            != BINARY_CACHE_VERSION ||
+	   header.m_header_size        != sizeof(BinaryCacheHeader) ||
+	   header.m_layout             != BINARY_CACHE_LAYOUT  ||
+	   header.m_source_time        != source_time          ||
+	   header.m_source_size        != source_size          ||
+	   header.m_source_name_length != filename.size())
+	{
+		if(DEBUGGING)
+			cout << "Binary cache for \"" << filename << "\" is out of date" << endl;
+		return false;
+	}
+
+	const char* a_source_name = reader.readArray<char>(header.m_source_name_length);
+	if(a_source_name == NULL || filename.compare(0, string::npos, a_source_name, header.m_source_name_length) != 0)
+		return false;
+	if(!reader.alignTo8())
+		return false;
+
+	vector<string> v_library_names(header.m_material_library_count);
+	for(unsigned int i = 0; i < header.m_material_library_count; i++)
+		if(!reader.readString(v_library_names[i]) || v_library_names[i] == "")
+			return false;
+	vector<string> v_material_names(header.m_mesh_count);
+	for(unsigned int i = 0; i < header.m_mesh_count; i++)
+		if(!reader.readString(v_material_names[i]))
+			return false;
+	if(!reader.alignTo8())
+		return false;
+
+	const Vector3* a_vertexes            = reader.readArray<Vector3>(header.m_vertex_count);
+	const Vector2* a_texture_coordinates = reader.readArray<Vector2>(header.m_texture_coordinate_count);
+	const Vector3* a_normals             = reader.readArray<Vector3>(header.m_normal_count);
+	if(a_vertexes == NULL || a_texture_coordinates == NULL || a_normals == NULL)
+		return false;
+
+	const unsigned int* a_point_set_sizes = reader.readArray<unsigned int>(header.m_point_set_count);
+	if(a_point_set_sizes == NULL)
+		return false;
+	size_t point_set_vertex_count = 0;
+	for(unsigned int p = 0; p < header.m_point_set_count; p++)
+		point_set_vertex_count += a_point_set_sizes[p];
+	const unsigned int* a_point_set_vertexes = reader.readArray<unsigned int>(point_set_vertex_count);
+
+	const unsigned int* a_polyline_sizes = reader.readArray<unsigned int>(header.m_polyline_count);
+	if(a_point_set_vertexes == NULL || a_polyline_sizes == NULL)
+		return false;
+	size_t polyline_vertex_count = 0;
+	for(unsigned int l = 0; l < header.m_polyline_count; l++)
+		polyline_vertex_count += a_polyline_sizes[l];
+	const unsigned int* a_polyline_vertexes = reader.readArray<unsigned int>(polyline_vertex_count * 2);
+
+	const unsigned int* a_mesh_sizes = reader.readArray<unsigned int>(header.m_mesh_count);
+	const unsigned int* a_face_sizes = reader.readArray<unsigned int>(header.m_face_count);
+	const unsigned int* a_face_vertexes = reader.readArray<unsigned int>((size_t)(header.m_face_vertex_count) * 3);
+	if(a_polyline_vertexes == NULL || a_mesh_sizes == NULL || a_face_sizes == NULL || a_face_vertexes == NULL)
+		return false;
+	if(!reader.isAtEnd())
+		return false;
+
+	size_t face_count = 0;
+	for(unsigned int s = 0; s < header.m_mesh_count; s++)
+		face_count += a_mesh_sizes[s];
+	size_t face_vertex_count = 0;
+	for(unsigned int f = 0; f < header.m_face_count; f++)
+		face_vertex_count += a_face_sizes[f];
+	if(face_count != header.m_face_count || face_vertex_count != header.m_face_vertex_count)
+		return false;
+
+	//
+	//  Copy the contents into this ObjModel
+	//
+
+	if(DEBUGGING)
+		cout << "Loading \"" << filename << "\" from binary cache" << endl;
+
+	for(unsigned int i = 0; i < header.m_material_library_count; i++)
+		addMaterialLibrary(v_library_names[i], r_logstream);
+
+	mv_vertexes           .assign(a_vertexes,            a_vertexes            + header.m_vertex_count);
+	mv_texture_coordinates.assign(a_texture_coordinates, a_texture_coordinates + header.m_texture_coordinate_count);
+	mv_normals            .assign(a_normals,             a_normals             + header.m_normal_count);
+
+	mv_point_sets.resize(header.m_point_set_count);
+	for(unsigned int p = 0; p < header.m_point_set_count; p++)
+	{
+		mv_point_sets[p].mv_vertexes.assign(a_point_set_vertexes, a_point_set_vertexes + a_point_set_sizes[p]);
+		a_point_set_vertexes += a_point_set_sizes[p];
+	}
+
+	mv_polylines.resize(header.m_polyline_count);
+	for(unsigned int l = 0; l < header.m_polyline_count; l++)
+	{
+		vector<PolylineVertex>& rv_vertexes = mv_polylines[l].mv_vertexes;
+		rv_vertexes.resize(a_polyline_sizes[l]);
+		for(unsigned int v = 0; v < a_polyline_sizes[l]; v++)
+		{
+			rv_vertexes[v].m_vertex             = a_polyline_vertexes[0];
+			rv_vertexes[v].m_texture_coordinate = a_polyline_vertexes[1];
+			a_polyline_vertexes += 2;
+		}
+	}
+
+	for(unsigned int s = 0; s < header.m_mesh_count; s++)
+	{
+		unsigned int mesh_index = addMesh();
+		if(v_material_names[s] != "")
+			setMeshMaterial(mesh_index, v_material_names[s]);
+
+		vector<Face>& rv_faces = mv_meshes[mesh_index].mv_faces;
+		rv_faces.resize(a_mesh_sizes[s]);
+		for(unsigned int f = 0; f < a_mesh_sizes[s]; f++)
+		{
+			vector<FaceVertex>& rv_vertexes = rv_faces[f].mv_vertexes;
+			rv_vertexes.resize(*a_face_sizes);
+			for(unsigned int v = 0; v < *a_face_sizes; v++)
+			{
+				rv_vertexes[v].m_vertex             = a_face_vertexes[0];
+				rv_vertexes[v].m_texture_coordinate = a_face_vertexes[1];
+				rv_vertexes[v].m_normal             = a_face_vertexes[2];
+				a_face_vertexes += 3;
+			}
+			a_face_sizes++;
+		}
+	}
+
+	assert(invariant());
+	return true;
+#else
+	return false;
+#endif
+}
+
+void ObjModel :: saveBinaryCache (const string& filename) const
+{
+	assert(filename != "");
+
+#ifdef OBJ_LIBRARY_BINARY_CACHE
+	BinaryCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	if(!getSourceStamp(filename, header.m_source_time, header.m_source_size))
+		return;
+
+	header.m_magic                    = BINARY_CACHE_MAGIC;
+	header.m_version                  = BINARY_CACHE_VERSION;
+	header.m_header_size              = sizeof(BinaryCacheHeader);
+	header.m_layout                   = BINARY_CACHE_LAYOUT;
+	header.m_source_name_length       = (unsigned int)(filename.size());
+	header.m_material_library_count   = (unsigned int)(mv_material_libraries.size());
+	header.m_vertex_count             = (unsigned int)(mv_vertexes.size());
+	header.m_texture_coordinate_count = (unsigned int)(mv_texture_coordinates.size());
+	header.m_normal_count             = (unsigned int)(mv_normals.size());
+	header.m_point_set_count          = (unsigned int)(mv_point_sets.size());
+	header.m_polyline_count           = (unsigned int)(mv_polylines.size());
+	header.m_mesh_count               = (unsigned int)(mv_meshes.size());
+	header.m_face_count               = getFaceCountTotal();
+	header.m_face_vertex_count        = 0;
+	for(unsigned int s = 0; s < mv_meshes.size(); s++)
+		for(unsigned int f = 0; f < mv_meshes[s].mv_faces.size(); f++)
+			header.m_face_vertex_count += (unsigned int)(mv_meshes[s].mv_faces[f].mv_vertexes.size());
+
+	BinaryCacheWriter writer;
+	writer.append(header);
+	writer.appendBytes(filename.data(), filename.size());
+	writer.alignTo8();
+
+	for(unsigned int i = 0; i < mv_material_libraries.size(); i++)
+		writer.appendString(mv_material_libraries[i].m_name);
+	for(unsigned int s = 0; s < mv_meshes.size(); s++)
+		writer.appendString(mv_meshes[s].m_material_name);
+	writer.alignTo8();
+
+	if(!mv_vertexes.empty())
+		writer.appendBytes(&(mv_vertexes[0]), mv_vertexes.size() * sizeof(Vector3));
+	if(!mv_texture_coordinates.empty())
+		writer.appendBytes(&(mv_texture_coordinates[0]), mv_texture_coordinates.size() * sizeof(Vector2));
+	if(!mv_normals.empty())
+		writer.appendBytes(&(mv_normals[0]), mv_normals.size() * sizeof(Vector3));
+
+	for(unsigned int p = 0; p < mv_point_sets.size(); p++)
+		writer.append((unsigned int)(mv_point_sets[p].mv_vertexes.size()));
+	for(unsigned int p = 0; p < mv_point_sets.size(); p++)
+		for(unsigned int v = 0; v < mv_point_sets[p].mv_vertexes.size(); v++)
+			writer.append(mv_point_sets[p].mv_vertexes[v]);
+
+	for(unsigned int l = 0; l < mv_polylines.size(); l++)
+		writer.append((unsigned int)(mv_polylines[l].mv_vertexes.size()));
+	for(unsigned int l = 0; l < mv_polylines.size(); l++)
+		for(unsigned int v = 0; v < mv_polylines[l].mv_vertexes.size(); v++)
+		{
+			writer.append(mv_polylines[l].mv_vertexes[v].m_vertex);
+			writer.append(mv_polylines[l].mv_vertexes[v].m_texture_coordinate);
+		}
+
+	for(unsigned int s = 0; s < mv_meshes.size(); s++)
+		writer.append((unsigned int)(mv_meshes[s].mv_faces.size()));
+	for(unsigned int s = 0; s < mv_meshes.size(); s++)
+		for(unsigned int f = 0; f < mv_meshes[s].mv_faces.size(); f++)
+			writer.append((unsigned int)(mv_meshes[s].mv_faces[f].mv_vertexes.size()));
+	for(unsigned int s = 0; s < mv_meshes.size(); s++)
+		for(unsigned int f = 0; f < mv_meshes[s].mv_faces.size(); f++)
+			for(unsigned int v = 0; v < mv_meshes[s].mv_faces[f].mv_vertexes.size(); v++)
+			{
+				const FaceVertex& face_vertex = mv_meshes[s].mv_faces[f].mv_vertexes[v];
+				writer.append(face_vertex.m_vertex);
+				writer.append(face_vertex.m_texture_coordinate);
+				writer.append(face_vertex.m_normal);
+			}
+
+	//
+	//  Write to a temporary file and then rename it, so that
+	//    another program loading the same model never sees a
+	//    partly-written cache file
+	//
+
+	string cache_filename = filename + OBJ_LIBRARY_BINARY_CACHE_EXTENSION;
+	string temporary_filename = cache_filename + ".tmp";
+
+	ofstream output_file(temporary_filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if(!output_file.is_open())
+		return;	// read-only folder, so don't cache
+	output_file.write(writer.getBuffer().data(), writer.getBuffer().size());
+	output_file.close();
+	if(!output_file)
+	{
+		remove(temporary_filename.c_str());
+		return;
+	}
+
+	remove(cache_filename.c_str());	// needed on Windows
+	if(rename(temporary_filename.c_str(), cache_filename.c_str()) != 0)
+		remove(temporary_filename.c_str());
+	else if(DEBUGGING)
+		cout << "Wrote binary cache \"" << cache_filename << "\"" << endl;
+#endif
+}
+
 bool ObjModel :: invariant () const
 {
 	if(m_file_name == "") return false;
@@ -34,6 +34,7 @@
 class DisplayList;
 class Material;
 class MtlLibrary;
+class VertexBuffer;
 
 
 
@@ -1577,6 +1578,33 @@ public:
 
 	DisplayList getDisplayListMaterialNone () const;
 
+//
+//  getVertexBuffer
+//
+//  Purpose: To generate a VertexBuffer for this ObjModel.  This
+//           can be used instead of getDisplayList.  The faces
+//           of each mesh become one range in the VertexBuffer,
+//           drawn with the material for that mesh.  Faces with
+//           more than 3 vertices are split into triangle fans.
+//           Point sets and polylines are not included.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//    <2> !Material::isMaterialActive()
+//  Returns: A VertexBuffer for the faces of this ObjModel.
+//           Face vertices that share the same vertex, texture
+//           coordinates, and normal share a vertex in the
+//           VertexBuffer.  Face vertices without a normal use
+//           (0, 0, 1) and those without texture coordinates use
+//           (0, 0), which are the OpenGL defaults.  The
+//           VertexBuffer is always ready to draw, even if this
+//           ObjModel has no faces.
+//  Side Effect: The textures used by the materials for this
+//               ObjModel are loaded.
+//
+
+	VertexBuffer getVertexBuffer () const;
+
 //
 //  save
 //
@@ -1648,7 +1676,10 @@ public:
 //               logging stream is specified, any loading errors
 //               are written to that file or stream.  Otherwise,
 //               any loading errors are written to the standard
-//               error stream.
+//               error stream.  If the binary cache is enabled
+//               in ObjSettings.h, the model is read from an
+//               up-to-date binary cache file if there is one,
+//               and a cache file is written otherwise.
 //
 
 	void load (const std::string& filename);
@@ -2922,6 +2953,47 @@ private:
 
 	void removeLastFace (unsigned int mesh);
 
+//
+//  loadBinaryCache
+//
+//  Purpose: To replace this ObjModel with the model stored in
+//           the binary cache file for the specified OBJ file.
+//  Parameter(s):
+//    <1> filename: The name of the OBJ file
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the model was loaded from the cache file.
+//           If there is no cache file for file filename, or it
+//           is out of date or damaged, false is returned.
+//  Side Effect: If true is returned, the model in the cache
+//               file is added to this ObjModel, and its
+//               material libraries are loaded.  Otherwise,
+//               there is no effect.  This function should only
+//               be called on an empty ObjModel.
+//
+
+	bool loadBinaryCache (const std::string& filename,
+	                      std::ostream& r_logstream);
+
+//
+//  saveBinaryCache
+//
+//  Purpose: To write this ObjModel to the binary cache file for
+//           the specified OBJ file.
+//  Parameter(s):
+//    <1> filename: The name of the OBJ file this ObjModel was
+//                  loaded from
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: N/A
+//  Side Effect: The cache file for file filename is replaced
+//               with this ObjModel.  If the cache file cannot
+//               be written, there is no effect.
+//
+
+	void saveBinaryCache (const std::string& filename) const;
+
 //
 //  invariant
 //
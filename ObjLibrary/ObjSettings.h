@@ -110,6 +110,30 @@
 
 
 
+//
+//  Parsing a large OBJ file as text is slow.  To speed up
+//    loading, the ObjLibrary can keep a binary copy of each
+//    model it loads.  The copy is stored beside the OBJ file
+//    with OBJ_LIBRARY_BINARY_CACHE_EXTENSION appended to the
+//    file name (e.g. "models/barrel.obj.cache").  It is written
+//    the first time the model is loaded and read directly
+//    (memory-mapped where possible) on later loads.
+//
+//  The binary copy records the name, modification time, and
+//    size of the OBJ file it was made from.  If any of these
+//    change, or the cache file was written by a different
+//    version of the library or for a different kind of
+//    computer, it is ignored and replaced.  Material libraries
+//    are still loaded from their MTL files.
+//
+//  To enable the binary cache, define the macro
+//    OBJ_LIBRARY_BINARY_CACHE.
+//
+#define OBJ_LIBRARY_BINARY_CACHE
+#define OBJ_LIBRARY_BINARY_CACHE_EXTENSION ".cache"
+
+
+
 
 
 #endif
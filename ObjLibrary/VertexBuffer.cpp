@@ -0,0 +1,382 @@
+//
+//  VertexBuffer.cpp
+//
+//  This file is part of the ../../ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2015.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.  If you are in a position of
+//    authority, you may forbid others ffrom using them in areas
+//    that fall under your authority.  For example, a professor
+//    could forbid students from using them for a class project,
+//    or an employer could forbid employees using for a company
+//    project.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ../../ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <string>	// for NULL
+#include <vector>
+
+//
+//  The buffer object functions are part of OpenGL 1.5.  The
+//    Windows headers only declare OpenGL 1.1, so we fall back
+//    to vertex arrays there.
+//
+#ifdef _WIN32
+#define OBJ_LIBRARY_NO_BUFFER_OBJECTS
+#else
+#define GL_GLEXT_PROTOTYPES
+#endif
+
+#include "GetGlut.h"
+#include "Material.h"
+#include "VertexBuffer.h"
+
+using namespace std;
+namespace
+{
+	//
+	//  The layout of each vertex: 3 floats for the position,
+	//    then 3 for the normal, then 2 for the texture
+	//    coordinates.
+	//
+
+	const unsigned int FLOATS_PER_VERTEX = 8;
+	const unsigned int NORMAL_OFFSET     = 3;
+	const unsigned int TEXTURE_OFFSET    = 6;
+	const int VERTEX_STRIDE = FLOATS_PER_VERTEX * sizeof(float);
+}
+
+
+
+const unsigned int VertexBuffer :: EMPTY   = 0;
+const unsigned int VertexBuffer :: PARTIAL = 1;
+const unsigned int VertexBuffer :: READY   = 2;
+
+
+
+VertexBuffer :: VertexBuffer ()
+{
+	mp_data = NULL;
+}
+
+VertexBuffer :: VertexBuffer (const VertexBuffer& original)
+{
+	assert(!original.isPartial());
+
+	mp_data = NULL;
+	copy(original);
+}
+
+VertexBuffer :: ~VertexBuffer ()
+{
+	makeEmpty();
+}
+
+VertexBuffer& VertexBuffer :: operator= (const VertexBuffer& original)
+{
+	assert(!original.isPartial());
+
+	if(&original != this)
+	{
+		makeEmpty();
+		copy(original);
+	}
+
+	return *this;
+}
+
+
+
+unsigned int VertexBuffer :: getState () const
+{
+	if(mp_data == NULL)
+		return EMPTY;
+	else if(mp_data->m_usages == 0)
+		return PARTIAL;
+	else
+		return READY;
+}
+
+bool VertexBuffer :: isEmpty () const
+{
+	return (mp_data == NULL);
+}
+
+bool VertexBuffer :: isPartial () const
+{
+	return (mp_data != NULL && mp_data->m_usages == 0);
+}
+
+bool VertexBuffer :: isReady () const
+{
+	return (mp_data != NULL && mp_data->m_usages > 0);
+}
+
+unsigned int VertexBuffer :: getVertexCount () const
+{
+	if(mp_data == NULL)
+		return 0;
+	else if(isPartial())
+		return mp_data->mv_vertex_data.size() / FLOATS_PER_VERTEX;
+	else
+		return mp_data->m_vertex_count;
+}
+
+unsigned int VertexBuffer :: getTriangleCount () const
+{
+	if(mp_data == NULL)
+		return 0;
+	else if(isPartial())
+		return mp_data->mv_indexes.size() / 3;
+	else
+		return mp_data->m_index_count / 3;
+}
+
+unsigned int VertexBuffer :: getRangeCount () const
+{
+	if(mp_data == NULL)
+		return 0;
+	else
+		return mp_data->mv_ranges.size();
+}
+
+void VertexBuffer :: draw () const
+{
+	assert(isReady());
+	assert(!Material::isMaterialActive());
+
+	drawRanges(true);
+
+	assert(!Material::isMaterialActive());
+}
+
+void VertexBuffer :: drawMaterialNone () const
+{
+	assert(isReady());
+
+	drawRanges(false);
+}
+
+
+
+void VertexBuffer :: makeEmpty ()
+{
+	switch(getState())
+	{
+	case PARTIAL:
+		delete mp_data;
+		mp_data = NULL;
+		break;
+	case READY:
+		assert(mp_data->m_usages > 0);
+		mp_data->m_usages--;
+		if(mp_data->m_usages == 0)
+		{
+#ifndef OBJ_LIBRARY_NO_BUFFER_OBJECTS
+			glDeleteBuffers(1, &(mp_data->m_vertex_buffer_id));
+			glDeleteBuffers(1, &(mp_data->m_index_buffer_id));
+#endif
+			delete mp_data;
+		}
+		mp_data = NULL;
+		break;
+	}
+
+	assert(isEmpty());
+}
+
+unsigned int VertexBuffer :: addVertex (float x,  float y,  float z,
+                                        float nx, float ny, float nz,
+                                        float u,  float v)
+{
+	startSpecifying();
+	assert(isPartial());
+
+	unsigned int index = getVertexCount();
+
+	vector<float>& rv_vertex_data = mp_data->mv_vertex_data;
+	rv_vertex_data.push_back(x);
+	rv_vertex_data.push_back(y);
+	rv_vertex_data.push_back(z);
+	rv_vertex_data.push_back(nx);
+	rv_vertex_data.push_back(ny);
+	rv_vertex_data.push_back(nz);
+	rv_vertex_data.push_back(u);
+	rv_vertex_data.push_back(v);
+
+	return index;
+}
+
+void VertexBuffer :: addRange (const Material* p_material)
+{
+	startSpecifying();
+	assert(isPartial());
+
+	Range range;
+	range.mp_material   = p_material;
+	range.m_first_index = mp_data->mv_indexes.size();
+	range.m_index_count = 0;
+	mp_data->mv_ranges.push_back(range);
+}
+
+void VertexBuffer :: addTriangle (unsigned int vertex0,
+                                  unsigned int vertex1,
+                                  unsigned int vertex2)
+{
+	assert(isPartial());
+	assert(getRangeCount() > 0);
+	assert(vertex0 < getVertexCount());
+	assert(vertex1 < getVertexCount());
+	assert(vertex2 < getVertexCount());
+
+	mp_data->mv_indexes.push_back(vertex0);
+	mp_data->mv_indexes.push_back(vertex1);
+	mp_data->mv_indexes.push_back(vertex2);
+	mp_data->mv_ranges.back().m_index_count += 3;
+}
+
+void VertexBuffer :: end ()
+{
+	assert(isPartial());
+
+	mp_data->m_vertex_count = mp_data->mv_vertex_data.size() / FLOATS_PER_VERTEX;
+	mp_data->m_index_count  = mp_data->mv_indexes.size();
+
+#ifndef OBJ_LIBRARY_NO_BUFFER_OBJECTS
+	glGenBuffers(1, &(mp_data->m_vertex_buffer_id));
+	glBindBuffer(GL_ARRAY_BUFFER, mp_data->m_vertex_buffer_id);
+	if(!mp_data->mv_vertex_data.empty())
+	{
+		glBufferData(GL_ARRAY_BUFFER,
+		             mp_data->mv_vertex_data.size() * sizeof(float),
+		             &(mp_data->mv_vertex_data[0]),
+		             GL_STATIC_DRAW);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glGenBuffers(1, &(mp_data->m_index_buffer_id));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mp_data->m_index_buffer_id);
+	if(!mp_data->mv_indexes.empty())
+	{
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+		             mp_data->mv_indexes.size() * sizeof(unsigned int),
+		             &(mp_data->mv_indexes[0]),
+		             GL_STATIC_DRAW);
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	// the data is in video memory now, so free the copies
+	vector<float>().swap(mp_data->mv_vertex_data);
+	vector<unsigned int>().swap(mp_data->mv_indexes);
+#endif
+
+	assert(mp_data->m_usages == 0);
+	mp_data->m_usages = 1;
+
+	assert(isReady());
+}
+
+
+
+void VertexBuffer :: copy (const VertexBuffer& original)
+{
+	assert(isEmpty());
+	assert(!original.isPartial());
+
+	mp_data = original.mp_data;
+
+	if(mp_data != NULL)
+		mp_data->m_usages++;
+}
+
+void VertexBuffer :: startSpecifying ()
+{
+	if(isReady())
+		makeEmpty();
+
+	if(isEmpty())
+	{
+		mp_data = new InnerData();
+		mp_data->m_vertex_buffer_id = 0;
+		mp_data->m_index_buffer_id  = 0;
+		mp_data->m_vertex_count     = 0;
+		mp_data->m_index_count      = 0;
+		mp_data->m_usages           = 0;
+	}
+
+	assert(isPartial());
+}
+
+void VertexBuffer :: drawRanges (bool is_materials) const
+{
+	assert(isReady());
+
+	if(mp_data->m_index_count == 0)
+		return;
+
+	//
+	//  With buffer objects, the "pointers" are offsets into
+	//    the bound buffers
+	//
+
+#ifndef OBJ_LIBRARY_NO_BUFFER_OBJECTS
+	glBindBuffer(GL_ARRAY_BUFFER,         mp_data->m_vertex_buffer_id);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mp_data->m_index_buffer_id);
+	const float*        p_vertex_data = NULL;
+	const unsigned int* p_indexes     = NULL;
+#else
+	const float*        p_vertex_data = &(mp_data->mv_vertex_data[0]);
+	const unsigned int* p_indexes     = &(mp_data->mv_indexes[0]);
+#endif
+
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_NORMAL_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer  (3, GL_FLOAT, VERTEX_STRIDE, p_vertex_data);
+	glNormalPointer  (   GL_FLOAT, VERTEX_STRIDE, p_vertex_data + NORMAL_OFFSET);
+	glTexCoordPointer(2, GL_FLOAT, VERTEX_STRIDE, p_vertex_data + TEXTURE_OFFSET);
+
+	for(unsigned int r = 0; r < mp_data->mv_ranges.size(); r++)
+	{
+		const Range& range = mp_data->mv_ranges[r];
+		if(range.m_index_count == 0)
+			continue;
+
+		const unsigned int* p_range_indexes = p_indexes + range.m_first_index;
+
+		// same material handling as ObjModel::drawMeshMaterial
+		if(!is_materials || range.mp_material == NULL)
+			glDrawElements(GL_TRIANGLES, range.m_index_count, GL_UNSIGNED_INT, p_range_indexes);
+		else
+		{
+			range.mp_material->activate();
+			glDrawElements(GL_TRIANGLES, range.m_index_count, GL_UNSIGNED_INT, p_range_indexes);
+			Material::deactivate();
+
+			if(range.mp_material->isSeperateSpecular())
+			{
+				range.mp_material->activateSeperateSpecular();
+				glDrawElements(GL_TRIANGLES, range.m_index_count, GL_UNSIGNED_INT, p_range_indexes);
+				Material::deactivate();
+			}
+		}
+	}
+
+	glPopClientAttrib();
+
+#ifndef OBJ_LIBRARY_NO_BUFFER_OBJECTS
+	glBindBuffer(GL_ARRAY_BUFFER,         0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+#endif
+}
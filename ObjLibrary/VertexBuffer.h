@@ -0,0 +1,466 @@
+//
+//  VertexBuffer.h
+//
+//  A module to encapsulate the OpenGL vertex and index buffers
+//    for a model.
+//
+//  This file is part of the ../../ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2015.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.  If you are in a position of
+//    authority, you may forbid others ffrom using them in areas
+//    that fall under your authority.  For example, a professor
+//    could forbid students from using them for a class project,
+//    or an employer could forbid employees using for a company
+//    project.
+//
+//  If you are destributing the source files, you must not
+//    remove this notice.  If you are only destributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ../../ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef VERTEX_BUFFER_H
+#define VERTEX_BUFFER_H
+
+#include <vector>
+
+class Material;
+
+
+
+//
+//  VertexBuffer
+//
+//  A wrapper class to encapsulate the OpenGL buffers for a
+//    model made of triangles.  The vertices are stored in one
+//    vertex buffer object, interleaved as position, normal, and
+//    texture coordinates, and the triangles are stored in one
+//    index buffer object.  The triangles are divided into
+//    ranges, each of which is drawn with a single Material.
+//    The whole model is drawn with one glDrawElements call per
+//    range instead of one OpenGL call per vertex attribute.
+//
+//  A VertexBuffer is usually created with
+//    ObjModel::getVertexBuffer(), but it can also be filled in
+//    directly:
+//      <1> Create a VertexBuffer vb
+//      <2> Call vb.addVertex() for each vertex
+//      <3> For each range, call vb.addRange() and then call
+//          vb.addTriangle() for each triangle in it
+//      <4> Call vb.end() to copy the data to video memory
+//      <5> Call vb.draw() whenever you want to display it
+//
+//  Like a DisplayList, if a VertexBuffer is copied, the OpenGL
+//    buffers are not copied.  Instead, both VertexBuffers refer
+//    to the same buffers, which are not destroyed until the
+//    last reference is removed.
+//
+//  A VertexBuffer can be in one of three states, and this state
+//    can be determined with the getState() method.  The states
+//    are as follows:
+//      <1> EMPTY: No buffers have been created
+//      <2> PARTIAL: Vertices and triangles are being added
+//      <3> READY: The buffers are ready to be drawn
+//
+//  On platforms where the OpenGL 1.5 buffer functions are not
+//    available without an extension loader (i.e. Windows), the
+//    vertices and triangles are kept in system memory and drawn
+//    with vertex arrays instead.
+//
+
+class VertexBuffer
+{
+public:
+//
+//  EMPTY
+//  PARTIAL
+//  READY
+//
+//  These are the constants returned by the getState() method.
+//
+
+	static const unsigned int EMPTY;
+	static const unsigned int PARTIAL;
+	static const unsigned int READY;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new empty VertexBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new VertexBuffer is created and marked as
+//               empty.
+//
+
+	VertexBuffer ();
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create a new VertexBuffer as a copy of another.
+//  Parameter(s):
+//    <1> original: The VertexBuffer to copy
+//  Precondition(s):
+//    <1> !original.isPartial()
+//  Returns: N/A
+//  Side Effect: A new VertexBuffer is created.  If original is
+//               empty, this VertexBuffer is marked as empty.
+//               Otherwise, if original is ready, this
+//               VertexBuffer is set to refer to the same OpenGL
+//               buffers as original.
+//
+
+	VertexBuffer (const VertexBuffer& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this VertexBuffer without memory
+//           leaks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All dynamically allocated memory is freed.  If
+//               this VertexBuffer contains the last reference
+//               to its OpenGL buffers, they are destroyed.
+//
+
+	~VertexBuffer ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To modify this VertexBuffer to be a copy of
+//           another.
+//  Parameter(s):
+//    <1> original: The VertexBuffer to copy
+//  Precondition(s):
+//    <1> !original.isPartial()
+//  Returns: N/A
+//  Side Effect: If original is empty, this VertexBuffer is
+//               marked as empty.  Otherwise, if original is
+//               ready, this VertexBuffer is set to refer to the
+//               same OpenGL buffers as original.  If this
+//               VertexBuffer contained the last reference to
+//               its OpenGL buffers, they are destroyed.
+//
+
+	VertexBuffer& operator= (const VertexBuffer& original);
+
+//
+//  getState
+//
+//  Purpose: To determine the current state of this
+//           VertexBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: If this VertexBuffer is empty, VertexBuffer::EMPTY
+//           is returned.  If vertices and triangles are being
+//           added, VertexBuffer::PARTIAL is returned.
+//           Otherwise, if this VertexBuffer is ready to draw,
+//           VertexBuffer::READY is returned.
+//  Side Effect: N/A
+//
+
+	unsigned int getState () const;
+
+//
+//  isEmpty
+//  isPartial
+//  isReady
+//
+//  Purpose: To determine if this VertexBuffer is in the
+//           specified state.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this VertexBuffer is empty, being
+//           specified, or ready to draw, respectively.
+//  Side Effect: N/A
+//
+
+	bool isEmpty () const;
+	bool isPartial () const;
+	bool isReady () const;
+
+//
+//  getVertexCount
+//
+//  Purpose: To determine the number of vertices in this
+//           VertexBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of vertices.  If this VertexBuffer is
+//           empty, 0 is returned.
+//  Side Effect: N/A
+//
+
+	unsigned int getVertexCount () const;
+
+//
+//  getTriangleCount
+//
+//  Purpose: To determine the number of triangles in this
+//           VertexBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of triangles in all ranges.  If this
+//           VertexBuffer is empty, 0 is returned.
+//  Side Effect: N/A
+//
+
+	unsigned int getTriangleCount () const;
+
+//
+//  getRangeCount
+//
+//  Purpose: To determine the number of ranges in this
+//           VertexBuffer.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of ranges.  If this VertexBuffer is
+//           empty, 0 is returned.
+//  Side Effect: N/A
+//
+
+	unsigned int getRangeCount () const;
+
+//
+//  draw
+//
+//  Purpose: To display the contents of this VertexBuffer, with
+//           the Material for each range.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//    <2> !Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: The triangles in this VertexBuffer are
+//               displayed.  Each range is displayed with its
+//               Material, or with the current OpenGL state if
+//               it has none.
+//
+
+	void draw () const;
+
+//
+//  drawMaterialNone
+//
+//  Purpose: To display the contents of this VertexBuffer
+//           without any Materials.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//  Returns: N/A
+//  Side Effect: The triangles in this VertexBuffer are
+//               displayed with the current OpenGL state.
+//
+
+	void drawMaterialNone () const;
+
+//
+//  makeEmpty
+//
+//  Purpose: To mark this VertexBuffer as empty.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This VertexBuffer is marked as empty.  If this
+//               VertexBuffer contains the last reference to its
+//               OpenGL buffers, they are destroyed.
+//
+
+	void makeEmpty ();
+
+//
+//  addVertex
+//
+//  Purpose: To add a vertex to this VertexBuffer.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The position of the vertex
+//    <4> nx
+//    <5> ny
+//    <6> nz: The normal vector at the vertex
+//    <7> u
+//    <8> v: The texture coordinates at the vertex
+//  Precondition(s): N/A
+//  Returns: The index of the new vertex.
+//  Side Effect: If this VertexBuffer is ready, it is marked as
+//               empty first.  A vertex is added to this
+//               VertexBuffer, which is marked as being
+//               specified.
+//
+
+	unsigned int addVertex (float x,  float y,  float z,
+	                        float nx, float ny, float nz,
+	                        float u,  float v);
+
+//
+//  addRange
+//
+//  Purpose: To start a new range of triangles in this
+//           VertexBuffer.
+//  Parameter(s):
+//    <1> p_material: The Material to draw the range with, or
+//                    NULL for none
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If this VertexBuffer is ready, it is marked as
+//               empty first.  A new range is added to this
+//               VertexBuffer.  Triangles added after this are
+//               part of the new range.  This VertexBuffer is
+//               marked as being specified.
+//
+
+	void addRange (const Material* p_material);
+
+//
+//  addTriangle
+//
+//  Purpose: To add a triangle to the last range in this
+//           VertexBuffer.
+//  Parameter(s):
+//    <1> vertex0
+//    <2> vertex1
+//    <3> vertex2: The indexes of the corners of the triangle
+//  Precondition(s):
+//    <1> isPartial()
+//    <2> getRangeCount() > 0
+//    <3> vertex0 < getVertexCount()
+//    <4> vertex1 < getVertexCount()
+//    <5> vertex2 < getVertexCount()
+//  Returns: N/A
+//  Side Effect: A triangle with the specified corners is added
+//               to the last range in this VertexBuffer.
+//
+
+	void addTriangle (unsigned int vertex0,
+	                  unsigned int vertex1,
+	                  unsigned int vertex2);
+
+//
+//  end
+//
+//  Purpose: To finish specifying this VertexBuffer.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isPartial()
+//  Returns: N/A
+//  Side Effect: The vertices and triangles are copied into
+//               OpenGL buffers and this VertexBuffer is marked
+//               as ready.  The copies in system memory are
+//               freed where possible.
+//
+
+	void end ();
+
+private:
+//
+//  copy
+//
+//  Purpose: To copy the values of another VertexBuffer to this
+//           VertexBuffer.
+//  Parameter(s):
+//    <1> original: The VertexBuffer to copy
+//  Precondition(s):
+//    <1> isEmpty()
+//    <2> !original.isPartial()
+//  Returns: N/A
+//  Side Effect: If original is empty, this VertexBuffer is
+//               marked as empty.  Otherwise, this VertexBuffer
+//               is set to refer to the same OpenGL buffers as
+//               original.
+//
+
+	void copy (const VertexBuffer& original);
+
+//
+//  startSpecifying
+//
+//  Purpose: To prepare this VertexBuffer to have vertices and
+//           triangles added.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If this VertexBuffer is ready, it is marked as
+//               empty.  If it is empty, it is marked as being
+//               specified with no vertices or ranges.
+//
+
+	void startSpecifying ();
+
+//
+//  drawRanges
+//
+//  Purpose: To display the ranges in this VertexBuffer.
+//  Parameter(s):
+//    <1> is_materials: Whether to use the Material for each
+//                      range
+//  Precondition(s):
+//    <1> isReady()
+//  Returns: N/A
+//  Side Effect: The triangles in this VertexBuffer are
+//               displayed.
+//
+
+	void drawRanges (bool is_materials) const;
+
+private:
+	//
+	//  Range
+	//
+	//  A record to store a range of triangles that are drawn
+	//    with the same Material.  The range is stored as the
+	//    position of its first index in the index buffer and
+	//    the number of indexes.
+	//
+
+	struct Range
+	{
+		const Material* mp_material;
+		unsigned int m_first_index;
+		unsigned int m_index_count;
+	};
+
+	//
+	//  InnerData
+	//
+	//  A record to store the information about a set of
+	//    buffers.  The buffer ids, the ranges, and a usage
+	//    count are stored.  As in DisplayList, a special
+	//    value of 0 usages indicates that the buffers are
+	//    only partially specified.  The vertex and index data
+	//    are kept in system memory while they are being
+	//    specified, and afterwards if there are no buffer
+	//    objects.
+	//
+
+	struct InnerData
+	{
+		unsigned int m_vertex_buffer_id;
+		unsigned int m_index_buffer_id;
+		unsigned int m_vertex_count;
+		unsigned int m_index_count;
+		std::vector<Range> mv_ranges;
+		std::vector<float> mv_vertex_data;
+		std::vector<unsigned int> mv_indexes;
+		unsigned int m_usages;
+	};
+
+private:
+	InnerData* mp_data;
+};
+
+
+
+#endif
@@ -0,0 +1,313 @@
+//
+//  AiSchedulerTests.cpp
+//
+//  A program to check that the AiScheduler from cs409a5 skips
+//    sleeping AIs and wakes them at the right frame, and holds
+//    back AIs waiting for budget until it can run them.  Each
+//    check that fails is printed, and the program exits with
+//    status 1 if any did.
+//
+//  To build from this directory, enter as one command:
+//
+//    g++ -std=c++11 -O2 -o AiSchedulerTests
+//        AiSchedulerTests.cpp ../cs409a5/AiScheduler.cpp
+//
+
+#include <iostream>
+#include <vector>
+
+#include "../cs409a5/AiScheduler.h"
+
+using namespace std;
+
+namespace
+{
+    const unsigned int SLOT_COUNT = 8;
+    const long long FRAME_DURATION = 1000;
+
+    unsigned int g_failure_count = 0;
+
+    //
+    //  check
+    //
+    //  Purpose: To record the result of one check, printing it
+    //           if it failed.
+    //
+
+    void check (bool is_passed, const char* a_description)
+    {
+        if (!is_passed)
+        {
+            cout << "FAILED: " << a_description << endl;
+            g_failure_count++;
+        }
+    }
+
+    //
+    //  getRunSlots
+    //
+    //  Purpose: To list the slots that the scheduler will run in
+    //           the current frame.
+    //
+
+    vector<unsigned int> getRunSlots (const AiScheduler& scheduler)
+    {
+        vector<unsigned int> v_slots;
+        for (unsigned int i = 0; i < scheduler.getRunSlotCount(); i++)
+            v_slots.push_back(scheduler.getRunSlot(i));
+        return v_slots;
+    }
+
+    //
+    //  isRun
+    //
+    //  Purpose: To determine if the scheduler will run the
+    //           specified slot in the current frame.
+    //
+
+    bool isRun (const AiScheduler& scheduler, unsigned int slot)
+    {
+        for (unsigned int i = 0; i < scheduler.getRunSlotCount(); i++)
+            if (scheduler.getRunSlot(i) == slot)
+                return true;
+        return false;
+    }
+
+    //
+    //  runFrame
+    //
+    //  Purpose: To pretend to run every AI in the current frame
+    //           with the specified cost, and then end the frame
+    //           that started at the specified time.
+    //
+
+    void runFrame (AiScheduler& r_scheduler, long long frame_start, long long cost)
+    {
+        for (unsigned int i = 0; i < r_scheduler.getRunSlotCount(); i++)
+            r_scheduler.recordCost(r_scheduler.getRunSlot(i), cost);
+        r_scheduler.endFrame(0, frame_start + FRAME_DURATION);
+    }
+
+    void testNoSleeping ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+        for (unsigned int f = 0; f < 3; f++)
+        {
+            check(scheduler.getRunSlotCount() == SLOT_COUNT,
+                  "without sleeping or a budget, every slot runs");
+            runFrame(scheduler, f * FRAME_DURATION, 10);
+        }
+    }
+
+    void testWakeAtTime ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+
+        // slot 3 wakes at the start of frame 4, slot 5 in the
+        //  middle of frame 2, so at the start of frame 3
+        scheduler.setWakeTime(3, 4 * FRAME_DURATION);
+        scheduler.setWakeTime(5, 2 * FRAME_DURATION + FRAME_DURATION / 2);
+        check(isRun(scheduler, 3) && isRun(scheduler, 5),
+              "a slot that goes to sleep finishes the current frame");
+        runFrame(scheduler, 0, 10);
+
+        for (unsigned int f = 1; f < 6; f++)
+        {
+            check(scheduler.getPlannedSlotCount() == SLOT_COUNT,
+                  "sleeping slots stay in the window");
+            check(isRun(scheduler, 3) == (f >= 4),
+                  "slot 3 sleeps until the frame starting at its wake time");
+            check(isRun(scheduler, 5) == (f >= 3),
+                  "slot 5 sleeps until the first frame after its wake time");
+            check(scheduler.isSleeping(3) == !isRun(scheduler, 3),
+                  "isSleeping matches the slots that are skipped");
+            check(isRun(scheduler, 0),
+                  "slots that are awake keep running");
+            runFrame(scheduler, f * FRAME_DURATION, 10);
+        }
+    }
+
+    void testSleepAgain ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+
+        // slot 2 wakes, runs, and goes back to sleep
+        scheduler.setWakeTime(2, 1 * FRAME_DURATION);
+        runFrame(scheduler, 0, 10);
+        check(isRun(scheduler, 2), "slot 2 wakes in frame 1");
+        scheduler.setWakeTime(2, 3 * FRAME_DURATION);
+        runFrame(scheduler, 1 * FRAME_DURATION, 10);
+        check(!isRun(scheduler, 2), "slot 2 sleeps again in frame 2");
+        runFrame(scheduler, 2 * FRAME_DURATION, 10);
+        check(isRun(scheduler, 2), "slot 2 wakes again in frame 3");
+    }
+
+    void testWakeTimePassed ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+
+        scheduler.setWakeTime(6, 0);
+        runFrame(scheduler, 0, 10);
+        check(isRun(scheduler, 6),
+              "a slot with a wake time that has passed is not skipped");
+    }
+
+    void testBudget ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+        scheduler.setWaitFramesMax(SLOT_COUNT);
+
+        // every AI is measured, and slots 1 to 5 go to sleep
+        for (unsigned int s = 1; s <= 5; s++)
+            scheduler.setWakeTime(s, 100 * FRAME_DURATION);
+        runFrame(scheduler, 0, 100);
+
+        // the budget fits 2 AIs
+        scheduler.setBudget(250);
+
+        vector<unsigned int> v_slots = getRunSlots(scheduler);
+        check(v_slots.size() == 2,
+              "sleeping slots do not use up the budget");
+        check(v_slots.size() == 2 && v_slots[0] == 0 && v_slots[1] == 6,
+              "the window passes over sleeping slots");
+
+        // a replay sets the same window size, which must skip
+        //  the same slots
+        unsigned int planned = scheduler.getPlannedSlotCount();
+        scheduler.setPlannedSlotCount(planned);
+        check(getRunSlots(scheduler) == v_slots,
+              "setting the window size again skips the same slots");
+    }
+
+    void testInitWakes ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+        scheduler.setWakeTime(1, 100 * FRAME_DURATION);
+        runFrame(scheduler, 0, 10);
+        check(scheduler.isSleeping(1), "slot 1 is sleeping");
+
+        scheduler.init(SLOT_COUNT, 1);
+        check(!scheduler.isSleeping(1) && scheduler.getRunSlotCount() == SLOT_COUNT,
+              "init wakes every slot");
+        runFrame(scheduler, 1 * FRAME_DURATION, 10);
+        check(scheduler.getRunSlotCount() == SLOT_COUNT,
+              "init clears the wake list");
+    }
+
+    void testBudgetWaitUnlimited ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+
+        scheduler.setBudgetWaitEnd(4, 100 * FRAME_DURATION);
+        runFrame(scheduler, 0, 10);
+        check(scheduler.isWaitingForBudget(4),
+              "slot 4 is waiting for budget");
+        check(isRun(scheduler, 4),
+              "without a budget, a slot waiting for budget still runs");
+    }
+
+    void testBudgetWaitHeld ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+        scheduler.setWaitFramesMax(SLOT_COUNT);
+        runFrame(scheduler, 0, 100);
+
+        // slots 1 to 5 wait for budget until frame 10, and the
+        //  budget fits 2 AIs
+        for (unsigned int s = 1; s <= 5; s++)
+            scheduler.setBudgetWaitEnd(s, 10 * FRAME_DURATION);
+        runFrame(scheduler, 1 * FRAME_DURATION, 100);
+        scheduler.setBudget(250);
+
+        vector<unsigned int> v_slots = getRunSlots(scheduler);
+        check(v_slots.size() == 2 && v_slots[0] == 0 && v_slots[1] == 6,
+              "slots waiting for budget are skipped and cost nothing");
+        check(scheduler.getPlannedSlotCount() < SLOT_COUNT,
+              "a window that skips slots waiting for budget is not every slot");
+
+        unsigned int planned = scheduler.getPlannedSlotCount();
+        scheduler.setPlannedSlotCount(planned);
+        check(getRunSlots(scheduler) == v_slots,
+              "setting the window size again skips the same slots");
+
+        // a window that covers every slot runs them
+        scheduler.setPlannedSlotCount(SLOT_COUNT);
+        check(scheduler.getRunSlotCount() == SLOT_COUNT,
+              "a window over every slot runs the slots waiting for budget");
+
+        // once the wait ends, they run as usual
+        for (unsigned int f = 2; f <= 10; f++)
+            scheduler.endFrame(0, f * FRAME_DURATION);
+        check(!scheduler.isWaitingForBudget(3),
+              "a budget wait ends at its end time");
+        bool is_any_run = false;
+        for (unsigned int f = 10; f < 14; f++)
+        {
+            for (unsigned int s = 1; s <= 5; s++)
+                if (isRun(scheduler, s))
+                    is_any_run = true;
+            runFrame(scheduler, f * FRAME_DURATION, 100);
+        }
+        check(is_any_run,
+              "slots whose budget wait has ended run within the budget");
+    }
+
+    void testBudgetWaitAfterSleep ()
+    {
+        AiScheduler scheduler;
+        scheduler.init(SLOT_COUNT, 1);
+        scheduler.setWaitFramesMax(SLOT_COUNT);
+        runFrame(scheduler, 0, 100);
+        scheduler.setBudget(250);
+
+        // slot 2 sleeps until frame 3 and then waits for budget
+        //  until frame 20
+        scheduler.setPlannedSlotCount(SLOT_COUNT);
+        scheduler.setWakeTime(2, 3 * FRAME_DURATION);
+        scheduler.setBudgetWaitEnd(2, 20 * FRAME_DURATION);
+        runFrame(scheduler, 1 * FRAME_DURATION, 100);
+
+        bool is_run = false;
+        for (unsigned int f = 2; f < 20; f++)
+        {
+            if (isRun(scheduler, 2))
+                is_run = true;
+            runFrame(scheduler, f * FRAME_DURATION, 100);
+        }
+        check(!is_run,
+              "a slot that wakes into a budget wait is held back while the budget is short");
+        check(isRun(scheduler, 2) || !scheduler.isWaitingForBudget(2),
+              "the budget wait ends at its end time");
+    }
+}
+
+
+
+int main ()
+{
+    testNoSleeping();
+    testWakeAtTime();
+    testSleepAgain();
+    testWakeTimePassed();
+    testBudget();
+    testInitWakes();
+    testBudgetWaitUnlimited();
+    testBudgetWaitHeld();
+    testBudgetWaitAfterSleep();
+
+    if (g_failure_count > 0)
+    {
+        cout << g_failure_count << " checks failed" << endl;
+        return 1;
+    }
+    cout << "All AiScheduler checks passed" << endl;
+    return 0;
+}
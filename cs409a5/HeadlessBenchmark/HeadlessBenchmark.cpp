@@ -0,0 +1,488 @@
+//
+//  HeadlessBenchmark.cpp
+//
+//  A program to run the World from cs409a5 without a display.
+//    The World is initialized without OpenGL, stepped a fixed
+//    number of frames with a fixed frame duration, and the time
+//    taken by each phase of World::updateAll is reported as a
+//    JSON object on standard output.
+//
+//  Command line options:
+//    --frames N    Number of frames to simulate (default 600)
+//    --fps F       Simulated frames per second (default 60)
+//    --seed S      Random seed for the World (default 1)
+//    --per-frame   Also report the phase times for every frame
+//    --ai-budget M Limit the unit AIs to M milliseconds per
+//                  frame (default unlimited)
+//    --ring-volume Bake the ring density into a volume of
+//                  samples instead of calculating it exactly
+//    --record FILE Save the run as a replay file
+//    --replay FILE Play back a replay file instead of running
+//                  a fixed number of frames
+//    --lookups N   After the run, look up every ship, missile
+//                  and the planet by id N times and report the
+//                  average time per lookup
+//    --check-restore N
+//                  After N frames, copy the World into a second
+//                  World through a snapshot, and run both to the
+//                  end to check that they stay the same
+//
+//  Times in the output are in milliseconds.  The frames per
+//    second reported is for updateAll only, not for the fixed
+//    simulated frame rate.
+//
+//  A replay file records the World seed and the player input
+//    and frame times for every frame.  It can be recorded by
+//    this program or by running the game with
+//    --record FILE.  It must be played back with the same
+//    --ring-volume setting that it was recorded with.  When a
+//    replay is played back, the output includes whether the
+//    World ended up in exactly the state that was recorded,
+//    and the program exits with status 1 if it did not.  This
+//    makes it possible to run a slow game again under a
+//    profiler.
+//
+//  With --check-restore, the second World is created with the
+//    same seed and settings and restored from a snapshot of
+//    the first.  Snapshots cut short are read into it first,
+//    and must be rejected without changing it.  Then both
+//    Worlds are given the same input and run the same unit
+//    AIs each frame, and must end in exactly the same state.
+//    The output includes whether they did, and the program
+//    exits with status 1 if they did not.  Only the first
+//    World is timed.
+//
+//  To build from this directory, enter as one command:
+//
+//    g++ -std=c++11 -O2 -pthread -o HeadlessBenchmark
+//        HeadlessBenchmark.cpp
+//        $(ls ../cs409a5/*.cpp | grep -v Main4A.cpp)
+//        ../../ObjLibrary/*.cpp -lglut -lGLU -lGL
+//
+//  The OpenGL libraries are only needed to link; no OpenGL
+//    functions are called, so no display or GPU is required.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../ObjLibrary/DisplayList.h"
+#include "../cs409a5/TimeSystem.h"
+#include "../cs409a5/PlayerInput.h"
+#include "../cs409a5/World.h"
+#include "../cs409a5/Replay.h"
+
+using namespace std;
+
+namespace
+{
+    const unsigned int FRAME_COUNT_DEFAULT = 600;
+    const float FRAMES_PER_SECOND_DEFAULT = 60.0f;
+    const unsigned long long SEED_DEFAULT = 1;
+    
+    // replays can contain long frames from the game
+    const double REPLAY_FRAME_DURATION_MAX_MIN = 1.0;
+    
+    // how many snapshots cut short to try restoring from
+    const unsigned int RESTORE_CUT_COUNT = 16;
+    
+    const unsigned int PHASE_COUNT = 5;
+    const char* PHASE_NAMES[PHASE_COUNT] =
+    {
+        "ai", "movement", "collisions", "explosions", "total"
+    };
+    
+    //
+    //  PhaseStatistics
+    //
+    //  A record of the total and maximum time for a phase.
+    //
+    
+    struct PhaseStatistics
+    {
+        double m_total;
+        double m_max;
+    };
+    
+    void printUsage (const char* program)
+    {
+        cerr << "Usage: " << program
+             << " [--frames N] [--fps F] [--seed S] [--per-frame]"
+             << " [--ai-budget M] [--ring-volume] [--lookups N]"
+             << " [--check-restore N]"
+             << " [--record FILE | --replay FILE]" << endl;
+    }
+    
+    //
+    //  getSnapshot
+    //
+    //  Purpose: To take a snapshot of the specified World.
+    //  Parameter(s):
+    //    <1> world: The World
+    //    <2> is_ai_estimates_written: Whether to include the AI
+    //                                 cost estimates
+    //  Precondition(s):
+    //    <1> world.isInitialized()
+    //  Returns: The bytes of the snapshot.
+    //  Side Effect: N/A
+    //
+    
+    string getSnapshot (const World& world, bool is_ai_estimates_written)
+    {
+        ostringstream snapshot(ios::out | ios::binary);
+        world.writeSnapshot(snapshot, is_ai_estimates_written);
+        return snapshot.str();
+    }
+    
+    //
+    //  restoreSnapshot
+    //
+    //  Purpose: To set one World to the state of another through
+    //           a snapshot, checking that snapshots cut short are
+    //           rejected on the way.
+    //  Parameter(s):
+    //    <1> original: The World to copy
+    //    <2> r_copy: The World to set
+    //  Precondition(s):
+    //    <1> original.isInitialized()
+    //    <2> r_copy.isInitialized()
+    //  Returns: Whether every cut snapshot was rejected without
+    //           changing r_copy, and the whole snapshot was read
+    //           and gives back the same snapshot.
+    //  Side Effect: r_copy is set to the state of original.
+    //
+    
+    bool restoreSnapshot (const World& original, World& r_copy)
+    {
+        string snapshot = getSnapshot(original, true);
+        string before   = getSnapshot(r_copy,   true);
+        
+        bool is_matching = true;
+        for (unsigned int c = 0; c < RESTORE_CUT_COUNT; c++)
+        {
+            istringstream cut(snapshot.substr(0, snapshot.size() * c / RESTORE_CUT_COUNT),
+                              ios::in | ios::binary);
+            if (r_copy.readSnapshot(cut) || getSnapshot(r_copy, true) != before)
+                is_matching = false;
+        }
+        
+        istringstream whole(snapshot, ios::in | ios::binary);
+        if (!r_copy.readSnapshot(whole) || getSnapshot(r_copy, true) != snapshot)
+            is_matching = false;
+        return is_matching;
+    }
+    
+    //
+    //  measureObjectLookup
+    //
+    //  Purpose: To measure the average time to find a physics
+    //           object in the specified World from its id.
+    //  Parameter(s):
+    //    <1> world: The World to look objects up in
+    //    <2> round_count: The number of times to look up every
+    //                     object
+    //  Precondition(s):
+    //    <1> round_count > 0
+    //  Returns: The average time in nanoseconds for one lookup.
+    //  Side Effect: N/A
+    //
+    
+    double measureObjectLookup (const WorldInterface& world,
+                                unsigned int round_count)
+    {
+        vector<PhysicsObjectId> v_ids;
+        v_ids.push_back(world.getPlanetId());
+        for (unsigned int f = 0; f < world.getFleetCount(); f++)
+        {
+            if (f == PhysicsObjectId::FLEET_NATURE)
+                continue;
+            
+            PhysicsObjectId id_command = world.getFleetCommandShipId(f);
+            if (id_command != PhysicsObjectId::ID_NOTHING && world.isAlive(id_command))
+                v_ids.push_back(id_command);
+            vector<PhysicsObjectId> v_fighters = world.getFleetFighterIds(f);
+            v_ids.insert(v_ids.end(), v_fighters.begin(), v_fighters.end());
+            vector<PhysicsObjectId> v_missiles = world.getFleetMissileIds(f);
+            v_ids.insert(v_ids.end(), v_missiles.begin(), v_missiles.end());
+        }
+        
+        // sum the radii so the lookups cannot be optimized away
+        double sum = 0.0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned int r = 0; r < round_count; r++)
+            for (unsigned int i = 0; i < v_ids.size(); i++)
+                sum += world.getRadius(v_ids[i]);
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        if (sum < 0.0)
+            cerr << "Error: negative radius" << endl;
+        
+        double lookup_count = (double)(round_count) * v_ids.size();
+        return chrono::duration<double, nano>(end - start).count() / lookup_count;
+    }
+}
+
+
+
+int main (int argc, char* argv[])
+{
+    unsigned int frame_count = FRAME_COUNT_DEFAULT;
+    float frames_per_second = FRAMES_PER_SECOND_DEFAULT;
+    unsigned long long seed = SEED_DEFAULT;
+    bool is_per_frame = false;
+    double ai_budget_ms = 0.0;
+    bool is_ring_volume = false;
+    unsigned int lookup_round_count = 0;
+    bool is_restore_checked = false;
+    unsigned int restore_frame = 0;
+    string record_filename = "";
+    string replay_filename = "";
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frame_count = (unsigned int)(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+            frames_per_second = (float)(atof(argv[++i]));
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--per-frame") == 0)
+            is_per_frame = true;
+        else if (strcmp(argv[i], "--ai-budget") == 0 && i + 1 < argc)
+            ai_budget_ms = atof(argv[++i]);
+        else if (strcmp(argv[i], "--ring-volume") == 0)
+            is_ring_volume = true;
+        else if (strcmp(argv[i], "--lookups") == 0 && i + 1 < argc)
+            lookup_round_count = (unsigned int)(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--check-restore") == 0 && i + 1 < argc)
+        {
+            is_restore_checked = true;
+            restore_frame = (unsigned int)(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record_filename = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replay_filename = argv[++i];
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (frame_count == 0 || frames_per_second <= 0.0f || ai_budget_ms < 0.0 ||
+        (record_filename != "" && replay_filename != "") ||
+        (replay_filename == "" && is_restore_checked && restore_frame >= frame_count))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+    
+    Replay replay(seed);
+    bool is_replaying = (replay_filename != "");
+    if (is_replaying)
+    {
+        if (!replay.load(replay_filename) || replay.getFrameCount() == 0)
+            return 2;
+        seed = replay.getWorldSeed();
+        frame_count = replay.getFrameCount();
+        if (is_restore_checked && restore_frame >= frame_count)
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+        
+        // the frame times come from the replay, but the
+        //  TimeSystem must allow frames that long
+        double duration_max = REPLAY_FRAME_DURATION_MAX_MIN;
+        for (unsigned int f = 0; f < frame_count; f++)
+        {
+            double duration = TimeSystem::toSeconds(replay.getFrame(f).m_duration);
+            if (duration > duration_max)
+                duration_max = duration;
+        }
+        TimeSystem::init(0.5 / duration_max, frames_per_second, 1.0);
+    }
+    else
+        TimeSystem::init(frames_per_second, frames_per_second, 1.0f);
+    
+    World* p_world = new World();
+    p_world->setRandomSeed(seed);
+    chrono::steady_clock::time_point init_start = chrono::steady_clock::now();
+    p_world->initHeadless();
+    if (is_ring_volume)
+        p_world->setRingDensityVolumeEnabled(true);
+    chrono::steady_clock::time_point init_end = chrono::steady_clock::now();
+    if (ai_budget_ms > 0.0)
+        p_world->setAiBudget(ai_budget_ms / 1000.0);
+    unsigned long long ai_slots_run = 0;
+    unsigned long long ai_runs = 0;
+    unsigned long long perception_requests = 0;
+    unsigned long long perception_ship_queries = 0;
+    
+    PhaseStatistics a_statistics[PHASE_COUNT];
+    for (unsigned int p = 0; p < PHASE_COUNT; p++)
+    {
+        a_statistics[p].m_total = 0.0;
+        a_statistics[p].m_max   = 0.0;
+    }
+    vector<double> v_frame_times;
+    if (is_per_frame)
+        v_frame_times.reserve(frame_count * PHASE_COUNT);
+    
+    World* p_restored = NULL;
+    bool is_restore_matching = true;
+    
+    PlayerInput no_input;
+    for (unsigned int f = 0; f < frame_count; f++)
+    {
+        if (is_restore_checked && f == restore_frame)
+        {
+            p_restored = new World();
+            p_restored->setRandomSeed(seed);
+            p_restored->initHeadless();
+            if (is_ring_volume)
+                p_restored->setRingDensityVolumeEnabled(true);
+            if (ai_budget_ms > 0.0)
+                p_restored->setAiBudget(ai_budget_ms / 1000.0);
+            is_restore_matching = restoreSnapshot(*p_world, *p_restored);
+        }
+        
+        PlayerInput input = no_input;
+        if (is_replaying)
+        {
+            replay.applyFrame(f, *p_world);
+            input = replay.getFrame(f).m_input;
+        }
+        else
+        {
+            if (record_filename != "")
+                replay.recordFrame(no_input, *p_world);
+            p_world->applyPlayerInput(no_input);
+        }
+        
+        // the restored World runs the same unit AIs, as in a
+        //  replay, so the AI budget cannot make them differ
+        if (p_restored != NULL)
+        {
+            p_restored->setPlannedAiCount(p_world->getPlannedAiCount());
+            p_restored->applyPlayerInput(input);
+        }
+        
+        ai_slots_run += p_world->getPlannedAiCount();
+        ai_runs      += p_world->getRunAiCount();
+        chrono::steady_clock::time_point frame_start = chrono::steady_clock::now();
+        p_world->updateAll();
+        chrono::steady_clock::time_point frame_end = chrono::steady_clock::now();
+        if (p_restored != NULL)
+            p_restored->updateAll();
+        if (!is_replaying)
+            TimeSystem::markFrameEndFixed();
+        
+        const PerceptionStats& perception = p_world->getPerceptionStats();
+        perception_requests     += perception.m_request_count;
+        perception_ship_queries += perception.m_ship_query_count;
+        
+        const World::UpdateTimes& times = p_world->getLastUpdateTimes();
+        double a_times[PHASE_COUNT] =
+        {
+            times.m_ai,
+            times.m_movement,
+            times.m_collisions,
+            times.m_explosions,
+            chrono::duration<double>(frame_end - frame_start).count()
+        };
+        
+        for (unsigned int p = 0; p < PHASE_COUNT; p++)
+        {
+            a_statistics[p].m_total += a_times[p];
+            if (a_times[p] > a_statistics[p].m_max)
+                a_statistics[p].m_max = a_times[p];
+            if (is_per_frame)
+                v_frame_times.push_back(a_times[p]);
+        }
+    }
+    
+    double total = a_statistics[PHASE_COUNT - 1].m_total;
+    
+    bool is_replay_matching = true;
+    if (is_replaying && replay.isFinalSnapshot())
+        is_replay_matching = replay.isMatchingFinalSnapshot(*p_world);
+    if (p_restored != NULL &&
+        getSnapshot(*p_restored, false) != getSnapshot(*p_world, false))
+    {
+        is_restore_matching = false;
+    }
+    if (record_filename != "")
+    {
+        replay.recordFinalSnapshot(*p_world);
+        if (!replay.save(record_filename))
+            return 2;
+    }
+    
+    cout << "{" << endl;
+    cout << "  \"frames\": " << frame_count << "," << endl;
+    cout << "  \"simulated_fps\": " << frames_per_second << "," << endl;
+    cout << "  \"seed\": " << seed << "," << endl;
+    cout << "  \"ai_budget_ms\": " << ai_budget_ms << "," << endl;
+    cout << "  \"ring_volume\": " << (is_ring_volume ? "true" : "false") << "," << endl;
+    cout << "  \"ai_slots_per_frame\": " << (double)(ai_slots_run) / frame_count << "," << endl;
+    cout << "  \"ai_runs_per_frame\": " << (double)(ai_runs) / frame_count << "," << endl;
+    cout << "  \"perception_per_frame\": { "
+         << "\"requests\": "     << (double)(perception_requests)     / frame_count << ", "
+         << "\"ship_queries\": " << (double)(perception_ship_queries) / frame_count << " }," << endl;
+    if (is_replaying)
+    {
+        cout << "  \"replay_matches\": ";
+        if (replay.isFinalSnapshot())
+            cout << (is_replay_matching ? "true" : "false") << "," << endl;
+        else
+            cout << "null," << endl;
+    }
+    if (is_restore_checked)
+    {
+        cout << "  \"restore_frame\": " << restore_frame << "," << endl;
+        cout << "  \"restore_matches\": " << (is_restore_matching ? "true" : "false") << "," << endl;
+    }
+    cout << "  \"init_ms\": " << chrono::duration<double, milli>(init_end - init_start).count() << "," << endl;
+    cout << "  \"update_fps\": " << (total > 0.0 ? frame_count / total : 0.0) << "," << endl;
+    if (lookup_round_count > 0)
+        cout << "  \"object_lookup_ns\": " << measureObjectLookup(*p_world, lookup_round_count) << "," << endl;
+    cout << "  \"phases\": {" << endl;
+    for (unsigned int p = 0; p < PHASE_COUNT; p++)
+    {
+        cout << "    \"" << PHASE_NAMES[p] << "\": { "
+             << "\"mean_ms\": " << a_statistics[p].m_total * 1000.0 / frame_count << ", "
+             << "\"max_ms\": "  << a_statistics[p].m_max   * 1000.0 << ", "
+             << "\"total_ms\": " << a_statistics[p].m_total * 1000.0 << " }"
+             << (p + 1 < PHASE_COUNT ? "," : "") << endl;
+    }
+    cout << "  }";
+    if (is_per_frame)
+    {
+        cout << "," << endl;
+        cout << "  \"per_frame_ms\": {" << endl;
+        cout << "    \"columns\": [";
+        for (unsigned int p = 0; p < PHASE_COUNT; p++)
+            cout << (p > 0 ? ", " : "") << "\"" << PHASE_NAMES[p] << "\"";
+        cout << "]," << endl;
+        cout << "    \"rows\": [" << endl;
+        for (unsigned int f = 0; f < frame_count; f++)
+        {
+            cout << "      [";
+            for (unsigned int p = 0; p < PHASE_COUNT; p++)
+                cout << (p > 0 ? ", " : "") << v_frame_times[f * PHASE_COUNT + p] * 1000.0;
+            cout << "]" << (f + 1 < frame_count ? "," : "") << endl;
+        }
+        cout << "    ]" << endl;
+        cout << "  }";
+    }
+    cout << endl << "}" << endl;
+    
+    delete p_restored;
+    delete p_world;
+    return (is_replay_matching && is_restore_matching) ? 0 : 1;
+}
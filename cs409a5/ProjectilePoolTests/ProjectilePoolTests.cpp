@@ -0,0 +1,207 @@
+//
+//  ProjectilePoolTests.cpp
+//
+//  A program to check that the ProjectilePool from cs409a5
+//    rejects the ids of projectiles that have been removed,
+//    even after their slots have been reused many times.  Each
+//    check that fails is printed, and the program exits with
+//    status 1 if any did.
+//
+//  To build from this directory, enter as one command:
+//
+//    g++ -std=c++11 -O2 -o ProjectilePoolTests
+//        ProjectilePoolTests.cpp ../cs409a5/ProjectilePool.cpp
+//
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "../cs409a5/ProjectilePool.h"
+
+using namespace std;
+
+namespace
+{
+    const unsigned int REUSE_COUNT = 10000;
+
+    unsigned int g_failure_count = 0;
+
+    //
+    //  check
+    //
+    //  Purpose: To record the result of one check, printing it
+    //           if it failed.
+    //
+
+    void check (bool is_passed, const char* a_description)
+    {
+        if (!is_passed)
+        {
+            cout << "FAILED: " << a_description << endl;
+            g_failure_count++;
+        }
+    }
+
+    void testStaleAfterReuse ()
+    {
+        ProjectilePool pool;
+        unsigned int slot = pool.add();
+        unsigned int index_stale = pool.getIndex(slot);
+        pool.remove(slot);
+        check(!pool.isCurrent(index_stale),
+              "a removed projectile's index is not current");
+
+        // with only one projectile at a time, the free slots are
+        //  used in turn
+        unsigned int slot_reuse_count = 0;
+        bool is_stale_rejected = true;
+        for (unsigned int r = 0; r < REUSE_COUNT; r++)
+        {
+            unsigned int reused = pool.add();
+            if (reused == slot)
+                slot_reuse_count++;
+            if (pool.isCurrent(index_stale))
+                is_stale_rejected = false;
+            pool.remove(reused);
+        }
+        check(slot_reuse_count >= 100, "the slot is reused many times");
+        check(is_stale_rejected,
+              "a stale index is rejected after many reuses of its slot");
+    }
+
+    void testSingleSlotReuse ()
+    {
+        // fill the pool so that only one slot is ever free
+        ProjectilePool pool;
+        for (unsigned int i = 0; i < ProjectilePool::CAPACITY_INITIAL; i++)
+            pool.add();
+        unsigned int slot = pool.getLiveSlot(0);
+        unsigned int index_stale = pool.getIndex(slot);
+        pool.remove(slot);
+
+        bool is_stale_rejected = true;
+        bool is_slot_reused = true;
+        for (unsigned int r = 0; r < REUSE_COUNT; r++)
+        {
+            unsigned int reused = pool.add();
+            if (reused != slot)
+                is_slot_reused = false;
+            if (pool.isCurrent(index_stale))
+                is_stale_rejected = false;
+            pool.remove(reused);
+        }
+        check(is_slot_reused, "the only free slot is reused");
+        check(is_stale_rejected,
+              "a stale index is rejected after many reuses of one slot");
+    }
+
+    void testIndexesUnique ()
+    {
+        ProjectilePool pool;
+        for (unsigned int i = 0; i < 1000; i++)
+            pool.add();
+
+        // remove every other projectile and add them again
+        for (unsigned int i = pool.getLiveCount(); i > 0; i -= 2)
+            pool.remove(pool.getLiveSlot(i - 1));
+        for (unsigned int i = 0; i < 500; i++)
+            pool.add();
+
+        vector<bool> v_is_seen(ProjectilePool::INDEX_COUNT, false);
+        bool is_unique = true;
+        bool is_slot_matching = true;
+        for (unsigned int i = 0; i < pool.getLiveCount(); i++)
+        {
+            unsigned int slot = pool.getLiveSlot(i);
+            unsigned int index = pool.getIndex(slot);
+            if (v_is_seen[index])
+                is_unique = false;
+            v_is_seen[index] = true;
+            if (!pool.isCurrent(index) || pool.getSlot(index) != slot)
+                is_slot_matching = false;
+        }
+        check(is_unique, "live projectiles have different indexes");
+        check(is_slot_matching, "each live index maps back to its slot");
+    }
+
+    void testWrapAround ()
+    {
+        // the index only comes around again after the rest of
+        //  the indexes have been used
+        ProjectilePool pool;
+        unsigned int slot = pool.add();
+        unsigned int index_stale = pool.getIndex(slot);
+        pool.remove(slot);
+
+        unsigned int first_current = 0;
+        for (unsigned int r = 1; r <= ProjectilePool::INDEX_COUNT; r++)
+        {
+            unsigned int reused = pool.add();
+            bool is_current = pool.isCurrent(index_stale);
+            pool.remove(reused);
+            if (is_current)
+            {
+                first_current = r;
+                break;
+            }
+        }
+        check(first_current == ProjectilePool::INDEX_COUNT,
+              "an index is not handed out again until the others have been");
+    }
+
+    void testSnapshot ()
+    {
+        ProjectilePool pool;
+        for (unsigned int i = 0; i < 100; i++)
+            pool.add();
+        for (unsigned int i = 0; i < 30; i++)
+            pool.remove(pool.getLiveSlot(i * 2));
+        unsigned int slot_removed = pool.add();
+        unsigned int index_stale = pool.getIndex(slot_removed);
+        pool.remove(slot_removed);
+
+        stringstream stream(ios::in | ios::out | ios::binary);
+        pool.writeState(stream);
+        ProjectilePool copy;
+        check(copy.readState(stream), "a written pool can be read");
+
+        bool is_same = copy.getLiveCount() == pool.getLiveCount();
+        for (unsigned int i = 0; is_same && i < pool.getLiveCount(); i++)
+        {
+            unsigned int slot = pool.getLiveSlot(i);
+            if (copy.getLiveSlot(i) != slot || copy.getIndex(slot) != pool.getIndex(slot))
+                is_same = false;
+        }
+        check(is_same, "a read pool has the same live slots and indexes");
+        check(!copy.isCurrent(index_stale), "a read pool rejects stale indexes");
+
+        bool is_same_next = true;
+        for (unsigned int i = 0; i < 200; i++)
+        {
+            unsigned int slot = pool.add();
+            if (copy.add() != slot || copy.getIndex(slot) != pool.getIndex(slot))
+                is_same_next = false;
+        }
+        check(is_same_next, "a read pool adds the same slots and indexes");
+    }
+}
+
+
+
+int main ()
+{
+    testStaleAfterReuse();
+    testSingleSlotReuse();
+    testIndexesUnique();
+    testWrapAround();
+    testSnapshot();
+
+    if (g_failure_count > 0)
+    {
+        cout << g_failure_count << " checks failed" << endl;
+        return 1;
+    }
+    cout << "All ProjectilePool checks passed" << endl;
+    return 0;
+}
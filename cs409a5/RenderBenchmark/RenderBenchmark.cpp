@@ -0,0 +1,378 @@
+//
+//  RenderBenchmark.cpp
+//
+//  A program to compare the cost of drawing ObjModels from a
+//    DisplayList and from a VertexBuffer.  It creates an
+//    off-screen OpenGL context through EGL, so it runs without
+//    a display.  With Mesa, setting LIBGL_ALWAYS_SOFTWARE=1
+//    (or having no GPU) selects the llvmpipe software
+//    rasterizer, which makes the results repeatable on any
+//    machine.
+//
+//  For each model, both drawing methods are timed for the same
+//    number of frames, drawing the model several times per
+//    frame.  Two times are reported per frame:
+//    <1> submit: The time for the draw calls to return, which
+//                is the CPU cost of submitting the model
+//    <2> frame: The time until glFinish returns, which also
+//               includes rasterizing the model
+//
+//  Command line options:
+//    --frames N   Number of frames to time per method
+//                 (default 100)
+//    --draws N    Number of times to draw the model per frame
+//                 (default 20)
+//    --size W H   Size of the off-screen image (default 640 480)
+//    MODEL...     The OBJ files to draw (default: the models
+//                 the game loads from Models/)
+//
+//  Times in the output are in milliseconds.  Run the program
+//    from the game directory (../cs409a5) so that the models
+//    and their materials and textures are found.
+//
+//  To build from this directory and run, enter the g++ command
+//    as one command:
+//
+//    g++ -std=c++11 -O2 -o RenderBenchmark RenderBenchmark.cpp
+//        ../../ObjLibrary/*.cpp -lEGL -lglut -lGLU -lGL
+//    cd ../cs409a5 && ../RenderBenchmark/RenderBenchmark
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "../../ObjLibrary/GetGlut.h"
+#include "../../ObjLibrary/ObjModel.h"
+#include "../../ObjLibrary/DisplayList.h"
+#include "../../ObjLibrary/VertexBuffer.h"
+
+using namespace std;
+
+namespace
+{
+    const unsigned int FRAME_COUNT_DEFAULT = 100;
+    const unsigned int DRAW_COUNT_DEFAULT = 20;
+    const int WIDTH_DEFAULT = 640;
+    const int HEIGHT_DEFAULT = 480;
+    const unsigned int WARM_UP_FRAME_COUNT = 5;
+
+    const char* MODEL_NAMES_DEFAULT[] =
+    {
+        "Models/Skybox.obj",
+        "Models/Ring.obj",
+        "Models/Grapple.obj",
+        "Models/Bolt.obj",
+        "Models/RingParticleA0.obj",
+    };
+    const unsigned int MODEL_NAME_DEFAULT_COUNT =
+            sizeof(MODEL_NAMES_DEFAULT) / sizeof(MODEL_NAMES_DEFAULT[0]);
+
+    const unsigned int METHOD_COUNT = 2;
+    const char* METHOD_NAMES[METHOD_COUNT] =
+    {
+        "display_list", "vertex_buffer"
+    };
+
+    //
+    //  MethodStatistics
+    //
+    //  A record of the total submit and frame times for one
+    //    drawing method.
+    //
+
+    struct MethodStatistics
+    {
+        double m_submit_total;
+        double m_submit_max;
+        double m_frame_total;
+    };
+
+    void printUsage (const char* program)
+    {
+        cerr << "Usage: " << program
+             << " [--frames N] [--draws N] [--size W H] [MODEL...]" << endl;
+    }
+
+    //
+    //  initContext
+    //
+    //  Purpose: To create an off-screen OpenGL context and make
+    //           it current.
+    //  Parameter(s):
+    //    <1> width
+    //    <2> height: The size of the off-screen image
+    //  Precondition(s): N/A
+    //  Returns: Whether the context was created.
+    //  Side Effect: An OpenGL compatibility context is created
+    //               with a width x height pbuffer and made
+    //               current.  If this fails, an error message
+    //               is printed to standard error.
+    //
+
+    bool initContext (int width, int height)
+    {
+        // prefer a display-less platform, but fall back to the
+        //  default display if it is not supported
+        EGLDisplay display = EGL_NO_DISPLAY;
+        PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC)(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (get_platform_display != NULL)
+            display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (display == EGL_NO_DISPLAY)
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        EGLint major;
+        EGLint minor;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+        {
+            cerr << "Error: Could not initialize EGL" << endl;
+            return false;
+        }
+        eglBindAPI(EGL_OPENGL_API);
+
+        const EGLint a_config_attributes[] =
+        {
+            EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE,        8,
+            EGL_GREEN_SIZE,      8,
+            EGL_BLUE_SIZE,       8,
+            EGL_DEPTH_SIZE,      24,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint config_count = 0;
+        if (!eglChooseConfig(display, a_config_attributes, &config, 1, &config_count) ||
+            config_count < 1)
+        {
+            cerr << "Error: No EGL configuration supports OpenGL pbuffers" << endl;
+            return false;
+        }
+
+        const EGLint a_surface_attributes[] =
+        {
+            EGL_WIDTH,  width,
+            EGL_HEIGHT, height,
+            EGL_NONE
+        };
+        EGLSurface surface = eglCreatePbufferSurface(display, config, a_surface_attributes);
+        EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+        if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT ||
+            !eglMakeCurrent(display, surface, surface, context))
+        {
+            cerr << "Error: Could not create an OpenGL context" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    //
+    //  initView
+    //
+    //  Purpose: To set up the OpenGL state to draw a model the
+    //           way the game does.
+    //  Parameter(s):
+    //    <1> width
+    //    <2> height: The size of the off-screen image
+    //  Precondition(s):
+    //    <1> An OpenGL context is current
+    //  Returns: N/A
+    //  Side Effect: The viewport, projection, depth test, and a
+    //               light are set up.
+    //
+
+    void initView (int width, int height)
+    {
+        glViewport(0, 0, width, height);
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        gluPerspective(60.0, (double)(width) / (double)(height), 1.0, 100000.0);
+        glMatrixMode(GL_MODELVIEW);
+
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_LIGHTING);
+        glEnable(GL_LIGHT0);
+        glEnable(GL_NORMALIZE);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    //
+    //  drawFrame
+    //
+    //  Purpose: To draw one frame of a model with the specified
+    //           method.
+    //  Parameter(s):
+    //    <1> method: Which method to draw with
+    //    <2> display_list: The DisplayList for the model
+    //    <3> vertex_buffer: The VertexBuffer for the model
+    //    <4> distance: How far from the camera to draw the
+    //                  model
+    //    <5> draw_count: How many times to draw the model
+    //    <6> r_submit: A variable to store the submit time in
+    //  Precondition(s):
+    //    <1> method < METHOD_COUNT
+    //    <2> display_list.isReady()
+    //    <3> vertex_buffer.isReady()
+    //  Returns: The time for the whole frame in seconds.
+    //  Side Effect: The model is drawn draw_count times, spread
+    //               around the middle of the image, and the time
+    //               until the draw calls returned is stored in
+    //               r_submit.
+    //
+
+    double drawFrame (unsigned int method,
+                      const DisplayList& display_list,
+                      const VertexBuffer& vertex_buffer,
+                      double distance,
+                      unsigned int draw_count,
+                      double& r_submit)
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glFinish();
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned int d = 0; d < draw_count; d++)
+        {
+            double offset = ((double)(d) / draw_count - 0.5) * distance;
+            glLoadIdentity();
+            glTranslated(offset, 0.0, -distance);
+            glRotated(d * 360.0 / draw_count, 0.0, 1.0, 0.0);
+
+            if (method == 0)
+                display_list.draw();
+            else
+                vertex_buffer.draw();
+        }
+        chrono::steady_clock::time_point submitted = chrono::steady_clock::now();
+        glFinish();
+        chrono::steady_clock::time_point finished = chrono::steady_clock::now();
+
+        r_submit = chrono::duration<double>(submitted - start).count();
+        return chrono::duration<double>(finished - start).count();
+    }
+}
+
+
+
+int main (int argc, char* argv[])
+{
+    unsigned int frame_count = FRAME_COUNT_DEFAULT;
+    unsigned int draw_count = DRAW_COUNT_DEFAULT;
+    int width = WIDTH_DEFAULT;
+    int height = HEIGHT_DEFAULT;
+    vector<string> v_model_names;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frame_count = (unsigned int)(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--draws") == 0 && i + 1 < argc)
+            draw_count = (unsigned int)(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--size") == 0 && i + 2 < argc)
+        {
+            width  = atoi(argv[++i]);
+            height = atoi(argv[++i]);
+        }
+        else if (argv[i][0] != '-')
+            v_model_names.push_back(argv[i]);
+        else
+        {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (frame_count == 0 || draw_count == 0 || width <= 0 || height <= 0)
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (v_model_names.empty())
+        v_model_names.assign(MODEL_NAMES_DEFAULT, MODEL_NAMES_DEFAULT + MODEL_NAME_DEFAULT_COUNT);
+
+    if (!initContext(width, height))
+        return 2;
+    initView(width, height);
+
+    cout << "{" << endl;
+    cout << "  \"renderer\": \"" << glGetString(GL_RENDERER) << "\"," << endl;
+    cout << "  \"frames\": " << frame_count << "," << endl;
+    cout << "  \"draws_per_frame\": " << draw_count << "," << endl;
+    cout << "  \"models\": [" << endl;
+
+    for (unsigned int m = 0; m < v_model_names.size(); m++)
+    {
+        ObjModel model;
+        model.load(v_model_names[m]);
+        if (!model.isLoadedSuccessfully() || !model.isValid())
+        {
+            cerr << "Error: Could not load \"" << v_model_names[m] << "\"" << endl;
+            return 2;
+        }
+
+        chrono::steady_clock::time_point build_start = chrono::steady_clock::now();
+        DisplayList display_list = model.getDisplayList();
+        chrono::steady_clock::time_point build_middle = chrono::steady_clock::now();
+        VertexBuffer vertex_buffer = model.getVertexBuffer();
+        chrono::steady_clock::time_point build_end = chrono::steady_clock::now();
+
+        // fit the model in the image from its farthest vertex
+        double radius = 1.0;
+        for (unsigned int v = 0; v < model.getVertexCount(); v++)
+        {
+            double norm = model.getVertexPosition(v).getNorm();
+            if (norm > radius)
+                radius = norm;
+        }
+        double distance = radius * 3.0;
+
+        MethodStatistics a_statistics[METHOD_COUNT];
+        for (unsigned int method = 0; method < METHOD_COUNT; method++)
+        {
+            a_statistics[method].m_submit_total = 0.0;
+            a_statistics[method].m_submit_max   = 0.0;
+            a_statistics[method].m_frame_total  = 0.0;
+
+            double submit;
+            for (unsigned int f = 0; f < WARM_UP_FRAME_COUNT; f++)
+                drawFrame(method, display_list, vertex_buffer, distance, draw_count, submit);
+
+            for (unsigned int f = 0; f < frame_count; f++)
+            {
+                double frame = drawFrame(method, display_list, vertex_buffer, distance, draw_count, submit);
+                a_statistics[method].m_submit_total += submit;
+                a_statistics[method].m_frame_total  += frame;
+                if (submit > a_statistics[method].m_submit_max)
+                    a_statistics[method].m_submit_max = submit;
+            }
+        }
+
+        cout << "    {" << endl;
+        cout << "      \"file\": \"" << v_model_names[m] << "\"," << endl;
+        cout << "      \"vertices\": " << vertex_buffer.getVertexCount() << "," << endl;
+        cout << "      \"triangles\": " << vertex_buffer.getTriangleCount() << "," << endl;
+        cout << "      \"ranges\": " << vertex_buffer.getRangeCount() << "," << endl;
+        cout << "      \"build_ms\": { "
+             << "\"display_list\": " << chrono::duration<double, milli>(build_middle - build_start).count() << ", "
+             << "\"vertex_buffer\": " << chrono::duration<double, milli>(build_end - build_middle).count() << " }," << endl;
+        for (unsigned int method = 0; method < METHOD_COUNT; method++)
+        {
+            cout << "      \"" << METHOD_NAMES[method] << "\": { "
+                 << "\"submit_mean_ms\": " << a_statistics[method].m_submit_total * 1000.0 / frame_count << ", "
+                 << "\"submit_max_ms\": "  << a_statistics[method].m_submit_max   * 1000.0 << ", "
+                 << "\"frame_mean_ms\": "  << a_statistics[method].m_frame_total  * 1000.0 / frame_count << " }"
+                 << (method + 1 < METHOD_COUNT ? "," : "") << endl;
+        }
+        cout << "    }" << (m + 1 < v_model_names.size() ? "," : "") << endl;
+    }
+
+    cout << "  ]" << endl;
+    cout << "}" << endl;
+    return 0;
+}
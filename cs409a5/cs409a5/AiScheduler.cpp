@@ -0,0 +1,452 @@
+//
+//  AiScheduler.cpp
+//
+
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "SnapshotStream.h"
+#include "AiScheduler.h"
+
+using namespace std;
+namespace
+{
+	// each new measurement moves the estimate 1 / 4 of the way
+	//  towards it, so one slow frame does not starve an AI
+	const long long COST_SMOOTHING_DIVISOR = 4;
+
+	// the estimate for an AI that has not been measured yet
+	const long long COST_UNKNOWN = -1;
+}
+
+
+
+const long long AiScheduler :: BUDGET_UNLIMITED = -1;
+const unsigned int AiScheduler :: WAIT_FRAMES_MAX_DEFAULT = 4;
+const long long AiScheduler :: WAKE_NONE = -1;
+
+
+
+AiScheduler :: AiScheduler ()
+		: mv_cost_estimates(),
+		  mv_wake_times(),
+		  mv_budget_wait_ends(),
+		  m_wake_list(),
+		  mv_run_slots(),
+		  m_parallelism(1),
+		  m_budget(BUDGET_UNLIMITED),
+		  m_wait_frames_max(WAIT_FRAMES_MAX_DEFAULT),
+		  m_first_slot(0),
+		  m_planned_slot_count(0),
+		  m_frame_start_time(0)
+{
+	assert(invariant());
+}
+
+
+
+unsigned int AiScheduler :: getSlotCount () const
+{
+	return (unsigned int)(mv_cost_estimates.size());
+}
+
+long long AiScheduler :: getBudget () const
+{
+	return m_budget;
+}
+
+unsigned int AiScheduler :: getWaitFramesMax () const
+{
+	return m_wait_frames_max;
+}
+
+unsigned int AiScheduler :: getPlannedSlotCount () const
+{
+	return m_planned_slot_count;
+}
+
+unsigned int AiScheduler :: getRunSlotCount () const
+{
+	return (unsigned int)(mv_run_slots.size());
+}
+
+unsigned int AiScheduler :: getRunSlot (unsigned int index) const
+{
+	assert(index < getRunSlotCount());
+
+	return mv_run_slots[index];
+}
+
+bool AiScheduler :: isSleeping (unsigned int slot) const
+{
+	assert(slot < getSlotCount());
+
+	return mv_wake_times[slot] != WAKE_NONE;
+}
+
+bool AiScheduler :: isWaitingForBudget (unsigned int slot) const
+{
+	assert(slot < getSlotCount());
+
+	return mv_budget_wait_ends[slot] != WAKE_NONE &&
+	       mv_budget_wait_ends[slot] > m_frame_start_time;
+}
+
+long long AiScheduler :: getCostEstimate (unsigned int slot) const
+{
+	assert(slot < getSlotCount());
+
+	if(mv_cost_estimates[slot] == COST_UNKNOWN)
+		return 0;
+	return mv_cost_estimates[slot];
+}
+
+
+
+void AiScheduler :: init (unsigned int slot_count, unsigned int parallelism)
+{
+	assert(parallelism >= 1);
+
+	mv_cost_estimates.assign(slot_count, COST_UNKNOWN);
+	mv_wake_times.assign(slot_count, WAKE_NONE);
+	mv_budget_wait_ends.assign(slot_count, WAKE_NONE);
+	m_wake_list = WakeList();
+	m_parallelism = parallelism;
+	m_first_slot  = 0;
+	m_frame_start_time = 0;
+	m_planned_slot_count = slot_count;
+	buildRunSlots();
+
+	assert(invariant());
+}
+
+void AiScheduler :: setBudget (long long budget)
+{
+	assert(budget > 0 || budget == BUDGET_UNLIMITED);
+
+	m_budget = budget;
+	if(getSlotCount() > 0)
+	{
+		if(m_budget == BUDGET_UNLIMITED)
+			plan(BUDGET_UNLIMITED);
+		else
+			plan(m_budget * m_parallelism);
+	}
+
+	assert(invariant());
+}
+
+void AiScheduler :: setWaitFramesMax (unsigned int wait_frames_max)
+{
+	assert(wait_frames_max >= 1);
+
+	m_wait_frames_max = wait_frames_max;
+
+	assert(invariant());
+}
+
+void AiScheduler :: setPlannedSlotCount (unsigned int slot_count)
+{
+	assert(slot_count >= 1);
+	assert(slot_count <= getSlotCount());
+
+	m_planned_slot_count = slot_count;
+	buildRunSlots();
+
+	assert(invariant());
+}
+
+void AiScheduler :: recordCost (unsigned int slot, long long cost)
+{
+	assert(slot < getSlotCount());
+
+	if(cost < 0)
+		cost = 0;
+
+	long long& r_estimate = mv_cost_estimates[slot];
+	if(r_estimate <= 0)
+		r_estimate = cost;
+	else
+		r_estimate += (cost - r_estimate) / COST_SMOOTHING_DIVISOR;
+}
+
+void AiScheduler :: clearCost (unsigned int slot)
+{
+	assert(slot < getSlotCount());
+
+	mv_cost_estimates[slot] = 0;
+}
+
+void AiScheduler :: setWakeTime (unsigned int slot, long long wake_time)
+{
+	assert(slot < getSlotCount());
+	assert(wake_time >= 0 || wake_time == WAKE_NONE);
+
+	mv_wake_times[slot] = wake_time;
+}
+
+void AiScheduler :: setBudgetWaitEnd (unsigned int slot, long long end_time)
+{
+	assert(slot < getSlotCount());
+	assert(end_time >= 0 || end_time == WAKE_NONE);
+
+	mv_budget_wait_ends[slot] = end_time;
+}
+
+void AiScheduler :: endFrame (long long overshoot, long long next_frame_time)
+{
+	assert(overshoot >= 0);
+
+	if(getSlotCount() == 0)
+		return;
+
+	// only the slots that just ran can have gone to sleep, and
+	//  a slot only wakes when its entry is removed, so each
+	//  sleeping slot has exactly one entry
+	for(unsigned int i = 0; i < mv_run_slots.size(); i++)
+	{
+		unsigned int slot = mv_run_slots[i];
+		if(mv_wake_times[slot] != WAKE_NONE)
+			m_wake_list.push(WakeEntry(mv_wake_times[slot], slot));
+	}
+
+	while(!m_wake_list.empty() && m_wake_list.top().first <= next_frame_time)
+	{
+		unsigned int slot = m_wake_list.top().second;
+		assert(mv_wake_times[slot] == m_wake_list.top().first);
+		mv_wake_times[slot] = WAKE_NONE;
+		m_wake_list.pop();
+	}
+
+	m_first_slot = (m_first_slot + m_planned_slot_count) % getSlotCount();
+	m_frame_start_time = next_frame_time;
+
+	if(m_budget == BUDGET_UNLIMITED)
+		plan(BUDGET_UNLIMITED);
+	else if(overshoot >= m_budget)
+		plan(0);
+	else
+		plan((m_budget - overshoot) * m_parallelism);
+
+	assert(invariant());
+}
+
+
+
+void AiScheduler :: writeState (ostream& r_out) const
+{
+	SnapshotStream::writeValue(r_out, getSlotCount());
+	SnapshotStream::writeValue(r_out, m_first_slot);
+	SnapshotStream::writeValue(r_out, m_frame_start_time);
+	for(unsigned int i = 0; i < getSlotCount(); i++)
+	{
+		SnapshotStream::writeValue(r_out, mv_wake_times[i]);
+		SnapshotStream::writeValue(r_out, mv_budget_wait_ends[i]);
+	}
+}
+
+bool AiScheduler :: readState (istream& r_in)
+{
+	unsigned int slot_count;
+	unsigned int first_slot;
+	long long frame_start_time;
+	if(!SnapshotStream::readValue(r_in, slot_count) ||
+	   !SnapshotStream::readValue(r_in, first_slot) ||
+	   !SnapshotStream::readValue(r_in, frame_start_time))
+	{
+		return false;
+	}
+	if(slot_count != getSlotCount())
+		return false;
+	if(slot_count > 0 && first_slot >= slot_count)
+		return false;
+
+	vector<long long> v_wake_times(slot_count);
+	vector<long long> v_budget_wait_ends(slot_count);
+	for(unsigned int i = 0; i < slot_count; i++)
+	{
+		if(!SnapshotStream::readValue(r_in, v_wake_times[i])       ||
+		   !SnapshotStream::readValue(r_in, v_budget_wait_ends[i]) ||
+		   (v_wake_times[i]       < 0 && v_wake_times[i]       != WAKE_NONE) ||
+		   (v_budget_wait_ends[i] < 0 && v_budget_wait_ends[i] != WAKE_NONE))
+		{
+			return false;
+		}
+	}
+
+	// the wake list is ordered by time and then slot, so
+	//  building it again gives the same order
+	m_wake_list = WakeList();
+	for(unsigned int i = 0; i < slot_count; i++)
+		if(v_wake_times[i] != WAKE_NONE)
+			m_wake_list.push(WakeEntry(v_wake_times[i], i));
+
+	mv_wake_times      .swap(v_wake_times);
+	mv_budget_wait_ends.swap(v_budget_wait_ends);
+	m_first_slot       = first_slot;
+	m_frame_start_time = frame_start_time;
+	buildRunSlots();
+
+	assert(invariant());
+	return true;
+}
+
+void AiScheduler :: writeEstimates (ostream& r_out) const
+{
+	SnapshotStream::writeValue(r_out, getSlotCount());
+	for(unsigned int i = 0; i < getSlotCount(); i++)
+		SnapshotStream::writeValue(r_out, mv_cost_estimates[i]);
+	SnapshotStream::writeValue(r_out, m_planned_slot_count);
+}
+
+bool AiScheduler :: readEstimates (istream& r_in)
+{
+	unsigned int slot_count;
+	if(!SnapshotStream::readValue(r_in, slot_count))
+		return false;
+	if(slot_count != getSlotCount())
+		return false;
+
+	vector<long long> v_cost_estimates(slot_count);
+	for(unsigned int i = 0; i < slot_count; i++)
+	{
+		if(!SnapshotStream::readValue(r_in, v_cost_estimates[i]) ||
+		   (v_cost_estimates[i] < 0 && v_cost_estimates[i] != COST_UNKNOWN))
+		{
+			return false;
+		}
+	}
+
+	unsigned int planned_slot_count;
+	if(!SnapshotStream::readValue(r_in, planned_slot_count))
+		return false;
+	if(planned_slot_count > slot_count ||
+	   (slot_count > 0 && planned_slot_count < 1))
+	{
+		return false;
+	}
+
+	mv_cost_estimates.swap(v_cost_estimates);
+	m_planned_slot_count = planned_slot_count;
+	buildRunSlots();
+
+	assert(invariant());
+	return true;
+}
+
+
+
+void AiScheduler :: plan (long long budget)
+{
+	unsigned int slot_count = getSlotCount();
+	if(budget == BUDGET_UNLIMITED)
+	{
+		m_planned_slot_count = slot_count;
+		buildRunSlots();
+		return;
+	}
+
+	// enough slots that the window gets all the way around
+	//  within m_wait_frames_max frames
+	unsigned int minimum = (slot_count + m_wait_frames_max - 1) / m_wait_frames_max;
+	if(minimum < 1)
+		minimum = 1;
+
+	// AIs that have not been measured are assumed to cost as
+	//  much as the average AI that has; if none have, only the
+	//  minimum are run until there is something to go on
+	long long known_total = 0;
+	unsigned int known_count = 0;
+	for(unsigned int i = 0; i < slot_count; i++)
+		if(mv_cost_estimates[i] > 0)
+		{
+			known_total += mv_cost_estimates[i];
+			known_count++;
+		}
+	long long unknown_cost = budget + 1;
+	if(known_count > 0)
+		unknown_cost = known_total / known_count;
+
+	// the slots waiting for budget only run if every slot fits,
+	//  so they only count against the budget in that case
+	unsigned int count = countWindow(budget, minimum, unknown_cost, false);
+	if(count < slot_count)
+	{
+		count = countWindow(budget, minimum, unknown_cost, true);
+		if(count >= slot_count)
+			count = slot_count - 1;
+		assert(count >= minimum);
+	}
+	m_planned_slot_count = count;
+	buildRunSlots();
+}
+
+unsigned int AiScheduler :: countWindow (long long budget,
+                                         unsigned int minimum,
+                                         long long unknown_cost,
+                                         bool is_budget_wait_free) const
+{
+	assert(budget >= 0);
+
+	unsigned int slot_count = getSlotCount();
+	long long total = 0;
+	unsigned int count = 0;
+	while(count < slot_count)
+	{
+		unsigned int slot = (m_first_slot + count) % slot_count;
+		long long cost = mv_cost_estimates[slot];
+		if(mv_wake_times[slot] != WAKE_NONE)
+			cost = 0;
+		else if(is_budget_wait_free && isWaitingForBudget(slot))
+			cost = 0;
+		else if(cost == COST_UNKNOWN)
+			cost = unknown_cost;
+		if(count >= minimum && total + cost > budget)
+			break;
+		total += cost;
+		count++;
+	}
+	return count;
+}
+
+void AiScheduler :: buildRunSlots ()
+{
+	unsigned int slot_count = getSlotCount();
+	bool is_every_slot = (m_planned_slot_count == slot_count);
+
+	mv_run_slots.clear();
+	for(unsigned int i = 0; i < m_planned_slot_count; i++)
+	{
+		unsigned int slot = (m_first_slot + i) % slot_count;
+		if(mv_wake_times[slot] != WAKE_NONE)
+			continue;
+		if(!is_every_slot && isWaitingForBudget(slot))
+			continue;
+		mv_run_slots.push_back(slot);
+	}
+}
+
+bool AiScheduler :: invariant () const
+{
+	if(m_parallelism < 1) return false;
+	if(m_budget <= 0 && m_budget != BUDGET_UNLIMITED) return false;
+	if(m_wait_frames_max < 1) return false;
+	if(!mv_cost_estimates.empty() && m_first_slot >= mv_cost_estimates.size()) return false;
+	if(m_planned_slot_count > mv_cost_estimates.size()) return false;
+	if(!mv_cost_estimates.empty() && m_planned_slot_count < 1) return false;
+	for(unsigned int i = 0; i < mv_cost_estimates.size(); i++)
+		if(mv_cost_estimates[i] < 0 && mv_cost_estimates[i] != COST_UNKNOWN)
+			return false;
+	if(mv_wake_times.size() != mv_cost_estimates.size()) return false;
+	for(unsigned int i = 0; i < mv_wake_times.size(); i++)
+		if(mv_wake_times[i] < 0 && mv_wake_times[i] != WAKE_NONE)
+			return false;
+	if(mv_run_slots.size() > m_planned_slot_count) return false;
+	if(mv_budget_wait_ends.size() != mv_cost_estimates.size()) return false;
+	for(unsigned int i = 0; i < mv_budget_wait_ends.size(); i++)
+		if(mv_budget_wait_ends[i] < 0 && mv_budget_wait_ends[i] != WAKE_NONE)
+			return false;
+	return true;
+}
@@ -0,0 +1,611 @@
+//
+//  AiScheduler.h
+//
+
+#ifndef AI_SCHEDULER_H
+#define AI_SCHEDULER_H
+
+#include <iosfwd>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+
+
+
+//
+//  AiScheduler
+//
+//  A class to decide which unit AIs run in each frame so that
+//    the time spent on AIs stays within a budget.  The AIs are
+//    identified by slot numbers, and each frame a window of
+//    consecutive slots, wrapping around at the end, is run.
+//    The next frame starts where the previous window ended, so
+//    the AIs take turns in round-robin order.
+//
+//  The size of each window is planned at the end of the frame
+//    before, using an estimate of the cost of each AI.  The
+//    estimates are updated from the time each AI actually
+//    took, so an expensive AI fills more of the budget and
+//    fewer AIs run with it.  An AI that has not run yet is
+//    assumed to cost as much as the average AI that has.  If
+//    the frame before went over its budget, the overshoot is
+//    taken from the next budget.
+//    Because the size of the window is decided before the
+//    frame starts, it can be recorded and set again when a
+//    game is replayed, so that exactly the same AIs run.
+//
+//  Every window covers at least 1 / getWaitFramesMax() of the
+//    slots, however long the AIs take.  This guarantees that
+//    every AI runs at least once every getWaitFramesMax()
+//    frames.  Without a budget, every AI runs every frame.
+//
+//  An AI can also be put to sleep until a specified time, such
+//    as when it is waiting and has nothing to do until then.
+//    A sleeping slot is skipped when the window passes over it
+//    and costs nothing.  The sleeping slots are kept in a wake
+//    list ordered by wake time, so waking them each frame only
+//    looks at the ones that are due.
+//
+//  An AI that is awake can instead be set to wait for budget,
+//    such as when it has work to do that can be put off.  Such
+//    a slot is only run in a frame whose window covers every
+//    slot, so that it never takes time from an AI that would
+//    otherwise be skipped, or once its budget wait has ended.
+//    When planning a window that cannot cover every slot, the
+//    slots waiting for budget cost nothing.  Whether they run
+//    depends only on the window size and the frame start time,
+//    so a replay that sets the same window size runs them too.
+//
+//  All times are in nanoseconds.
+//
+//  Class Invariant:
+//    <1> m_parallelism >= 1
+//    <2> m_budget > 0 || m_budget == BUDGET_UNLIMITED
+//    <3> m_wait_frames_max >= 1
+//    <4> mv_cost_estimates.empty() ||
+//        m_first_slot < mv_cost_estimates.size()
+//    <5> m_planned_slot_count <= mv_cost_estimates.size()
+//    <6> mv_cost_estimates.empty() || m_planned_slot_count >= 1
+//    <7> mv_cost_estimates[i] >= 0 ||
+//        mv_cost_estimates[i] == COST_UNKNOWN
+//                             WHERE 0 <= i < getSlotCount()
+//    <8> mv_wake_times.size() == mv_cost_estimates.size()
+//    <9> mv_wake_times[i] >= 0 || mv_wake_times[i] == WAKE_NONE
+//                             WHERE 0 <= i < getSlotCount()
+//    <10> mv_run_slots.size() <= m_planned_slot_count
+//    <11> mv_budget_wait_ends.size() == mv_cost_estimates.size()
+//    <12> mv_budget_wait_ends[i] >= 0 ||
+//         mv_budget_wait_ends[i] == WAKE_NONE
+//                             WHERE 0 <= i < getSlotCount()
+//
+
+class AiScheduler
+{
+public:
+//
+//  BUDGET_UNLIMITED
+//
+//  A constant indicating that there is no limit on the time
+//    spent on AIs.
+//
+
+	static const long long BUDGET_UNLIMITED;
+
+//
+//  WAIT_FRAMES_MAX_DEFAULT
+//
+//  The default for the largest number of frames in a row that
+//    an AI can go without running.
+//
+
+	static const unsigned int WAIT_FRAMES_MAX_DEFAULT;
+
+//
+//  WAKE_NONE
+//
+//  A constant indicating that an AI is not sleeping.
+//
+
+	static const long long WAKE_NONE;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new AiScheduler with no slots.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new AiScheduler is created with no slots, a
+//               parallelism of 1, no budget, and a maximum
+//               wait of WAIT_FRAMES_MAX_DEFAULT frames.
+//
+
+	AiScheduler ();
+
+//
+//  getSlotCount
+//
+//  Purpose: To determine the number of AI slots.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of slots.
+//  Side Effect: N/A
+//
+
+	unsigned int getSlotCount () const;
+
+//
+//  getBudget
+//
+//  Purpose: To determine the time allowed for AIs each frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The budget in nanoseconds of elapsed time, or
+//           BUDGET_UNLIMITED.
+//  Side Effect: N/A
+//
+
+	long long getBudget () const;
+
+//
+//  getWaitFramesMax
+//
+//  Purpose: To determine the largest number of frames in a row
+//           that an AI can go without running.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The maximum wait in frames.
+//  Side Effect: N/A
+//
+
+	unsigned int getWaitFramesMax () const;
+
+//
+//  getPlannedSlotCount
+//
+//  Purpose: To determine how many slots will be run in the
+//           current frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of slots in the window for the current
+//           frame.
+//  Side Effect: N/A
+//
+
+	unsigned int getPlannedSlotCount () const;
+
+//
+//  getRunSlotCount
+//
+//  Purpose: To determine how many AIs will actually be run in
+//           the current frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of slots in the window for the current
+//           frame that are not sleeping.
+//  Side Effect: N/A
+//
+
+	unsigned int getRunSlotCount () const;
+
+//
+//  getRunSlot
+//
+//  Purpose: To determine which slot is at the specified
+//           position in the list of slots to run in the current
+//           frame.
+//  Parameter(s):
+//    <1> index: The position in the list
+//  Precondition(s):
+//    <1> index < getRunSlotCount()
+//  Returns: The index-th slot in the window that is not
+//           sleeping, counting from the start of the window.
+//  Side Effect: N/A
+//
+
+	unsigned int getRunSlot (unsigned int index) const;
+
+//
+//  isSleeping
+//
+//  Purpose: To determine if the specified slot is sleeping.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//  Returns: Whether slot slot will be skipped until its wake
+//           time.
+//  Side Effect: N/A
+//
+
+	bool isSleeping (unsigned int slot) const;
+
+//
+//  isWaitingForBudget
+//
+//  Purpose: To determine if the specified slot is being held
+//           back until there is budget to spare.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//  Returns: Whether slot slot is waiting for budget and its
+//           budget wait has not ended by the start of the
+//           current frame.
+//  Side Effect: N/A
+//
+
+	bool isWaitingForBudget (unsigned int slot) const;
+
+//
+//  getCostEstimate
+//
+//  Purpose: To determine the estimated cost of running the AI
+//           in the specified slot.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//  Returns: The estimated cost in nanoseconds.  If the AI has
+//           not been measured, 0 is returned.
+//  Side Effect: N/A
+//
+
+	long long getCostEstimate (unsigned int slot) const;
+
+//
+//  init
+//
+//  Purpose: To set the number of AI slots and how many AIs can
+//           run at once.
+//  Parameter(s):
+//    <1> slot_count: The number of slots
+//    <2> parallelism: The number of AIs that can run at the
+//                     same time
+//  Precondition(s):
+//    <1> parallelism >= 1
+//  Returns: N/A
+//  Side Effect: This AiScheduler is set to have slot_count
+//               slots with no cost estimates and none
+//               sleeping or waiting for budget.  The current
+//               frame is taken to start at time 0.  The window for the current frame is
+//               set to start at slot 0 and cover every slot.
+//               The budget and maximum wait are not changed.
+//
+
+	void init (unsigned int slot_count, unsigned int parallelism);
+
+//
+//  setBudget
+//
+//  Purpose: To change the time allowed for AIs each frame.
+//  Parameter(s):
+//    <1> budget: The new budget in nanoseconds of elapsed time
+//  Precondition(s):
+//    <1> budget > 0 || budget == BUDGET_UNLIMITED
+//  Returns: N/A
+//  Side Effect: The budget is set to budget, and the window
+//               for the current frame is planned again to fit
+//               it.
+//
+
+	void setBudget (long long budget);
+
+//
+//  setWaitFramesMax
+//
+//  Purpose: To change the largest number of frames in a row
+//           that an AI can go without running.
+//  Parameter(s):
+//    <1> wait_frames_max: The new maximum wait in frames
+//  Precondition(s):
+//    <1> wait_frames_max >= 1
+//  Returns: N/A
+//  Side Effect: The maximum wait is set to wait_frames_max.
+//               This takes effect when the next frame is
+//               planned.
+//
+
+	void setWaitFramesMax (unsigned int wait_frames_max);
+
+//
+//  setPlannedSlotCount
+//
+//  Purpose: To replace the planned window size for the current
+//           frame.  This is intended for replaying a recording.
+//  Parameter(s):
+//    <1> slot_count: The number of slots to run
+//  Precondition(s):
+//    <1> slot_count >= 1
+//    <2> slot_count <= getSlotCount()
+//  Returns: N/A
+//  Side Effect: The window for the current frame is set to
+//               cover slot_count slots.  The slots in it that
+//               are sleeping are still skipped.
+//
+
+	void setPlannedSlotCount (unsigned int slot_count);
+
+//
+//  recordCost
+//
+//  Purpose: To record how long the AI in the specified slot
+//           took to run.
+//  Parameter(s):
+//    <1> slot: The slot
+//    <2> cost: The time the AI took in nanoseconds
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//  Returns: N/A
+//  Side Effect: The cost estimate for slot slot is updated.
+//               This function may be called for different slots
+//               from different threads at the same time.
+//
+
+	void recordCost (unsigned int slot, long long cost);
+
+//
+//  clearCost
+//
+//  Purpose: To record that the specified slot has no AI to
+//           run, such as because its ship is dead.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//  Returns: N/A
+//  Side Effect: The cost estimate for slot slot is set to 0.
+//               This function may be called for different slots
+//               from different threads at the same time.
+//
+
+	void clearCost (unsigned int slot);
+
+//
+//  setWakeTime
+//
+//  Purpose: To record that the AI in the specified slot has
+//           nothing to do until the specified time.
+//  Parameter(s):
+//    <1> slot: The slot
+//    <2> wake_time: The time to sleep until, or WAKE_NONE
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//    <2> wake_time >= 0 || wake_time == WAKE_NONE
+//    <3> slot is in the window for the current frame
+//  Returns: N/A
+//  Side Effect: Slot slot is set to sleep until wake_time.  It
+//               is added to the wake list when the current
+//               frame ends.  This function may be called for
+//               different slots from different threads at the
+//               same time.
+//
+
+	void setWakeTime (unsigned int slot, long long wake_time);
+
+//
+//  setBudgetWaitEnd
+//
+//  Purpose: To record that the AI in the specified slot should
+//           only run when there is budget to spare, until the
+//           specified time.
+//  Parameter(s):
+//    <1> slot: The slot
+//    <2> end_time: The time to stop waiting for budget at, or
+//                  WAKE_NONE
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//    <2> end_time >= 0 || end_time == WAKE_NONE
+//  Returns: N/A
+//  Side Effect: Slot slot is set to wait for budget until the
+//               first frame that starts at or after end_time.
+//               If it is also sleeping, it starts waiting for
+//               budget when it wakes.  This takes effect when
+//               the next frame is planned.  This function may
+//               be called for different slots from different
+//               threads at the same time.
+//
+
+	void setBudgetWaitEnd (unsigned int slot, long long end_time);
+
+//
+//  endFrame
+//
+//  Purpose: To move on to the next frame.
+//  Parameter(s):
+//    <1> overshoot: How far past the budget the AIs ran this
+//                   frame, in nanoseconds
+//    <2> next_frame_time: The time the next frame starts at
+//  Precondition(s):
+//    <1> overshoot >= 0
+//  Returns: N/A
+//  Side Effect: The slots that went to sleep this frame are
+//               added to the wake list, and every sleeping slot
+//               with a wake time no later than next_frame_time
+//               is woken.  The next frame is taken to start at
+//               next_frame_time, which decides which budget
+//               waits have ended.  The window for the next frame
+//               is set to start after the window for the
+//               current frame.  Its size is planned from the cost
+//               estimates so that the AIs in it fit in the
+//               budget less overshoot.
+//
+
+	void endFrame (long long overshoot, long long next_frame_time);
+
+//
+//  writeState
+//
+//  Purpose: To write the state of this AiScheduler that
+//           affects the game to a binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The slot count, the first slot in the window
+//               for the current frame, the start time of the
+//               current frame, and the wake time and budget
+//               wait end for every slot are written to r_out.
+//               The cost estimates and planned window size
+//               depend on how fast the computer is, so they
+//               are written separately by writeEstimates.
+//
+
+	void writeState (std::ostream& r_out) const;
+
+//
+//  readState
+//
+//  Purpose: To read the state of this AiScheduler from a
+//           binary stream, as written by writeState.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s): N/A
+//  Returns: Whether a valid state could be read.  If the slot
+//           count does not match getSlotCount(), false is
+//           returned.
+//  Side Effect: If true is returned, the window for the current
+//               frame, the frame start time, and the sleeping
+//               and budget waits of every slot are set to the
+//               ones read, and the wake list and the list of
+//               slots to run are built again.  Otherwise, this
+//               AiScheduler is unchanged.
+//
+
+	bool readState (std::istream& r_in);
+
+//
+//  writeEstimates
+//
+//  Purpose: To write the cost estimates of this AiScheduler to
+//           a binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The slot count, the cost estimate for every
+//               slot, and the size of the window for the
+//               current frame are written to r_out.
+//
+
+	void writeEstimates (std::ostream& r_out) const;
+
+//
+//  readEstimates
+//
+//  Purpose: To read the cost estimates of this AiScheduler from
+//           a binary stream, as written by writeEstimates.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s): N/A
+//  Returns: Whether valid estimates could be read.  If the slot
+//           count does not match getSlotCount(), false is
+//           returned.
+//  Side Effect: If true is returned, the cost estimates and the
+//               size of the window for the current frame are
+//               set to the ones read, and the list of slots to
+//               run is built again.  Otherwise, this
+//               AiScheduler is unchanged.
+//
+
+	bool readEstimates (std::istream& r_in);
+
+private:
+//
+//  plan
+//
+//  Purpose: To choose the size of the window for the current
+//           frame.
+//  Parameter(s):
+//    <1> budget: The total cost in nanoseconds that the window
+//                may have, or BUDGET_UNLIMITED
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The window is set to cover as many slots,
+//               starting at m_first_slot, as fit in budget, but
+//               never fewer than are needed to keep the
+//               maximum wait or more than every slot.  Sleeping
+//               slots cost nothing.  If the window cannot cover
+//               every slot, slots waiting for budget cost
+//               nothing either.  The list of slots to run is
+//               built again.
+//
+
+	void plan (long long budget);
+
+//
+//  countWindow
+//
+//  Purpose: To determine how many slots, starting at
+//           m_first_slot, fit in the specified budget.
+//  Parameter(s):
+//    <1> budget: The total cost in nanoseconds allowed
+//    <2> minimum: The fewest slots to count
+//    <3> unknown_cost: The cost to use for an AI that has not
+//                      been measured
+//    <4> is_budget_wait_free: Whether slots waiting for budget
+//                             cost nothing
+//  Precondition(s):
+//    <1> budget >= 0
+//  Returns: The number of slots that fit, but at least minimum
+//           and at most getSlotCount().
+//  Side Effect: N/A
+//
+
+	unsigned int countWindow (long long budget,
+	                          unsigned int minimum,
+	                          long long unknown_cost,
+	                          bool is_budget_wait_free) const;
+
+//
+//  buildRunSlots
+//
+//  Purpose: To list the slots to run in the current frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: mv_run_slots is set to the slots in the window
+//               for the current frame that are not sleeping, in
+//               window order.  Slots waiting for budget are left
+//               out unless the window covers every slot.
+//
+
+	void buildRunSlots ();
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	// the wake list is a min-heap of wake times and slots
+	typedef std::pair<long long, unsigned int> WakeEntry;
+	typedef std::priority_queue<WakeEntry,
+	                            std::vector<WakeEntry>,
+	                            std::greater<WakeEntry> > WakeList;
+
+	std::vector<long long> mv_cost_estimates;
+	std::vector<long long> mv_wake_times;
+	std::vector<long long> mv_budget_wait_ends;
+	WakeList m_wake_list;
+	std::vector<unsigned int> mv_run_slots;
+	unsigned int m_parallelism;
+	long long m_budget;
+	unsigned int m_wait_frames_max;
+	unsigned int m_first_slot;
+	unsigned int m_planned_slot_count;
+	long long m_frame_start_time;
+};
+
+
+
+#endif
@@ -3,6 +3,8 @@
 //
 
 #include <cassert>
+#include <istream>
+#include <ostream>
 #include "GetGlut.h"
 
 #include "../../ObjLibrary/Vector3.h"
@@ -11,6 +13,7 @@
 #include "TimeSystem.h"
 #include "WorldInterface.h"
 #include "PhysicsObject.h"
+#include "SnapshotStream.h"
 #include "Bullet.h"
 
 namespace
@@ -94,13 +97,15 @@ const PhysicsObjectId& Bullet :: getSourceId () const
 
 void Bullet :: fire (const Vector3& position,
                      const Vector3& forward,
-                     const PhysicsObjectId& source_id)
+                     const PhysicsObjectId& source_id,
+                     PseudorandomGenerator& r_random)
 {
 	assert(forward.isNormal());
 
 	setPosition(position);
+	setPositionPreviousToCurrent();
 	setVelocity(forward * SPEED);
-	randomizeUpVector();
+	randomizeUpVector(r_random);
 
 	m_source_id     = source_id;
 	m_creation_time = TimeSystem::getFrameStartTime();
@@ -168,3 +173,38 @@ void Bullet :: update (WorldInterface& r_world)
 	updateBasic();  // moves the Bullet
 }
 
+void Bullet :: writeState (std::ostream& r_out) const
+{
+	PhysicsObject::writeState(r_out);
+
+	SnapshotStream::writeValue(r_out, m_source_id.m_type);
+	SnapshotStream::writeValue(r_out, m_source_id.m_fleet);
+	SnapshotStream::writeValue(r_out, m_source_id.m_index);
+	SnapshotStream::writeValue(r_out, m_creation_time);
+	SnapshotStream::writeValue(r_out, m_is_dead);
+}
+
+bool Bullet :: readState (std::istream& r_in)
+{
+	if(!PhysicsObject::readState(r_in))
+		return false;
+
+	PhysicsObjectId source_id;
+	double creation_time;
+	bool is_dead;
+
+	if(!SnapshotStream::readValue(r_in, source_id.m_type)  ||
+	   !SnapshotStream::readValue(r_in, source_id.m_fleet) ||
+	   !SnapshotStream::readValue(r_in, source_id.m_index) ||
+	   !SnapshotStream::readValue(r_in, creation_time)     ||
+	   !SnapshotStream::readValue(r_in, is_dead))
+	{
+		return false;
+	}
+
+	m_source_id     = source_id;
+	m_creation_time = creation_time;
+	m_is_dead       = is_dead;
+	return true;
+}
+
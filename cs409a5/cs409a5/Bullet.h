@@ -11,6 +11,7 @@
 #include "PhysicsObject.h"
 
 class DisplayList;
+class PseudorandomGenerator;
 
 class WorldInterface;
 
@@ -181,11 +182,13 @@ public:
 //
 //  Purpose: To modifiy this Bullet to have just been fired from
 //           the specified position by the specified source with
-//           the specified velocity.
+//           the specified velocity, choosing its spin with the
+//           specified PseudorandomGenerator.
 //  Parameter(s):
 //    <1> position: The new position this Bullet was fired from
 //    <2> forward: The direction this Bullet was fired in
 //    <3> source_id: The id for the source that fired this Bullet
+//    <4> r_random: The PseudorandomGenerator to use
 //  Precondition(s):
 //    <1> forward.isNormal()
 //  Returns: N/A
@@ -193,12 +196,17 @@ public:
 //               and moving in direction forward with speed
 //               SPEED.  It is marked as fired from the source
 //               with id source_id and has a creation time of
-//               the current time.
+//               the current time.  Its previous position is
+//               also set to position, so it is not treated as
+//               having moved there from where it was before.
+//               Its up vector is chosen using r_random, so the
+//               result is repeatable.
 //
 
 	void fire (const Vector3& position,
 	           const Vector3& forward,
-	           const PhysicsObjectId& source_id);
+	           const PhysicsObjectId& source_id,
+	           PseudorandomGenerator& r_random);
 
 //
 //  setSourceId
@@ -328,6 +336,40 @@ public:
 
 	virtual void update (WorldInterface& r_world);
 
+//
+//  writeState
+//
+//  Purpose: To write the state of this Bullet to the specified
+//           binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s):
+//    <1> r_out was opened in binary mode
+//  Returns: N/A
+//  Side Effect: The PhysicsObject state of this Bullet is
+//               written to r_out, followed by its source id,
+//               creation time, and whether it is dead.
+//
+
+	virtual void writeState (std::ostream& r_out) const;
+
+//
+//  readState
+//
+//  Purpose: To set this Bullet to the state read from the
+//           specified binary stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s):
+//    <1> r_in was opened in binary mode
+//  Returns: Whether a valid state was read.
+//  Side Effect: A state written by writeState is read from
+//               r_in.  If it is valid, this Bullet is set to
+//               have that state.
+//
+
+	virtual bool readState (std::istream& r_in);
+
 private:
 	PhysicsObjectId m_source_id;
 	double m_creation_time;
@@ -0,0 +1,477 @@
+//
+//  CollisionSystemGrid.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <unordered_map>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "PhysicsObjectId.h"
+#include "CollisionSystemInterface.h"
+#include "CollisionSystemGrid.h"
+
+using namespace std;
+namespace
+{
+	const unsigned int      CELL_KEY_BITS = 21;
+	const unsigned long long CELL_KEY_MASK = (1ull << CELL_KEY_BITS) - 1;
+
+	//
+	//  AppendId
+	//  VisitId
+	//  AppendPair
+	//
+	//  Function objects to pass to forEachCollision to add each
+	//    result to a vector of ids, pass it to a Visitor, or add
+	//    it to a vector of CollisionPairs.
+	//
+
+	struct AppendId
+	{
+		vector<PhysicsObjectId>& mr_results;
+
+		void operator() (const PhysicsObjectId& id)
+		{	mr_results.push_back(id);	}
+	};
+
+	struct VisitId
+	{
+		CollisionSystemInterface::Visitor& mr_visitor;
+
+		void operator() (const PhysicsObjectId& id)
+		{	mr_visitor.visit(id);	}
+	};
+
+	struct AppendPair
+	{
+		vector<CollisionSystemInterface::CollisionPair>& mr_results;
+		unsigned int m_query;
+
+		void operator() (const PhysicsObjectId& id)
+		{
+			CollisionSystemInterface::CollisionPair pair = { m_query, id };
+			mr_results.push_back(pair);
+		}
+	};
+}
+
+
+
+const double CollisionSystemGrid :: CELL_SIZE_DEFAULT = 100.0;
+
+
+
+CollisionSystemGrid :: CollisionSystemGrid ()
+		: m_cell_size(CELL_SIZE_DEFAULT),
+		  m_cell_size_inverse(1.0 / CELL_SIZE_DEFAULT),
+		  mv_objects(),
+		  m_object_indexes(),
+		  m_cells()
+{
+	assert(isEmpty());
+	assert(invariant());
+}
+
+CollisionSystemGrid :: CollisionSystemGrid (double cell_size)
+		: m_cell_size(cell_size),
+		  m_cell_size_inverse(1.0 / cell_size),
+		  mv_objects(),
+		  m_object_indexes(),
+		  m_cells()
+{
+	assert(cell_size > 0.0);
+
+	assert(isEmpty());
+	assert(invariant());
+}
+
+CollisionSystemGrid :: CollisionSystemGrid (const CollisionSystemGrid& original)
+		: m_cell_size(original.m_cell_size),
+		  m_cell_size_inverse(original.m_cell_size_inverse),
+		  mv_objects(original.mv_objects),
+		  m_object_indexes(original.m_object_indexes),
+		  m_cells(original.m_cells)
+{
+	assert(invariant());
+}
+
+CollisionSystemGrid :: ~CollisionSystemGrid ()
+{
+}
+
+CollisionSystemGrid& CollisionSystemGrid :: operator= (const CollisionSystemGrid& original)
+{
+	if(&original != this)
+	{
+		m_cell_size         = original.m_cell_size;
+		m_cell_size_inverse = original.m_cell_size_inverse;
+		mv_objects          = original.mv_objects;
+		m_object_indexes    = original.m_object_indexes;
+		m_cells             = original.m_cells;
+	}
+
+	assert(invariant());
+	return *this;
+}
+
+
+
+double CollisionSystemGrid :: getCellSize () const
+{
+	return m_cell_size;
+}
+
+unsigned int CollisionSystemGrid :: getObjectCount () const
+{
+	return (unsigned int)(mv_objects.size());
+}
+
+bool CollisionSystemGrid :: isObject (const PhysicsObjectId& id) const
+{
+	return m_object_indexes.find(id) != m_object_indexes.end();
+}
+
+bool CollisionSystemGrid :: isEmpty () const
+{
+	return mv_objects.empty();
+}
+
+vector<PhysicsObjectId> CollisionSystemGrid :: getCollisions (const Vector3& position) const
+{
+	vector<PhysicsObjectId> results;
+	appendCollisions(position, position, results);
+	return results;
+}
+
+vector<PhysicsObjectId> CollisionSystemGrid :: getCollisions (const Vector3& corner_min,
+                                                              const Vector3& corner_max) const
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	vector<PhysicsObjectId> results;
+	appendCollisions(corner_min, corner_max, results);
+	return results;
+}
+
+void CollisionSystemGrid :: appendCollisions (const Vector3& position,
+                                              vector<PhysicsObjectId>& r_results) const
+{
+	AppendId report = { r_results };
+	forEachCollision(position, position, report);
+}
+
+void CollisionSystemGrid :: appendCollisions (const Vector3& corner_min,
+                                              const Vector3& corner_max,
+                                              vector<PhysicsObjectId>& r_results) const
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	AppendId report = { r_results };
+	forEachCollision(corner_min, corner_max, report);
+}
+
+void CollisionSystemGrid :: visitCollisions (const Vector3& position,
+                                             Visitor& r_visitor) const
+{
+	VisitId report = { r_visitor };
+	forEachCollision(position, position, report);
+}
+
+void CollisionSystemGrid :: visitCollisions (const Vector3& corner_min,
+                                             const Vector3& corner_max,
+                                             Visitor& r_visitor) const
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	VisitId report = { r_visitor };
+	forEachCollision(corner_min, corner_max, report);
+}
+
+void CollisionSystemGrid :: appendCollisionsBatch (const Vector3 a_corner_min[],
+                                                   const Vector3 a_corner_max[],
+                                                   unsigned int query_count,
+                                                   vector<CollisionPair>& r_results) const
+{
+	assert(query_count == 0 || a_corner_min != NULL);
+	assert(query_count == 0 || a_corner_max != NULL);
+
+	AppendPair report = { r_results, 0 };
+	for(unsigned int i = 0; i < query_count; i++)
+	{
+		assert(a_corner_min[i].isAllComponentsLessThanOrEqual(a_corner_max[i]));
+
+		report.m_query = i;
+		forEachCollision(a_corner_min[i], a_corner_max[i], report);
+	}
+}
+
+CollisionSystemInterface* CollisionSystemGrid :: getClone () const
+{
+	return new CollisionSystemGrid(*this);
+}
+
+
+
+void CollisionSystemGrid :: add (const PhysicsObjectId& id,
+                                 const Vector3& position)
+{
+	move(id, position, position);
+}
+
+void CollisionSystemGrid :: add (const PhysicsObjectId& id,
+                                 const Vector3& corner_min,
+                                 const Vector3& corner_max)
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	move(id, corner_min, corner_max);
+}
+
+bool CollisionSystemGrid :: remove (const PhysicsObjectId& id,
+                                    const Vector3& /* position */)
+{
+	// we know where the object is, so the position is not needed
+	return removeById(id);
+}
+
+bool CollisionSystemGrid :: remove (const PhysicsObjectId& id,
+                                    const Vector3& corner_min,
+                                    const Vector3& corner_max)
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	// we know where the object is, so the cuboid is not needed
+	return removeById(id);
+}
+
+void CollisionSystemGrid :: removeAll ()
+{
+	mv_objects.clear();
+	m_object_indexes.clear();
+	m_cells.clear();
+
+	assert(isEmpty());
+	assert(invariant());
+}
+
+void CollisionSystemGrid :: move (const PhysicsObjectId& id,
+                                  const Vector3& position)
+{
+	move(id, position, position);
+}
+
+void CollisionSystemGrid :: move (const PhysicsObjectId& id,
+                                  const Vector3& corner_min,
+                                  const Vector3& corner_max)
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	CellRange cells = calculateCellRange(corner_min, corner_max);
+
+	unordered_map<unsigned int, unsigned int>::iterator found = m_object_indexes.find(id);
+	if(found == m_object_indexes.end())
+	{
+		// new object
+		unsigned int object_index = (unsigned int)(mv_objects.size());
+		ObjectRecord record = { id, corner_min, corner_max, cells };
+		mv_objects.push_back(record);
+		m_object_indexes[id] = object_index;
+		insertIntoCells(object_index, cells);
+	}
+	else
+	{
+		// existing object: only touch the grid if it changed cells
+		unsigned int object_index = found->second;
+		assert(object_index < mv_objects.size());
+		ObjectRecord& r_record = mv_objects[object_index];
+		if(!(r_record.m_cells == cells))
+		{
+			removeFromCells(object_index, r_record.m_cells);
+			insertIntoCells(object_index, cells);
+			r_record.m_cells = cells;
+		}
+		r_record.m_corner_min = corner_min;
+		r_record.m_corner_max = corner_max;
+	}
+
+	assert(isObject(id));
+	assert(invariant());
+}
+
+
+
+CollisionSystemGrid::CellRange CollisionSystemGrid :: calculateCellRange (const Vector3& corner_min,
+                                                                          const Vector3& corner_max) const
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	CellRange cells;
+	cells.m_min_x = (int)(floor(corner_min.x * m_cell_size_inverse));
+	cells.m_min_y = (int)(floor(corner_min.y * m_cell_size_inverse));
+	cells.m_min_z = (int)(floor(corner_min.z * m_cell_size_inverse));
+	cells.m_max_x = (int)(floor(corner_max.x * m_cell_size_inverse));
+	cells.m_max_y = (int)(floor(corner_max.y * m_cell_size_inverse));
+	cells.m_max_z = (int)(floor(corner_max.z * m_cell_size_inverse));
+	return cells;
+}
+
+CollisionSystemGrid::CellKey CollisionSystemGrid :: calculateCellKey (int x, int y, int z)
+{
+	// coordinates wrap around after 2^21 cells, which only
+	//  causes extra potential collisions, never missed ones
+	return  ((CellKey)(x) & CELL_KEY_MASK) |
+	       (((CellKey)(y) & CELL_KEY_MASK) <<  CELL_KEY_BITS) |
+	       (((CellKey)(z) & CELL_KEY_MASK) << (CELL_KEY_BITS * 2));
+}
+
+template <class ReportFunction>
+void CollisionSystemGrid :: forEachCollision (const Vector3& corner_min,
+                                              const Vector3& corner_max,
+                                              ReportFunction& r_report) const
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	CellRange query = calculateCellRange(corner_min, corner_max);
+
+	double cell_count = (query.m_max_x - query.m_min_x + 1.0) *
+	                    (query.m_max_y - query.m_min_y + 1.0) *
+	                    (query.m_max_z - query.m_min_z + 1.0);
+	if(cell_count > mv_objects.size())
+	{
+		// a huge query: checking every object is faster
+		for(unsigned int i = 0; i < mv_objects.size(); i++)
+		{
+			const ObjectRecord& record = mv_objects[i];
+			if(record.m_corner_min.isAllComponentsLessThanOrEqual(corner_max) &&
+			   corner_min.isAllComponentsLessThanOrEqual(record.m_corner_max))
+			{
+				r_report(record.m_id);
+			}
+		}
+		return;
+	}
+
+	for(int x = query.m_min_x; x <= query.m_max_x; x++)
+		for(int y = query.m_min_y; y <= query.m_max_y; y++)
+			for(int z = query.m_min_z; z <= query.m_max_z; z++)
+			{
+				unordered_map<CellKey, vector<unsigned int> >::const_iterator found =
+				                              m_cells.find(calculateCellKey(x, y, z));
+				if(found == m_cells.end())
+					continue;
+
+				const vector<unsigned int>& v_cell = found->second;
+				for(unsigned int i = 0; i < v_cell.size(); i++)
+				{
+					assert(v_cell[i] < mv_objects.size());
+					const ObjectRecord& record = mv_objects[v_cell[i]];
+
+					//
+					//  An object in several cells is only reported
+					//    from the first cell shared with the query.
+					//    This avoids duplicates without any
+					//    bookkeeping.
+					//
+
+					if(x != max(record.m_cells.m_min_x, query.m_min_x)) continue;
+					if(y != max(record.m_cells.m_min_y, query.m_min_y)) continue;
+					if(z != max(record.m_cells.m_min_z, query.m_min_z)) continue;
+
+					if(record.m_corner_min.isAllComponentsLessThanOrEqual(corner_max) &&
+					   corner_min.isAllComponentsLessThanOrEqual(record.m_corner_max))
+					{
+						r_report(record.m_id);
+					}
+				}
+			}
+}
+
+void CollisionSystemGrid :: insertIntoCells (unsigned int object_index,
+                                             const CellRange& cells)
+{
+	assert(object_index < mv_objects.size());
+
+	for(int x = cells.m_min_x; x <= cells.m_max_x; x++)
+		for(int y = cells.m_min_y; y <= cells.m_max_y; y++)
+			for(int z = cells.m_min_z; z <= cells.m_max_z; z++)
+				m_cells[calculateCellKey(x, y, z)].push_back(object_index);
+}
+
+void CollisionSystemGrid :: removeFromCells (unsigned int object_index,
+                                             const CellRange& cells)
+{
+	assert(object_index < mv_objects.size());
+
+	for(int x = cells.m_min_x; x <= cells.m_max_x; x++)
+		for(int y = cells.m_min_y; y <= cells.m_max_y; y++)
+			for(int z = cells.m_min_z; z <= cells.m_max_z; z++)
+			{
+				unordered_map<CellKey, vector<unsigned int> >::iterator found =
+				                              m_cells.find(calculateCellKey(x, y, z));
+				assert(found != m_cells.end());
+
+				vector<unsigned int>& rv_cell = found->second;
+				for(unsigned int i = 0; i < rv_cell.size(); i++)
+					if(rv_cell[i] == object_index)
+					{
+						rv_cell[i] = rv_cell.back();
+						rv_cell.pop_back();
+						break;
+					}
+
+				if(rv_cell.empty())
+					m_cells.erase(found);
+			}
+}
+
+bool CollisionSystemGrid :: removeById (const PhysicsObjectId& id)
+{
+	unordered_map<unsigned int, unsigned int>::iterator found = m_object_indexes.find(id);
+	if(found == m_object_indexes.end())
+		return false;  // we didn't find the object
+
+	unsigned int object_index = found->second;
+	unsigned int last_index   = (unsigned int)(mv_objects.size() - 1);
+	assert(object_index <= last_index);
+
+	removeFromCells(object_index, mv_objects[object_index].m_cells);
+	m_object_indexes.erase(found);
+
+	if(object_index != last_index)
+	{
+		// move the last object into the freed slot
+		const ObjectRecord& last = mv_objects[last_index];
+		const CellRange& cells = last.m_cells;
+		for(int x = cells.m_min_x; x <= cells.m_max_x; x++)
+			for(int y = cells.m_min_y; y <= cells.m_max_y; y++)
+				for(int z = cells.m_min_z; z <= cells.m_max_z; z++)
+				{
+					vector<unsigned int>& rv_cell = m_cells[calculateCellKey(x, y, z)];
+					for(unsigned int i = 0; i < rv_cell.size(); i++)
+						if(rv_cell[i] == last_index)
+						{
+							rv_cell[i] = object_index;
+							break;
+						}
+				}
+
+		m_object_indexes[last.m_id] = object_index;
+		mv_objects[object_index] = last;
+	}
+	mv_objects.pop_back();
+
+	assert(!isObject(id));
+	assert(invariant());
+	return true;
+}
+
+bool CollisionSystemGrid :: invariant () const
+{
+	if(m_cell_size <= 0.0) return false;
+	if(m_cell_size_inverse != 1.0 / m_cell_size) return false;
+	if(m_object_indexes.size() != mv_objects.size()) return false;
+	return true;
+}
@@ -0,0 +1,678 @@
+//
+//  CollisionSystemGrid.h
+//
+//  A class that implements the CollisionSystemInterface
+//    interface using a hashed uniform grid.
+//
+
+#ifndef COLLISION_SYSTEM_GRID_H
+#define COLLISION_SYSTEM_GRID_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "PhysicsObjectId.h"
+#include "CollisionSystemInterface.h"
+
+
+
+//
+//  CollisionSystemGrid
+//
+//  A class that implements the CollisionSystemInterface
+//    interface using a uniform grid of cubic cells.  Only the
+//    cells that contain objects are stored, in a hash table
+//    keyed by the cell coordinates, so the grid is unbounded.
+//    Each object is recorded in every cell its bounding cuboid
+//    overlaps.  A query only examines the cells overlapped by
+//    the query cuboid, so the cost of a query depends on the
+//    number of objects nearby, not on the total number of
+//    objects.
+//
+//  Queries never report the same object twice, and only report
+//    objects whose bounding cuboids overlap the query cuboid.
+//    Touching counts as overlapping.
+//
+//  Each id may only be associated with one object at a time.
+//    Adding an object with an id that is already present moves
+//    the existing object instead.  The move functions can be
+//    used to update an object each frame.  If the object stays
+//    in the same cells, moving it does not change the grid.
+//
+//  Class Invariant:
+//    <1> m_cell_size > 0.0
+//    <2> m_cell_size_inverse == 1.0 / m_cell_size
+//    <3> m_object_indexes.size() == mv_objects.size()
+//
+
+class CollisionSystemGrid : public CollisionSystemInterface
+{
+public:
+//
+//  CELL_SIZE_DEFAULT
+//
+//  The side length of a grid cell for a CollisionSystemGrid
+//    created with the default constructor.
+//
+
+	static const double CELL_SIZE_DEFAULT;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a CollisionSystemGrid containing no
+//           objects.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new CollisionSystemGrid is created with cells
+//               of size CELL_SIZE_DEFAULT.  No objects are
+//               added.
+//
+
+	CollisionSystemGrid ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a CollisionSystemGrid containing no
+//           objects with the specified cell size.
+//  Parameter(s):
+//    <1> cell_size: The side length of a grid cell
+//  Precondition(s):
+//    <1> cell_size > 0.0
+//  Returns: N/A
+//  Side Effect: A new CollisionSystemGrid is created with cells
+//               of size cell_size.  No objects are added.
+//
+
+	CollisionSystemGrid (double cell_size);
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create a CollisionSystemGrid containing the
+//           same objects as another.
+//  Parameter(s):
+//    <1> original: The CollisionSystemGrid to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new CollisionSystemGrid is created.  A copy
+//               of each object in original is added.
+//
+
+	CollisionSystemGrid (const CollisionSystemGrid& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy a CollisionSystemGrid without
+//           memory leaks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All dynamically allocated memory associated
+//               with this CollisionSystemGrid is freed.
+//
+
+	virtual ~CollisionSystemGrid ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To modify this a CollisionSystemGrid to contain
+//           the same objects as another.
+//  Parameter(s):
+//    <1> original: The CollisionSystemGrid to copy
+//  Precondition(s): N/A
+//  Returns: A reference to this CollisionSystemGrid.
+//  Side Effect: This CollisionSystemGrid is set to contian a
+//               copy of each object in original.  Any existing
+//               objects are removed.
+//
+
+	CollisionSystemGrid& operator= (
+	                       const CollisionSystemGrid& original);
+
+//
+//  getCellSize
+//
+//  Purpose: To determine the side length of the cells in this
+//           CollisionSystemGrid.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The cell side length.
+//  Side Effect: N/A
+//
+
+	double getCellSize () const;
+
+//
+//  getObjectCount
+//
+//  Purpose: To determine the number of objects in this
+//           CollisionSystemGrid.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of objects.
+//  Side Effect: N/A
+//
+
+	unsigned int getObjectCount () const;
+
+//
+//  isObject
+//
+//  Purpose: To determine if there is an object with the
+//           specified id in this CollisionSystemGrid.
+//  Parameter(s):
+//    <1> id: The id to check for
+//  Precondition(s): N/A
+//  Returns: Whether there is an object with id id.
+//  Side Effect: N/A
+//
+
+	bool isObject (const PhysicsObjectId& id) const;
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if there are any objects in this
+//           CollisionSystem.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: true if this CollisionSystem contians no objects.
+//           false if there is 1 or more objects.
+//  Side Effect: N/A
+//
+
+	virtual bool isEmpty () const;
+
+//
+//  getCollisions
+//
+//  Purpose: To determine all pontential collisions at the
+//           specified position.
+//  Parameter(s):
+//    <1> position: The position to query
+//  Precondition(s): N/A
+//  Returns: A std::vector containing the ids for all the
+//           objects whose bounding cuboids contain position
+//           position.  The vector is not sorted and does not
+//           include duplicates.
+//  Side Effect: N/A
+//
+
+	virtual std::vector<PhysicsObjectId> getCollisions (
+	                             const Vector3& position) const;
+
+//
+//  getCollisions
+//
+//  Purpose: To determine all pontential collisions in the
+//           specified axis-aligned cuboid.
+//  Parameter(s):
+//    <1> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <2> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: A std::vector containing the ids for all the
+//           objects whose bounding cuboids overlap the cuboid
+//           from corner_min to corner_max.  The vector is not
+//           sorted and does not include duplicates.
+//  Side Effect: N/A
+//
+
+	virtual std::vector<PhysicsObjectId> getCollisions (
+	                           const Vector3& corner_min,
+	                           const Vector3& corner_max) const;
+
+//
+//  appendCollisions
+//
+//  Purpose: To add all pontential collisions at the specified
+//           position to the specified vector.
+//  Parameter(s):
+//    <1> position: The position to query
+//    <2> r_results: The vector to add to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The ids for all the objects whose bounding
+//               cuboids contain position position are added to
+//               the end of r_results, each exactly once.
+//
+
+	virtual void appendCollisions (
+	                   const Vector3& position,
+	                   std::vector<PhysicsObjectId>& r_results) const;
+
+//
+//  appendCollisions
+//
+//  Purpose: To add all pontential collisions in the specified
+//           axis-aligned cuboid to the specified vector.
+//  Parameter(s):
+//    <1> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <2> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//    <3> r_results: The vector to add to
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: N/A
+//  Side Effect: The ids for all the objects whose bounding
+//               cuboids overlap the cuboid from corner_min to
+//               corner_max are added to the end of r_results,
+//               each exactly once.
+//
+
+	virtual void appendCollisions (
+	                   const Vector3& corner_min,
+	                   const Vector3& corner_max,
+	                   std::vector<PhysicsObjectId>& r_results) const;
+
+//
+//  visitCollisions
+//
+//  Purpose: To pass all pontential collisions at the specified
+//           position to the specified Visitor.
+//  Parameter(s):
+//    <1> position: The position to query
+//    <2> r_visitor: The Visitor to pass the results to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: r_visitor.visit is called once with the id of
+//               each object whose bounding cuboid contains
+//               position position.
+//
+
+	virtual void visitCollisions (const Vector3& position,
+	                              Visitor& r_visitor) const;
+
+//
+//  visitCollisions
+//
+//  Purpose: To pass all pontential collisions in the specified
+//           axis-aligned cuboid to the specified Visitor.
+//  Parameter(s):
+//    <1> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <2> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//    <3> r_visitor: The Visitor to pass the results to
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: N/A
+//  Side Effect: r_visitor.visit is called once with the id of
+//               each object whose bounding cuboid overlaps the
+//               cuboid from corner_min to corner_max.
+//
+
+	virtual void visitCollisions (const Vector3& corner_min,
+	                              const Vector3& corner_max,
+	                              Visitor& r_visitor) const;
+
+//
+//  appendCollisionsBatch
+//
+//  Purpose: To determine all pontential collisions in each of
+//           the specified axis-aligned cuboids.
+//  Parameter(s):
+//    <1> a_corner_min: An array of the corners of the cuboids
+//                      with the minimum value for each
+//                      coordinate
+//    <2> a_corner_max: An array of the corners of the cuboids
+//                      with the maximum value for each
+//                      coordinate
+//    <3> query_count: The number of cuboids
+//    <4> r_results: The vector to add the results to
+//  Precondition(s):
+//    <1> a_corner_min and a_corner_max each contain at least
+//        query_count elements
+//    <2> a_corner_min[i].isAllComponentsLessThanOrEqual(
+//        a_corner_max[i]) for all i < query_count
+//  Returns: N/A
+//  Side Effect: For each query i, a CollisionPair with query
+//               index i is added to the end of r_results for
+//               each object whose bounding cuboid overlaps the
+//               cuboid from a_corner_min[i] to a_corner_max[i].
+//               The pairs are added in increasing order of
+//               query index.
+//
+
+	virtual void appendCollisionsBatch (
+	                   const Vector3 a_corner_min[],
+	                   const Vector3 a_corner_max[],
+	                   unsigned int query_count,
+	                   std::vector<CollisionPair>& r_results) const;
+
+//
+//  getClone
+//
+//  Purpose: To create a dynamically-allocated copy of this
+//           CollisionSystemInterface.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pointer to a dynamically-allocated deep copy of
+//           this CollisionSystemInterface.
+//  Side Effect: N/A
+//
+
+	virtual CollisionSystemInterface* getClone () const;
+
+//
+//  add
+//
+//  Purpose: To add a point object with the specified id at the
+//           specified position.
+//  Parameter(s):
+//    <1> id: The id for the object
+//    <2> position: The position for the object
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A point-sized object with id id is added
+//               at position position.  If there was already an
+//               object with id id, it is moved instead.
+//
+
+	virtual void add (const PhysicsObjectId& id,
+	                  const Vector3& position);
+
+//
+//  add
+//
+//  Purpose: To add an object with the specified id occupying
+//           the specified axis-aligned cuboid.
+//  Parameter(s):
+//    <1> id: The id for the object
+//    <2> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <3> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: N/A
+//  Side Effect: An object with id id is added covering the
+//               axis-aligned cuboid from corner_min to
+//               corner_max.  If there was already an object
+//               with id id, it is moved instead.
+//
+
+	virtual void add (const PhysicsObjectId& id,
+	                  const Vector3& corner_min,
+	                  const Vector3& corner_max);
+
+//
+//  remove
+//
+//  Purpose: To remove a point object with the specified id that
+//           is at the specified position.
+//  Parameter(s):
+//    <1> id: The id for the object
+//    <2> position: The position for the object
+//  Precondition(s): N/A
+//  Returns: Whether the object was removed.
+//  Side Effect: If there is an object with id id, it is
+//               removed, wherever it is.  Otherwise, there is
+//               no effect.
+//
+
+	virtual bool remove (const PhysicsObjectId& id,
+	                     const Vector3& position);
+
+//
+//  remove
+//
+//  Purpose: To remove an object with the specified id occupying
+//           the specified axis-aligned cuboid.
+//  Parameter(s):
+//    <1> id: The id for the object
+//    <2> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <3> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: Whether the object was removed.
+//  Side Effect: If there is an object with id id, it is
+//               removed, wherever it is.  Otherwise, there is
+//               no effect.
+//
+
+	virtual bool remove (const PhysicsObjectId& id,
+	                     const Vector3& corner_min,
+	                     const Vector3& corner_max);
+
+//
+//  removeAll
+//
+//  Purpose: To remove all objects from this CollisionSystem.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All iobjects are removed.
+//
+
+	virtual void removeAll ();
+
+//
+//  move
+//
+//  Purpose: To move the point object with the specified id to
+//           the specified position.
+//  Parameter(s):
+//    <1> id: The id for the object
+//    <2> position: The new position for the object
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The object with id id is set to be a point at
+//               position position.  If there was no object with
+//               id id, one is added.  The grid cells are only
+//               updated if the object changed cells.
+//
+
+	void move (const PhysicsObjectId& id,
+	           const Vector3& position);
+
+//
+//  move
+//
+//  Purpose: To move the object with the specified id to cover
+//           the specified axis-aligned cuboid.
+//  Parameter(s):
+//    <1> id: The id for the object
+//    <2> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <3> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: N/A
+//  Side Effect: The object with id id is set to cover the
+//               cuboid from corner_min to corner_max.  If there
+//               was no object with id id, one is added.  The
+//               grid cells are only updated if the object
+//               changed cells.
+//
+
+	void move (const PhysicsObjectId& id,
+	           const Vector3& corner_min,
+	           const Vector3& corner_max);
+
+private:
+//
+//  CellRange
+//
+//  A record to represent the block of grid cells overlapped by
+//    a cuboid.  The minimum and maximum values are both
+//    included.
+//
+
+	struct CellRange
+	{
+		int m_min_x;
+		int m_min_y;
+		int m_min_z;
+		int m_max_x;
+		int m_max_y;
+		int m_max_z;
+
+		bool operator== (const CellRange& other) const
+		{
+			return m_min_x == other.m_min_x &&
+			       m_min_y == other.m_min_y &&
+			       m_min_z == other.m_min_z &&
+			       m_max_x == other.m_max_x &&
+			       m_max_y == other.m_max_y &&
+			       m_max_z == other.m_max_z;
+		}
+	};
+
+//
+//  ObjectRecord
+//
+//  A record to represent an object in the grid.  Each object
+//    has an id, a bounding cuboid, and the block of cells it is
+//    recorded in.
+//
+
+	struct ObjectRecord
+	{
+		PhysicsObjectId m_id;
+		Vector3 m_corner_min;
+		Vector3 m_corner_max;
+		CellRange m_cells;
+	};
+
+//
+//  CellKey
+//
+//  The type used to identify a grid cell in the hash table.
+//    The 3 cell coordinates are each packed into 21 bits.
+//
+
+	typedef unsigned long long CellKey;
+
+private:
+//
+//  calculateCellRange
+//
+//  Purpose: To determine the block of cells overlapped by the
+//           specified cuboid.
+//  Parameter(s):
+//    <1> corner_min: The minimum corner of the cuboid
+//    <2> corner_max: The maximum corner of the cuboid
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: The cells overlapped by the cuboid.
+//  Side Effect: N/A
+//
+
+	CellRange calculateCellRange (const Vector3& corner_min,
+	                              const Vector3& corner_max) const;
+
+//
+//  calculateCellKey
+//
+//  Purpose: To determine the hash table key for the cell with
+//           the specified coordinates.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The cell coordinates
+//  Precondition(s): N/A
+//  Returns: The key for cell (x, y, z).
+//  Side Effect: N/A
+//
+
+	static CellKey calculateCellKey (int x, int y, int z);
+
+//
+//  forEachCollision
+//
+//  Purpose: To report each object overlapping the specified
+//           cuboid to the specified function object.
+//  Parameter(s):
+//    <1> corner_min: The minimum corner of the cuboid
+//    <2> corner_max: The maximum corner of the cuboid
+//    <3> r_report: The function object to call
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: N/A
+//  Side Effect: r_report is called with the id of each object
+//               overlapping the cuboid from corner_min to
+//               corner_max exactly once.
+//
+//  This is only defined in CollisionSystemGrid.cpp, where all
+//    the query functions are implemented with it.
+//
+
+	template <class ReportFunction>
+	void forEachCollision (const Vector3& corner_min,
+	                       const Vector3& corner_max,
+	                       ReportFunction& r_report) const;
+
+//
+//  insertIntoCells
+//  removeFromCells
+//
+//  Purpose: To add/remove the specified object index to/from
+//           each cell in the specified block.
+//  Parameter(s):
+//    <1> object_index: The index in mv_objects
+//    <2> cells: The block of cells
+//  Precondition(s):
+//    <1> object_index < mv_objects.size()
+//  Returns: N/A
+//  Side Effect: object_index is added to or removed from each
+//               cell in cells.  Empty cells are discarded.
+//
+
+	void insertIntoCells (unsigned int object_index,
+	                      const CellRange& cells);
+	void removeFromCells (unsigned int object_index,
+	                      const CellRange& cells);
+
+//
+//  removeById
+//
+//  Purpose: To remove the object with the specified id.
+//  Parameter(s):
+//    <1> id: The id of the object to remove
+//  Precondition(s): N/A
+//  Returns: Whether an object was removed.
+//  Side Effect: If there is an object with id id, it is
+//               removed.  The last object in mv_objects is
+//               moved into the freed slot.
+//
+
+	bool removeById (const PhysicsObjectId& id);
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	double m_cell_size;
+	double m_cell_size_inverse;
+	std::vector<ObjectRecord> mv_objects;
+	std::unordered_map<unsigned int, unsigned int> m_object_indexes;
+	std::unordered_map<CellKey, std::vector<unsigned int> > m_cells;
+};
+
+
+
+#endif
@@ -61,6 +61,59 @@ vector<PhysicsObjectId> CollisionSystemLinear :: getCollisions (const Vector3& c
 	return mv_objects;
 }
 
+void CollisionSystemLinear :: appendCollisions (const Vector3& position,
+                                                vector<PhysicsObjectId>& r_results) const
+{
+	r_results.insert(r_results.end(), mv_objects.begin(), mv_objects.end());
+}
+
+void CollisionSystemLinear :: appendCollisions (const Vector3& corner_min,
+                                                const Vector3& corner_max,
+                                                vector<PhysicsObjectId>& r_results) const
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	r_results.insert(r_results.end(), mv_objects.begin(), mv_objects.end());
+}
+
+void CollisionSystemLinear :: visitCollisions (const Vector3& position,
+                                               Visitor& r_visitor) const
+{
+	for(unsigned int i = 0; i < mv_objects.size(); i++)
+		r_visitor.visit(mv_objects[i]);
+}
+
+void CollisionSystemLinear :: visitCollisions (const Vector3& corner_min,
+                                               const Vector3& corner_max,
+                                               Visitor& r_visitor) const
+{
+	assert(corner_min.isAllComponentsLessThanOrEqual(corner_max));
+
+	for(unsigned int i = 0; i < mv_objects.size(); i++)
+		r_visitor.visit(mv_objects[i]);
+}
+
+void CollisionSystemLinear :: appendCollisionsBatch (const Vector3 a_corner_min[],
+                                                     const Vector3 a_corner_max[],
+                                                     unsigned int query_count,
+                                                     vector<CollisionPair>& r_results) const
+{
+	assert(query_count == 0 || a_corner_min != NULL);
+	assert(query_count == 0 || a_corner_max != NULL);
+
+	r_results.reserve(r_results.size() + query_count * mv_objects.size());
+	for(unsigned int q = 0; q < query_count; q++)
+	{
+		assert(a_corner_min[q].isAllComponentsLessThanOrEqual(a_corner_max[q]));
+
+		for(unsigned int i = 0; i < mv_objects.size(); i++)
+		{
+			CollisionPair pair = { q, mv_objects[i] };
+			r_results.push_back(pair);
+		}
+	}
+}
+
 CollisionSystemInterface* CollisionSystemLinear :: getClone () const
 {
 	return new CollisionSystemLinear(*this);
@@ -146,6 +146,117 @@ public:
 	                           const Vector3& corner_min,
 	                           const Vector3& corner_max) const;
 
+//
+//  appendCollisions
+//
+//  Purpose: To add all pontential collisions at the specified
+//           position to the specified vector.
+//  Parameter(s):
+//    <1> position: The position to query
+//    <2> r_results: The vector to add to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The ids for all the objects are added to the
+//               end of r_results.
+//
+
+	virtual void appendCollisions (
+	                   const Vector3& position,
+	                   std::vector<PhysicsObjectId>& r_results) const;
+
+//
+//  appendCollisions
+//
+//  Purpose: To add all pontential collisions in the specified
+//           axis-aligned cuboid to the specified vector.
+//  Parameter(s):
+//    <1> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <2> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//    <3> r_results: The vector to add to
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: N/A
+//  Side Effect: The ids for all the objects are added to the
+//               end of r_results.
+//
+
+	virtual void appendCollisions (
+	                   const Vector3& corner_min,
+	                   const Vector3& corner_max,
+	                   std::vector<PhysicsObjectId>& r_results) const;
+
+//
+//  visitCollisions
+//
+//  Purpose: To pass all pontential collisions at the specified
+//           position to the specified Visitor.
+//  Parameter(s):
+//    <1> position: The position to query
+//    <2> r_visitor: The Visitor to pass the results to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: r_visitor.visit is called with the id of each
+//               object.
+//
+
+	virtual void visitCollisions (const Vector3& position,
+	                              Visitor& r_visitor) const;
+
+//
+//  visitCollisions
+//
+//  Purpose: To pass all pontential collisions in the specified
+//           axis-aligned cuboid to the specified Visitor.
+//  Parameter(s):
+//    <1> corner_min: The corner of the cuboid with the minimum
+//                    value for each coordinate
+//    <2> corner_max: The corner of the cuboid with the maximum
+//                    value for each coordinate
+//    <3> r_visitor: The Visitor to pass the results to
+//  Precondition(s):
+//    <1> corner_min.isAllComponentsLessThanOrEqual(corner_max)
+//  Returns: N/A
+//  Side Effect: r_visitor.visit is called with the id of each
+//               object.
+//
+
+	virtual void visitCollisions (const Vector3& corner_min,
+	                              const Vector3& corner_max,
+	                              Visitor& r_visitor) const;
+
+//
+//  appendCollisionsBatch
+//
+//  Purpose: To determine all pontential collisions in each of
+//           the specified axis-aligned cuboids.
+//  Parameter(s):
+//    <1> a_corner_min: An array of the corners of the cuboids
+//                      with the minimum value for each
+//                      coordinate
+//    <2> a_corner_max: An array of the corners of the cuboids
+//                      with the maximum value for each
+//                      coordinate
+//    <3> query_count: The number of cuboids
+//    <4> r_results: The vector to add the results to
+//  Precondition(s):
+//    <1> a_corner_min and a_corner_max each contain at least
+//        query_count elements
+//    <2> a_corner_min[i].isAllComponentsLessThanOrEqual(
+//        a_corner_max[i]) for all i < query_count
+//  Returns: N/A
+//  Side Effect: For each query i, in increasing order, a
+//               CollisionPair with query index i is added to
+//               the end of r_results for each object.
+//
+
+	virtual void appendCollisionsBatch (
+	                   const Vector3 a_corner_min[],
+	                   const Vector3 a_corner_max[],
+	                   unsigned int query_count,
+	                   std::vector<CollisionPair>& r_results) const;
+
 //
 //  getClone
 //
@@ -2,13 +2,19 @@
 //  CoordinateSystem.cpp
 //
 
+#include <cassert>
+#include <cmath>
+
 #include "GetGlut.h"
 
 #include "Pi.h"
 #include "../../ObjLibrary/Vector3.h"
 
+#include "Quaternion.h"
 #include "CoordinateSystem.h"
 
+using namespace std;
+
 //
 //  There has got to be a better way to ensure that the default
 //    value constants are initialized correctly.  For now,
@@ -29,6 +35,7 @@ const Vector3 CoordinateSystem :: RIGHT_DEFAULT    = Vector3( 1.0,  0.0,  0.0);
 
 CoordinateSystem :: CoordinateSystem ()
 		: m_position(POSITION_DEFAULT_MACRO),
+		  m_orientation(),
 		  m_forward(FORWARD_DEFAULT_MACRO),
 		  m_up     (UP_DEFAULT_MACRO)
 {
@@ -37,6 +44,7 @@ CoordinateSystem :: CoordinateSystem ()
 
 CoordinateSystem :: CoordinateSystem (const Vector3& position)
 		: m_position(position),
+		  m_orientation(),
 		  m_forward(FORWARD_DEFAULT_MACRO),
 		  m_up     (UP_DEFAULT_MACRO)
 {
@@ -46,11 +54,13 @@ CoordinateSystem :: CoordinateSystem (const Vector3& position)
 CoordinateSystem :: CoordinateSystem (const Vector3& position,
 	                                  const Vector3& forward)
 		: m_position(position),
-		  m_forward(forward),
-		  m_up     (calculateUp(forward))
+		  m_orientation(calculateOrientation(forward, calculateUp(forward))),
+		  m_forward(),
+		  m_up     ()
 {
 	assert(forward.isNormal());
 
+	updateAxes();
 	assert(invariant());
 }
 
@@ -58,13 +68,15 @@ CoordinateSystem :: CoordinateSystem (const Vector3& position,
 	                                  const Vector3& forward,
 	                                  const Vector3& up)
 		: m_position(position),
-		  m_forward(forward),
-		  m_up     (up)
+		  m_orientation(calculateOrientation(forward, up)),
+		  m_forward(),
+		  m_up     ()
 {
 	assert(forward.isNormal());
 	assert(up.isNormal());
 	assert(forward.isOrthogonal(up));
 
+	updateAxes();
 	assert(invariant());
 }
 
@@ -89,6 +101,11 @@ Vector3 CoordinateSystem :: getRight () const
 	return m_forward.crossProduct(m_up);
 }
 
+const Quaternion& CoordinateSystem :: getOrientation () const
+{
+	return m_orientation;
+}
+
 void CoordinateSystem :: setupCamera () const
 {
 	Vector3 look_at = m_position + m_forward;
@@ -129,18 +146,20 @@ void CoordinateSystem :: setupOrientationMatrix () const
 
 void CoordinateSystem :: init ()
 {
-	m_position = POSITION_DEFAULT_MACRO;
-	m_forward  = FORWARD_DEFAULT_MACRO;
-	m_up       = UP_DEFAULT_MACRO;
+	m_position    = POSITION_DEFAULT_MACRO;
+	m_orientation = Quaternion::IDENTITY;
+	m_forward     = FORWARD_DEFAULT_MACRO;
+	m_up          = UP_DEFAULT_MACRO;
 
 	assert(invariant());
 }
 
 void CoordinateSystem :: init (const Vector3& position)
 {
-	m_position = position;
-	m_forward  = FORWARD_DEFAULT_MACRO;
-	m_up       = UP_DEFAULT_MACRO;
+	m_position    = position;
+	m_orientation = Quaternion::IDENTITY;
+	m_forward     = FORWARD_DEFAULT_MACRO;
+	m_up          = UP_DEFAULT_MACRO;
 
 	assert(invariant());
 }
@@ -150,9 +169,9 @@ void CoordinateSystem :: init (const Vector3& position,
 {
 	assert(forward.isNormal());
 
-	m_position = position;
-	m_forward  = forward;
-	m_up       = calculateUp(forward);
+	m_position    = position;
+	m_orientation = calculateOrientation(forward, calculateUp(forward));
+	updateAxes();
 
 	assert(invariant());
 }
@@ -165,9 +184,9 @@ void CoordinateSystem :: init (const Vector3& position,
 	assert(up.isNormal());
 	assert(forward.isOrthogonal(up));
 
-	m_position = position;
-	m_forward  = forward;
-	m_up       = up;
+	m_position    = position;
+	m_orientation = calculateOrientation(forward, up);
+	updateAxes();
 
 	assert(invariant());
 }
@@ -190,8 +209,8 @@ void CoordinateSystem :: setOrientation (const Vector3& forward)
 {
 	assert(forward.isNormal());
 
-	m_forward  = forward;
-	m_up       = calculateUp(forward);
+	m_orientation = calculateOrientation(forward, calculateUp(forward));
+	updateAxes();
 
 	assert(invariant());
 }
@@ -203,8 +222,20 @@ void CoordinateSystem :: setOrientation (const Vector3& forward,
 	assert(up.isNormal());
 	assert(forward.isOrthogonal(up));
 
-	m_forward  = forward;
-	m_up       = up;
+	m_orientation = calculateOrientation(forward, up);
+	updateAxes();
+
+	assert(invariant());
+}
+
+void CoordinateSystem :: setOrientation (const Quaternion& orientation)
+{
+	assert(orientation.isNormal());
+
+	// not renormalized, so an orientation read back from a
+	//  snapshot is exactly the one that was saved
+	m_orientation = orientation;
+	updateAxes();
 
 	assert(invariant());
 }
@@ -214,7 +245,8 @@ void CoordinateSystem :: setUp (const Vector3& up)
 	assert(up.isNormal());
 	assert(getForward().isOrthogonal(up));
 
-	m_up = up;
+	m_orientation = calculateOrientation(m_forward, up);
+	updateAxes();
 
 	assert(invariant());
 }
@@ -243,8 +275,7 @@ void CoordinateSystem :: moveRight (double distance)
 void CoordinateSystem :: rotateAroundForward (double radians)
 {
 	assert(m_forward.isNormal());
-	m_up.rotateArbitrary(m_forward, radians);
-	m_up.normalize();
+	applyRotation(Quaternion::getAxisAngle(m_forward, radians));
 
 	assert(invariant());
 }
@@ -252,8 +283,7 @@ void CoordinateSystem :: rotateAroundForward (double radians)
 void CoordinateSystem :: rotateAroundUp (double radians)
 {
 	assert(m_up.isNormal());
-	m_forward.rotateArbitrary(m_up, radians);
-	m_forward.normalize();
+	applyRotation(Quaternion::getAxisAngle(m_up, radians));
 
 	assert(invariant());
 }
@@ -262,10 +292,7 @@ void CoordinateSystem :: rotateAroundRight (double radians)
 {
 	Vector3 right = m_forward.crossProduct(m_up);
 	assert(right.isNormal());
-	m_forward.rotateArbitrary(right, radians);
-	m_up     .rotateArbitrary(right, radians);
-	m_forward.normalize();
-	m_up     .normalize();
+	applyRotation(Quaternion::getAxisAngle(right, radians));
 
 	assert(invariant());
 }
@@ -273,24 +300,55 @@ void CoordinateSystem :: rotateAroundRight (double radians)
 void CoordinateSystem :: rotateToVector (const Vector3& target,
                                          double max_radians)
 {
-	Vector3 axis = m_forward.crossProduct(target);
-	if(axis.isZero())
-		axis = m_up;
-	else
-		axis.normalize();
-	assert(axis.isNormal());
+	assert(!target.isZero());
+	assert(max_radians >= 0.0);
 
-	double radians = m_forward.getAngleSafe(target);
-	if(radians > max_radians)
-		radians = max_radians;
-	m_forward.rotateArbitrary(axis, radians);
-	m_up     .rotateArbitrary(axis, radians);
-	m_forward.normalize();
-	m_up     .normalize();
+	// turning more than half way around is never needed
+	if(max_radians > PI)
+		max_radians = PI;
+
+	applyRotation(calculateTurn(m_forward, m_up, target,
+	                            cos(max_radians * 0.5),
+	                            sin(max_radians * 0.5)));
 
 	assert(invariant());
 }
 
+void CoordinateSystem :: rotateToVectorBatch (CoordinateSystem* ap_systems[],
+                                              const Vector3 a_targets[],
+                                              const double a_max_radians[],
+                                              unsigned int count)
+{
+	assert(count == 0 || ap_systems    != NULL);
+	assert(count == 0 || a_targets     != NULL);
+	assert(count == 0 || a_max_radians != NULL);
+
+	double max_radians  = -1.0;  // not a valid limit, so the first is always calculated
+	double half_max_cos = 1.0;
+	double half_max_sin = 0.0;
+	for(unsigned int i = 0; i < count; i++)
+	{
+		assert(ap_systems[i] != NULL);
+		assert(!a_targets[i].isZero());
+		assert(a_max_radians[i] >= 0.0);
+
+		double limit = a_max_radians[i];
+		if(limit > PI)
+			limit = PI;
+		if(limit != max_radians)
+		{
+			max_radians  = limit;
+			half_max_cos = cos(max_radians * 0.5);
+			half_max_sin = sin(max_radians * 0.5);
+		}
+
+		CoordinateSystem& r_system = *(ap_systems[i]);
+		r_system.applyRotation(calculateTurn(r_system.m_forward, r_system.m_up, a_targets[i],
+		                                     half_max_cos, half_max_sin));
+		assert(r_system.invariant());
+	}
+}
+
 
 
 Vector3 CoordinateSystem :: calculateUp (const Vector3& forward)
@@ -310,8 +368,136 @@ Vector3 CoordinateSystem :: calculateUp (const Vector3& forward)
 	}
 }
 
+Quaternion CoordinateSystem :: calculateOrientation (const Vector3& forward,
+                                                     const Vector3& up)
+{
+	assert(forward.isNormal());
+	assert(up.isNormal());
+	assert(forward.isOrthogonal(up));
+
+	//
+	//  The rotation takes the default right, up, and backward
+	//    vectors, which are the x, y, and z axes, to the new
+	//    ones, so those are the columns of its matrix.  The
+	//    quaternion is found from the largest of its diagonal
+	//    and trace to avoid dividing by a small number.
+	//
+
+	Vector3 right    = forward.crossProduct(up);
+	Vector3 backward = -forward;
+	double trace = right.x + up.y + backward.z;
+
+	Quaternion result;
+	if(trace > 0.0)
+	{
+		double s = 2.0 * sqrt(trace + 1.0);
+		result = Quaternion(0.25 * s,
+		                    (up.z - backward.y) / s,
+		                    (backward.x - right.z) / s,
+		                    (right.y - up.x) / s);
+	}
+	else if(right.x > up.y && right.x > backward.z)
+	{
+		double s = 2.0 * sqrt(1.0 + right.x - up.y - backward.z);
+		result = Quaternion((up.z - backward.y) / s,
+		                    0.25 * s,
+		                    (up.x + right.y) / s,
+		                    (backward.x + right.z) / s);
+	}
+	else if(up.y > backward.z)
+	{
+		double s = 2.0 * sqrt(1.0 + up.y - right.x - backward.z);
+		result = Quaternion((backward.x - right.z) / s,
+		                    (up.x + right.y) / s,
+		                    0.25 * s,
+		                    (backward.y + up.z) / s);
+	}
+	else
+	{
+		double s = 2.0 * sqrt(1.0 + backward.z - right.x - up.y);
+		result = Quaternion((right.y - up.x) / s,
+		                    (backward.x + right.z) / s,
+		                    (backward.y + up.z) / s,
+		                    0.25 * s);
+	}
+	result.normalize();
+	return result;
+}
+
+Quaternion CoordinateSystem :: calculateTurn (const Vector3& forward,
+                                              const Vector3& up,
+                                              const Vector3& target,
+                                              double half_max_cos,
+                                              double half_max_sin)
+{
+	assert(forward.isNormal());
+	assert(up.isNormal());
+	assert(!target.isZero());
+
+	//
+	//  The shortest rotation from forward to target is
+	//    (1 + f.t, f x t), normalized, for unit vectors f and t.
+	//    This gives the half-angle sine and cosine directly, so
+	//    no inverse trigonometry is needed.  If the rotation
+	//    turns further than allowed, the part of the way that
+	//    can be turned, which slerp from the identity would give,
+	//    has the same axis and the limiting half-angle.
+	//
+
+	Vector3 direction = target.getNormalized();
+	Vector3 axis = forward.crossProduct(direction);
+
+	Quaternion turn;
+	if(axis.isZero())
+	{
+		if(forward.dotProduct(direction) >= 0.0)
+			return Quaternion::IDENTITY;
+
+		// exactly backwards: turn around the up vector
+		axis = up;
+		turn = Quaternion(0.0, up.x, up.y, up.z);
+	}
+	else
+	{
+		turn = Quaternion(1.0 + forward.dotProduct(direction),
+		                  axis.x, axis.y, axis.z);
+		turn.normalize();
+		axis.normalize();
+	}
+
+	if(turn.w < half_max_cos)
+	{
+		turn = Quaternion(half_max_cos,
+		                  axis.x * half_max_sin,
+		                  axis.y * half_max_sin,
+		                  axis.z * half_max_sin);
+	}
+
+	assert(turn.isNormal());
+	return turn;
+}
+
+void CoordinateSystem :: applyRotation (const Quaternion& rotation)
+{
+	assert(rotation.isNormal());
+
+	m_orientation = rotation * m_orientation;
+	m_orientation.normalize();
+	updateAxes();
+}
+
+void CoordinateSystem :: updateAxes ()
+{
+	assert(m_orientation.isNormal());
+
+	m_forward = m_orientation.getRotated(FORWARD_DEFAULT_MACRO);
+	m_up      = m_orientation.getRotated(UP_DEFAULT_MACRO);
+}
+
 bool CoordinateSystem :: invariant () const
 {
+	if (!m_orientation.isNormal()) return false;
+	if (!m_orientation.isFinite()) return false;
 	if (!m_forward.isNormal()) return false;
 	if (!m_up.isNormal()) return false;
 	if (!m_forward.isOrthogonal(m_up)) return false;
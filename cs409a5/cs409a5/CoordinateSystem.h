@@ -7,6 +7,8 @@
 
 #include "../../ObjLibrary/Vector3.h"
 
+#include "Quaternion.h"
+
 
 
 //
@@ -14,12 +16,22 @@
 //
 //  A class to represent a local coordinate system.
 //
+//  The orientation is stored as a unit quaternion that rotates
+//    the default axes to the current ones.  Every rotation is
+//    applied to the quaternion, and the forward and up vectors
+//    are then recalculated from it, so they cannot drift apart
+//    or lose their length over many small rotations.  The
+//    vectors are kept as well so that they can be returned by
+//    reference.
+//
 //  Class Invariant:
-//    <1> m_forward.isNormal()
-//    <2> m_up.isNormal()
-//    <3> m_forward.isOrthogonal(m_up)
-//    <4> m_forward.isFinite()
-//    <5> m_up.isFinite()
+//    <1> m_orientation.isNormal()
+//    <2> m_orientation.isFinite()
+//    <3> m_forward.isNormal()
+//    <4> m_up.isNormal()
+//    <5> m_forward.isOrthogonal(m_up)
+//    <6> m_forward.isFinite()
+//    <7> m_up.isFinite()
 //
 
 class CoordinateSystem
@@ -70,6 +82,7 @@ public:
 	const Vector3& getForward () const;
 	const Vector3& getUp () const;
 	Vector3 getRight () const;
+	const Quaternion& getOrientation () const;
 
 	void setupCamera () const;
 	void setupOrientationMatrix () const;
@@ -86,6 +99,7 @@ public:
 	void setOrientation (const Vector3& forward);
 	void setOrientation (const Vector3& forward,
 	                     const Vector3& up);
+	void setOrientation (const Quaternion& orientation);
 
 	void setUp (const Vector3& up);
 	void moveForward (double distance);
@@ -97,14 +111,39 @@ public:
 	void rotateToVector (const Vector3& target,
 	                     double max_radians);
 
+	//
+	//  rotateToVectorBatch
+	//
+	//  Rotates each of count coordinate systems as
+	//    rotateToVector(a_targets[i], a_max_radians[i]) would.
+	//    The turn limit is usually the same for many systems in
+	//    a row, such as all the ships of one type, so its sine
+	//    and cosine are only recalculated when it changes.
+	//
+
+	static void rotateToVectorBatch (CoordinateSystem* ap_systems[],
+	                                 const Vector3 a_targets[],
+	                                 const double a_max_radians[],
+	                                 unsigned int count);
+
 private:
 	static Vector3 calculateUp (const Vector3& forward);
+	static Quaternion calculateOrientation (const Vector3& forward,
+	                                        const Vector3& up);
+	static Quaternion calculateTurn (const Vector3& forward,
+	                                 const Vector3& up,
+	                                 const Vector3& target,
+	                                 double half_max_cos,
+	                                 double half_max_sin);
+	void applyRotation (const Quaternion& rotation);
+	void updateAxes ();
 
 private:
 	bool invariant () const;
 
 private:
 	Vector3 m_position;
+	Quaternion m_orientation;
 	Vector3 m_forward;
 	Vector3 m_up;
 };
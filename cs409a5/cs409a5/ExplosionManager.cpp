@@ -75,7 +75,7 @@ void ExplosionManager :: updateForPause ()
 		unsigned int index = i % EXPLOSION_COUNT_MAX;
 		assert(index < EXPLOSION_COUNT_MAX);
 
-		ma_explosions[index].m_creation_time += TimeSystem::getPauseDuration();
+		ma_explosions[index].m_creation_time += TimeSystem::getPauseDurationNanoseconds();
 	}
 
 	assert(invariant());
@@ -162,7 +162,8 @@ void ExplosionManager :: draw (const Vector3& camera_forward,
 		unsigned int index = i % EXPLOSION_COUNT_MAX;
 		assert(index < EXPLOSION_COUNT_MAX);
 
-		double life_elapsed_seconds = TimeSystem::getFrameStartTime() - ma_explosions[index].m_creation_time;
+		double life_elapsed_seconds = TimeSystem::toSeconds(TimeSystem::getFrameStartTimeNanoseconds() -
+		                                                     ma_explosions[index].m_creation_time);
 		assert(life_elapsed_seconds >= 0.0);
 
 		assert(LIFESPAN > 0.0);
@@ -233,7 +234,7 @@ void ExplosionManager :: add (const Vector3& position, double size)
 {
 	ma_explosions[m_next_explosion].m_position      = position;
 	ma_explosions[m_next_explosion].m_size          = size;
-	ma_explosions[m_next_explosion].m_creation_time = TimeSystem::getFrameStartTime();
+	ma_explosions[m_next_explosion].m_creation_time = TimeSystem::getFrameStartTimeNanoseconds();
 	m_next_explosion = (m_next_explosion + 1) % EXPLOSION_COUNT_MAX;
 
 	assert(invariant());
@@ -253,7 +254,8 @@ void ExplosionManager :: update ()
 		assert(index < EXPLOSION_COUNT_MAX);
 
 		if(i == m_oldest_explosion &&
-		   ma_explosions[index].m_creation_time + LIFESPAN <= TimeSystem::getFrameStartTime())
+		   ma_explosions[index].m_creation_time + TimeSystem::toNanoseconds(LIFESPAN) <=
+		                                        TimeSystem::getFrameStartTimeNanoseconds())
 		{
 			// move along oldest counter if explosion is done
 			m_oldest_explosion++;
@@ -333,16 +333,17 @@ private:
 	//  Explosion
 	//
 	//  A record to represent a single explosion.  An Explosion
-	//    has a position, a size, and a creation time.
-	//    Explosions with a creation time more than LIFESPAN
-	//    before the current time are assumed not to exist.
+	//    has a position, a size, and a creation time in
+	//    nanoseconds.  Explosions with a creation time more
+	//    than LIFESPAN before the current time are assumed not
+	//    to exist.
 	//
 
 	struct Explosion
 	{
 		Vector3 m_position;
 		double m_size;
-		double m_creation_time;
+		long long m_creation_time;
 	};
 
 private:
@@ -7,16 +7,19 @@
 //
 
 #include <cassert>
-#include <cstdlib>  // for rand()
 #include <string>
 #include <cmath>
 #include <iostream>
+#include <istream>
+#include <ostream>
 
 #include "../../ObjLibrary/Vector3.h"
 
 #include "TimeSystem.h"
 #include "PhysicsObjectId.h"
 #include "WorldInterface.h"
+#include "PseudorandomGenerator.h"
+#include "SnapshotStream.h"
 #include "FleetNameSteeringBehaviours.h"
 
 using namespace std;
@@ -34,20 +37,6 @@ namespace
 	const bool DEBUGGING_INTERSECTION_TIME = false;
 	const bool DEBUGGING_PATROL_SPHERE     = false;
 	const bool DEBUGGING_AVOID             = false;
-
-
-
-	inline double random0 ()
-	{
-		return rand () / (RAND_MAX + 1.0);
-	}
-
-	inline double random2 (double min_value, double max_value)
-	{
-		assert(min_value <= max_value);
-
-		return min_value + random0() * (max_value - min_value);
-	}
 }
 
 
@@ -192,7 +181,23 @@ SteeringBehaviour :: SteeringBehaviour (const PhysicsObjectId& id_agent)
 		  m_explore_position(),
 		  m_sphere_center(),
 		  m_desired_distance(DEFAULT_DESIRED_DISTANCE),
-		  m_desired_distance_tolerance(DEFAULT_DESIRED_DISTANCE_TOLERANCE)
+		  m_desired_distance_tolerance(DEFAULT_DESIRED_DISTANCE_TOLERANCE),
+		  m_random(PseudorandomGenerator::calculateMixedSeed(PseudorandomGenerator::SEED_DEFAULT, id_agent))
+{
+	assert(id_agent != PhysicsObjectId::ID_NOTHING);
+
+	assert(invariant());
+}
+
+SteeringBehaviour :: SteeringBehaviour (const PhysicsObjectId& id_agent,
+                                        unsigned long long random_seed)
+		: m_id_agent(id_agent),
+		  m_steering_behaviour(STOP),
+		  m_explore_position(),
+		  m_sphere_center(),
+		  m_desired_distance(DEFAULT_DESIRED_DISTANCE),
+		  m_desired_distance_tolerance(DEFAULT_DESIRED_DISTANCE_TOLERANCE),
+		  m_random(random_seed)
 {
 	assert(id_agent != PhysicsObjectId::ID_NOTHING);
 
@@ -205,7 +210,8 @@ SteeringBehaviour :: SteeringBehaviour (const SteeringBehaviour& original)
 		  m_explore_position(original.m_explore_position),
 		  m_sphere_center(original.m_sphere_center),
 		  m_desired_distance(original.m_desired_distance),
-		  m_desired_distance_tolerance(original.m_desired_distance_tolerance)
+		  m_desired_distance_tolerance(original.m_desired_distance_tolerance),
+		  m_random(original.m_random)
 {
 	assert(invariant());
 }
@@ -224,12 +230,65 @@ SteeringBehaviour& SteeringBehaviour :: operator= (const SteeringBehaviour& orig
 		m_sphere_center              = original.m_sphere_center;
 		m_desired_distance           = original.m_desired_distance;
 		m_desired_distance_tolerance = original.m_desired_distance_tolerance;
+		m_random                     = original.m_random;
 	}
 
 	assert(invariant());
 	return *this;
 }
 
+void SteeringBehaviour :: writeState (ostream& r_out) const
+{
+	SnapshotStream::writeId     (r_out, m_id_agent);
+	SnapshotStream::writeValue  (r_out, m_steering_behaviour);
+	SnapshotStream::writeVector3(r_out, m_explore_position);
+	SnapshotStream::writeVector3(r_out, m_sphere_center);
+	SnapshotStream::writeValue  (r_out, m_desired_distance);
+	SnapshotStream::writeValue  (r_out, m_desired_distance_tolerance);
+	SnapshotStream::writeValue  (r_out, m_random.getState());
+}
+
+bool SteeringBehaviour :: readState (istream& r_in)
+{
+	PhysicsObjectId id_agent;
+	unsigned int steering_behaviour;
+	Vector3 explore_position;
+	Vector3 sphere_center;
+	double desired_distance;
+	double desired_distance_tolerance;
+	unsigned long long random_state;
+
+	if(!SnapshotStream::readId     (r_in, id_agent)                   ||
+	   !SnapshotStream::readValue  (r_in, steering_behaviour)         ||
+	   !SnapshotStream::readVector3(r_in, explore_position)           ||
+	   !SnapshotStream::readVector3(r_in, sphere_center)              ||
+	   !SnapshotStream::readValue  (r_in, desired_distance)           ||
+	   !SnapshotStream::readValue  (r_in, desired_distance_tolerance) ||
+	   !SnapshotStream::readValue  (r_in, random_state))
+	{
+		return false;
+	}
+
+	if(id_agent == PhysicsObjectId::ID_NOTHING ||
+	   steering_behaviour >= COUNT ||
+	   desired_distance < 0.0 ||
+	   desired_distance_tolerance < 0.0)
+	{
+		return false;
+	}
+
+	m_id_agent                   = id_agent;
+	m_steering_behaviour         = steering_behaviour;
+	m_explore_position           = explore_position;
+	m_sphere_center              = sphere_center;
+	m_desired_distance           = desired_distance;
+	m_desired_distance_tolerance = desired_distance_tolerance;
+	m_random.setState(random_state);
+
+	assert(invariant());
+	return true;
+}
+
 
 
 Vector3 SteeringBehaviour :: stop (const WorldInterface& world)
@@ -758,7 +817,7 @@ Vector3 SteeringBehaviour :: avoid (const WorldInterface& world,
 	while(sideways_vector.isNormLessThan(0.01))
 	{
 		// we have almost no sideways, so use a random value
-		sideways_vector = Vector3::getRandomUnitVector().getAntiProjection(original_velocity);
+		sideways_vector = m_random.getNextUnitVector().getAntiProjection(original_velocity);
 		// keep trying until we get a good one
 	}
 	assert(!sideways_vector.isZero());
@@ -905,7 +964,7 @@ Vector3 SteeringBehaviour :: avoid (const WorldInterface& world,
 		while(sideways_vector.isNormLessThan(AVOID_SIDEWAYS_NORM_MIN))
 		{
 			// we have almost no sideways, so use a random value
-			sideways_vector = Vector3::getRandomUnitVector().getAntiProjection(agent_forward);
+			sideways_vector = m_random.getNextUnitVector().getAntiProjection(agent_forward);
 			// keep trying until we get a good one
 		}
 		assert(!original_velocity.isZero());
@@ -987,9 +1046,9 @@ Vector3 SteeringBehaviour :: calculateExplorePosition (const Vector3& agent_posi
 			distance_min = 0.0;
 		double distance_max = m_desired_distance + m_desired_distance_tolerance;
 		assert(distance_min <= distance_max);
-		double distance = random2(distance_min, distance_max);
+		double distance = m_random.getNextInRange(distance_min, distance_max);
 
-		Vector3 new_position = agent_position + Vector3::getRandomUnitVector() * distance;
+		Vector3 new_position = agent_position + m_random.getNextUnitVector() * distance;
 		if(new_position.isDistanceGreaterThan(agent_position, EXPLORE_DISTANCE_NEW_POSITION))
 		{
 			// "infinite" loop ende here
@@ -998,7 +1057,7 @@ Vector3 SteeringBehaviour :: calculateExplorePosition (const Vector3& agent_posi
 	}
 
 	// fallback
-	return agent_position + Vector3::getRandomUnitVector() * m_desired_distance;
+	return agent_position + m_random.getNextUnitVector() * m_desired_distance;
 }
 
 Vector3 SteeringBehaviour :: calculateEscortPosition (const WorldInterface& world,
@@ -1028,7 +1087,7 @@ Vector3 SteeringBehaviour :: calculatePatrolSpherePosition (const Vector3& agent
 
 	for(unsigned int i = 0; i < EXPLORE_POSITION_ATTEMPT_COUNT; i++) // loop also ends on valid position
 	{
-		Vector3 new_position = m_sphere_center + Vector3::getRandomUnitVector() * m_desired_distance;
+		Vector3 new_position = m_sphere_center + m_random.getNextUnitVector() * m_desired_distance;
 		if(!isNearEnoughPatrolSpherePoint(agent_position))
 		{
 			// stop when we find a valid position
@@ -1037,7 +1096,7 @@ Vector3 SteeringBehaviour :: calculatePatrolSpherePosition (const Vector3& agent
 	}
 
 	// fallback
-	return m_sphere_center + Vector3::getRandomUnitVector() * m_desired_distance;
+	return m_sphere_center + m_random.getNextUnitVector() * m_desired_distance;
 }
 
 bool SteeringBehaviour :: isNearEnoughPatrolSpherePoint (const Vector3& position) const
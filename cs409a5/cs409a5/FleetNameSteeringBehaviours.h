@@ -9,9 +9,12 @@
 #ifndef RED_STEERING_BEHAVIOURS_H
 #define RED_STEERING_BEHAVIOURS_H
 
+#include <iosfwd>
+
 #include "../../ObjLibrary/Vector3.h"
 
 #include "PhysicsObjectId.h"
+#include "PseudorandomGenerator.h"
 
 class WorldInterface;
 
@@ -76,6 +79,12 @@ namespace FleetName
 //    direction a shot of a known speed would have to be fired
 //    to hit a moving target.
 //
+//  Each SteeringBehaviour has its own PseudorandomGenerator for
+//    the behaviours that need random values, such as explore.
+//    This keeps the behaviour of each agent repeatable for a
+//    given seed, even when the AIs for different agents are
+//    run on different threads.
+//
 //  Class Invariant:
 //    <1> m_id_agent != PhysicsObjectId::ID_NOTHING
 //    <2> m_steering_behaviour < COUNT
@@ -378,6 +387,28 @@ namespace FleetName
 
 		SteeringBehaviour (const PhysicsObjectId& id_agent);
 
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a SteeringBehaviour to control the
+	//           agent with the specified id, using the
+	//           specified seed for random values.
+	//  Parameter(s):
+	//    <1> id_agent: The id for the agent
+	//    <2> random_seed: The seed for the pseudorandom values
+	//  Precondition(s):
+	//    <1> id_agent != PhysicsObjectId::ID_NOTHING
+	//  Returns: N/A
+	//  Side Effect: A new SteeringBehaviour is created to
+	//               control the agent with id id_agent, and is
+	//               marked as performing the stop behaviour.
+	//               Its random values are generated from seed
+	//               random_seed.
+	//
+
+		SteeringBehaviour (const PhysicsObjectId& id_agent,
+		                   unsigned long long random_seed);
+
 	//
 	//  Copy Constructor
 	//
@@ -430,6 +461,43 @@ namespace FleetName
 		SteeringBehaviour& operator= (
 		                     const SteeringBehaviour& original);
 
+	//
+	//  writeState
+	//
+	//  Purpose: To write the state of this SteeringBehaviour to
+	//           the specified binary stream.
+	//  Parameter(s):
+	//    <1> r_out: The stream to write to
+	//  Precondition(s):
+	//    <1> r_out was opened in binary mode
+	//  Returns: N/A
+	//  Side Effect: The agent id, current steering behaviour,
+	//               stored details, and pseudorandom generator
+	//               state of this SteeringBehaviour are written
+	//               to r_out.
+	//
+
+		void writeState (std::ostream& r_out) const;
+
+	//
+	//  readState
+	//
+	//  Purpose: To set this SteeringBehaviour to the state read
+	//           from the specified binary stream.
+	//  Parameter(s):
+	//    <1> r_in: The stream to read from
+	//  Precondition(s):
+	//    <1> r_in was opened in binary mode
+	//  Returns: Whether a valid state was read.
+	//  Side Effect: A state written by writeState is read from
+	//               r_in.  If it is valid, this
+	//               SteeringBehaviour is set to have that state.
+	//               Otherwise, this SteeringBehaviour is
+	//               unchanged.
+	//
+
+		bool readState (std::istream& r_in);
+
 	//
 	//  stop
 	//
@@ -925,6 +993,7 @@ namespace FleetName
 		Vector3 m_sphere_center;
 		double  m_desired_distance;
 		double  m_desired_distance_tolerance;
+		mutable PseudorandomGenerator m_random;
 	};
 
 
@@ -0,0 +1,342 @@
+//
+//  FleetRegistry.cpp
+//
+
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+#include "PhysicsObjectId.h"
+#include "SnapshotStream.h"
+#include "FleetRegistry.h"
+
+using namespace std;
+
+namespace
+{
+	//
+	//  writeIdList
+	//  readIdList
+	//
+	//  Purpose: To write/read a list of PhysicsObjectIds,
+	//           preceded by its length, to/from a binary stream.
+	//
+
+	void writeIdList (ostream& r_out, const vector<PhysicsObjectId>& ids)
+	{
+		SnapshotStream::writeValue(r_out, (unsigned int)(ids.size()));
+		for(unsigned int i = 0; i < ids.size(); i++)
+			SnapshotStream::writeId(r_out, ids[i]);
+	}
+
+	bool readIdList (istream& r_in, vector<PhysicsObjectId>& r_ids)
+	{
+		unsigned int count;
+		if(!SnapshotStream::readValue(r_in, count))
+			return false;
+
+		r_ids.clear();
+		for(unsigned int i = 0; i < count; i++)
+		{
+			PhysicsObjectId id;
+			if(!SnapshotStream::readId(r_in, id))
+				return false;
+			r_ids.push_back(id);
+		}
+		return true;
+	}
+
+	//
+	//  addPositions
+	//
+	//  Purpose: To record the position of each id in a list
+	//           read from a snapshot, checking that each has the
+	//           expected type and fleet and was not already
+	//           seen.
+	//  Returns: Whether every id was valid.
+	//
+
+	bool addPositions (unordered_map<unsigned int, unsigned int>& r_positions,
+	                   const vector<PhysicsObjectId>& ids,
+	                   unsigned int type,
+	                   unsigned int fleet)
+	{
+		for(unsigned int i = 0; i < ids.size(); i++)
+		{
+			if(ids[i].m_type != type || ids[i].m_fleet != fleet)
+				return false;
+			if(!r_positions.insert(make_pair((unsigned int)(ids[i]), i)).second)
+				return false;
+		}
+		return true;
+	}
+}
+
+
+
+FleetRegistry :: FleetRegistry ()
+		: mv_fleets(),
+		  m_positions()
+{
+	assert(invariant());
+}
+
+
+
+unsigned int FleetRegistry :: getFleetCount () const
+{
+	return (unsigned int)(mv_fleets.size());
+}
+
+float FleetRegistry :: getScore (unsigned int fleet) const
+{
+	assert(fleet < getFleetCount());
+
+	return mv_fleets[fleet].m_score;
+}
+
+bool FleetRegistry :: isAlive (unsigned int fleet) const
+{
+	assert(fleet < getFleetCount());
+
+	const Fleet& f = mv_fleets[fleet];
+	if(f.m_command_ship_id != PhysicsObjectId::ID_NOTHING)
+		return f.m_is_command_ship_alive;
+	else
+		return !f.mv_fighter_ids.empty();
+}
+
+const PhysicsObjectId& FleetRegistry :: getCommandShipId (unsigned int fleet) const
+{
+	assert(fleet < getFleetCount());
+
+	return mv_fleets[fleet].m_command_ship_id;
+}
+
+const vector<PhysicsObjectId>& FleetRegistry :: getFighterIds (unsigned int fleet) const
+{
+	assert(fleet < getFleetCount());
+
+	return mv_fleets[fleet].mv_fighter_ids;
+}
+
+const vector<PhysicsObjectId>& FleetRegistry :: getMissileIds (unsigned int fleet) const
+{
+	assert(fleet < getFleetCount());
+
+	return mv_fleets[fleet].mv_missile_ids;
+}
+
+bool FleetRegistry :: isRegistered (const PhysicsObjectId& id) const
+{
+	return m_positions.find(id) != m_positions.end();
+}
+
+
+
+void FleetRegistry :: init (unsigned int fleet_count)
+{
+	assert(fleet_count <= PhysicsObjectId::FLEET_MAX + 1);
+
+	mv_fleets.resize(fleet_count);
+	for(unsigned int f = 0; f < fleet_count; f++)
+		mv_fleets[f].m_score = 0.0f;
+	clearObjects();
+
+	assert(invariant());
+}
+
+void FleetRegistry :: clearObjects ()
+{
+	for(unsigned int f = 0; f < getFleetCount(); f++)
+	{
+		Fleet& r_fleet = mv_fleets[f];
+		r_fleet.m_command_ship_id       = PhysicsObjectId::ID_NOTHING;
+		r_fleet.m_is_command_ship_alive = false;
+		r_fleet.mv_fighter_ids.clear();
+		r_fleet.mv_missile_ids.clear();
+	}
+	m_positions.clear();
+
+	assert(invariant());
+}
+
+void FleetRegistry :: setCommandShip (const PhysicsObjectId& id, bool is_alive)
+{
+	assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
+	assert(id.m_fleet < getFleetCount());
+	assert(!isRegistered(id));
+
+	Fleet& r_fleet = mv_fleets[id.m_fleet];
+	r_fleet.m_command_ship_id       = id;
+	r_fleet.m_is_command_ship_alive = is_alive;
+
+	assert(invariant());
+}
+
+void FleetRegistry :: addFighter (const PhysicsObjectId& id)
+{
+	assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
+	assert(id.m_fleet < getFleetCount());
+	assert(!isRegistered(id));
+
+	addToList(mv_fleets[id.m_fleet].mv_fighter_ids, id);
+
+	assert(invariant());
+}
+
+void FleetRegistry :: addMissile (const PhysicsObjectId& id)
+{
+	assert(id.m_type == PhysicsObjectId::TYPE_MISSILE);
+	assert(id.m_fleet < getFleetCount());
+	assert(!isRegistered(id));
+
+	addToList(mv_fleets[id.m_fleet].mv_missile_ids, id);
+
+	assert(invariant());
+}
+
+void FleetRegistry :: markShipDead (const PhysicsObjectId& id)
+{
+	assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
+	assert(id.m_fleet < getFleetCount());
+
+	Fleet& r_fleet = mv_fleets[id.m_fleet];
+	if(id == r_fleet.m_command_ship_id)
+		r_fleet.m_is_command_ship_alive = false;
+	else
+		removeFromList(r_fleet.mv_fighter_ids, id);
+
+	assert(invariant());
+}
+
+void FleetRegistry :: removeMissile (const PhysicsObjectId& id)
+{
+	assert(id.m_type == PhysicsObjectId::TYPE_MISSILE);
+
+	if(id.m_fleet < getFleetCount())
+		removeFromList(mv_fleets[id.m_fleet].mv_missile_ids, id);
+
+	assert(invariant());
+}
+
+void FleetRegistry :: addScore (unsigned int fleet, float increase)
+{
+	assert(fleet < getFleetCount());
+
+	mv_fleets[fleet].m_score += increase;
+
+	assert(invariant());
+}
+
+
+
+void FleetRegistry :: writeState (ostream& r_out) const
+{
+	SnapshotStream::writeValue(r_out, getFleetCount());
+	for(unsigned int f = 0; f < getFleetCount(); f++)
+	{
+		const Fleet& fleet = mv_fleets[f];
+		SnapshotStream::writeId(r_out, fleet.m_command_ship_id);
+		SnapshotStream::writeValue(r_out, fleet.m_is_command_ship_alive);
+		SnapshotStream::writeValue(r_out, fleet.m_score);
+		writeIdList(r_out, fleet.mv_fighter_ids);
+		writeIdList(r_out, fleet.mv_missile_ids);
+	}
+}
+
+bool FleetRegistry :: readState (istream& r_in)
+{
+	unsigned int fleet_count;
+	if(!SnapshotStream::readValue(r_in, fleet_count))
+		return false;
+	if(fleet_count != getFleetCount())
+		return false;
+
+	vector<Fleet> v_fleets(fleet_count);
+	for(unsigned int f = 0; f < fleet_count; f++)
+	{
+		Fleet& r_fleet = v_fleets[f];
+		if(!SnapshotStream::readId(r_in, r_fleet.m_command_ship_id)       ||
+		   !SnapshotStream::readValue(r_in, r_fleet.m_is_command_ship_alive) ||
+		   !SnapshotStream::readValue(r_in, r_fleet.m_score)                 ||
+		   !readIdList(r_in, r_fleet.mv_fighter_ids)                         ||
+		   !readIdList(r_in, r_fleet.mv_missile_ids))
+		{
+			return false;
+		}
+	}
+
+	// every id must be in the right list exactly once
+	unordered_map<unsigned int, unsigned int> positions;
+	for(unsigned int f = 0; f < fleet_count; f++)
+	{
+		const Fleet& fleet = v_fleets[f];
+		if(fleet.m_command_ship_id != PhysicsObjectId::ID_NOTHING &&
+		   (fleet.m_command_ship_id.m_type  != PhysicsObjectId::TYPE_SHIP ||
+		    fleet.m_command_ship_id.m_fleet != f))
+		{
+			return false;
+		}
+		if(!addPositions(positions, fleet.mv_fighter_ids, PhysicsObjectId::TYPE_SHIP,    f) ||
+		   !addPositions(positions, fleet.mv_missile_ids, PhysicsObjectId::TYPE_MISSILE, f))
+		{
+			return false;
+		}
+		if(positions.count(fleet.m_command_ship_id) > 0)
+			return false;
+	}
+
+	mv_fleets.swap(v_fleets);
+	m_positions.swap(positions);
+
+	assert(invariant());
+	return true;
+}
+
+
+
+void FleetRegistry :: addToList (vector<PhysicsObjectId>& r_list,
+                                 const PhysicsObjectId& id)
+{
+	assert(!isRegistered(id));
+
+	m_positions[id] = (unsigned int)(r_list.size());
+	r_list.push_back(id);
+}
+
+void FleetRegistry :: removeFromList (vector<PhysicsObjectId>& r_list,
+                                      const PhysicsObjectId& id)
+{
+	unordered_map<unsigned int, unsigned int>::iterator found = m_positions.find(id);
+	if(found == m_positions.end())
+		return;
+
+	unsigned int position = found->second;
+	assert(position < r_list.size());
+	assert(r_list[position] == id);
+	m_positions.erase(found);
+
+	// move the last id into the gap
+	if(position + 1 < r_list.size())
+	{
+		r_list[position] = r_list.back();
+		m_positions[r_list[position]] = position;
+	}
+	r_list.pop_back();
+}
+
+bool FleetRegistry :: invariant () const
+{
+	unsigned int total = 0;
+	for(unsigned int f = 0; f < mv_fleets.size(); f++)
+	{
+		total += (unsigned int)(mv_fleets[f].mv_fighter_ids.size());
+		total += (unsigned int)(mv_fleets[f].mv_missile_ids.size());
+	}
+	if(m_positions.size() != total) return false;
+	return true;
+}
@@ -0,0 +1,362 @@
+//
+//  FleetRegistry.h
+//
+
+#ifndef FLEET_REGISTRY_H
+#define FLEET_REGISTRY_H
+
+#include <iosfwd>
+#include <vector>
+#include <unordered_map>
+
+#include "PhysicsObjectId.h"
+
+
+
+//
+//  FleetRegistry
+//
+//  A class to keep track of the living ships and missiles in
+//    each fleet, and of the score of each fleet.  Nothing is
+//    ever found by searching the world.  Instead, the owner
+//    reports each ship or missile when it appears and again
+//    when it dies, and the lists are updated at that time.
+//    Adding and removing both take constant time, and every
+//    query either takes constant time or returns a reference
+//    to a list that is already up to date.
+//
+//  Each fleet may have one command ship, which is not
+//    included in the list of fighters.  Removing an object
+//    moves the last object in its list into its place, so the
+//    order of a list depends only on the order of the calls
+//    made.  It is the same every time a game is replayed.
+//
+//  Class Invariant:
+//    <1> mv_fleets.size() == getFleetCount()
+//    <2> m_positions contains exactly one entry for each
+//        fighter and missile in each fleet
+//
+
+class FleetRegistry
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new FleetRegistry with no fleets.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new FleetRegistry is created with a fleet
+//               count of 0.
+//
+
+	FleetRegistry ();
+
+//
+//  getFleetCount
+//
+//  Purpose: To determine the number of fleets in this
+//           FleetRegistry.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of fleets, including empty ones.
+//  Side Effect: N/A
+//
+
+	unsigned int getFleetCount () const;
+
+//
+//  getScore
+//
+//  Purpose: To determine the score of the specified fleet.
+//  Parameter(s):
+//    <1> fleet: The fleet to query
+//  Precondition(s):
+//    <1> fleet < getFleetCount()
+//  Returns: The score of fleet fleet.
+//  Side Effect: N/A
+//
+
+	float getScore (unsigned int fleet) const;
+
+//
+//  isAlive
+//
+//  Purpose: To determine if the specified fleet is alive.
+//  Parameter(s):
+//    <1> fleet: The fleet to query
+//  Precondition(s):
+//    <1> fleet < getFleetCount()
+//  Returns: If fleet fleet has a command ship, whether it is
+//           alive.  Otherwise, whether fleet fleet has any
+//           living fighters.
+//  Side Effect: N/A
+//
+
+	bool isAlive (unsigned int fleet) const;
+
+//
+//  getCommandShipId
+//
+//  Purpose: To determine the id of the command ship for the
+//           specified fleet.
+//  Parameter(s):
+//    <1> fleet: The fleet to query
+//  Precondition(s):
+//    <1> fleet < getFleetCount()
+//  Returns: The id of the command ship for fleet fleet, or
+//           PhysicsObjectId::ID_NOTHING if it has none.  The
+//           id is returned even after the command ship dies.
+//  Side Effect: N/A
+//
+
+	const PhysicsObjectId& getCommandShipId (unsigned int fleet) const;
+
+//
+//  getFighterIds
+//  getMissileIds
+//
+//  Purpose: To determine the ids of the living fighters or
+//           missiles in the specified fleet.
+//  Parameter(s):
+//    <1> fleet: The fleet to query
+//  Precondition(s):
+//    <1> fleet < getFleetCount()
+//  Returns: A reference to the list of ids.  The reference
+//           stays valid until this FleetRegistry is changed.
+//  Side Effect: N/A
+//
+
+	const std::vector<PhysicsObjectId>& getFighterIds (
+	                                   unsigned int fleet) const;
+	const std::vector<PhysicsObjectId>& getMissileIds (
+	                                   unsigned int fleet) const;
+
+//
+//  isRegistered
+//
+//  Purpose: To determine if the specified fighter or missile
+//           is in this FleetRegistry.
+//  Parameter(s):
+//    <1> id: The id to check for
+//  Precondition(s): N/A
+//  Returns: Whether id is in the list of fighters or missiles
+//           for its fleet.  Command ships are not included.
+//  Side Effect: N/A
+//
+
+	bool isRegistered (const PhysicsObjectId& id) const;
+
+//
+//  init
+//
+//  Purpose: To remove everything from this FleetRegistry and
+//           set the number of fleets.
+//  Parameter(s):
+//    <1> fleet_count: The number of fleets
+//  Precondition(s):
+//    <1> fleet_count <= PhysicsObjectId::FLEET_MAX + 1
+//  Returns: N/A
+//  Side Effect: This FleetRegistry is set to have fleet_count
+//               fleets.  Each fleet has no command ship, no
+//               fighters, no missiles, and a score of 0.
+//
+
+	void init (unsigned int fleet_count);
+
+//
+//  clearObjects
+//
+//  Purpose: To remove all the ships and missiles from this
+//           FleetRegistry without changing the scores.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each fleet is set to have no command ship, no
+//               fighters, and no missiles.
+//
+
+	void clearObjects ();
+
+//
+//  setCommandShip
+//
+//  Purpose: To set the command ship for a fleet.
+//  Parameter(s):
+//    <1> id: The id of the command ship
+//    <2> is_alive: Whether the command ship is alive
+//  Precondition(s):
+//    <1> id.m_type == PhysicsObjectId::TYPE_SHIP
+//    <2> id.m_fleet < getFleetCount()
+//    <3> !isRegistered(id)
+//  Returns: N/A
+//  Side Effect: Ship id becomes the command ship for its
+//               fleet, replacing any earlier command ship.
+//
+
+	void setCommandShip (const PhysicsObjectId& id, bool is_alive);
+
+//
+//  addFighter
+//  addMissile
+//
+//  Purpose: To add a living fighter or missile.
+//  Parameter(s):
+//    <1> id: The id of the fighter or missile
+//  Precondition(s):
+//    <1> id.m_type == PhysicsObjectId::TYPE_SHIP for
+//        addFighter, or PhysicsObjectId::TYPE_MISSILE for
+//        addMissile
+//    <2> id.m_fleet < getFleetCount()
+//    <3> !isRegistered(id)
+//  Returns: N/A
+//  Side Effect: id is added to the end of the list of fighters
+//               or missiles for its fleet.
+//
+
+	void addFighter (const PhysicsObjectId& id);
+	void addMissile (const PhysicsObjectId& id);
+
+//
+//  markShipDead
+//
+//  Purpose: To record that a ship has died.
+//  Parameter(s):
+//    <1> id: The id of the ship
+//  Precondition(s):
+//    <1> id.m_type == PhysicsObjectId::TYPE_SHIP
+//    <2> id.m_fleet < getFleetCount()
+//  Returns: N/A
+//  Side Effect: If id is the command ship for its fleet, it is
+//               marked as dead.  Otherwise, if it is a
+//               registered fighter, it is removed.
+//
+
+	void markShipDead (const PhysicsObjectId& id);
+
+//
+//  removeMissile
+//
+//  Purpose: To remove a missile.
+//  Parameter(s):
+//    <1> id: The id of the missile
+//  Precondition(s):
+//    <1> id.m_type == PhysicsObjectId::TYPE_MISSILE
+//  Returns: N/A
+//  Side Effect: If id is registered, it is removed.
+//
+
+	void removeMissile (const PhysicsObjectId& id);
+
+//
+//  addScore
+//
+//  Purpose: To increase the score of a fleet.
+//  Parameter(s):
+//    <1> fleet: The fleet
+//    <2> increase: The amount to add
+//  Precondition(s):
+//    <1> fleet < getFleetCount()
+//  Returns: N/A
+//  Side Effect: The score for fleet fleet is increased by
+//               increase.
+//
+
+	void addScore (unsigned int fleet, float increase);
+
+//
+//  writeState
+//
+//  Purpose: To write the state of this FleetRegistry to a
+//           binary stream.  The lists are written in order, so
+//           a game continued from the snapshot sees them in the
+//           same order as the original game did.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The fleet count and, for each fleet, the
+//               command ship, score, fighters, and missiles are
+//               written to r_out.
+//
+
+	void writeState (std::ostream& r_out) const;
+
+//
+//  readState
+//
+//  Purpose: To read the state of this FleetRegistry from a
+//           binary stream, as written by writeState.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s): N/A
+//  Returns: Whether a valid state could be read.  If the fleet
+//           count does not match getFleetCount(), or any id is
+//           in the wrong fleet or appears twice, false is
+//           returned.
+//  Side Effect: If true is returned, this FleetRegistry is set
+//               to the state read.  Otherwise, this
+//               FleetRegistry is unchanged.
+//
+
+	bool readState (std::istream& r_in);
+
+private:
+//
+//  Fleet
+//
+//  A record of everything known about one fleet.
+//
+
+	struct Fleet
+	{
+		PhysicsObjectId m_command_ship_id;
+		bool m_is_command_ship_alive;
+		std::vector<PhysicsObjectId> mv_fighter_ids;
+		std::vector<PhysicsObjectId> mv_missile_ids;
+		float m_score;
+	};
+
+//
+//  addToList
+//  removeFromList
+//
+//  Purpose: To add/remove an id to/from one of the lists in a
+//           Fleet, keeping m_positions up to date.
+//  Parameter(s):
+//    <1> r_list: The list
+//    <2> id: The id to add or remove
+//  Precondition(s):
+//    <1> !isRegistered(id) for addToList
+//  Returns: N/A
+//  Side Effect: id is added to the end of r_list, or, if it is
+//               registered, removed from r_list, with the last
+//               element moved into its place.
+//
+
+	void addToList (std::vector<PhysicsObjectId>& r_list,
+	                const PhysicsObjectId& id);
+	void removeFromList (std::vector<PhysicsObjectId>& r_list,
+	                     const PhysicsObjectId& id);
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	std::vector<Fleet> mv_fleets;
+	std::unordered_map<unsigned int, unsigned int> m_positions;
+};
+
+
+
+#endif
@@ -0,0 +1,168 @@
+//
+//  GeometricCollisionsSwept.cpp
+//
+
+#include <cassert>
+#include <cmath>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "GeometricCollisions.h"
+#include "GeometricCollisionsBatch.h"
+#include "GeometricCollisionsSwept.h"
+
+using namespace std;
+namespace
+{
+	// the same tolerance Vector3 uses for isDistanceLessThan
+	const float TOLERANCE_PLUS_ONE_SQUARED = (float)(VECTOR3_NORM_TOLERANCE_PLUS_ONE_SQUARED);
+
+	//
+	//  clampSegmentOverlap
+	//
+	//  Purpose: To narrow the range of times [r_t_min, r_t_max]
+	//           to the times when a point moving along one axis
+	//           from start to start + delta is strictly between
+	//           center - size and center + size.
+	//  Returns: Whether the narrowed range can still contain a
+	//           time.
+	//
+
+	inline bool clampSegmentOverlap (double start, double delta,
+	                                 double center, double size,
+	                                 double& r_t_min, double& r_t_max)
+	{
+		if(delta == 0.0)
+			return fabs(start - center) < size;
+
+		double t1 = (center - size - start) / delta;
+		double t2 = (center + size - start) / delta;
+		if(t1 > t2)
+		{
+			double temp = t1;
+			t1 = t2;
+			t2 = temp;
+		}
+
+		if(t1 > r_t_min) r_t_min = t1;
+		if(t2 < r_t_max) r_t_max = t2;
+		return r_t_min < r_t_max;
+	}
+}
+
+
+
+bool GeometricCollisions :: segmentVsSphere (const Vector3& segment_start,
+                                             const Vector3& segment_end,
+                                             const Vector3& sphere_center,
+                                             double sphere_radius)
+{
+	assert(sphere_radius >= 0.0);
+
+	Vector3 delta = segment_end - segment_start;
+	double length_squared = delta.getNormSquared();
+	if(length_squared == 0.0)
+		return pointVsSphere(segment_start, sphere_center, sphere_radius);
+
+	// find the point on the segment closest to the sphere
+	double t = (sphere_center - segment_start).dotProduct(delta) / length_squared;
+	if(t < 0.0)
+		t = 0.0;
+	else if(t > 1.0)
+		t = 1.0;
+
+	Vector3 closest = segment_start + delta * t;
+	return closest.isDistanceLessThan(sphere_center, sphere_radius);
+}
+
+bool GeometricCollisions :: segmentVsCuboid (const Vector3& segment_start,
+                                             const Vector3& segment_end,
+                                             const Vector3& cuboid_center,
+                                             const Vector3& cuboid_size)
+{
+	assert(cuboid_size.isAllComponentsNonNegative());
+
+	// the segment is inside the cuboid for the times when it is
+	//  inside all 3 slabs; an axis the segment does not move
+	//  along either includes all times or none
+	Vector3 delta = segment_end - segment_start;
+	double t_min = 0.0;
+	double t_max = 1.0;
+	if(!clampSegmentOverlap(segment_start.x, delta.x, cuboid_center.x, cuboid_size.x, t_min, t_max))
+		return false;
+	if(!clampSegmentOverlap(segment_start.y, delta.y, cuboid_center.y, cuboid_size.y, t_min, t_max))
+		return false;
+	if(!clampSegmentOverlap(segment_start.z, delta.z, cuboid_center.z, cuboid_size.z, t_min, t_max))
+		return false;
+	return true;
+}
+
+bool GeometricCollisions :: movingSphereVsMovingSphere (const Vector3& sphere1_start,
+                                                        const Vector3& sphere1_end,
+                                                        double sphere1_radius,
+                                                        const Vector3& sphere2_start,
+                                                        const Vector3& sphere2_end,
+                                                        double sphere2_radius)
+{
+	assert(sphere1_radius >= 0.0);
+	assert(sphere2_radius >= 0.0);
+
+	// in the frame of reference of the second sphere, it does
+	//  not move and the first sphere moves along a segment
+	return segmentVsSphere(sphere1_start - sphere2_start,
+	                       sphere1_end   - sphere2_end,
+	                       Vector3::ZERO,
+	                       sphere1_radius + sphere2_radius);
+}
+
+unsigned int GeometricCollisions :: movingSphereVsSpheresFirst (const Vector3& sphere_start,
+                                                                const Vector3& sphere_end,
+                                                                double sphere_radius,
+                                                                const float a_x[],
+                                                                const float a_y[],
+                                                                const float a_z[],
+                                                                const float a_radius[],
+                                                                unsigned int count)
+{
+	assert(sphere_radius >= 0.0);
+	assert(count == 0 || a_x != NULL);
+	assert(count == 0 || a_y != NULL);
+	assert(count == 0 || a_z != NULL);
+	assert(count == 0 || a_radius != NULL);
+
+	float sx = (float)(sphere_start.x);
+	float sy = (float)(sphere_start.y);
+	float sz = (float)(sphere_start.z);
+	float dx = (float)(sphere_end.x - sphere_start.x);
+	float dy = (float)(sphere_end.y - sphere_start.y);
+	float dz = (float)(sphere_end.z - sphere_start.z);
+	float r  = (float)(sphere_radius);
+
+	float length_squared = dx * dx + dy * dy + dz * dz;
+	if(length_squared == 0.0f)
+	{
+		return sphereVsSpheresFirst(sphere_start, sphere_radius,
+		                            a_x, a_y, a_z, a_radius, count);
+	}
+	float length_squared_inverse = 1.0f / length_squared;
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		// find the point on the segment closest to sphere i
+		float t = ((a_x[i] - sx) * dx +
+		           (a_y[i] - sy) * dy +
+		           (a_z[i] - sz) * dz) * length_squared_inverse;
+		if(t < 0.0f)
+			t = 0.0f;
+		else if(t > 1.0f)
+			t = 1.0f;
+
+		float ox  = a_x[i] - (sx + dx * t);
+		float oy  = a_y[i] - (sy + dy * t);
+		float oz  = a_z[i] - (sz + dz * t);
+		float sum = a_radius[i] + r;
+		if(ox * ox + oy * oy + oz * oz <= sum * sum * TOLERANCE_PLUS_ONE_SQUARED)
+			return i;
+	}
+	return count;
+}
@@ -0,0 +1,160 @@
+//
+//  GeometricCollisionsSwept.h
+//
+//  An extension to the GeometricCollisions module to check for
+//    collisions with solids that move during a frame.  A solid
+//    that moves in a straight line sweeps out a line segment
+//    (for a point) or a capsule (for a sphere).  Testing
+//    against the swept shape instead of only the final position
+//    means that a fast, small object cannot pass through
+//    another object between two frames, no matter how long the
+//    frames are.
+//
+//  As in the GeometricCollisions module, spheres that are just
+//    touching (within the tolerance used by Vector3) intersect,
+//    but cuboids that are just touching do not.
+//
+
+#ifndef GEOMETRIC_COLLISIONS_SWEPT_H
+#define GEOMETRIC_COLLISIONS_SWEPT_H
+
+class Vector3;
+
+
+
+namespace GeometricCollisions
+{
+
+//
+//  segmentVsSphere
+//
+//  Purpose: A function to test whether the specified line
+//           segment intersects the specified sphere.
+//  Parameter(s):
+//    <1> segment_start: The position of one end of the line
+//                       segment
+//    <2> segment_end: The position of the other end of the line
+//                     segment
+//    <3> sphere_center: The position of the sphere center
+//    <4> sphere_radius: The radius of the sphere
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//  Returns: Whether any point on the line segment is inside the
+//           sphere.  If segment_start == segment_end, this is
+//           the same as pointVsSphere.
+//  Side Effect: N/A
+//
+
+	bool segmentVsSphere (const Vector3& segment_start,
+	                      const Vector3& segment_end,
+	                      const Vector3& sphere_center,
+	                      double sphere_radius);
+
+//
+//  segmentVsCuboid
+//
+//  Purpose: A function to test whether the specified line
+//           segment intersects the specified axis-aligned
+//           rectangular cuboid.
+//  Parameter(s):
+//    <1> segment_start: The position of one end of the line
+//                       segment
+//    <2> segment_end: The position of the other end of the line
+//                     segment
+//    <3> cuboid_center: The position of the cuboid center
+//    <4> cuboid_size: The distance from the cuboid center to
+//                     the faces along each axis;
+//                     Half the side length along each axis
+//  Precondition(s):
+//    <1> cuboid_size.isAllComponentsNonNegative()
+//  Returns: Whether any point on the line segment is inside the
+//           cuboid.  If segment_start == segment_end, this is
+//           the same as pointVsCuboid.
+//  Side Effect: N/A
+//
+
+	bool segmentVsCuboid (const Vector3& segment_start,
+	                      const Vector3& segment_end,
+	                      const Vector3& cuboid_center,
+	                      const Vector3& cuboid_size);
+
+//
+//  movingSphereVsMovingSphere
+//
+//  Purpose: A function to test whether two spheres, each moving
+//           in a straight line at a constant speed over the
+//           same period of time, intersect at any point during
+//           that time.
+//  Parameter(s):
+//    <1> sphere1_start: The position of the first sphere center
+//                       at the start of the time
+//    <2> sphere1_end: The position of the first sphere center
+//                     at the end of the time
+//    <3> sphere1_radius: The radius of the first sphere
+//    <4> sphere2_start: The position of the second sphere
+//                       center at the start of the time
+//    <5> sphere2_end: The position of the second sphere center
+//                     at the end of the time
+//    <6> sphere2_radius: The radius of the second sphere
+//  Precondition(s):
+//    <1> sphere1_radius >= 0.0
+//    <2> sphere2_radius >= 0.0
+//  Returns: Whether the spheres intersect at any time.  If the
+//           spheres do not move, this is the same as
+//           sphereVsSphere.
+//  Side Effect: N/A
+//
+
+	bool movingSphereVsMovingSphere (const Vector3& sphere1_start,
+	                                 const Vector3& sphere1_end,
+	                                 double sphere1_radius,
+	                                 const Vector3& sphere2_start,
+	                                 const Vector3& sphere2_end,
+	                                 double sphere2_radius);
+
+//
+//  movingSphereVsSpheresFirst
+//
+//  Purpose: A function to find the first of a list of
+//           stationary spheres that a moving sphere intersects.
+//  Parameter(s):
+//    <1> sphere_start: The position of the moving sphere center
+//                      at the start of its movement
+//    <2> sphere_end: The position of the moving sphere center
+//                    at the end of its movement
+//    <3> sphere_radius: The radius of the moving sphere
+//    <4> a_x
+//    <5> a_y
+//    <6> a_z: Arrays of the components of the centers of the
+//             spheres to test against
+//    <7> a_radius: An array of the radii of the spheres to test
+//                  against
+//    <8> count: The number of spheres to test against
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//    <2> a_x, a_y, a_z, and a_radius each contain at least
+//        count elements
+//    <3> a_radius[i] >= 0.0 for all i < count
+//  Returns: The lowest index i such that the sphere at position
+//           (a_x[i], a_y[i], a_z[i]) with radius a_radius[i]
+//           intersects the moving sphere at any point along its
+//           movement.  If no sphere intersects it, count is
+//           returned.  If sphere_start == sphere_end, this gives
+//           the same result as sphereVsSpheresFirst.
+//  Side Effect: N/A
+//
+
+	unsigned int movingSphereVsSpheresFirst (const Vector3& sphere_start,
+	                                         const Vector3& sphere_end,
+	                                         double sphere_radius,
+	                                         const float a_x[],
+	                                         const float a_y[],
+	                                         const float a_z[],
+	                                         const float a_radius[],
+	                                         unsigned int count);
+
+}  // end of namespace GeometricCollisions
+
+
+
+#endif
@@ -3,12 +3,16 @@
 //
 
 #include <stdlib.h>
+#include <string.h>
+#include <string>
 #include "GetGlut.h"
 #include "Sleep.h"
 #include "TimeSystem.h"
 #include "../../ObjLibrary/ObjModel.h"
 #include "../../ObjLibrary/DisplayList.h"
 #include "World.h"
+#include "PlayerInput.h"
+#include "Replay.h"
 
 void init();
 void initDisplay();
@@ -22,6 +26,14 @@ void display();
 
 World* world;
 
+// Recording with --record
+unsigned long long world_seed = PseudorandomGenerator::SEED_DEFAULT;
+std::string record_filename = "";
+Replay* replay = NULL;
+
+// A quarter of a 60 fps frame for the unit AIs
+const double AI_BUDGET = 0.004;
+
 // Improved keyboard stuff
 bool key_pressed[256];
 bool special_key_pressed[128];
@@ -32,6 +44,16 @@ int main(int argc, char* argv[])
     glutInitWindowPosition(0, 0);
     
     glutInit(&argc, argv);
+    
+    // GLUT has removed its own options by now
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            world_seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record_filename = argv[++i];
+    }
+    
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_DEPTH | GLUT_RGB);
     glutCreateWindow("CS 409 Assignment 5");
     glutKeyboardFunc(keyboard);
@@ -65,7 +87,12 @@ void init()
     
     initDisplay();
     world = new World();
+    world->setRandomSeed(world_seed);
     world->init();
+    world->setAiBudget(AI_BUDGET);
+    
+    if (record_filename != "")
+        replay = new Replay(world_seed);
     
 }
 
@@ -87,6 +114,11 @@ void keyboard(unsigned char key, int x, int y)
     switch (key)
     {
         case 27: // on [ESC]
+            if (replay != NULL)
+            {
+                replay->recordFinalSnapshot(*world);
+                replay->save(record_filename);
+            }
             exit(0); // normal exit
             break;
     }
@@ -109,49 +141,18 @@ void specialUp(int special_key, int x, int y)
 
 void update()
 {
-    float TURN_SPEED = 0.05;
-    if (key_pressed['f'] || key_pressed['F'])
-    {
-        world->player_ship.setSpeed(2500);
-    }
-    else if (key_pressed['s'] || key_pressed['S'])
-    {
-        world->player_ship.setSpeed(50);
-        TURN_SPEED /= 5;
-    }
-    else
-    {
-        world->player_ship.setSpeed(250);
-    }
-    
-    if (special_key_pressed[GLUT_KEY_RIGHT])
-    {
-        world->player_ship.rotateAroundUp(-TURN_SPEED);
-    }
-    if (special_key_pressed[GLUT_KEY_LEFT])
-    {
-        world->player_ship.rotateAroundUp(TURN_SPEED);
-    }
-    if (special_key_pressed[GLUT_KEY_UP])
-    {
-        world->player_ship.rotateAroundRight(TURN_SPEED);
-    }
-    if (special_key_pressed[GLUT_KEY_DOWN])
-    {
-        world->player_ship.rotateAroundRight(-TURN_SPEED);
-    }
-    
-    if (key_pressed[' '])
-    {
-        if (world->player_ship.isAlive() && world->player_ship.isReloaded())
-        {
-            world->addBullet(world->player_ship.getPosition(),
-                            world->player_ship.getForward(),
-                            world->player_ship.getId());
-            world->player_ship.markReloading();
-        }
-    }
-    
+    PlayerInput input;
+    input.setHeld(PlayerInput::FAST, key_pressed['f'] || key_pressed['F']);
+    input.setHeld(PlayerInput::SLOW, key_pressed['s'] || key_pressed['S']);
+    input.setHeld(PlayerInput::TURN_RIGHT, special_key_pressed[GLUT_KEY_RIGHT]);
+    input.setHeld(PlayerInput::TURN_LEFT,  special_key_pressed[GLUT_KEY_LEFT]);
+    input.setHeld(PlayerInput::TURN_UP,    special_key_pressed[GLUT_KEY_UP]);
+    input.setHeld(PlayerInput::TURN_DOWN,  special_key_pressed[GLUT_KEY_DOWN]);
+    input.setHeld(PlayerInput::FIRE, key_pressed[' ']);
+    
+    if (replay != NULL)
+        replay->recordFrame(input, *world);
+    world->applyPlayerInput(input);
     world->updateAll();
     
     sleep(TimeSystem::getTimeToNextFrame());
@@ -0,0 +1,200 @@
+//
+//  Missile.cpp
+//
+
+#include <cassert>
+#include <istream>
+#include <ostream>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "TimeSystem.h"
+#include "WorldInterface.h"
+#include "PhysicsObject.h"
+#include "SnapshotStream.h"
+#include "Missile.h"
+
+namespace
+{
+	const double LONG_AGO       = -1.0e20;  // creation time for missiles created with default constructor
+	const double EXPLOSION_SIZE = 25.0;     // size of death explosion
+}
+
+
+
+const double Missile :: RADIUS        =    5.0;
+const double Missile :: LIFESPAN      =   10.0;
+const double Missile :: FUEL_DURATION =    6.0;
+const double Missile :: SPEED         = 1000.0;
+const double Missile :: TURN_RATE     =    1.5;
+
+
+
+Missile :: Missile ()
+		: PhysicsObject(RADIUS),
+		  m_source_id(PhysicsObjectId::ID_NOTHING),
+		  m_target_id(PhysicsObjectId::ID_NOTHING),
+		  m_creation_time(LONG_AGO),
+		  m_is_dead(true)
+{
+}
+
+Missile :: Missile (const Missile& original)
+		: PhysicsObject(original),
+		  m_source_id(original.m_source_id),
+		  m_target_id(original.m_target_id),
+		  m_creation_time(original.m_creation_time),
+		  m_is_dead(original.m_is_dead)
+{
+}
+
+Missile :: ~Missile ()
+{
+	// destructor for superclass will be invoked automatically
+}
+
+Missile& Missile :: operator= (const Missile& original)
+{
+	if(&original != this)
+	{
+		PhysicsObject::operator=(original);
+
+		m_source_id     = original.m_source_id;
+		m_target_id     = original.m_target_id;
+		m_creation_time = original.m_creation_time;
+		m_is_dead       = original.m_is_dead;
+	}
+	return *this;
+}
+
+
+
+const PhysicsObjectId& Missile :: getSourceId () const
+{
+	return m_source_id;
+}
+
+const PhysicsObjectId& Missile :: getTargetId () const
+{
+	return m_target_id;
+}
+
+bool Missile :: isOutOfFuel () const
+{
+	return m_creation_time + FUEL_DURATION < TimeSystem::getFrameStartTime();
+}
+
+
+
+void Missile :: fire (const Vector3& position,
+                      const Vector3& forward,
+                      const PhysicsObjectId& source_id,
+                      const PhysicsObjectId& target_id,
+                      PseudorandomGenerator& r_random)
+{
+	assert(forward.isNormal());
+
+	setPosition(position);
+	setPositionPreviousToCurrent();
+	setVelocity(forward * SPEED);
+	randomizeUpVector(r_random);
+
+	m_source_id     = source_id;
+	m_target_id     = target_id;
+	m_creation_time = TimeSystem::getFrameStartTime();
+	m_is_dead       = false;
+}
+
+
+
+///////////////////////////////////////////////////////////////
+//
+//  Virtual functions inherited from PhysicsObject
+//
+
+PhysicsObject* Missile :: getClone () const
+{
+	return new Missile(*this);
+}
+
+bool Missile :: isAlive () const
+{
+	return !m_is_dead;
+}
+
+bool Missile :: isDying () const
+{
+	assert(isAlive());
+
+	if(m_creation_time + LIFESPAN < TimeSystem::getFrameStartTime())
+		return true;
+	else
+		return false;
+}
+
+void Missile :: markDead (bool instant)
+{
+	m_creation_time = LONG_AGO;
+
+	if(instant)
+		m_is_dead = true;
+}
+
+void Missile :: update (WorldInterface& r_world)
+{
+	// explode if out of lifespan (or markDead(false) was called)
+	if(isAlive() && isDying())
+	{
+		r_world.addExplosion(getPositionPrevious(), EXPLOSION_SIZE, 0);
+		m_is_dead = true;
+
+		// no further updates
+		return;
+	}
+
+	if(!isOutOfFuel() &&
+	   m_target_id != PhysicsObjectId::ID_NOTHING &&
+	   r_world.isAlive(m_target_id))
+	{
+		Vector3 to_target = r_world.getPosition(m_target_id) - getPosition();
+		if(!to_target.isZero())
+			rotateTowards(to_target.getNormalized(), TURN_RATE * TimeSystem::getFrameDuration());
+	}
+
+	updateBasic();  // moves the Missile
+}
+
+void Missile :: writeState (std::ostream& r_out) const
+{
+	PhysicsObject::writeState(r_out);
+
+	SnapshotStream::writeId(r_out, m_source_id);
+	SnapshotStream::writeId(r_out, m_target_id);
+	SnapshotStream::writeValue(r_out, m_creation_time);
+	SnapshotStream::writeValue(r_out, m_is_dead);
+}
+
+bool Missile :: readState (std::istream& r_in)
+{
+	if(!PhysicsObject::readState(r_in))
+		return false;
+
+	PhysicsObjectId source_id;
+	PhysicsObjectId target_id;
+	double creation_time;
+	bool is_dead;
+
+	if(!SnapshotStream::readId(r_in, source_id)        ||
+	   !SnapshotStream::readId(r_in, target_id)        ||
+	   !SnapshotStream::readValue(r_in, creation_time) ||
+	   !SnapshotStream::readValue(r_in, is_dead))
+	{
+		return false;
+	}
+
+	m_source_id     = source_id;
+	m_target_id     = target_id;
+	m_creation_time = creation_time;
+	m_is_dead       = is_dead;
+	return true;
+}
@@ -0,0 +1,359 @@
+//
+//  Missile.h
+//
+
+#ifndef MISSILE_H
+#define MISSILE_H
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "PhysicsObjectId.h"
+#include "PhysicsObject.h"
+
+class DisplayList;
+class PseudorandomGenerator;
+
+class WorldInterface;
+
+
+
+//
+//  Missile
+//
+//  A class to represent a missile fired.  In addition to
+//    PhysicsObject fields, a Missile has an id for the source
+//    (normally a Ship) that shot it, an id for the target it is
+//    homing on, and a creation time.
+//
+//  A Missile turns towards its target at a limited rate until
+//    its fuel runs out FUEL_DURATION after its creation time.
+//    After that, or if the target is dead, it flies straight.
+//    Like a Bullet, a Missile disappears a fixed time interval
+//    LIFESPAN after its creation time.  A Missile is said to be
+//    alive before its lifespan has elapsed and dead after.
+//
+//  A Missile should not collide with the source that shot it.
+//
+
+class Missile : public PhysicsObject
+{
+public:
+//
+//  RADIUS
+//
+//  The default radius of the sphere used to represent a Missile
+//    for collision checking.
+//
+
+	static const double RADIUS;
+
+//
+//  LIFESPAN
+//
+//  The time between when a Missile is created and when it
+//    disappears.
+//
+
+	static const double LIFESPAN;
+
+//
+//  FUEL_DURATION
+//
+//  The time between when a Missile is created and when it runs
+//    out of fuel and stops turning.
+//
+
+	static const double FUEL_DURATION;
+
+//
+//  SPEED
+//
+//  The speed a Missile flies at.
+//
+
+	static const double SPEED;
+
+//
+//  TURN_RATE
+//
+//  The rate, in radians per second, at which a Missile with
+//    fuel turns towards its target.
+//
+
+	static const double TURN_RATE;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new stationary Missile at the origin.
+//  Paremeter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Missile is created at the origin.  The
+//               new Missile is dead, is not moving, has a
+//               creation time in the distant past, and has no
+//               known source or target.  No display list is
+//               set.
+//
+
+	Missile ();
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create a new Missile as a copy of another.
+//  Paremeter(s):
+//    <1> original: The Missile to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Missile is created with the same values
+//               as original.  This includes id, position,
+//               velocity, display list, source id, target id,
+//               and creation time.
+//
+
+	Missile (const Missile& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy a Missile without memory leaks.
+//  Paremeter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All dynamically allocated memory associated
+//               with this Missile is freed.
+//
+
+	virtual ~Missile ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To modify this Missile to be a copy of another.
+//  Paremeter(s):
+//    <1> original: The Missile to copy
+//  Precondition(s): N/A
+//  Returns: A reference to this Missile.
+//  Side Effect: The Missile is set to have the same values as
+//               original.  This includes id, position,
+//               velocity, display list, source id, target id,
+//               and creation time.
+//
+
+	Missile& operator= (const Missile& original);
+
+//
+//  getSourceId
+//
+//  Purpose: To determine the id of the source of this Missile.
+//           This is probably the Ship that fired it.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The id of the source of this Missile.  Collisions
+//           between this Missile and its source should be
+//           ignored.
+//  Side Effect: N/A
+//
+
+	const PhysicsObjectId& getSourceId () const;
+
+//
+//  getTargetId
+//
+//  Purpose: To determine the id of the target this Missile is
+//           homing on.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The id of the target of this Missile.  If it is
+//           not homing on a target, PhysicsObjectId::ID_NOTHING
+//           is returned.
+//  Side Effect: N/A
+//
+
+	const PhysicsObjectId& getTargetId () const;
+
+//
+//  isOutOfFuel
+//
+//  Purpose: To determine if this Missile has used up its fuel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether FUEL_DURATION has passed since the creation
+//           time of this Missile.
+//  Side Effect: N/A
+//
+
+	bool isOutOfFuel () const;
+
+//
+//  fire
+//
+//  Purpose: To modifiy this Missile to have just been fired
+//           from the specified position by the specified source
+//           at the specified target.
+//  Parameter(s):
+//    <1> position: The new position this Missile was fired from
+//    <2> forward: The direction this Missile was fired in
+//    <3> source_id: The id for the source that fired this
+//                   Missile
+//    <4> target_id: The id for the target to home on
+//    <5> r_random: The PseudorandomGenerator to use
+//  Precondition(s):
+//    <1> forward.isNormal()
+//  Returns: N/A
+//  Side Effect: This Missile is set to be at position position
+//               and moving in direction forward with speed
+//               SPEED.  It is marked as fired from the source
+//               with id source_id at the target with id
+//               target_id, and has a creation time of the
+//               current time.  Its previous position is also
+//               set to position.  Its up vector is chosen using
+//               r_random.
+//
+
+	void fire (const Vector3& position,
+	           const Vector3& forward,
+	           const PhysicsObjectId& source_id,
+	           const PhysicsObjectId& target_id,
+	           PseudorandomGenerator& r_random);
+
+///////////////////////////////////////////////////////////////
+//
+//  Virtual functions inherited from PhysicsObject
+//
+
+//
+//  getClone
+//
+//  Purpose: To create a dynamically allocated copy of this
+//           PhysicsObject.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A deep copy of this PhysicsObject.  This copy
+//           should be created using the copy constructor for
+//           the derived class.
+//  Side Effect: N/A
+//
+
+	virtual PhysicsObject* getClone () const;
+
+//
+//  isAlive
+//
+//  Purpose: To determine if this PhysicsObject is alive.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this PhysicsObject is alive.  If this
+//           PhysicsObject is of a type that cannot become dead,
+//           true is returned.
+//  Side Effect: N/A
+//
+
+	virtual bool isAlive () const;
+
+//
+//  isDying
+//
+//  Purpose: To determine if this PhysicsObject is currently
+//           dying.  This function can be used to prevent a
+//           PhysicsObject being counted twice.  For example, a
+//           bullet should not hit the same target twice.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isAlive()
+//  Returns: Whether this PhysicsObject is going to be marked as
+//           dead the next time that update is called.  If this
+//           PhysicsObject is of a type that cannot become dead,
+//           false is returned.
+//  Side Effect: N/A
+//
+
+	virtual bool isDying () const;
+
+//
+//  markDead
+//
+//  Purpose: To mark this PhysicsObject as dead.  Its creation
+//           time is set to somewhere in the distant past.
+//  Parameter(s):
+//    <1> instant: Whether the PhysicsObject should be marked as
+//                 dead immediately
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If instant == true, this PhysicisObject is
+//               marked as dead and no death explosion is
+//               generated.  Otherwise, this PhysicsObject is
+//               marked as dying.  The next time that update is
+//               called, it will generate a death explosion and
+//               be marked as dead.
+//
+
+	virtual void markDead (bool instant);
+
+//
+//  update
+//
+//  Purpose: To update this PhysicsObject for one frame.  This
+//           function does not perform collision checking or
+//           handling.
+//  Parameter(s):
+//    <1> r_world: An interface to the world this PhysicsObject
+//                 is in
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This PhysicsObject is updated for one frame.
+//               If it has fuel and its target is alive, it
+//               turns towards its target first.  Any queries
+//               about or changes to the world it is in are
+//               resolved through r_world.
+//
+
+	virtual void update (WorldInterface& r_world);
+
+//
+//  writeState
+//
+//  Purpose: To write the state of this Missile to the specified
+//           binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s):
+//    <1> r_out was opened in binary mode
+//  Returns: N/A
+//  Side Effect: The PhysicsObject state of this Missile is
+//               written to r_out, followed by its source id,
+//               target id, creation time, and whether it is
+//               dead.
+//
+
+	virtual void writeState (std::ostream& r_out) const;
+
+//
+//  readState
+//
+//  Purpose: To set this Missile to the state read from the
+//           specified binary stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s):
+//    <1> r_in was opened in binary mode
+//  Returns: Whether a valid state was read.
+//  Side Effect: A state written by writeState is read from
+//               r_in.  If it is valid, this Missile is set to
+//               have that state.
+//
+
+	virtual bool readState (std::istream& r_in);
+
+private:
+	PhysicsObjectId m_source_id;
+	PhysicsObjectId m_target_id;
+	double m_creation_time;
+	bool m_is_dead;
+};
+
+
+
+#endif
@@ -0,0 +1,48 @@
+//
+//  NearbyShipData.h
+//  cs409a5
+//
+
+#ifndef NearbyShipData_h
+#define NearbyShipData_h
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "PhysicsObjectId.h"
+
+//
+//  NearbyShipData
+//
+//  A record to store basic information about a single ship
+//    found by a spatial query, so that the caller does not
+//    have to look its position up again.  The distance is
+//    measured from the position the query was made from.
+//
+
+struct NearbyShipData
+{
+    PhysicsObjectId m_id;
+    Vector3 m_position;
+    double m_distance_squared;
+};
+
+//
+//  isNearbyShipCloser
+//
+//  Purpose: To determine if one ship query result should be
+//           sorted before another.  Nearer ships come first,
+//           and ships at the same distance are ordered by id,
+//           so the order never depends on the grid.
+//
+
+inline bool isNearbyShipCloser (const NearbyShipData& a,
+                                const NearbyShipData& b)
+{
+    if (a.m_distance_squared != b.m_distance_squared)
+        return a.m_distance_squared < b.m_distance_squared;
+    if (a.m_id.m_fleet != b.m_id.m_fleet)
+        return a.m_id.m_fleet < b.m_id.m_fleet;
+    return a.m_id.m_index < b.m_id.m_index;
+}
+
+#endif /* NearbyShipData_h */
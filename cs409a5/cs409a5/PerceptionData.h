@@ -0,0 +1,38 @@
+//
+//  PerceptionData.h
+//  cs409a5
+//
+
+#ifndef PerceptionData_h
+#define PerceptionData_h
+
+#include <vector>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "PhysicsObjectId.h"
+#include "RingParticleData.h"
+#include "NearbyShipData.h"
+
+//
+//  PerceptionData
+//
+//  A record to store the answer to one perception request: the
+//    ships and ring particles near a ship and the planetoid
+//    nearest to it.  The ships are sorted nearest first, as
+//    for WorldInterface::getShipsInSphere, and the ring
+//    particles are exactly those WorldInterface::getRingParticles
+//    would return.  The frame number is the TimeSystem frame
+//    that the answer was found in, so a unit AI can tell if it
+//    is out of date.
+//
+
+struct PerceptionData
+{
+    std::vector<NearbyShipData> mv_ships;
+    std::vector<RingParticleData> mv_ring_particles;
+    PhysicsObjectId m_nearest_planetoid;
+    unsigned int m_frame_number;
+};
+
+#endif /* PerceptionData_h */
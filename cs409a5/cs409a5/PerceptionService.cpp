@@ -0,0 +1,373 @@
+//
+//  PerceptionService.cpp
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "RingSectorIndex.h"
+#include "RingSystem.h"
+#include "WorldInterface.h"
+#include "SnapshotStream.h"
+#include "PerceptionService.h"
+
+using namespace std;
+namespace
+{
+	// requests with ship spheres centered in the same cell of
+	//  this size share a query; this is about the size of the
+	//  space patrolled around a moon
+	const double SHIP_GROUP_CELL_SIZE = 10000.0;
+
+	// added to the radius of a shared query so that rounding
+	//  cannot leave out a ship right at the edge of a request
+	const double SHIP_GROUP_RADIUS_MARGIN = 1.0;
+
+	//
+	//  calculateKey
+	//
+	//  Purpose: To pack 3 16-bit grid coordinates into a key that
+	//           is unique to them.
+	//
+
+	unsigned long long calculateKey (short x, short y, short z)
+	{
+		return ((unsigned long long)(unsigned short)(x) << 32) |
+		       ((unsigned long long)(unsigned short)(y) << 16) |
+		        (unsigned long long)(unsigned short)(z);
+	}
+
+	//
+	//  calculateShipGroupKey
+	//
+	//  Purpose: To calculate the key for the ship group cell that
+	//           contains the specified position.
+	//
+
+	unsigned long long calculateShipGroupKey (const Vector3& position)
+	{
+		return calculateKey((short)(floor(position.x / SHIP_GROUP_CELL_SIZE)),
+		                    (short)(floor(position.y / SHIP_GROUP_CELL_SIZE)),
+		                    (short)(floor(position.z / SHIP_GROUP_CELL_SIZE)));
+	}
+}
+
+
+
+PerceptionService :: PerceptionService ()
+		: mv_requests(),
+		  mv_results()
+{
+	m_stats.m_request_count    = 0;
+	m_stats.m_ship_query_count = 0;
+
+	assert(invariant());
+}
+
+
+
+unsigned int PerceptionService :: getSlotCount () const
+{
+	return (unsigned int)(mv_requests.size());
+}
+
+bool PerceptionService :: isRequestPending (unsigned int slot) const
+{
+	assert(slot < getSlotCount());
+
+	return mv_requests[slot].m_is_pending;
+}
+
+bool PerceptionService :: isReady (unsigned int slot) const
+{
+	assert(slot < getSlotCount());
+
+	return mv_requests[slot].m_is_ready;
+}
+
+const PerceptionStats& PerceptionService :: getStats () const
+{
+	return m_stats;
+}
+
+
+
+void PerceptionService :: init (unsigned int slot_count)
+{
+	Request empty;
+	empty.m_is_pending  = false;
+	empty.m_is_ready    = false;
+	empty.m_ship_radius = 0.0;
+	empty.m_ring_radius = 0.0;
+
+	mv_requests.assign(slot_count, empty);
+	mv_results.assign(slot_count, PerceptionData());
+
+	m_stats.m_request_count    = 0;
+	m_stats.m_ship_query_count = 0;
+
+	assert(invariant());
+}
+
+void PerceptionService :: request (unsigned int slot,
+                                   const Vector3& ship_sphere_center,
+                                   double ship_sphere_radius,
+                                   const Vector3& ring_sphere_center,
+                                   double ring_sphere_radius)
+{
+	assert(slot < getSlotCount());
+	assert(ship_sphere_radius >= 0.0);
+	assert(ring_sphere_radius >= 0.0);
+
+	Request& r_request = mv_requests[slot];
+	r_request.m_is_pending  = true;
+	r_request.m_ship_center = ship_sphere_center;
+	r_request.m_ship_radius = ship_sphere_radius;
+	r_request.m_ring_center = ring_sphere_center;
+	r_request.m_ring_radius = ring_sphere_radius;
+}
+
+void PerceptionService :: takeResult (unsigned int slot, PerceptionData& r_result)
+{
+	assert(slot < getSlotCount());
+	assert(isReady(slot));
+
+	PerceptionData& r_answer = mv_results[slot];
+	r_answer.mv_ships.swap(r_result.mv_ships);
+	r_answer.mv_ring_particles.swap(r_result.mv_ring_particles);
+	r_result.m_nearest_planetoid = r_answer.m_nearest_planetoid;
+	r_result.m_frame_number      = r_answer.m_frame_number;
+	mv_requests[slot].m_is_ready = false;
+}
+
+void PerceptionService :: answerAll (const WorldInterface& world,
+                                     const RingSystem& rings,
+                                     unsigned int frame_number)
+{
+	mv_pending.clear();
+	for(unsigned int s = 0; s < getSlotCount(); s++)
+		if(mv_requests[s].m_is_pending)
+			mv_pending.push_back(s);
+
+	m_stats.m_request_count    = (unsigned int)(mv_pending.size());
+	m_stats.m_ship_query_count = 0;
+	if(mv_pending.empty())
+		return;
+
+	answerShips(world);
+	answerRingParticles(rings);
+
+	for(unsigned int p = 0; p < mv_pending.size(); p++)
+	{
+		unsigned int slot = mv_pending[p];
+		Request& r_request = mv_requests[slot];
+		mv_results[slot].m_nearest_planetoid = world.getNearestPlanetoidId(r_request.m_ship_center);
+		mv_results[slot].m_frame_number      = frame_number;
+		r_request.m_is_pending = false;
+		r_request.m_is_ready   = true;
+	}
+
+	assert(invariant());
+}
+
+
+
+void PerceptionService :: writeState (ostream& r_out) const
+{
+	SnapshotStream::writeValue(r_out, getSlotCount());
+	for(unsigned int s = 0; s < getSlotCount(); s++)
+	{
+		const Request& request = mv_requests[s];
+		SnapshotStream::writeValue(r_out, request.m_is_pending);
+		SnapshotStream::writeValue(r_out, request.m_is_ready);
+
+		// the rest of a request or answer that is not in use
+		//  is left over from before, and never read again
+		if(request.m_is_pending)
+		{
+			SnapshotStream::writeVector3(r_out, request.m_ship_center);
+			SnapshotStream::writeValue  (r_out, request.m_ship_radius);
+			SnapshotStream::writeVector3(r_out, request.m_ring_center);
+			SnapshotStream::writeValue  (r_out, request.m_ring_radius);
+		}
+		if(request.m_is_ready)
+		{
+			const PerceptionData& result = mv_results[s];
+			SnapshotStream::writeNearbyShips  (r_out, result.mv_ships);
+			SnapshotStream::writeRingParticles(r_out, result.mv_ring_particles);
+			SnapshotStream::writeId           (r_out, result.m_nearest_planetoid);
+		}
+	}
+}
+
+bool PerceptionService :: readState (istream& r_in,
+                                     unsigned int frame_number)
+{
+	unsigned int slot_count;
+	if(!SnapshotStream::readValue(r_in, slot_count))
+		return false;
+	if(slot_count != getSlotCount())
+		return false;
+
+	vector<Request> v_requests(mv_requests);
+	vector<PerceptionData> v_results(slot_count);
+	for(unsigned int s = 0; s < slot_count; s++)
+	{
+		Request& r_request = v_requests[s];
+		if(!SnapshotStream::readValue(r_in, r_request.m_is_pending) ||
+		   !SnapshotStream::readValue(r_in, r_request.m_is_ready))
+		{
+			return false;
+		}
+
+		if(r_request.m_is_pending)
+		{
+			if(!SnapshotStream::readVector3(r_in, r_request.m_ship_center) ||
+			   !SnapshotStream::readValue  (r_in, r_request.m_ship_radius) ||
+			   !SnapshotStream::readVector3(r_in, r_request.m_ring_center) ||
+			   !SnapshotStream::readValue  (r_in, r_request.m_ring_radius) ||
+			   r_request.m_ship_radius < 0.0 ||
+			   r_request.m_ring_radius < 0.0)
+			{
+				return false;
+			}
+		}
+		if(r_request.m_is_ready)
+		{
+			PerceptionData& r_result = v_results[s];
+			if(!SnapshotStream::readNearbyShips  (r_in, r_result.mv_ships)            ||
+			   !SnapshotStream::readRingParticles(r_in, r_result.mv_ring_particles)   ||
+			   !SnapshotStream::readId           (r_in, r_result.m_nearest_planetoid))
+			{
+				return false;
+			}
+
+			// an answer is only used in the frame it is made in,
+			//  so any earlier frame will do (before frame 0, this
+			//  wraps around to a frame that is never reached)
+			r_result.m_frame_number = frame_number - 1;
+		}
+	}
+
+	mv_requests.swap(v_requests);
+	mv_results .swap(v_results);
+
+	assert(invariant());
+	return true;
+}
+
+
+
+void PerceptionService :: answerShips (const WorldInterface& world)
+{
+	// sort the requests by cell, keeping them in slot order
+	//  within each cell so the answers never depend on threads
+	mv_ship_groups.clear();
+	for(unsigned int p = 0; p < mv_pending.size(); p++)
+	{
+		unsigned int slot = mv_pending[p];
+		unsigned long long key = calculateShipGroupKey(mv_requests[slot].m_ship_center);
+		mv_ship_groups.push_back(make_pair(key, slot));
+	}
+	sort(mv_ship_groups.begin(), mv_ship_groups.end());
+
+	unsigned int group_begin = 0;
+	while(group_begin < mv_ship_groups.size())
+	{
+		unsigned int group_end = group_begin + 1;
+		while(group_end < mv_ship_groups.size() &&
+		      mv_ship_groups[group_end].first == mv_ship_groups[group_begin].first)
+		{
+			group_end++;
+		}
+
+		// one sphere around every request in the group
+		Vector3 low  = mv_requests[mv_ship_groups[group_begin].second].m_ship_center;
+		Vector3 high = low;
+		for(unsigned int g = group_begin + 1; g < group_end; g++)
+		{
+			const Vector3& center = mv_requests[mv_ship_groups[g].second].m_ship_center;
+			low .x = min(low .x, center.x);
+			low .y = min(low .y, center.y);
+			low .z = min(low .z, center.z);
+			high.x = max(high.x, center.x);
+			high.y = max(high.y, center.y);
+			high.z = max(high.z, center.z);
+		}
+		Vector3 group_center = (low + high) * 0.5;
+		double group_radius = 0.0;
+		for(unsigned int g = group_begin; g < group_end; g++)
+		{
+			const Request& request = mv_requests[mv_ship_groups[g].second];
+			double radius = group_center.getDistance(request.m_ship_center) + request.m_ship_radius;
+			if(radius > group_radius)
+				group_radius = radius;
+		}
+
+		world.getShipsInSphere(group_center,
+		                       group_radius + SHIP_GROUP_RADIUS_MARGIN,
+		                       mv_group_ships);
+		m_stats.m_ship_query_count++;
+
+		for(unsigned int g = group_begin; g < group_end; g++)
+		{
+			unsigned int slot = mv_ship_groups[g].second;
+			const Request& request = mv_requests[slot];
+			double radius_squared = request.m_ship_radius * request.m_ship_radius;
+
+			vector<NearbyShipData>& r_ships = mv_results[slot].mv_ships;
+			r_ships.clear();
+			for(unsigned int i = 0; i < mv_group_ships.size(); i++)
+			{
+				double distance_squared = request.m_ship_center.getDistanceSquared(mv_group_ships[i].m_position);
+				if(distance_squared < radius_squared)
+				{
+					NearbyShipData data = { mv_group_ships[i].m_id,
+					                        mv_group_ships[i].m_position,
+					                        distance_squared };
+					r_ships.push_back(data);
+				}
+			}
+			sort(r_ships.begin(), r_ships.end(), isNearbyShipCloser);
+		}
+
+		group_begin = group_end;
+	}
+}
+
+void PerceptionService :: answerRingParticles (const RingSystem& rings)
+{
+	// Few requests share ring sectors, and a sector fetch from
+	//  the cache is cheaper than finding the ones they do share,
+	//  so each answer reads its own sectors.  Building it in
+	//  place still saves the new vector getRingParticles makes.
+	for(unsigned int p = 0; p < mv_pending.size(); p++)
+	{
+		unsigned int slot = mv_pending[p];
+		const Request& request = mv_requests[slot];
+
+		mv_sector_indexes.clear();
+		RingSystem::appendRingSectorIndexes(request.m_ring_center,
+		                                    request.m_ring_radius,
+		                                    mv_sector_indexes);
+
+		vector<RingParticleData>& r_particles = mv_results[slot].mv_ring_particles;
+		r_particles.clear();
+		for(unsigned int i = 0; i < mv_sector_indexes.size(); i++)
+			RingSystem::appendRingParticleData(*rings.getRingSector(mv_sector_indexes[i]),
+			                                   r_particles);
+	}
+}
+
+bool PerceptionService :: invariant () const
+{
+	if(mv_requests.size() != mv_results.size()) return false;
+	return true;
+}
@@ -0,0 +1,347 @@
+//
+//  PerceptionService.h
+//
+
+#ifndef PERCEPTION_SERVICE_H
+#define PERCEPTION_SERVICE_H
+
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "RingSectorIndex.h"
+#include "RingParticleData.h"
+#include "NearbyShipData.h"
+#include "PerceptionData.h"
+
+class WorldInterface;
+class RingSystem;
+
+
+
+//
+//  PerceptionStats
+//
+//  A record of how much work the perception requests for one
+//    frame took.  Without the sharing, there would be one ship
+//    query for every request.
+//
+
+struct PerceptionStats
+{
+	unsigned int m_request_count;
+	unsigned int m_ship_query_count;
+};
+
+
+
+//
+//  PerceptionService
+//
+//  A class to answer the scans that unit AIs make of the world
+//    around them in batches.  Each requester is identified by a
+//    slot number.  A unit AI requests the ships in one sphere
+//    and the ring particles in another, and the answer is ready
+//    after the next call to answerAll.  The answer stays
+//    available until it is taken or the answer to the next
+//    request replaces it.
+//
+//  All the requests made since the last call to answerAll are
+//    answered together.  Requests whose ship spheres are
+//    centered in the same cell of a coarse grid share one
+//    query for a sphere around all of them, and each request
+//    then keeps only the ships in its own sphere.  The ring
+//    particles are built directly into the answers.
+//  The answers are exactly what the corresponding
+//    WorldInterface queries would have returned at the time
+//    answerAll was called.
+//
+//  Different slots can be requested from different threads at
+//    the same time, but not while answerAll is running.
+//
+//  Class Invariant:
+//    <1> mv_requests.size() == mv_results.size()
+//
+
+class PerceptionService
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new PerceptionService with no slots.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new PerceptionService is created with no
+//               slots.
+//
+
+	PerceptionService ();
+
+//
+//  getSlotCount
+//
+//  Purpose: To determine the number of requester slots.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of slots.
+//  Side Effect: N/A
+//
+
+	unsigned int getSlotCount () const;
+
+//
+//  isRequestPending
+//
+//  Purpose: To determine if the specified slot has a request
+//           that has not been answered yet.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//  Returns: Whether slot slot has an unanswered request.
+//  Side Effect: N/A
+//
+
+	bool isRequestPending (unsigned int slot) const;
+
+//
+//  isReady
+//
+//  Purpose: To determine if the specified slot has an answer.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//  Returns: Whether a request for slot slot has been answered
+//           and the answer has not been taken.
+//  Side Effect: N/A
+//
+
+	bool isReady (unsigned int slot) const;
+
+//
+//  getStats
+//
+//  Purpose: To determine how much work the most recent call to
+//           answerAll did.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The statistics for the most recent call to
+//           answerAll.  If answerAll has not been called since
+//           init, all the counts are 0.
+//  Side Effect: N/A
+//
+
+	const PerceptionStats& getStats () const;
+
+//
+//  init
+//
+//  Purpose: To set the number of requester slots.
+//  Parameter(s):
+//    <1> slot_count: The number of slots
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This PerceptionService is set to have
+//               slot_count slots with no requests and no
+//               answers.
+//
+
+	void init (unsigned int slot_count);
+
+//
+//  request
+//
+//  Purpose: To request a scan of the world for the specified
+//           slot.
+//  Parameter(s):
+//    <1> slot: The slot
+//    <2> ship_sphere_center: The center of the sphere to find
+//                            ships in
+//    <3> ship_sphere_radius: The radius of the sphere to find
+//                            ships in
+//    <4> ring_sphere_center: The center of the sphere to find
+//                            ring particles in
+//    <5> ring_sphere_radius: The radius of the sphere to find
+//                            ring particles in
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//    <2> ship_sphere_radius >= 0.0
+//    <3> ring_sphere_radius >= 0.0
+//  Returns: N/A
+//  Side Effect: A request is recorded for slot slot, replacing
+//               any earlier request that has not been answered.
+//               The nearest planetoid in the answer is found
+//               from ship_sphere_center.
+//
+
+	void request (unsigned int slot,
+	              const Vector3& ship_sphere_center,
+	              double ship_sphere_radius,
+	              const Vector3& ring_sphere_center,
+	              double ring_sphere_radius);
+
+//
+//  takeResult
+//
+//  Purpose: To retrieve the answer for the specified slot.
+//  Parameter(s):
+//    <1> slot: The slot
+//    <2> r_result: A PerceptionData to put the answer in
+//  Precondition(s):
+//    <1> slot < getSlotCount()
+//    <2> isReady(slot)
+//  Returns: N/A
+//  Side Effect: The answer for slot slot is swapped with
+//               r_result, so r_result gets the answer and its
+//               earlier contents are reused for the next
+//               answer.  The nearest planetoid and frame number
+//               are copied.  Slot slot is no longer ready.
+//
+
+	void takeResult (unsigned int slot, PerceptionData& r_result);
+
+//
+//  answerAll
+//
+//  Purpose: To answer all the requests that are pending.
+//  Parameter(s):
+//    <1> world: The World to find ships and planetoids in
+//    <2> rings: The RingSystem to find ring particles in
+//    <3> frame_number: The number of the current frame
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Every pending request is answered and is no
+//               longer pending.  Each answer is marked with
+//               frame_number.  The statistics are replaced
+//               with the ones for these requests.  Any ring
+//               sectors that are needed and have not been
+//               generated are generated.
+//
+
+	void answerAll (const WorldInterface& world,
+	                const RingSystem& rings,
+	                unsigned int frame_number);
+
+//
+//  writeState
+//
+//  Purpose: To write the requests and answers of this
+//           PerceptionService to a binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The slot count is written to r_out, followed by
+//               the request for each slot that is pending and
+//               the answer for each slot that is ready.  The
+//               statistics are not written.  Neither is the
+//               frame number of each answer, because an answer
+//               is only used in the frame it is made in, and a
+//               replay numbers its frames differently.
+//
+
+	void writeState (std::ostream& r_out) const;
+
+//
+//  readState
+//
+//  Purpose: To read the requests and answers of this
+//           PerceptionService from a binary stream, as written
+//           by writeState.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//    <2> frame_number: The number of the current frame
+//  Precondition(s): N/A
+//  Returns: Whether a valid state could be read.  If the slot
+//           count does not match getSlotCount(), false is
+//           returned.
+//  Side Effect: If true is returned, every slot is set to have
+//               the request and answer read, with each answer
+//               marked as made in the frame before
+//               frame_number.  Otherwise, this
+//               PerceptionService is unchanged.
+//
+
+	bool readState (std::istream& r_in,
+	                unsigned int frame_number);
+
+private:
+//
+//  answerShips
+//
+//  Purpose: To find the ships for all the requests in
+//           mv_pending.
+//  Parameter(s):
+//    <1> world: The World to find ships in
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The ships in the answer for every slot in
+//               mv_pending are replaced.
+//
+
+	void answerShips (const WorldInterface& world);
+
+//
+//  answerRingParticles
+//
+//  Purpose: To find the ring particles for all the requests in
+//           mv_pending.
+//  Parameter(s):
+//    <1> rings: The RingSystem to find ring particles in
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The ring particles in the answer for every slot
+//               in mv_pending are replaced.
+//
+
+	void answerRingParticles (const RingSystem& rings);
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	//
+	//  Request
+	//
+	//  A record of the most recent request for one slot.
+	//
+
+	struct Request
+	{
+		bool m_is_pending;
+		bool m_is_ready;
+		Vector3 m_ship_center;
+		double m_ship_radius;
+		Vector3 m_ring_center;
+		double m_ring_radius;
+	};
+
+private:
+	std::vector<Request> mv_requests;
+	std::vector<PerceptionData> mv_results;
+	PerceptionStats m_stats;
+
+	// working space for answerAll, kept to avoid reallocating
+	std::vector<unsigned int> mv_pending;
+	std::vector<std::pair<unsigned long long, unsigned int> > mv_ship_groups;
+	std::vector<NearbyShipData> mv_group_ships;
+	std::vector<RingSectorIndex> mv_sector_indexes;
+};
+
+
+
+#endif
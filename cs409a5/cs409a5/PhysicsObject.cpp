@@ -3,8 +3,9 @@
 //
 
 #include <cassert>
-#include <cstdlib>  // for rand()
 #include <iostream>
+#include <istream>
+#include <ostream>
 #include "GetGlut.h"
 
 #include "Pi.h"
@@ -12,7 +13,10 @@
 #include "../../ObjLibrary/DisplayList.h"
 
 #include "TimeSystem.h"
+#include "Quaternion.h"
 #include "CoordinateSystem.h"
+#include "PseudorandomGenerator.h"
+#include "SnapshotStream.h"
 #include "PhysicsObject.h"
 
 using namespace std;
@@ -21,6 +25,7 @@ namespace
 	const double RADIUS_DEFAULT        = 0.0;
 	const double SPEED_DEFAULT         = 0.0;
 	const double DISPLAY_SCALE_DEFAULT = 1.0;
+	const unsigned int ROTATE_BATCH_SIZE = 64;
 }
 
 
@@ -226,7 +231,7 @@ void PhysicsObject :: initPhysics (const PhysicsObjectId& id,
 {
 	assert(id != PhysicsObjectId::ID_NOTHING);
 	assert(radius >= 0.0);
-	assert(display_list.isReady());
+	assert(display_list.isReady() || display_list.isEmpty());
 	assert(display_scale >= 0.0);
 
 	double speed = velocity.getNorm();
@@ -239,7 +244,7 @@ void PhysicsObject :: initPhysics (const PhysicsObjectId& id,
 	m_position_previous = position;
 	m_radius            = radius;
 	m_speed             = speed;
-	mp_display_list     = &display_list;
+	mp_display_list     = display_list.isReady() ? &display_list : NULL;
 	m_display_scale     = display_scale;
 
 	assert(invariant());
@@ -347,6 +352,39 @@ void PhysicsObject :: rotateTowards (const Vector3& forward,
 	assert(invariant());
 }
 
+void PhysicsObject :: rotateTowardsBatch (PhysicsObject* ap_objects[],
+                                          const Vector3 a_forwards[],
+                                          const double a_max_radians[],
+                                          unsigned int count)
+{
+	assert(count == 0 || ap_objects    != NULL);
+	assert(count == 0 || a_forwards    != NULL);
+	assert(count == 0 || a_max_radians != NULL);
+
+	// pass the coordinate systems on in fixed-size groups
+	CoordinateSystem* ap_systems[ROTATE_BATCH_SIZE];
+	for(unsigned int start = 0; start < count; start += ROTATE_BATCH_SIZE)
+	{
+		unsigned int group_count = count - start;
+		if(group_count > ROTATE_BATCH_SIZE)
+			group_count = ROTATE_BATCH_SIZE;
+
+		for(unsigned int i = 0; i < group_count; i++)
+		{
+			assert(ap_objects[start + i] != NULL);
+			assert(a_forwards[start + i].isNormal());
+			ap_systems[i] = &(ap_objects[start + i]->m_coordinates);
+		}
+		CoordinateSystem::rotateToVectorBatch(ap_systems,
+		                                      a_forwards    + start,
+		                                      a_max_radians + start,
+		                                      group_count);
+
+		for(unsigned int i = 0; i < group_count; i++)
+			assert(ap_objects[start + i]->invariant());
+	}
+}
+
 void PhysicsObject :: setSpeed (double speed)
 {
 	assert(speed >= 0.0);
@@ -391,24 +429,80 @@ void PhysicsObject :: setDisplayListNone ()
 	assert(invariant());
 }
 
-void PhysicsObject :: randomizeUpVector ()
+void PhysicsObject :: randomizeUpVector (PseudorandomGenerator& r_random)
 {
-	double random0to1 = rand() / (RAND_MAX + 1.0);
-	m_coordinates.rotateAroundForward(random0to1 * TWO_PI);
+	m_coordinates.rotateAroundForward(r_random.getNext01() * TWO_PI);
 
 	assert(invariant());
 }
 
-void PhysicsObject :: randomizeOrientation ()
+void PhysicsObject :: randomizeOrientation (PseudorandomGenerator& r_random)
 {
 	// randomize forward direction
-	m_coordinates.setOrientation(Vector3::getRandomUnitVector());
+	m_coordinates.setOrientation(r_random.getNextUnitVector());
 
-	randomizeUpVector();
+	randomizeUpVector(r_random);
 
 	assert(invariant());
 }
 
+void PhysicsObject :: writeState (ostream& r_out) const
+{
+	SnapshotStream::writeValue  (r_out, m_id.m_type);
+	SnapshotStream::writeValue  (r_out, m_id.m_fleet);
+	SnapshotStream::writeValue  (r_out, m_id.m_index);
+	SnapshotStream::writeVector3(r_out, m_coordinates.getPosition());
+	SnapshotStream::writeValue  (r_out, m_coordinates.getOrientation().w);
+	SnapshotStream::writeValue  (r_out, m_coordinates.getOrientation().x);
+	SnapshotStream::writeValue  (r_out, m_coordinates.getOrientation().y);
+	SnapshotStream::writeValue  (r_out, m_coordinates.getOrientation().z);
+	SnapshotStream::writeVector3(r_out, m_position_previous);
+	SnapshotStream::writeValue  (r_out, m_radius);
+	SnapshotStream::writeValue  (r_out, m_speed);
+}
+
+bool PhysicsObject :: readState (istream& r_in)
+{
+	PhysicsObjectId id;
+	Vector3 position;
+	Quaternion orientation;
+	Vector3 position_previous;
+	double radius;
+	double speed;
+
+	if(!SnapshotStream::readValue  (r_in, id.m_type)        ||
+	   !SnapshotStream::readValue  (r_in, id.m_fleet)       ||
+	   !SnapshotStream::readValue  (r_in, id.m_index)       ||
+	   !SnapshotStream::readVector3(r_in, position)         ||
+	   !SnapshotStream::readValue  (r_in, orientation.w)    ||
+	   !SnapshotStream::readValue  (r_in, orientation.x)    ||
+	   !SnapshotStream::readValue  (r_in, orientation.y)    ||
+	   !SnapshotStream::readValue  (r_in, orientation.z)    ||
+	   !SnapshotStream::readVector3(r_in, position_previous) ||
+	   !SnapshotStream::readValue  (r_in, radius)           ||
+	   !SnapshotStream::readValue  (r_in, speed))
+	{
+		return false;
+	}
+
+	if(id == PhysicsObjectId::ID_NOTHING ||
+	   radius < 0.0 || speed < 0.0 ||
+	   !orientation.isFinite() || !orientation.isNormal())
+	{
+		return false;
+	}
+
+	m_id                = id;
+	m_coordinates       = CoordinateSystem(position);
+	m_coordinates.setOrientation(orientation);
+	m_position_previous = position_previous;
+	m_radius            = radius;
+	m_speed             = speed;
+
+	assert(invariant());
+	return true;
+}
+
 
 
 //
@@ -8,6 +8,8 @@
 #ifndef PHYSICS_OBJECT_H
 #define PHYSICS_OBJECT_H
 
+#include <iosfwd>
+
 #include "../../ObjLibrary/Vector3.h"
 
 #include "PhysicsObjectId.h"
@@ -15,6 +17,7 @@
 
 class DisplayList;
 class WorldInterface;
+class PseudorandomGenerator;
 
 
 
@@ -43,6 +46,13 @@ class WorldInterface;
 //  There exist functions to determine and change the position,
 //    orientation, size, current speed, and id.  There are also
 //    functions to give a PhysicsObject a random orientation.
+//    These can take a PseudorandomGenerator so that the
+//    orientation chosen is repeatable.
+//
+//  The state of a PhysicsObject can be written to and read from
+//    a binary stream with writeState and readState.  These
+//    functions are used to save a snapshot of the world.
+//    Subclasses with more state should override them.
 //
 //  The previous position is intended to be used for death
 //    explosions.  If the current position is used, the
@@ -441,7 +451,7 @@ public:
 //  Precondition(s):
 //    <1> id != PhysicsObjectId::ID_NOTHING
 //    <2> radius >= 0.0
-//    <3> display_list.isReady()
+//    <3> display_list.isReady() || display_list.isEmpty()
 //    <4> display_scale >= 0.0
 //  Returns: N/A
 //  Side Effect: This PhysicsObject is set to be at position
@@ -457,7 +467,9 @@ public:
 //               PhysicsObject has a previous position of the
 //               current position and is set to be displayed
 //               with display list display_list scaled by
-//               scaling factor display_scale.
+//               scaling factor display_scale.  If display_list
+//               is empty, this PhysicsObject is set to have no
+//               display list, as when running without graphics.
 //
 
 	void initPhysics (const PhysicsObjectId& id,
@@ -669,6 +681,34 @@ public:
 	void rotateTowards (const Vector3& forward,
 	                    double max_radians);
 
+//
+//  rotateTowardsBatch
+//
+//  Purpose: To rotate many PhysicsObjects towards the specified
+//           directions together.
+//  Parameter(s):
+//    <1> ap_objects: The PhysicsObjects to rotate
+//    <2> a_forwards: The desired forward direction for each
+//    <3> a_max_radians: The maximum angle to rotate each by
+//    <4> count: The number of PhysicsObjects
+//  Precondition(s):
+//    <1> count == 0 || ap_objects != NULL
+//    <2> count == 0 || a_forwards != NULL
+//    <3> count == 0 || a_max_radians != NULL
+//    <4> ap_objects[i] != NULL for all i < count
+//    <5> a_forwards[i].isNormal() for all i < count
+//    <6> a_max_radians[i] >= 0.0 for all i < count
+//  Returns: N/A
+//  Side Effect: Each PhysicsObject ap_objects[i] is rotated as
+//               rotateTowards(a_forwards[i], a_max_radians[i])
+//               would rotate it.
+//
+
+	static void rotateTowardsBatch (PhysicsObject* ap_objects[],
+	                                const Vector3 a_forwards[],
+	                                const double a_max_radians[],
+	                                unsigned int count);
+
 //
 //  setSpeed
 //
@@ -771,41 +811,86 @@ public:
 //  randomizeUpVector
 //
 //  Purpose: To rotate this PhysicsObject so that the up vector
-//           of its local coordinate system is in a random
-//           direction.
-//  Parameter(s): N/A
+//           of its local coordinate system is in a pseudorandom
+//           direction chosen by the specified generator.
+//  Parameter(s):
+//    <1> r_random: The PseudorandomGenerator to use
 //  Precondition(s): N/A
 //  Returns: N/A
 //  Side Effect: This PhysicsObject is rotated around its
-//               forward vector by a random amount, changing its
-//               local up vector.  The local up vector is
-//               undefined but guarenteed to be at a right angle
-//               to the forward vector.  The local right vector
-//               will be correct for the new orientation.  The
-//               current velocity does not change.
+//               forward vector by a pseudorandom amount,
+//               changing its local up vector.  The local up
+//               vector is undefined but guarenteed to be at a
+//               right angle to the forward vector.  The local
+//               right vector will be correct for the new
+//               orientation.  The current velocity does not
+//               change.  r_random advances one value.
 //
 
-	void randomizeUpVector ();
+	void randomizeUpVector (PseudorandomGenerator& r_random);
 
 //
 //  randomizeOrientation
 //
 //  Purpose: To rotate this PhysicsObject so that its local
-//           coordinate system is oriented randomly.
-//  Parameter(s): N/A
+//           coordinate system is oriented in a pseudorandom
+//           direction chosen by the specified generator.
+//  Parameter(s):
+//    <1> r_random: The PseudorandomGenerator to use
 //  Precondition(s): N/A
 //  Returns: N/A
 //  Side Effect: This PhysicsObject is rotated to be facing in a
-//               random direction.  The local up vector is
+//               pseudorandom direction.  The local up vector is
 //               undefined but guarenteed to be at a right angle
 //               to the forward vector.  The local right vector
 //               will be correct for the new orientation.  The
 //               current speed does not change, but the
 //               direction of motion is set to the new forward
-//               vector.
+//               vector.  r_random advances three values.
 //
 
-	void randomizeOrientation ();
+	void randomizeOrientation (PseudorandomGenerator& r_random);
+
+//
+//  writeState
+//
+//  Purpose: To write the state of this PhysicsObject to the
+//           specified binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s):
+//    <1> r_out was opened in binary mode
+//  Returns: N/A
+//  Side Effect: The id, position, orientation, previous
+//               position, size, and speed of this PhysicsObject
+//               are written to r_out.  The display list and
+//               display scale are not written.  A subclass that
+//               overrides this function should call it before
+//               writing its own state.
+//
+
+	virtual void writeState (std::ostream& r_out) const;
+
+//
+//  readState
+//
+//  Purpose: To set this PhysicsObject to the state read from
+//           the specified binary stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s):
+//    <1> r_in was opened in binary mode
+//  Returns: Whether a valid state was read.
+//  Side Effect: A state written by writeState is read from
+//               r_in.  If it is valid, this PhysicsObject is
+//               set to have that state.  Otherwise, this
+//               PhysicsObject is unchanged.  The display list
+//               and display scale are never changed.  A
+//               subclass that overrides this function should
+//               call it before reading its own state.
+//
+
+	virtual bool readState (std::istream& r_in);
 
 //
 //  getClone
@@ -144,7 +144,7 @@ void Planetoid :: initPlanetoid (const PhysicsObjectId& id,
 {
 	assert(id != PhysicsObjectId::ID_NOTHING);
 	assert(radius >= 0.0);
-	assert(display_list.isReady());
+	assert(display_list.isReady() || display_list.isEmpty());
 	assert(display_scale >= 0.0);
 
 	initPhysics(id,
@@ -210,7 +210,7 @@ public:
 //  Precondition(s):
 //    <1> id != PhysicsObjectId::ID_NOTHING
 //    <2> radius >= 0.0
-//    <3> display_list.isReady()
+//    <3> display_list.isReady() || display_list.isEmpty()
 //    <4> display_scale >= 0.0
 //  Returns: N/A
 //  Side Effect: This Planetoid is set to be at position
@@ -223,7 +223,8 @@ public:
 //               PhysicsObjectId::FLEET_NATURE, and is not
 //               actively claimed.  It is displayed with display
 //               list display_list scaled by scaling factor
-//               display_scale.
+//               display_scale.  If display_list is empty, this
+//               Planetoid is set to have no display list.
 //
 
 	void initPlanetoid (const PhysicsObjectId& id,
@@ -0,0 +1,99 @@
+//
+//  PlayerInput.h
+//
+//  A record of the controls the player is holding down.
+//
+
+#ifndef PLAYER_INPUT_H
+#define PLAYER_INPUT_H
+
+
+
+//
+//  PlayerInput
+//
+//  A record of the controls the player is holding down during
+//    one frame.  Each control is a bit in m_controls, so a
+//    PlayerInput is a single byte and a recording of the
+//    player's input for a whole game is small.
+//
+//  The program reading the keyboard sets the controls and
+//    passes the PlayerInput to World::applyPlayerInput.  The
+//    same PlayerInput values can later be applied again to
+//    replay the game.
+//
+
+struct PlayerInput
+{
+//
+//  Controls
+//
+//  The bits for each control.  FAST and SLOW change the speed
+//    of the player ship, the TURN controls rotate it, and FIRE
+//    fires a bullet if the ship is reloaded.
+//
+
+	static const unsigned char FAST       = 0x01;
+	static const unsigned char SLOW       = 0x02;
+	static const unsigned char TURN_LEFT  = 0x04;
+	static const unsigned char TURN_RIGHT = 0x08;
+	static const unsigned char TURN_UP    = 0x10;
+	static const unsigned char TURN_DOWN  = 0x20;
+	static const unsigned char FIRE       = 0x40;
+
+//
+//  Default Constructor
+//
+//  Purpose: To create a PlayerInput with no controls held.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new PlayerInput is created with no controls
+//               held.
+//
+
+	PlayerInput ()
+			: m_controls(0)
+	{ }
+
+//
+//  isHeld
+//
+//  Purpose: To determine if the specified control is held.
+//  Parameter(s):
+//    <1> control: The bit for the control
+//  Precondition(s): N/A
+//  Returns: Whether control control is held.
+//  Side Effect: N/A
+//
+
+	bool isHeld (unsigned char control) const
+	{	return (m_controls & control) != 0;	}
+
+//
+//  setHeld
+//
+//  Purpose: To change whether the specified control is held.
+//  Parameter(s):
+//    <1> control: The bit for the control
+//    <2> is_held: Whether the control is held
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Control control is marked as held if is_held
+//               == true and as not held otherwise.
+//
+
+	void setHeld (unsigned char control, bool is_held)
+	{
+		if(is_held)
+			m_controls |= control;
+		else
+			m_controls &= ~control;
+	}
+
+	unsigned char m_controls;
+};
+
+
+
+#endif
@@ -0,0 +1,255 @@
+//
+//  ProjectilePool.cpp
+//
+
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "SnapshotStream.h"
+#include "ProjectilePool.h"
+
+using namespace std;
+
+namespace
+{
+	const unsigned int NOT_LIVE = ~0u;
+	const unsigned short NO_SLOT = 0xFFFF;
+}
+
+
+
+ProjectilePool :: ProjectilePool ()
+		: mv_index(),
+		  mv_index_slot(),
+		  m_next_index(0),
+		  mv_live(),
+		  mv_live_position(),
+		  mv_free(),
+		  m_free_first(0),
+		  m_free_count(0)
+{
+	assert(invariant());
+}
+
+
+
+unsigned int ProjectilePool :: getCapacity () const
+{
+	return (unsigned int)(mv_index.size());
+}
+
+bool ProjectilePool :: isFull () const
+{
+	return getLiveCount() >= CAPACITY_MAX;
+}
+
+unsigned int ProjectilePool :: getLiveCount () const
+{
+	return (unsigned int)(mv_live.size());
+}
+
+unsigned int ProjectilePool :: getLiveSlot (unsigned int live) const
+{
+	assert(live < getLiveCount());
+
+	return mv_live[live];
+}
+
+bool ProjectilePool :: isLive (unsigned int slot) const
+{
+	return slot < getCapacity() && mv_live_position[slot] != NOT_LIVE;
+}
+
+unsigned int ProjectilePool :: getIndex (unsigned int slot) const
+{
+	assert(isLive(slot));
+
+	return mv_index[slot];
+}
+
+bool ProjectilePool :: isCurrent (unsigned int index) const
+{
+	return index < mv_index_slot.size() && mv_index_slot[index] != NO_SLOT;
+}
+
+unsigned int ProjectilePool :: getSlot (unsigned int index) const
+{
+	assert(isCurrent(index));
+
+	return mv_index_slot[index];
+}
+
+
+
+unsigned int ProjectilePool :: add ()
+{
+	assert(!isFull());
+
+	if(m_free_count == 0)
+		grow();
+	assert(m_free_count > 0);
+
+	unsigned int slot = mv_free[m_free_first];
+	m_free_first = (m_free_first + 1) % getCapacity();
+	m_free_count--;
+
+	// at most a quarter of the indexes are in use, so this
+	//  normally stops at once
+	while(mv_index_slot[m_next_index] != NO_SLOT)
+		m_next_index = (m_next_index + 1) % INDEX_COUNT;
+	mv_index[slot] = (unsigned short)(m_next_index);
+	mv_index_slot[m_next_index] = (unsigned short)(slot);
+	m_next_index = (m_next_index + 1) % INDEX_COUNT;
+
+	mv_live_position[slot] = (unsigned int)(mv_live.size());
+	mv_live.push_back(slot);
+
+	assert(invariant());
+	return slot;
+}
+
+void ProjectilePool :: remove (unsigned int slot)
+{
+	assert(isLive(slot));
+
+	// move the last live slot into the gap
+	unsigned int position = mv_live_position[slot];
+	unsigned int last     = mv_live.back();
+	mv_live[position]      = last;
+	mv_live_position[last] = position;
+	mv_live.pop_back();
+	mv_live_position[slot] = NOT_LIVE;
+	mv_index_slot[mv_index[slot]] = NO_SLOT;
+
+	mv_free[(m_free_first + m_free_count) % getCapacity()] = slot;
+	m_free_count++;
+
+	assert(invariant());
+}
+
+void ProjectilePool :: writeState (ostream& r_out) const
+{
+	SnapshotStream::writeValue(r_out, getCapacity());
+	SnapshotStream::writeValue(r_out, getLiveCount());
+	SnapshotStream::writeValue(r_out, m_next_index);
+	for(unsigned int i = 0; i < getLiveCount(); i++)
+	{
+		SnapshotStream::writeValue(r_out, mv_live[i]);
+		SnapshotStream::writeValue(r_out, mv_index[mv_live[i]]);
+	}
+	for(unsigned int f = 0; f < m_free_count; f++)
+		SnapshotStream::writeValue(r_out, mv_free[(m_free_first + f) % getCapacity()]);
+}
+
+bool ProjectilePool :: readState (istream& r_in)
+{
+	unsigned int capacity;
+	unsigned int live_count;
+	unsigned int next_index;
+	if(!SnapshotStream::readValue(r_in, capacity)   ||
+	   !SnapshotStream::readValue(r_in, live_count) ||
+	   !SnapshotStream::readValue(r_in, next_index))
+	{
+		return false;
+	}
+	if(capacity > CAPACITY_MAX || live_count > capacity ||
+	   next_index >= INDEX_COUNT)
+	{
+		return false;
+	}
+
+	// every slot must be either live or free exactly once, and
+	//  no two live slots can have the same index
+	vector<unsigned int> v_live(live_count);
+	vector<unsigned int> v_live_position(capacity, NOT_LIVE);
+	vector<unsigned short> v_index(capacity, 0);
+	vector<unsigned short> v_index_slot;
+	if(capacity > 0)
+		v_index_slot.resize(INDEX_COUNT, NO_SLOT);
+	vector<bool> v_is_seen(capacity, false);
+	for(unsigned int i = 0; i < live_count; i++)
+	{
+		unsigned short index;
+		if(!SnapshotStream::readValue(r_in, v_live[i]) ||
+		   v_live[i] >= capacity || v_is_seen[v_live[i]] ||
+		   !SnapshotStream::readValue(r_in, index) ||
+		   v_index_slot[index] != NO_SLOT)
+		{
+			return false;
+		}
+		v_is_seen[v_live[i]] = true;
+		v_live_position[v_live[i]] = i;
+		v_index[v_live[i]] = index;
+		v_index_slot[index] = (unsigned short)(v_live[i]);
+	}
+
+	vector<unsigned int> v_free(capacity);
+	unsigned int free_count = capacity - live_count;
+	for(unsigned int f = 0; f < free_count; f++)
+	{
+		if(!SnapshotStream::readValue(r_in, v_free[f]) ||
+		   v_free[f] >= capacity || v_is_seen[v_free[f]])
+		{
+			return false;
+		}
+		v_is_seen[v_free[f]] = true;
+	}
+
+	mv_index        .swap(v_index);
+	mv_index_slot   .swap(v_index_slot);
+	m_next_index = next_index;
+	mv_live         .swap(v_live);
+	mv_live_position.swap(v_live_position);
+	mv_free         .swap(v_free);
+	mv_live.reserve(capacity);
+	m_free_first = 0;
+	m_free_count = free_count;
+
+	assert(invariant());
+	return true;
+}
+
+
+
+void ProjectilePool :: grow ()
+{
+	assert(m_free_count == 0);
+	assert(getCapacity() < CAPACITY_MAX);
+
+	unsigned int capacity_old = getCapacity();
+	unsigned int capacity_new = capacity_old * 2;
+	if(capacity_new < CAPACITY_INITIAL)
+		capacity_new = CAPACITY_INITIAL;
+	if(capacity_new > CAPACITY_MAX)
+		capacity_new = CAPACITY_MAX;
+
+	// the free queue is empty, so it can be refilled from the
+	//  start with just the new slots
+	if(capacity_old == 0)
+		mv_index_slot.resize(INDEX_COUNT, NO_SLOT);
+	mv_index        .resize(capacity_new, 0);
+	mv_live_position.resize(capacity_new, NOT_LIVE);
+	mv_free         .resize(capacity_new);
+	mv_live.reserve(capacity_new);
+
+	m_free_first = 0;
+	m_free_count = capacity_new - capacity_old;
+	for(unsigned int f = 0; f < m_free_count; f++)
+		mv_free[f] = capacity_old + f;
+
+	assert(invariant());
+}
+
+bool ProjectilePool :: invariant () const
+{
+	if(getCapacity() > CAPACITY_MAX) return false;
+	if(mv_live_position.size() != getCapacity()) return false;
+	if(mv_free.size() != getCapacity()) return false;
+	if(getLiveCount() + m_free_count != getCapacity()) return false;
+	if(getCapacity() > 0 && m_free_first >= getCapacity()) return false;
+	if(mv_index_slot.size() != INDEX_COUNT && getCapacity() > 0) return false;
+	if(m_next_index >= INDEX_COUNT) return false;
+	return true;
+}
@@ -0,0 +1,324 @@
+//
+//  ProjectilePool.h
+//
+
+#ifndef PROJECTILE_POOL_H
+#define PROJECTILE_POOL_H
+
+#include <iosfwd>
+#include <vector>
+
+#include "PhysicsObjectId.h"
+
+
+
+//
+//  ProjectilePool
+//
+//  A class to keep track of which slots in an array of
+//    projectiles, such as Bullets or Missiles, are in use.
+//    Adding and removing a projectile both take constant time,
+//    and the slots in use are also kept in a compact list so
+//    they can be iterated over without visiting the free ones.
+//    The order of that list depends only on the order of the
+//    calls made, so it is the same every time a game is
+//    replayed.
+//
+//  The projectiles themselves are stored elsewhere, normally in
+//    an array with getCapacity() elements.  When there are no
+//    free slots, adding a projectile increases the capacity,
+//    so that array must be resized to match.
+//
+//  Each projectile added is given an id index, for use as the
+//    m_index field of a PhysicsObjectId, and a table maps the
+//    id indexes in use to their slots.  The id indexes are
+//    handed out in order, skipping any still in use, and wrap
+//    around after INDEX_COUNT.  So an id from a projectile that
+//    has been removed is not mistaken for a new projectile in
+//    the same slot until at least
+//    INDEX_COUNT - CAPACITY_MAX more projectiles have been
+//    added, however often that slot is reused.
+//
+//  Class Invariant:
+//    <1> getCapacity() <= CAPACITY_MAX
+//    <2> mv_index.size() == getCapacity()
+//    <3> mv_live_position.size() == getCapacity()
+//    <4> mv_free.size() == getCapacity()
+//    <5> getLiveCount() + m_free_count == getCapacity()
+//    <6> m_free_first < getCapacity() || getCapacity() == 0
+//    <7> mv_index_slot.size() == INDEX_COUNT ||
+//        getCapacity() == 0
+//    <8> m_next_index < INDEX_COUNT
+//
+
+class ProjectilePool
+{
+public:
+//
+//  INDEX_COUNT
+//
+//  The number of different id indexes.  This is the number of
+//    values the m_index field of a PhysicsObjectId can have.
+//
+
+	static const unsigned int INDEX_COUNT = PhysicsObjectId::INDEX_MAX + 1;
+
+//
+//  CAPACITY_MAX
+//
+//  The largest number of slots a ProjectilePool can have.  It
+//    is kept to a quarter of INDEX_COUNT, so that most id
+//    indexes are free and stale ids take a long time to come
+//    around again.
+//
+
+	static const unsigned int CAPACITY_MAX = INDEX_COUNT / 4;
+
+//
+//  CAPACITY_INITIAL
+//
+//  The number of slots a ProjectilePool gets when it first
+//    needs some.  After that, the capacity doubles each time it
+//    is increased.
+//
+
+	static const unsigned int CAPACITY_INITIAL = 64;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new ProjectilePool with no slots.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ProjectilePool is created with a capacity
+//               of 0.
+//
+
+	ProjectilePool ();
+
+//
+//  getCapacity
+//
+//  Purpose: To determine the number of slots in this
+//           ProjectilePool.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of slots, both used and free.
+//  Side Effect: N/A
+//
+
+	unsigned int getCapacity () const;
+
+//
+//  isFull
+//
+//  Purpose: To determine if this ProjectilePool has no room for
+//           more projectiles.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether all CAPACITY_MAX slots are in use.
+//  Side Effect: N/A
+//
+
+	bool isFull () const;
+
+//
+//  getLiveCount
+//
+//  Purpose: To determine the number of slots in use.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of slots in use.
+//  Side Effect: N/A
+//
+
+	unsigned int getLiveCount () const;
+
+//
+//  getLiveSlot
+//
+//  Purpose: To determine which slot is at the specified
+//           position in the compact list of slots in use.
+//  Parameter(s):
+//    <1> live: The position in the list
+//  Precondition(s):
+//    <1> live < getLiveCount()
+//  Returns: The slot at position live.
+//  Side Effect: N/A
+//
+
+	unsigned int getLiveSlot (unsigned int live) const;
+
+//
+//  isLive
+//
+//  Purpose: To determine if the specified slot is in use.
+//  Parameter(s):
+//    <1> slot: The slot to check
+//  Precondition(s): N/A
+//  Returns: Whether slot slot exists and is in use.
+//  Side Effect: N/A
+//
+
+	bool isLive (unsigned int slot) const;
+
+//
+//  getIndex
+//
+//  Purpose: To determine the id index of the projectile in the
+//           specified slot.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> isLive(slot)
+//  Returns: The id index for slot slot.  The slot can be found
+//           from this index with getSlot.
+//  Side Effect: N/A
+//
+
+	unsigned int getIndex (unsigned int slot) const;
+
+//
+//  isCurrent
+//
+//  Purpose: To determine if the specified id index refers to
+//           a projectile that is still in this ProjectilePool.
+//  Parameter(s):
+//    <1> index: The id index
+//  Precondition(s): N/A
+//  Returns: Whether index is the id index of a slot in use.
+//  Side Effect: N/A
+//
+
+	bool isCurrent (unsigned int index) const;
+
+//
+//  getSlot
+//
+//  Purpose: To determine which slot the specified id index
+//           refers to.
+//  Parameter(s):
+//    <1> index: The id index
+//  Precondition(s):
+//    <1> isCurrent(index)
+//  Returns: The slot with id index index.
+//  Side Effect: N/A
+//
+
+	unsigned int getSlot (unsigned int index) const;
+
+//
+//  add
+//
+//  Purpose: To mark a slot as in use.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> !isFull()
+//  Returns: The slot.
+//  Side Effect: The free slot that has been free the longest is
+//               marked as in use and added to the end of the
+//               list of slots in use.  It is given the next id
+//               index that is not in use.  If there are no free
+//               slots, the capacity is increased first.
+//
+
+	unsigned int add ();
+
+//
+//  remove
+//
+//  Purpose: To mark the specified slot as free.
+//  Parameter(s):
+//    <1> slot: The slot
+//  Precondition(s):
+//    <1> isLive(slot)
+//  Returns: N/A
+//  Side Effect: Slot slot is marked as free and its id index is
+//               no longer current.  The last slot in the list of slots
+//               in use is moved to the position slot had.
+//
+
+	void remove (unsigned int slot);
+
+//
+//  writeState
+//
+//  Purpose: To write the state of this ProjectilePool to the
+//           specified binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//  Precondition(s):
+//    <1> r_out was opened in binary mode
+//  Returns: N/A
+//  Side Effect: The capacity, list of slots in use and their id
+//               indexes, next id index, and order of the free
+//               slots are written to r_out.
+//
+
+	void writeState (std::ostream& r_out) const;
+
+//
+//  readState
+//
+//  Purpose: To set this ProjectilePool to the state read from
+//           the specified binary stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s):
+//    <1> r_in was opened in binary mode
+//  Returns: Whether a valid state was read.
+//  Side Effect: A state written by writeState is read from
+//               r_in.  If it is valid, this ProjectilePool is
+//               set to have that state.
+//
+
+	bool readState (std::istream& r_in);
+
+private:
+//
+//  grow
+//
+//  Purpose: To increase the capacity of this ProjectilePool.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> m_free_count == 0
+//    <2> getCapacity() < CAPACITY_MAX
+//  Returns: N/A
+//  Side Effect: The capacity is set to CAPACITY_INITIAL if it
+//               was 0 and doubled otherwise.  The new slots are
+//               all free.  The id index table is allocated the
+//               first time.
+//
+
+	void grow ();
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	std::vector<unsigned short> mv_index;
+	std::vector<unsigned short> mv_index_slot;
+	unsigned int m_next_index;
+	std::vector<unsigned int> mv_live;
+	std::vector<unsigned int> mv_live_position;
+
+	// a circular queue of free slots
+	std::vector<unsigned int> mv_free;
+	unsigned int m_free_first;
+	unsigned int m_free_count;
+};
+
+
+
+#endif
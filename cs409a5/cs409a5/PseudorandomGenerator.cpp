@@ -0,0 +1,121 @@
+//
+//  PseudorandomGenerator.cpp
+//
+
+#include <cassert>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "PseudorandomGenerator.h"
+
+namespace
+{
+	//
+	//  The constants for the SplitMix64 algorithm.  See
+	//    http://xoshiro.di.unimi.it/splitmix64.c
+	//
+
+	const unsigned long long GOLDEN_GAMMA = 0x9e3779b97f4a7c15ULL;
+	const unsigned long long MIX_MULTIPLIER_1 = 0xbf58476d1ce4e5b9ULL;
+	const unsigned long long MIX_MULTIPLIER_2 = 0x94d049bb133111ebULL;
+
+	//
+	//  The value of 2^-53.  A 53-bit integer multiplied by this
+	//    is exactly representable as a double in [0.0, 1.0).
+	//
+
+	const double SCALE_53_BITS_TO_01 = 1.0 / 9007199254740992.0;
+
+	//
+	//  mix
+	//
+	//  Purpose: To scramble the bits of a 64-bit value.
+	//  Parameter(s):
+	//    <1> z: The value to scramble
+	//  Precondition(s): N/A
+	//  Returns: The scrambled value.
+	//  Side Effect: N/A
+	//
+
+	inline unsigned long long mix (unsigned long long z)
+	{
+		z = (z ^ (z >> 30)) * MIX_MULTIPLIER_1;
+		z = (z ^ (z >> 27)) * MIX_MULTIPLIER_2;
+		return z ^ (z >> 31);
+	}
+}
+
+
+
+const unsigned long long PseudorandomGenerator :: SEED_DEFAULT = 0x6c8e9cf570932bd5ULL;
+
+
+
+unsigned long long PseudorandomGenerator :: calculateMixedSeed (
+                                            unsigned long long seed,
+                                            unsigned long long salt)
+{
+	return mix(seed + mix(salt + GOLDEN_GAMMA));
+}
+
+
+
+PseudorandomGenerator :: PseudorandomGenerator ()
+		: m_state(SEED_DEFAULT)
+{
+}
+
+PseudorandomGenerator :: PseudorandomGenerator (unsigned long long seed)
+		: m_state(seed)
+{
+}
+
+
+
+unsigned int PseudorandomGenerator :: getNext ()
+{
+	return (unsigned int)(getNext64() >> 32);
+}
+
+double PseudorandomGenerator :: getNext01 ()
+{
+	return (getNext64() >> 11) * SCALE_53_BITS_TO_01;
+}
+
+double PseudorandomGenerator :: getNextInRange (double min_value,
+                                                double max_value)
+{
+	assert(min_value <= max_value);
+
+	return min_value + getNext01() * (max_value - min_value);
+}
+
+unsigned int PseudorandomGenerator :: getNextIndex (unsigned int count)
+{
+	assert(count > 0);
+
+	// multiply-and-shift avoids the bias of the % operator
+	return (unsigned int)(((unsigned long long)(getNext()) * count) >> 32);
+}
+
+Vector3 PseudorandomGenerator :: getNextUnitVector ()
+{
+	double seed1 = getNext01();
+	double seed2 = getNext01();
+	return Vector3::getPseudorandomUnitVector(seed1, seed2);
+}
+
+
+
+void PseudorandomGenerator :: setState (unsigned long long state)
+{
+	m_state = state;
+}
+
+
+
+unsigned long long PseudorandomGenerator :: getNext64 ()
+{
+	m_state += GOLDEN_GAMMA;
+	return mix(m_state);
+}
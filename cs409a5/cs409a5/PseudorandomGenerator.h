@@ -0,0 +1,225 @@
+//
+//  PseudorandomGenerator.h
+//
+//  A module to generate a repeatable sequence of pseudorandom
+//    values from a seed.
+//
+
+#ifndef PSEUDORANDOM_GENERATOR_H
+#define PSEUDORANDOM_GENERATOR_H
+
+#include "../../ObjLibrary/Vector3.h"
+
+
+
+//
+//  PseudorandomGenerator
+//
+//  A class to generate a sequence of pseudorandom values.  The
+//    sequence depends only on the seed the generator was
+//    started with, so two generators with the same seed
+//    always produce the same values.  Unlike rand(), each
+//    PseudorandomGenerator has its own state, so objects
+//    updated on different threads do not affect each other's
+//    values.
+//
+//  The values are generated with the SplitMix64 algorithm.  The
+//    whole state is a single 64-bit integer, which can be read
+//    and restored to save and load the position in the
+//    sequence.
+//
+
+class PseudorandomGenerator
+{
+public:
+//
+//  SEED_DEFAULT
+//
+//  The seed used by a PseudorandomGenerator if none is
+//    specified.
+//
+
+	static const unsigned long long SEED_DEFAULT;
+
+public:
+//
+//  calculateMixedSeed
+//
+//  Purpose: To calculate a seed for a PseudorandomGenerator
+//           from a base seed and a number identifying the user
+//           of the generator.  Generators seeded with the same
+//           base seed and different numbers produce unrelated
+//           sequences.
+//  Parameter(s):
+//    <1> seed: The base seed
+//    <2> salt: The number identifying the user
+//  Precondition(s): N/A
+//  Returns: The seed for the generator for salt salt.
+//  Side Effect: N/A
+//
+
+	static unsigned long long calculateMixedSeed (
+	                                  unsigned long long seed,
+	                                  unsigned long long salt);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new PseudorandomGenerator with the
+//           default seed.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new PseudorandomGenerator is created with
+//               seed SEED_DEFAULT.
+//
+
+	PseudorandomGenerator ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a new PseudorandomGenerator with the
+//           specified seed.
+//  Parameter(s):
+//    <1> seed: The seed
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new PseudorandomGenerator is created with
+//               seed seed.
+//
+
+	PseudorandomGenerator (unsigned long long seed);
+
+//
+//  getState
+//
+//  Purpose: To determine the current state of this
+//           PseudorandomGenerator.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The current state.  Passing this value to setState
+//           will cause this PseudorandomGenerator to repeat the
+//           values it would generate from this point.
+//  Side Effect: N/A
+//
+
+	unsigned long long getState () const
+	{	return m_state;	}
+
+//
+//  getNext
+//
+//  Purpose: To generate the next pseudorandom value in the
+//           sequence.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pseudorandom 32-bit integer.
+//  Side Effect: This PseudorandomGenerator advances to the next
+//               value in its sequence.
+//
+
+	unsigned int getNext ();
+
+//
+//  getNext01
+//
+//  Purpose: To generate the next pseudorandom value in the
+//           sequence as a floating-point number.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pseudorandom value in the range [0.0, 1.0).
+//  Side Effect: This PseudorandomGenerator advances to the next
+//               value in its sequence.
+//
+
+	double getNext01 ();
+
+//
+//  getNextInRange
+//
+//  Purpose: To generate the next pseudorandom value in the
+//           sequence in the specified range.
+//  Parameter(s):
+//    <1> min_value: The minimum value
+//    <2> max_value: The maximum value
+//  Precondition(s):
+//    <1> min_value <= max_value
+//  Returns: A pseudorandom value in the range
+//           [min_value, max_value).
+//  Side Effect: This PseudorandomGenerator advances to the next
+//               value in its sequence.
+//
+
+	double getNextInRange (double min_value, double max_value);
+
+//
+//  getNextIndex
+//
+//  Purpose: To generate the next pseudorandom value in the
+//           sequence as an index into an array.
+//  Parameter(s):
+//    <1> count: The number of elements in the array
+//  Precondition(s):
+//    <1> count > 0
+//  Returns: A pseudorandom integer in the range [0, count).
+//  Side Effect: This PseudorandomGenerator advances to the next
+//               value in its sequence.
+//
+
+	unsigned int getNextIndex (unsigned int count);
+
+//
+//  getNextUnitVector
+//
+//  Purpose: To generate a pseudorandom Vector3 of norm 1.0 and
+//           with a uniform direction.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pseudorandom unit vector.
+//  Side Effect: This PseudorandomGenerator advances two values
+//               in its sequence.
+//
+
+	Vector3 getNextUnitVector ();
+
+//
+//  setState
+//
+//  Purpose: To change the current state of this
+//           PseudorandomGenerator.
+//  Parameter(s):
+//    <1> state: The new state
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This PseudorandomGenerator is set to have state
+//               state.  If state was returned by getState, this
+//               PseudorandomGenerator will repeat the values
+//               generated after that call.
+//
+
+	void setState (unsigned long long state);
+
+private:
+//
+//  getNext64
+//
+//  Purpose: To generate the next pseudorandom value in the
+//           sequence with all 64 bits.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: A pseudorandom 64-bit integer.
+//  Side Effect: This PseudorandomGenerator advances to the next
+//               value in its sequence.
+//
+
+	unsigned long long getNext64 ();
+
+private:
+	unsigned long long m_state;
+};
+
+
+
+#endif
@@ -0,0 +1,140 @@
+//
+//  Quaternion.cpp
+//
+
+#include <cassert>
+#include <cmath>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "Quaternion.h"
+
+using namespace std;
+namespace
+{
+	// above this, slerp interpolates linearly to avoid dividing
+	//  by a tiny sine
+	const double SLERP_LINEAR_DOT = 0.9995;
+}
+
+
+
+const Quaternion Quaternion :: IDENTITY(1.0, 0.0, 0.0, 0.0);
+const double Quaternion :: NORMAL_TOLERANCE = 1.0e-6;
+
+
+
+Quaternion Quaternion :: getAxisAngle (const Vector3& axis,
+                                       double radians)
+{
+	assert(axis.isNormal());
+
+	double half_sin = sin(radians * 0.5);
+	return Quaternion(cos(radians * 0.5),
+	                  axis.x * half_sin,
+	                  axis.y * half_sin,
+	                  axis.z * half_sin);
+}
+
+Quaternion Quaternion :: slerp (const Quaternion& a,
+                                const Quaternion& b,
+                                double t)
+{
+	assert(a.isNormal());
+	assert(b.isNormal());
+	assert(t >= 0.0);
+	assert(t <= 1.0);
+
+	// q and -q are the same rotation, so take the shorter way
+	double dot = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+	Quaternion end = b;
+	if(dot < 0.0)
+	{
+		dot = -dot;
+		end = Quaternion(-b.w, -b.x, -b.y, -b.z);
+	}
+
+	double factor_a;
+	double factor_b;
+	if(dot > SLERP_LINEAR_DOT)
+	{
+		factor_a = 1.0 - t;
+		factor_b = t;
+	}
+	else
+	{
+		double theta     = acos(dot);
+		double sin_theta = sin(theta);
+		factor_a = sin((1.0 - t) * theta) / sin_theta;
+		factor_b = sin(t * theta)         / sin_theta;
+	}
+
+	Quaternion result(a.w * factor_a + end.w * factor_b,
+	                  a.x * factor_a + end.x * factor_b,
+	                  a.y * factor_a + end.y * factor_b,
+	                  a.z * factor_a + end.z * factor_b);
+	result.normalize();
+	return result;
+}
+
+
+
+bool Quaternion :: isNormal () const
+{
+	return fabs(getNormSquared() - 1.0) <= NORMAL_TOLERANCE;
+}
+
+bool Quaternion :: isFinite () const
+{
+	return isfinite(w) && isfinite(x) && isfinite(y) && isfinite(z);
+}
+
+Quaternion Quaternion :: getNormalized () const
+{
+	assert(getNormSquared() > 0.0);
+
+	double inverse = 1.0 / sqrt(getNormSquared());
+	return Quaternion(w * inverse, x * inverse, y * inverse, z * inverse);
+}
+
+double Quaternion :: getAngle () const
+{
+	assert(isNormal());
+
+	// rounding can push w just outside [-1, 1]
+	if(w >= 1.0 || w <= -1.0)
+		return 0.0;
+	return 2.0 * acos(w);
+}
+
+Vector3 Quaternion :: getRotated (const Vector3& v) const
+{
+	assert(isNormal());
+
+	//
+	//  v' = v + 2w(u x v) + 2u x (u x v), where u = (x, y, z)
+	//
+	//  This is cheaper than multiplying by the quaternion and
+	//    its conjugate.
+	//
+
+	double tx = 2.0 * (y * v.z - z * v.y);
+	double ty = 2.0 * (z * v.x - x * v.z);
+	double tz = 2.0 * (x * v.y - y * v.x);
+	return Vector3(v.x + w * tx + (y * tz - z * ty),
+	               v.y + w * ty + (z * tx - x * tz),
+	               v.z + w * tz + (x * ty - y * tx));
+}
+
+
+
+void Quaternion :: normalize ()
+{
+	assert(getNormSquared() > 0.0);
+
+	double inverse = 1.0 / sqrt(getNormSquared());
+	w *= inverse;
+	x *= inverse;
+	y *= inverse;
+	z *= inverse;
+}
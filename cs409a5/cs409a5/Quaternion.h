@@ -0,0 +1,269 @@
+//
+//  Quaternion.h
+//
+
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+#include "../../ObjLibrary/Vector3.h"
+
+
+
+//
+//  Quaternion
+//
+//  A class to represent a quaternion, w + xi + yj + zk.  A unit
+//    quaternion represents a rotation, and is used here to
+//    store the orientation of a CoordinateSystem.  Rotations
+//    follow the same right-hand rule as
+//    Vector3::rotateArbitrary, so rotating a vector by
+//    getAxisAngle(axis, radians) gives the same result (to
+//    within rounding) as rotating it with rotateArbitrary.
+//
+//  The product a * b represents rotating by b and then by a.
+//
+//  Like Vector3, the components are public and there is no
+//    class invariant.
+//
+
+class Quaternion
+{
+public:
+//
+//  IDENTITY
+//
+//  The quaternion representing no rotation.
+//
+
+	static const Quaternion IDENTITY;
+
+//
+//  NORMAL_TOLERANCE
+//
+//  The amount the squared norm of a quaternion may differ from
+//    1.0 for it to still be considered normal.
+//
+
+	static const double NORMAL_TOLERANCE;
+
+public:
+//
+//  getAxisAngle
+//
+//  Purpose: To create a quaternion representing a rotation
+//           around an axis.
+//  Parameter(s):
+//    <1> axis: The axis to rotate around
+//    <2> radians: The angle to rotate by
+//  Precondition(s):
+//    <1> axis.isNormal()
+//  Returns: A unit quaternion rotating by radians around axis.
+//  Side Effect: N/A
+//
+
+	static Quaternion getAxisAngle (const Vector3& axis,
+	                                double radians);
+
+//
+//  slerp
+//
+//  Purpose: To spherically interpolate between two rotations.
+//  Parameter(s):
+//    <1> a: The rotation to start from
+//    <2> b: The rotation to end at
+//    <3> t: The fraction of the way from a to b
+//  Precondition(s):
+//    <1> a.isNormal()
+//    <2> b.isNormal()
+//    <3> t >= 0.0
+//    <4> t <= 1.0
+//  Returns: The unit quaternion fraction t of the way along
+//           the shortest arc from a to b, turning at a constant
+//           rate.
+//  Side Effect: N/A
+//
+
+	static Quaternion slerp (const Quaternion& a,
+	                         const Quaternion& b,
+	                         double t);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new Quaternion representing no
+//           rotation.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Quaternion is created with a w of 1 and
+//               x, y, and z of 0.
+//
+
+	Quaternion ()
+			: w(1.0), x(0.0), y(0.0), z(0.0)
+	{ }
+
+//
+//  Constructor
+//
+//  Purpose: To create a new Quaternion with the specified
+//           components.
+//  Parameter(s):
+//    <1> w1: The real component
+//    <2> x1
+//    <3> y1
+//    <4> z1: The imaginary components
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Quaternion (w1, x1, y1, z1) is created.
+//
+
+	Quaternion (double w1, double x1, double y1, double z1)
+			: w(w1), x(x1), y(y1), z(z1)
+	{ }
+
+//
+//  getNormSquared
+//
+//  Purpose: To determine the square of the norm of this
+//           Quaternion.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: w * w + x * x + y * y + z * z.
+//  Side Effect: N/A
+//
+
+	double getNormSquared () const
+	{	return w * w + x * x + y * y + z * z;	}
+
+//
+//  isNormal
+//
+//  Purpose: To determine if this Quaternion is a unit
+//           quaternion.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the squared norm is within
+//           NORMAL_TOLERANCE of 1.0.
+//  Side Effect: N/A
+//
+
+	bool isNormal () const;
+
+//
+//  isFinite
+//
+//  Purpose: To determine if all the components of this
+//           Quaternion are finite.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether w, x, y, and z are all finite.
+//  Side Effect: N/A
+//
+
+	bool isFinite () const;
+
+//
+//  getNormalized
+//
+//  Purpose: To determine a unit quaternion with the same
+//           direction as this Quaternion.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> getNormSquared() > 0.0
+//  Returns: This Quaternion divided by its norm.
+//  Side Effect: N/A
+//
+
+	Quaternion getNormalized () const;
+
+//
+//  getConjugate
+//
+//  Purpose: To determine the conjugate of this Quaternion.  For
+//           a unit quaternion, this is the opposite rotation.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: (w, -x, -y, -z).
+//  Side Effect: N/A
+//
+
+	Quaternion getConjugate () const
+	{	return Quaternion(w, -x, -y, -z);	}
+
+//
+//  getAngle
+//
+//  Purpose: To determine how far the rotation represented by
+//           this Quaternion turns.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isNormal()
+//  Returns: The angle of rotation in radians, in the range
+//           [0, 2 * PI].
+//  Side Effect: N/A
+//
+
+	double getAngle () const;
+
+//
+//  getRotated
+//
+//  Purpose: To rotate a vector by the rotation this Quaternion
+//           represents.
+//  Parameter(s):
+//    <1> v: The vector to rotate
+//  Precondition(s):
+//    <1> isNormal()
+//  Returns: v rotated by this Quaternion.
+//  Side Effect: N/A
+//
+
+	Vector3 getRotated (const Vector3& v) const;
+
+//
+//  Multiplication Operator
+//
+//  Purpose: To determine the Hamilton product of this
+//           Quaternion and another.
+//  Parameter(s):
+//    <1> other: The Quaternion to multiply by
+//  Precondition(s): N/A
+//  Returns: this * other.  For unit quaternions, this is the
+//           rotation by other followed by the rotation by this
+//           Quaternion.
+//  Side Effect: N/A
+//
+
+	Quaternion operator* (const Quaternion& other) const
+	{
+		return Quaternion(w * other.w - x * other.x - y * other.y - z * other.z,
+		                  w * other.x + x * other.w + y * other.z - z * other.y,
+		                  w * other.y - x * other.z + y * other.w + z * other.x,
+		                  w * other.z + x * other.y - y * other.x + z * other.w);
+	}
+
+//
+//  normalize
+//
+//  Purpose: To change this Quaternion to have a norm of 1.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> getNormSquared() > 0.0
+//  Returns: N/A
+//  Side Effect: This Quaternion is divided by its norm.
+//
+
+	void normalize ();
+
+public:
+	double w;
+	double x;
+	double y;
+	double z;
+};
+
+
+
+#endif
@@ -0,0 +1,233 @@
+//
+//  Replay.cpp
+//
+
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../ObjLibrary/DisplayList.h"
+
+#include "TimeSystem.h"
+#include "PseudorandomGenerator.h"
+#include "PlayerInput.h"
+#include "SnapshotStream.h"
+#include "World.h"
+#include "Replay.h"
+
+using namespace std;
+namespace
+{
+	// "A5RP" when read as bytes on a little-endian machine
+	const unsigned int REPLAY_MAGIC   = 0x50523541;
+	const unsigned int REPLAY_VERSION = 3;
+
+	//
+	//  getSnapshot
+	//
+	//  Purpose: To take a snapshot of the specified World to
+	//           compare with another.
+	//  Parameter(s):
+	//    <1> world: The World
+	//  Precondition(s):
+	//    <1> world.isInitialized()
+	//  Returns: The bytes of the snapshot, without the AI cost
+	//           estimates.  These are measured times, so they
+	//           would never match.
+	//  Side Effect: N/A
+	//
+
+	string getSnapshot (const World& world)
+	{
+		assert(world.isInitialized());
+
+		ostringstream snapshot(ios::out | ios::binary);
+		world.writeSnapshot(snapshot, false);
+		return snapshot.str();
+	}
+}
+
+
+
+Replay :: Replay ()
+		: m_world_seed(PseudorandomGenerator::SEED_DEFAULT),
+		  mv_frames(),
+		  m_final_snapshot()
+{
+}
+
+Replay :: Replay (unsigned long long world_seed)
+		: m_world_seed(world_seed),
+		  mv_frames(),
+		  m_final_snapshot()
+{
+}
+
+
+
+unsigned long long Replay :: getWorldSeed () const
+{
+	return m_world_seed;
+}
+
+unsigned int Replay :: getFrameCount () const
+{
+	return mv_frames.size();
+}
+
+const Replay::Frame& Replay :: getFrame (unsigned int frame) const
+{
+	assert(frame < getFrameCount());
+
+	return mv_frames[frame];
+}
+
+bool Replay :: isFinalSnapshot () const
+{
+	return !m_final_snapshot.empty();
+}
+
+bool Replay :: isMatchingFinalSnapshot (const World& world) const
+{
+	assert(isFinalSnapshot());
+	assert(world.isInitialized());
+
+	return getSnapshot(world) == m_final_snapshot;
+}
+
+void Replay :: applyFrame (unsigned int frame, World& r_world) const
+{
+	assert(frame < getFrameCount());
+	assert(r_world.isInitialized());
+	assert(TimeSystem::isInitialized());
+
+	const Frame& record = mv_frames[frame];
+	TimeSystem::markFrameEndRecorded(record.m_start_time, record.m_duration);
+	r_world.setPlannedAiCount(record.m_ai_count);
+	r_world.applyPlayerInput(record.m_input);
+}
+
+
+
+void Replay :: recordFrame (const PlayerInput& input, const World& world)
+{
+	assert(TimeSystem::isInitialized());
+	assert(world.isInitialized());
+
+	Frame record;
+	record.m_input      = input;
+	record.m_start_time = TimeSystem::getFrameStartTimeNanoseconds();
+	record.m_duration   = TimeSystem::getFrameDurationNanoseconds();
+	record.m_ai_count   = world.getPlannedAiCount();
+	mv_frames.push_back(record);
+
+	m_final_snapshot.clear();
+}
+
+void Replay :: recordFinalSnapshot (const World& world)
+{
+	assert(world.isInitialized());
+
+	m_final_snapshot = getSnapshot(world);
+}
+
+bool Replay :: save (const string& filename) const
+{
+	assert(filename != "");
+
+	ofstream output_file(filename.c_str(), ios::out | ios::binary);
+	if(!output_file)
+	{
+		cerr << "Error: Could not open replay file \"" << filename << "\" for writing" << endl;
+		return false;
+	}
+
+	SnapshotStream::writeValue(output_file, REPLAY_MAGIC);
+	SnapshotStream::writeValue(output_file, REPLAY_VERSION);
+	SnapshotStream::writeValue(output_file, m_world_seed);
+	SnapshotStream::writeValue(output_file, getFrameCount());
+	for(unsigned int i = 0; i < mv_frames.size(); i++)
+	{
+		SnapshotStream::writeValue(output_file, mv_frames[i].m_input.m_controls);
+		SnapshotStream::writeValue(output_file, mv_frames[i].m_start_time);
+		SnapshotStream::writeValue(output_file, mv_frames[i].m_duration);
+		SnapshotStream::writeValue(output_file, mv_frames[i].m_ai_count);
+	}
+	SnapshotStream::writeValue(output_file, (unsigned int)(m_final_snapshot.size()));
+	output_file.write(m_final_snapshot.data(), m_final_snapshot.size());
+
+	if(!output_file)
+	{
+		cerr << "Error: Could not write replay file \"" << filename << "\"" << endl;
+		return false;
+	}
+	return true;
+}
+
+bool Replay :: load (const string& filename)
+{
+	assert(filename != "");
+
+	ifstream input_file(filename.c_str(), ios::in | ios::binary);
+	if(!input_file)
+	{
+		cerr << "Error: Could not open replay file \"" << filename << "\"" << endl;
+		return false;
+	}
+
+	unsigned int magic;
+	unsigned int version;
+	unsigned long long world_seed;
+	unsigned int frame_count;
+	if(!SnapshotStream::readValue(input_file, magic)      ||
+	   !SnapshotStream::readValue(input_file, version)    ||
+	   !SnapshotStream::readValue(input_file, world_seed) ||
+	   !SnapshotStream::readValue(input_file, frame_count))
+	{
+		cerr << "Error: Replay file \"" << filename << "\" is too short" << endl;
+		return false;
+	}
+	if(magic != REPLAY_MAGIC || version != REPLAY_VERSION)
+	{
+		cerr << "Error: \"" << filename << "\" is not a version "
+		     << REPLAY_VERSION << " replay file" << endl;
+		return false;
+	}
+
+	vector<Frame> v_frames;
+	for(unsigned int i = 0; i < frame_count; i++)
+	{
+		Frame record;
+		if(!SnapshotStream::readValue(input_file, record.m_input.m_controls) ||
+		   !SnapshotStream::readValue(input_file, record.m_start_time)       ||
+		   !SnapshotStream::readValue(input_file, record.m_duration)         ||
+		   !SnapshotStream::readValue(input_file, record.m_ai_count))
+		{
+			cerr << "Error: Replay file \"" << filename << "\" ends after "
+			     << i << " of " << frame_count << " frames" << endl;
+			return false;
+		}
+		v_frames.push_back(record);
+	}
+
+	unsigned int snapshot_size;
+	if(!SnapshotStream::readValue(input_file, snapshot_size))
+	{
+		cerr << "Error: Replay file \"" << filename << "\" is missing its snapshot" << endl;
+		return false;
+	}
+	string final_snapshot(snapshot_size, '\0');
+	if(snapshot_size > 0 && !input_file.read(&final_snapshot[0], snapshot_size))
+	{
+		cerr << "Error: Replay file \"" << filename << "\" has an incomplete snapshot" << endl;
+		return false;
+	}
+
+	m_world_seed     = world_seed;
+	mv_frames.swap(v_frames);
+	m_final_snapshot = final_snapshot;
+	return true;
+}
@@ -0,0 +1,275 @@
+//
+//  Replay.h
+//
+//  A module to record the player's input for a game and play
+//    it back exactly.
+//
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+
+#include "PlayerInput.h"
+
+class World;
+
+
+
+//
+//  Replay
+//
+//  A class to record a game so it can be played back exactly.
+//    A World is completely determined by its random seed, the
+//    player input for each frame, the start time and duration
+//    of each frame, and how many unit AIs were run in each
+//    frame, so these are all that is recorded.  Playing back a Replay into a new World with the
+//    same seed produces bit-for-bit the same game, which makes
+//    it possible to run a slow or broken game again under a
+//    profiler or debugger.
+//
+//  A Replay can also store a snapshot of the World after the
+//    last frame.  If the snapshot after playing the Replay back
+//    is different, the game did not replay exactly.
+//
+//  To record a game:
+//    1. Create a Replay with the seed of the World
+//    2. Before each call to World::updateAll, call recordFrame
+//       and then World::applyPlayerInput with the same input
+//    3. Optionally, call recordFinalSnapshot after the last
+//       frame
+//    4. Call save
+//
+//  To play a game back:
+//    1. Call load
+//    2. Create a World and call setRandomSeed with the seed
+//       from the Replay before initializing it
+//    3. For each frame, call applyFrame and then
+//       World::updateAll
+//    4. Optionally, call isMatchingFinalSnapshot
+//
+//  Replay files are written in the native byte order, so they
+//    can only be played back on the same kind of machine.
+//
+
+class Replay
+{
+public:
+//
+//  Frame
+//
+//  A record of one frame: the controls the player held, the
+//    times reported by the TimeSystem, and the number of unit
+//    AI slots the World ran.  The times are stored in
+//    nanoseconds, exactly as the TimeSystem keeps them.
+//
+
+	struct Frame
+	{
+		PlayerInput m_input;
+		long long m_start_time;
+		long long m_duration;
+		unsigned int m_ai_count;
+	};
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty Replay.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Replay is created with no frames for a
+//               World with the default random seed.
+//
+
+	Replay ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an empty Replay for a World with the
+//           specified random seed.
+//  Parameter(s):
+//    <1> world_seed: The random seed for the World
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new Replay is created with no frames for a
+//               World with random seed world_seed.
+//
+
+	Replay (unsigned long long world_seed);
+
+//
+//  getWorldSeed
+//
+//  Purpose: To determine the random seed for the World this
+//           Replay is for.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The random seed for the World.
+//  Side Effect: N/A
+//
+
+	unsigned long long getWorldSeed () const;
+
+//
+//  getFrameCount
+//
+//  Purpose: To determine the number of frames in this Replay.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of frames.
+//  Side Effect: N/A
+//
+
+	unsigned int getFrameCount () const;
+
+//
+//  getFrame
+//
+//  Purpose: To retrieve the record for the specified frame.
+//  Parameter(s):
+//    <1> frame: The index of the frame
+//  Precondition(s):
+//    <1> frame < getFrameCount()
+//  Returns: The record for frame frame.
+//  Side Effect: N/A
+//
+
+	const Frame& getFrame (unsigned int frame) const;
+
+//
+//  isFinalSnapshot
+//
+//  Purpose: To determine if this Replay contains a snapshot of
+//           the World after the last frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this Replay has a final snapshot.
+//  Side Effect: N/A
+//
+
+	bool isFinalSnapshot () const;
+
+//
+//  isMatchingFinalSnapshot
+//
+//  Purpose: To determine if the specified World is in the same
+//           state as the World this Replay was recorded from
+//           was after the last frame.
+//  Parameter(s):
+//    <1> world: The World to check
+//  Precondition(s):
+//    <1> isFinalSnapshot()
+//    <2> world.isInitialized()
+//  Returns: Whether the snapshot of world is exactly the same
+//           as the final snapshot for this Replay.
+//  Side Effect: N/A
+//
+
+	bool isMatchingFinalSnapshot (const World& world) const;
+
+//
+//  applyFrame
+//
+//  Purpose: To prepare the specified World to replay the
+//           specified frame.
+//  Parameter(s):
+//    <1> frame: The index of the frame
+//    <2> r_world: The World to prepare
+//  Precondition(s):
+//    <1> frame < getFrameCount()
+//    <2> r_world.isInitialized()
+//    <3> TimeSystem::isInitialized()
+//  Returns: N/A
+//  Side Effect: The TimeSystem is set to report the start time
+//               and duration recorded for frame frame, and
+//               r_world is set to run the number of unit AIs
+//               recorded for that frame.  The player input
+//               recorded for that frame is applied to r_world.  The caller should then call
+//               r_world.updateAll().
+//
+
+	void applyFrame (unsigned int frame, World& r_world) const;
+
+//
+//  recordFrame
+//
+//  Purpose: To add a frame with the specified input to this
+//           Replay.
+//  Parameter(s):
+//    <1> input: The controls held by the player
+//    <2> world: The World being recorded
+//  Precondition(s):
+//    <1> TimeSystem::isInitialized()
+//    <2> world.isInitialized()
+//  Returns: N/A
+//  Side Effect: A frame is added to this Replay with player
+//               input input, the start time and duration
+//               currently reported by the TimeSystem, and the
+//               number of unit AIs world plans to run next.
+//               Any final snapshot is removed.
+//
+
+	void recordFrame (const PlayerInput& input, const World& world);
+
+//
+//  recordFinalSnapshot
+//
+//  Purpose: To store a snapshot of the specified World as the
+//           state after the last frame.
+//  Parameter(s):
+//    <1> world: The World to take the snapshot of
+//  Precondition(s):
+//    <1> world.isInitialized()
+//  Returns: N/A
+//  Side Effect: A snapshot of world is stored in this Replay.
+//
+
+	void recordFinalSnapshot (const World& world);
+
+//
+//  save
+//
+//  Purpose: To write this Replay to the specified file.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the file was written successfully.
+//  Side Effect: File filename is replaced with this Replay.  If
+//               the file cannot be written, an error message is
+//               printed to standard error.
+//
+
+	bool save (const std::string& filename) const;
+
+//
+//  load
+//
+//  Purpose: To read this Replay from the specified file.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//  Precondition(s):
+//    <1> filename != ""
+//  Returns: Whether the file was read successfully.
+//  Side Effect: If file filename contains a valid Replay, this
+//               Replay is set to be a copy of it.  Otherwise,
+//               an error message is printed to standard error
+//               and this Replay is unchanged.
+//
+
+	bool load (const std::string& filename);
+
+private:
+	unsigned long long m_world_seed;
+	std::vector<Frame> mv_frames;
+	std::string m_final_snapshot;
+};
+
+
+
+#endif
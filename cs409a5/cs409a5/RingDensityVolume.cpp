@@ -0,0 +1,343 @@
+//
+//  RingDensityVolume.cpp
+//
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "RingDensityVolume.h"
+
+using namespace std;
+
+namespace
+{
+	//
+	//  calculateAxisRange
+	//
+	//  Purpose: To determine which nodes along one axis are
+	//           between the specified coordinates.
+	//  Parameter(s):
+	//    <1> range_min
+	//    <2> range_max: The coordinates to check between
+	//    <3> origin: The coordinate of the first node
+	//    <4> cell_size: The distance between adjacent nodes
+	//    <5> count: The number of nodes along the axis
+	//    <6> r_begin: A reference to the first node in range
+	//    <7> r_end: A reference to one past the last node in
+	//               range
+	//  Precondition(s):
+	//    <1> cell_size > 0.0
+	//  Returns: Whether any nodes are in range.
+	//  Side Effect: If any nodes are in range, r_begin and r_end
+	//               are set to the range.
+	//
+
+	bool calculateAxisRange (double range_min, double range_max,
+	                         double origin, double cell_size,
+	                         unsigned int count,
+	                         unsigned int& r_begin, unsigned int& r_end)
+	{
+		assert(cell_size > 0.0);
+
+		double first = ceil ((range_min - origin) / cell_size);
+		double last  = floor((range_max - origin) / cell_size);
+		if(first < 0.0)
+			first = 0.0;
+		if(last > count - 1.0)
+			last = count - 1.0;
+		if(first > last)
+			return false;
+
+		r_begin = (unsigned int)(first);
+		r_end   = (unsigned int)(last) + 1;
+		return true;
+	}
+
+	//
+	//  calculateCell
+	//
+	//  Purpose: To determine which cell along one axis a
+	//           coordinate is in, and how far across it.
+	//  Parameter(s):
+	//    <1> coordinate: The coordinate
+	//    <2> origin: The coordinate of the first node
+	//    <3> cell_size: The distance between adjacent nodes
+	//    <4> count: The number of nodes along the axis
+	//    <5> r_fraction: A reference to the distance across the
+	//                    cell as a fraction of its size
+	//  Precondition(s):
+	//    <1> cell_size > 0.0
+	//    <2> count >= 2
+	//    <3> coordinate is between the first and last nodes
+	//  Returns: The index of the node at the low end of the cell.
+	//           This is always less than count - 1.
+	//  Side Effect: r_fraction is set to a value in [0, 1].
+	//
+
+	inline unsigned int calculateCell (double coordinate,
+	                                   double origin,
+	                                   double cell_size,
+	                                   unsigned int count,
+	                                   float& r_fraction)
+	{
+		assert(cell_size > 0.0);
+		assert(count >= 2);
+
+		double scaled = (coordinate - origin) / cell_size;
+		unsigned int cell = (unsigned int)(scaled);
+		if(cell > count - 2)
+			cell = count - 2;  // on the last node
+		r_fraction = (float)(scaled - cell);
+		return cell;
+	}
+}
+
+
+
+RingDensityVolume :: RingDensityVolume ()
+		: m_box_min(),
+		  m_cell_size(0.0),
+		  m_count_x(0),
+		  m_count_y(0),
+		  m_count_z(0),
+		  mv_base(),
+		  mv_current()
+{
+	assert(invariant());
+}
+
+RingDensityVolume :: RingDensityVolume (const RingDensityVolume& original)
+		: m_box_min(original.m_box_min),
+		  m_cell_size(original.m_cell_size),
+		  m_count_x(original.m_count_x),
+		  m_count_y(original.m_count_y),
+		  m_count_z(original.m_count_z),
+		  mv_base(original.mv_base),
+		  mv_current(original.mv_current)
+{
+	assert(invariant());
+}
+
+RingDensityVolume :: ~RingDensityVolume ()
+{
+}
+
+RingDensityVolume& RingDensityVolume :: operator= (const RingDensityVolume& original)
+{
+	if(&original != this)
+	{
+		m_box_min   = original.m_box_min;
+		m_cell_size = original.m_cell_size;
+		m_count_x   = original.m_count_x;
+		m_count_y   = original.m_count_y;
+		m_count_z   = original.m_count_z;
+		mv_base     = original.mv_base;
+		mv_current  = original.mv_current;
+	}
+
+	assert(invariant());
+	return *this;
+}
+
+
+
+bool RingDensityVolume :: isEmpty () const
+{
+	return mv_base.empty();
+}
+
+unsigned int RingDensityVolume :: getNodeCountX () const
+{
+	return m_count_x;
+}
+
+unsigned int RingDensityVolume :: getNodeCountY () const
+{
+	return m_count_y;
+}
+
+unsigned int RingDensityVolume :: getNodeCountZ () const
+{
+	return m_count_z;
+}
+
+Vector3 RingDensityVolume :: getNodePosition (unsigned int x,
+                                              unsigned int y,
+                                              unsigned int z) const
+{
+	assert(x < getNodeCountX());
+	assert(y < getNodeCountY());
+	assert(z < getNodeCountZ());
+
+	return Vector3(m_box_min.x + x * m_cell_size,
+	               m_box_min.y + y * m_cell_size,
+	               m_box_min.z + z * m_cell_size);
+}
+
+bool RingDensityVolume :: calculateNodeRange (const Vector3& box_min,
+                                              const Vector3& box_max,
+                                              unsigned int r_begin[3],
+                                              unsigned int r_end[3]) const
+{
+	if(isEmpty())
+		return false;
+
+	unsigned int begin[3];
+	unsigned int end[3];
+	if(!calculateAxisRange(box_min.x, box_max.x, m_box_min.x, m_cell_size, m_count_x, begin[0], end[0]))
+		return false;
+	if(!calculateAxisRange(box_min.y, box_max.y, m_box_min.y, m_cell_size, m_count_y, begin[1], end[1]))
+		return false;
+	if(!calculateAxisRange(box_min.z, box_max.z, m_box_min.z, m_cell_size, m_count_z, begin[2], end[2]))
+		return false;
+
+	for(unsigned int a = 0; a < 3; a++)
+	{
+		r_begin[a] = begin[a];
+		r_end[a]   = end[a];
+	}
+	return true;
+}
+
+bool RingDensityVolume :: isInside (const Vector3& position) const
+{
+	if(isEmpty())
+		return false;
+
+	Vector3 relative = position - m_box_min;
+	return relative.x >= 0.0 && relative.x <= (m_count_x - 1) * m_cell_size &&
+	       relative.y >= 0.0 && relative.y <= (m_count_y - 1) * m_cell_size &&
+	       relative.z >= 0.0 && relative.z <= (m_count_z - 1) * m_cell_size;
+}
+
+float RingDensityVolume :: getAt (const Vector3& position) const
+{
+	assert(isInside(position));
+
+	float fx;
+	float fy;
+	float fz;
+	unsigned int x = calculateCell(position.x, m_box_min.x, m_cell_size, m_count_x, fx);
+	unsigned int y = calculateCell(position.y, m_box_min.y, m_cell_size, m_count_y, fy);
+	unsigned int z = calculateCell(position.z, m_box_min.z, m_cell_size, m_count_z, fz);
+
+	// z is contiguous, so each pair along z is adjacent
+	const float* p_x0y0 = &mv_current[calculateNode(x,     y,     z)];
+	const float* p_x0y1 = &mv_current[calculateNode(x,     y + 1, z)];
+	const float* p_x1y0 = &mv_current[calculateNode(x + 1, y,     z)];
+	const float* p_x1y1 = &mv_current[calculateNode(x + 1, y + 1, z)];
+
+	float x0y0 = p_x0y0[0] + (p_x0y0[1] - p_x0y0[0]) * fz;
+	float x0y1 = p_x0y1[0] + (p_x0y1[1] - p_x0y1[0]) * fz;
+	float x1y0 = p_x1y0[0] + (p_x1y0[1] - p_x1y0[0]) * fz;
+	float x1y1 = p_x1y1[0] + (p_x1y1[1] - p_x1y1[0]) * fz;
+
+	float x0 = x0y0 + (x0y1 - x0y0) * fy;
+	float x1 = x1y0 + (x1y1 - x1y0) * fy;
+
+	return x0 + (x1 - x0) * fx;
+}
+
+
+
+void RingDensityVolume :: init (const Vector3& box_min,
+                                const Vector3& box_max,
+                                double cell_size)
+{
+	assert(cell_size > 0.0);
+	assert(box_min.x <= box_max.x);
+	assert(box_min.y <= box_max.y);
+	assert(box_min.z <= box_max.z);
+
+	Vector3 size = box_max - box_min;
+
+	m_box_min   = box_min;
+	m_cell_size = cell_size;
+	m_count_x   = (unsigned int)(ceil(size.x / cell_size)) + 1;
+	m_count_y   = (unsigned int)(ceil(size.y / cell_size)) + 1;
+	m_count_z   = (unsigned int)(ceil(size.z / cell_size)) + 1;
+
+	// interpolation needs at least one whole cell on each axis
+	if(m_count_x < 2) m_count_x = 2;
+	if(m_count_y < 2) m_count_y = 2;
+	if(m_count_z < 2) m_count_z = 2;
+
+	unsigned int node_count = m_count_x * m_count_y * m_count_z;
+	mv_base   .assign(node_count, 0.0f);
+	mv_current.assign(node_count, 0.0f);
+
+	assert(invariant());
+}
+
+void RingDensityVolume :: setBaseValue (unsigned int x,
+                                        unsigned int y,
+                                        unsigned int z,
+                                        float value)
+{
+	assert(x < getNodeCountX());
+	assert(y < getNodeCountY());
+	assert(z < getNodeCountZ());
+
+	unsigned int node = calculateNode(x, y, z);
+	mv_base   [node] = value;
+	mv_current[node] = value;
+}
+
+void RingDensityVolume :: lowerValue (unsigned int x,
+                                      unsigned int y,
+                                      unsigned int z,
+                                      float value)
+{
+	assert(x < getNodeCountX());
+	assert(y < getNodeCountY());
+	assert(z < getNodeCountZ());
+
+	unsigned int node = calculateNode(x, y, z);
+	if(value < mv_current[node])
+		mv_current[node] = value;
+}
+
+void RingDensityVolume :: resetToBase ()
+{
+	mv_current = mv_base;
+}
+
+void RingDensityVolume :: clear ()
+{
+	m_box_min   = Vector3::ZERO;
+	m_cell_size = 0.0;
+	m_count_x   = 0;
+	m_count_y   = 0;
+	m_count_z   = 0;
+
+	// swap with empty vectors so the memory is freed
+	vector<float>().swap(mv_base);
+	vector<float>().swap(mv_current);
+
+	assert(invariant());
+}
+
+
+
+unsigned int RingDensityVolume :: calculateNode (unsigned int x,
+                                                 unsigned int y,
+                                                 unsigned int z) const
+{
+	assert(x < getNodeCountX());
+	assert(y < getNodeCountY());
+	assert(z < getNodeCountZ());
+
+	return (x * m_count_y + y) * m_count_z + z;
+}
+
+bool RingDensityVolume :: invariant () const
+{
+	if(mv_base.size() != m_count_x * m_count_y * m_count_z) return false;
+	if(mv_current.size() != mv_base.size()) return false;
+	if(!isEmpty() && m_cell_size <= 0.0) return false;
+	if(!isEmpty() && (m_count_x < 2 || m_count_y < 2 || m_count_z < 2)) return false;
+	return true;
+}
@@ -0,0 +1,350 @@
+//
+//  RingDensityVolume.h
+//
+
+#ifndef RING_DENSITY_VOLUME_H
+#define RING_DENSITY_VOLUME_H
+
+#include <vector>
+
+#include "../../ObjLibrary/Vector3.h"
+
+
+
+//
+//  RingDensityVolume
+//
+//  A class to store values sampled at the nodes of a regular 3D
+//    grid over an axis-aligned box, and to estimate the value
+//    at any position inside the box by trilinear interpolation
+//    between the 8 surrounding nodes.  This lets an expensive
+//    function, such as the ring density, be replaced by a few
+//    memory reads.
+//
+//  Each node has a base value and a current value.  Setting the
+//    base value also sets the current value.  The current value
+//    can then be lowered, and all the current values can be put
+//    back to their base values at once.  This allows features
+//    that only ever lower the value, such as holes in the ring,
+//    to be added and removed without sampling the whole volume
+//    again.
+//
+//  Class Invariant:
+//    <1> mv_base.size() == m_count_x * m_count_y * m_count_z
+//    <2> mv_current.size() == mv_base.size()
+//    <3> isEmpty() || m_cell_size > 0.0
+//    <4> isEmpty() || (m_count_x >= 2 && m_count_y >= 2 &&
+//                      m_count_z >= 2)
+//
+
+class RingDensityVolume
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty RingDensityVolume.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new RingDensityVolume with no nodes is
+//               created.
+//
+
+	RingDensityVolume ();
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create a RingDensityVolume as a copy of another.
+//  Parameter(s):
+//    <1> original: The RingDensityVolume to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new RingDensityVolume is created with the same
+//               box, nodes, and values as original.
+//
+
+	RingDensityVolume (const RingDensityVolume& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy a RingDensityVolume without
+//           memory leaks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All dynamically allocated memory is freed.
+//
+
+	~RingDensityVolume ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To modify this RingDensityVolume to be a copy of
+//           another.
+//  Parameter(s):
+//    <1> original: The RingDensityVolume to copy
+//  Precondition(s): N/A
+//  Returns: A reference to this RingDensityVolume.
+//  Side Effect: This RingDensityVolume is set to have the same
+//               box, nodes, and values as original.
+//
+
+	RingDensityVolume& operator= (const RingDensityVolume& original);
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this RingDensityVolume has any
+//           nodes.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this RingDensityVolume has no nodes.
+//  Side Effect: N/A
+//
+
+	bool isEmpty () const;
+
+//
+//  getNodeCountX
+//  getNodeCountY
+//  getNodeCountZ
+//
+//  Purpose: To determine the number of nodes along the X/Y/Z
+//           axis.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of nodes along the axis.  If this
+//           RingDensityVolume is empty, 0 is returned.
+//  Side Effect: N/A
+//
+
+	unsigned int getNodeCountX () const;
+	unsigned int getNodeCountY () const;
+	unsigned int getNodeCountZ () const;
+
+//
+//  getNodePosition
+//
+//  Purpose: To determine the position of the specified node.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The index of the node along each axis
+//  Precondition(s):
+//    <1> x < getNodeCountX()
+//    <2> y < getNodeCountY()
+//    <3> z < getNodeCountZ()
+//  Returns: The position of node (x, y, z).
+//  Side Effect: N/A
+//
+
+	Vector3 getNodePosition (unsigned int x,
+	                         unsigned int y,
+	                         unsigned int z) const;
+
+//
+//  calculateNodeRange
+//
+//  Purpose: To determine which nodes are inside the specified
+//           axis-aligned box.
+//  Parameter(s):
+//    <1> box_min: The minimum corner of the box
+//    <2> box_max: The maximum corner of the box
+//    <3> r_begin: A reference to the first node index along
+//                 each axis
+//    <4> r_end: A reference to one past the last node index
+//               along each axis
+//  Precondition(s): N/A
+//  Returns: Whether any nodes are inside the box.
+//  Side Effect: If any nodes are inside the box, r_begin and
+//               r_end are set so that node (x, y, z) is inside
+//               the box for each r_begin[a] <= a < r_end[a].
+//               Otherwise, r_begin and r_end are not changed.
+//
+
+	bool calculateNodeRange (const Vector3& box_min,
+	                         const Vector3& box_max,
+	                         unsigned int r_begin[3],
+	                         unsigned int r_end[3]) const;
+
+//
+//  isInside
+//
+//  Purpose: To determine if the specified position is inside
+//           the box covered by the nodes.
+//  Parameter(s):
+//    <1> position: The position to check
+//  Precondition(s): N/A
+//  Returns: Whether position is inside the box.  If this
+//           RingDensityVolume is empty, false is returned.
+//  Side Effect: N/A
+//
+
+	bool isInside (const Vector3& position) const;
+
+//
+//  getAt
+//
+//  Purpose: To estimate the value at the specified position.
+//  Parameter(s):
+//    <1> position: The position to query the value at
+//  Precondition(s):
+//    <1> isInside(position)
+//  Returns: The current values of the 8 nodes around position,
+//           interpolated trilinearly.  At a node, this is the
+//           current value of that node.
+//  Side Effect: N/A
+//
+
+	float getAt (const Vector3& position) const;
+
+//
+//  init
+//
+//  Purpose: To set up this RingDensityVolume to cover the
+//           specified box.
+//  Parameter(s):
+//    <1> box_min: The minimum corner of the box
+//    <2> box_max: The maximum corner of the box
+//    <3> cell_size: The distance between adjacent nodes
+//  Precondition(s):
+//    <1> cell_size > 0.0
+//    <2> box_min.x <= box_max.x
+//    <3> box_min.y <= box_max.y
+//    <4> box_min.z <= box_max.z
+//  Returns: N/A
+//  Side Effect: This RingDensityVolume is set to have nodes
+//               every cell_size along each axis, starting at
+//               box_min and continuing until box_max is
+//               covered.  All values are set to 0.0.
+//
+
+	void init (const Vector3& box_min,
+	           const Vector3& box_max,
+	           double cell_size);
+
+//
+//  setBaseValue
+//
+//  Purpose: To set the base value for the specified node.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The index of the node along each axis
+//    <4> value: The new base value
+//  Precondition(s):
+//    <1> x < getNodeCountX()
+//    <2> y < getNodeCountY()
+//    <3> z < getNodeCountZ()
+//  Returns: N/A
+//  Side Effect: The base value and current value for node (x,
+//               y, z) are set to value.
+//
+
+	void setBaseValue (unsigned int x,
+	                   unsigned int y,
+	                   unsigned int z,
+	                   float value);
+
+//
+//  lowerValue
+//
+//  Purpose: To lower the current value for the specified node.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The index of the node along each axis
+//    <4> value: The value to lower the node to
+//  Precondition(s):
+//    <1> x < getNodeCountX()
+//    <2> y < getNodeCountY()
+//    <3> z < getNodeCountZ()
+//  Returns: N/A
+//  Side Effect: If value is less than the current value for
+//               node (x, y, z), the current value is set to
+//               value.  Otherwise, there is no effect.
+//
+
+	void lowerValue (unsigned int x,
+	                 unsigned int y,
+	                 unsigned int z,
+	                 float value);
+
+//
+//  resetToBase
+//
+//  Purpose: To undo all calls to lowerValue.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The current value for every node is set to its
+//               base value.
+//
+
+	void resetToBase ();
+
+//
+//  clear
+//
+//  Purpose: To remove all nodes from this RingDensityVolume.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This RingDensityVolume is set to be empty and
+//               its memory is freed.
+//
+
+	void clear ();
+
+private:
+//
+//  calculateNode
+//
+//  Purpose: To determine where the values for the specified
+//           node are stored.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The index of the node along each axis
+//  Precondition(s):
+//    <1> x < getNodeCountX()
+//    <2> y < getNodeCountY()
+//    <3> z < getNodeCountZ()
+//  Returns: The index into mv_base and mv_current for node (x,
+//           y, z).
+//  Side Effect: N/A
+//
+
+	unsigned int calculateNode (unsigned int x,
+	                            unsigned int y,
+	                            unsigned int z) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	Vector3 m_box_min;
+	double m_cell_size;
+	unsigned int m_count_x;
+	unsigned int m_count_y;
+	unsigned int m_count_z;
+	std::vector<float> mv_base;
+	std::vector<float> mv_current;
+};
+
+
+
+#endif
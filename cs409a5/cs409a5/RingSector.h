@@ -22,12 +22,23 @@
 //
 //  After it is created, a RingSector should not be modified.
 //
+//  The positions and radii of the ring particles are also
+//    stored as a structure of arrays, with one element in each
+//    of mv_particle_x, mv_particle_y, mv_particle_z, and
+//    mv_particle_radius for each element of mv_ring_particles.
+//    These are used for collision checking, which does not need
+//    the rest of the information in a RingParticle.
+//
 
 struct RingSector
 {
 	RingSectorIndex m_index;
 	unsigned int m_density;
 	std::vector<RingParticle> mv_ring_particles;
+	std::vector<float> mv_particle_x;
+	std::vector<float> mv_particle_y;
+	std::vector<float> mv_particle_z;
+	std::vector<float> mv_particle_radius;
 };
 
 
@@ -0,0 +1,174 @@
+//
+//  RingSectorCache.cpp
+//
+
+#include <cassert>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "RingSectorIndex.h"
+#include "RingSector.h"
+#include "RingSectorCache.h"
+
+using namespace std;
+
+
+
+RingSectorCache :: RingSectorCache ()
+		: m_capacity(CAPACITY_DEFAULT),
+		  ml_entries(),
+		  m_entry_map(),
+		  m_hit_count(0),
+		  m_miss_count(0)
+{
+	m_entry_map.reserve(m_capacity);
+
+	assert(invariant());
+}
+
+RingSectorCache :: RingSectorCache (unsigned int capacity)
+		: m_capacity(capacity),
+		  ml_entries(),
+		  m_entry_map(),
+		  m_hit_count(0),
+		  m_miss_count(0)
+{
+	assert(capacity > 0);
+
+	m_entry_map.reserve(m_capacity);
+
+	assert(invariant());
+}
+
+RingSectorCache :: RingSectorCache (const RingSectorCache& original)
+		: m_capacity(original.m_capacity),
+		  ml_entries(),
+		  m_entry_map(),
+		  m_hit_count(0),
+		  m_miss_count(0)
+{
+	m_entry_map.reserve(m_capacity);
+
+	assert(invariant());
+}
+
+RingSectorCache :: ~RingSectorCache ()
+{
+}
+
+RingSectorCache& RingSectorCache :: operator= (const RingSectorCache& original)
+{
+	if(&original != this)
+	{
+		removeAll();
+		resetCounters();
+		m_capacity = original.m_capacity;
+	}
+
+	assert(invariant());
+	return *this;
+}
+
+
+
+unsigned int RingSectorCache :: getCapacity () const
+{
+	return m_capacity;
+}
+
+unsigned int RingSectorCache :: getSize () const
+{
+	return (unsigned int)(m_entry_map.size());
+}
+
+unsigned long long RingSectorCache :: getHitCount () const
+{
+	return m_hit_count;
+}
+
+unsigned long long RingSectorCache :: getMissCount () const
+{
+	return m_miss_count;
+}
+
+
+
+shared_ptr<const RingSector> RingSectorCache :: getRingSector (const RingSectorIndex& index)
+{
+	unordered_map<unsigned long long, EntryList::iterator>::iterator found =
+	                                         m_entry_map.find(calculateKey(index));
+	if(found == m_entry_map.end())
+	{
+		m_miss_count++;
+		return shared_ptr<const RingSector>();
+	}
+
+	m_hit_count++;
+	// move to front without invalidating any iterators
+	ml_entries.splice(ml_entries.begin(), ml_entries, found->second);
+	return *(found->second);
+}
+
+void RingSectorCache :: addRingSector (const shared_ptr<const RingSector>& p_ring_sector)
+{
+	assert(p_ring_sector != NULL);
+
+	unsigned long long key = calculateKey(p_ring_sector->m_index);
+	unordered_map<unsigned long long, EntryList::iterator>::iterator found =
+	                                                       m_entry_map.find(key);
+	if(found != m_entry_map.end())
+	{
+		*(found->second) = p_ring_sector;
+		ml_entries.splice(ml_entries.begin(), ml_entries, found->second);
+	}
+	else
+	{
+		if(ml_entries.size() >= m_capacity)
+		{
+			// reuse the least recently used node
+			EntryList::iterator oldest = --ml_entries.end();
+			m_entry_map.erase(calculateKey((*oldest)->m_index));
+			*oldest = p_ring_sector;
+			ml_entries.splice(ml_entries.begin(), ml_entries, oldest);
+		}
+		else
+			ml_entries.push_front(p_ring_sector);
+		m_entry_map[key] = ml_entries.begin();
+	}
+
+	assert(invariant());
+}
+
+void RingSectorCache :: removeAll ()
+{
+	ml_entries.clear();
+	m_entry_map.clear();
+
+	assert(invariant());
+}
+
+void RingSectorCache :: resetCounters ()
+{
+	m_hit_count  = 0;
+	m_miss_count = 0;
+
+	assert(invariant());
+}
+
+
+
+unsigned long long RingSectorCache :: calculateKey (const RingSectorIndex& index)
+{
+	return ((unsigned long long)(unsigned short)(index.getX()) << 32) |
+	       ((unsigned long long)(unsigned short)(index.getY()) << 16) |
+	       ((unsigned long long)(unsigned short)(index.getZ()));
+}
+
+bool RingSectorCache :: invariant () const
+{
+	if(m_capacity == 0) return false;
+	if(ml_entries.size() > m_capacity) return false;
+	if(m_entry_map.size() != ml_entries.size()) return false;
+	return true;
+}
@@ -0,0 +1,292 @@
+//
+//  RingSectorCache.h
+//
+
+#ifndef RING_SECTOR_CACHE_H
+#define RING_SECTOR_CACHE_H
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "RingSectorIndex.h"
+#include "RingSector.h"
+
+
+
+//
+//  RingSectorCache
+//
+//  A class to store recently generated RingSectors so that they
+//    do not have to be generated again.  The cache holds at most
+//    a fixed number of RingSectors.  When it is full, the least
+//    recently used RingSector is discarded to make room for a
+//    new one.
+//
+//  The RingSectors are stored as shared pointers to constant
+//    RingSectors.  A RingSector that has been returned from
+//    getRingSector remains valid for as long as the caller
+//    keeps the pointer, even if the RingSector is discarded
+//    from the cache in the meantime.
+//
+//  A RingSectorCache keeps count of how many times a requested
+//    RingSector was found (a hit) and how many times it was not
+//    (a miss).
+//
+//  Class Invariant:
+//    <1> m_capacity > 0
+//    <2> ml_entries.size() <= m_capacity
+//    <3> m_entry_map.size() == ml_entries.size()
+//
+
+class RingSectorCache
+{
+public:
+//
+//  CAPACITY_DEFAULT
+//
+//  The number of RingSectors a RingSectorCache can hold if no
+//    capacity is specified.  This is enough to hold the ring
+//    sectors drawn around the camera several times over.
+//
+
+	static const unsigned int CAPACITY_DEFAULT = 8192;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty RingSectorCache with the default
+//           capacity.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new RingSectorCache is created.  It can hold
+//               up to CAPACITY_DEFAULT RingSectors.
+//
+
+	RingSectorCache ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an empty RingSectorCache with the
+//           specified capacity.
+//  Parameter(s):
+//    <1> capacity: The maximum number of RingSectors to store
+//  Precondition(s):
+//    <1> capacity > 0
+//  Returns: N/A
+//  Side Effect: A new RingSectorCache is created.  It can hold
+//               up to capacity RingSectors.
+//
+
+	RingSectorCache (unsigned int capacity);
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create a RingSectorCache with the same capacity
+//           as another.
+//  Parameter(s):
+//    <1> original: The RingSectorCache to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, empty RingSectorCache is created with
+//               the same capacity as original.  The cached
+//               RingSectors and the counters are not copied.
+//
+
+	RingSectorCache (const RingSectorCache& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy a RingSectorCache without memory
+//           leaks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All dynamically allocated memory is freed.
+//
+
+	~RingSectorCache ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To modify this RingSectorCache to have the same
+//           capacity as another.
+//  Parameter(s):
+//    <1> original: The RingSectorCache to copy
+//  Precondition(s): N/A
+//  Returns: A reference to this RingSectorCache.
+//  Side Effect: This RingSectorCache is emptied and set to have
+//               the same capacity as original.  The counters are
+//               reset to 0.
+//
+
+	RingSectorCache& operator= (const RingSectorCache& original);
+
+//
+//  getCapacity
+//
+//  Purpose: To determine the maximum number of RingSectors this
+//           RingSectorCache can hold.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The capacity of this RingSectorCache.
+//  Side Effect: N/A
+//
+
+	unsigned int getCapacity () const;
+
+//
+//  getSize
+//
+//  Purpose: To determine the number of RingSectors currently in
+//           this RingSectorCache.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of RingSectors stored.
+//  Side Effect: N/A
+//
+
+	unsigned int getSize () const;
+
+//
+//  getHitCount
+//
+//  Purpose: To determine how many times a requested RingSector
+//           was found in this RingSectorCache.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of cache hits since this RingSectorCache
+//           was created or the counters were last reset.
+//  Side Effect: N/A
+//
+
+	unsigned long long getHitCount () const;
+
+//
+//  getMissCount
+//
+//  Purpose: To determine how many times a requested RingSector
+//           was not found in this RingSectorCache.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of cache misses since this
+//           RingSectorCache was created or the counters were
+//           last reset.
+//  Side Effect: N/A
+//
+
+	unsigned long long getMissCount () const;
+
+//
+//  getRingSector
+//
+//  Purpose: To retrieve the RingSector with the specified index
+//           from this RingSectorCache.
+//  Parameter(s):
+//    <1> index: The index of the RingSector
+//  Precondition(s): N/A
+//  Returns: A pointer to the RingSector with index index, or
+//           an empty pointer if there is no such RingSector in
+//           this RingSectorCache.
+//  Side Effect: If the RingSector is present, it is marked as
+//               the most recently used and the hit count is
+//               increased.  Otherwise, the miss count is
+//               increased.
+//
+
+	std::shared_ptr<const RingSector> getRingSector (
+	                                   const RingSectorIndex& index);
+
+//
+//  addRingSector
+//
+//  Purpose: To add a RingSector to this RingSectorCache.
+//  Parameter(s):
+//    <1> p_ring_sector: A pointer to the RingSector to add
+//  Precondition(s):
+//    <1> p_ring_sector != NULL
+//  Returns: N/A
+//  Side Effect: p_ring_sector is added to this RingSectorCache
+//               as the most recently used RingSector.  Any
+//               RingSector already stored with the same index is
+//               replaced.  If this RingSectorCache is full, the
+//               least recently used RingSector is discarded.
+//
+
+	void addRingSector (
+	               const std::shared_ptr<const RingSector>& p_ring_sector);
+
+//
+//  removeAll
+//
+//  Purpose: To remove all RingSectors from this
+//           RingSectorCache.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This RingSectorCache is emptied.  The counters
+//               are not changed.
+//
+
+	void removeAll ();
+
+//
+//  resetCounters
+//
+//  Purpose: To reset the hit and miss counters for this
+//           RingSectorCache.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The hit and miss counts are set to 0.
+//
+
+	void resetCounters ();
+
+private:
+//
+//  calculateKey
+//
+//  Purpose: To calculate the hash table key for the specified
+//           RingSectorIndex.
+//  Parameter(s):
+//    <1> index: The RingSectorIndex
+//  Precondition(s): N/A
+//  Returns: A key that is unique to index.
+//  Side Effect: N/A
+//
+
+	static unsigned long long calculateKey (
+	                                  const RingSectorIndex& index);
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	typedef std::list<std::shared_ptr<const RingSector> > EntryList;
+
+	unsigned int m_capacity;
+	EntryList ml_entries;  // most recently used first
+	std::unordered_map<unsigned long long, EntryList::iterator> m_entry_map;
+	unsigned long long m_hit_count;
+	unsigned long long m_miss_count;
+};
+
+
+
+#endif
@@ -86,6 +86,18 @@ const double RING_PARTICLE_DRAW_DISTANCE_MAX =
                             RING_SECTOR_DRAW_FROM_CAMERA_COUNT *
                             RING_SECTOR_SIZE;
 
+//
+//  RING_SECTOR_PREFETCH_FRAMES
+//
+//  How many frames ahead to predict the camera position when
+//    choosing ring sectors to generate in the background.  The
+//    sectors that will be drawn around the predicted position
+//    are generated before the camera reaches them, so moving
+//    into a new sector does not cause a pause.
+//
+
+const double RING_SECTOR_PREFETCH_FRAMES = 30.0;
+
 
 
 #endif
@@ -0,0 +1,286 @@
+//
+//  RingSectorWindow.cpp
+//
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "RingSectorSize.h"
+#include "RingSectorIndex.h"
+#include "RingSector.h"
+#include "RingSectorWindow.h"
+
+using namespace std;
+
+namespace
+{
+	//
+	//  isSameIndex
+	//
+	//  Purpose: To determine if two ring sector indexes refer to
+	//           the same sector.  RingSectorIndex::operator== is
+	//           not const, so it cannot be used here.
+	//  Parameter(s):
+	//    <1> a
+	//    <2> b: The indexes to compare
+	//  Precondition(s): N/A
+	//  Returns: Whether a and b are the same.
+	//  Side Effect: N/A
+	//
+
+	inline bool isSameIndex (const RingSectorIndex& a,
+	                         const RingSectorIndex& b)
+	{
+		return a.getX() == b.getX() &&
+		       a.getY() == b.getY() &&
+		       a.getZ() == b.getZ();
+	}
+
+	//
+	//  isInRange
+	//
+	//  Purpose: To determine if a coordinate is within the
+	//           specified distance of a center coordinate.
+	//  Parameter(s):
+	//    <1> value: The coordinate
+	//    <2> center: The center coordinate
+	//    <3> radius: The distance
+	//  Precondition(s): N/A
+	//  Returns: Whether |value - center| <= radius.
+	//  Side Effect: N/A
+	//
+
+	inline bool isInRange (int value, int center, int radius)
+	{
+		return value >= center - radius && value <= center + radius;
+	}
+}
+
+
+
+RingSectorWindow :: RingSectorWindow ()
+		: m_radius(RING_SECTOR_DRAW_FROM_CAMERA_COUNT),
+		  m_is_placed(false),
+		  m_center(),
+		  mv_slots(),
+		  m_entered_count(0)
+{
+	mv_slots.resize(getSideLength() * getSideLength() * getSideLength());
+
+	assert(invariant());
+}
+
+RingSectorWindow :: RingSectorWindow (unsigned int radius)
+		: m_radius(radius),
+		  m_is_placed(false),
+		  m_center(),
+		  mv_slots(),
+		  m_entered_count(0)
+{
+	mv_slots.resize(getSideLength() * getSideLength() * getSideLength());
+
+	assert(invariant());
+}
+
+RingSectorWindow :: RingSectorWindow (const RingSectorWindow& original)
+		: m_radius(original.m_radius),
+		  m_is_placed(false),
+		  m_center(),
+		  mv_slots(),
+		  m_entered_count(0)
+{
+	mv_slots.resize(getSideLength() * getSideLength() * getSideLength());
+
+	assert(invariant());
+}
+
+RingSectorWindow :: ~RingSectorWindow ()
+{
+}
+
+RingSectorWindow& RingSectorWindow :: operator= (const RingSectorWindow& original)
+{
+	if(&original != this)
+	{
+		m_radius = original.m_radius;
+		mv_slots.clear();
+		mv_slots.resize(getSideLength() * getSideLength() * getSideLength());
+		m_is_placed = false;
+		m_center = RingSectorIndex();
+		m_entered_count = 0;
+	}
+
+	assert(invariant());
+	return *this;
+}
+
+
+
+unsigned int RingSectorWindow :: getRadius () const
+{
+	return m_radius;
+}
+
+unsigned int RingSectorWindow :: getSideLength () const
+{
+	return m_radius * 2 + 1;
+}
+
+bool RingSectorWindow :: isPlaced () const
+{
+	return m_is_placed;
+}
+
+const RingSectorIndex& RingSectorWindow :: getCenter () const
+{
+	assert(isPlaced());
+
+	return m_center;
+}
+
+bool RingSectorWindow :: isInWindow (const RingSectorIndex& index) const
+{
+	if(!m_is_placed)
+		return false;
+
+	int radius = (int)(m_radius);
+	return isInRange(index.getX(), m_center.getX(), radius) &&
+	       isInRange(index.getY(), m_center.getY(), radius) &&
+	       isInRange(index.getZ(), m_center.getZ(), radius);
+}
+
+bool RingSectorWindow :: isRingSectorSet (const RingSectorIndex& index) const
+{
+	assert(isInWindow(index));
+
+	const shared_ptr<const RingSector>& p_slot = mv_slots[calculateSlot(index)];
+	return p_slot != NULL && isSameIndex(p_slot->m_index, index);
+}
+
+const RingSector& RingSectorWindow :: getRingSector (const RingSectorIndex& index) const
+{
+	assert(isInWindow(index));
+	assert(isRingSectorSet(index));
+
+	return *mv_slots[calculateSlot(index)];
+}
+
+unsigned long long RingSectorWindow :: getEnteredCount () const
+{
+	return m_entered_count;
+}
+
+void RingSectorWindow :: calculateEntering (
+                                const RingSectorIndex& from,
+                                const RingSectorIndex& to,
+                                vector<RingSectorIndex>& rv_entering) const
+{
+	int radius = (int)(m_radius);
+
+	// A sector enters if it is outside the old range on at
+	//  least one axis.  Checking the axes in order, each sector
+	//  is visited only if it enters or if it shares an x (or
+	//  x and y) with sectors that enter, so whole slabs are
+	//  added without looking at the sectors that stay.
+	for(int x = to.getX() - radius; x <= to.getX() + radius; x++)
+	{
+		bool is_x_entering = !isInRange(x, from.getX(), radius);
+		for(int y = to.getY() - radius; y <= to.getY() + radius; y++)
+		{
+			bool is_y_entering = is_x_entering ||
+			                     !isInRange(y, from.getY(), radius);
+			if(is_y_entering)
+			{
+				for(int z = to.getZ() - radius; z <= to.getZ() + radius; z++)
+					rv_entering.push_back(RingSectorIndex((short)(x), (short)(y), (short)(z)));
+			}
+			else
+			{
+				// only the z slabs can enter
+				for(int z = to.getZ() - radius; z <= to.getZ() + radius; z++)
+				{
+					if(!isInRange(z, from.getZ(), radius))
+						rv_entering.push_back(RingSectorIndex((short)(x), (short)(y), (short)(z)));
+				}
+			}
+		}
+	}
+}
+
+void RingSectorWindow :: moveTo (const RingSectorIndex& center,
+                                 vector<RingSectorIndex>& rv_entering)
+{
+	rv_entering.clear();
+
+	if(m_is_placed && isSameIndex(center, m_center))
+		return;
+
+	if(m_is_placed)
+		calculateEntering(m_center, center, rv_entering);
+	else
+	{
+		// nothing is in the window yet, so everything enters;
+		//  the window can never contain its own center, so use
+		//  a center one full side away
+		RingSectorIndex far_away((short)(center.getX() + getSideLength()),
+		                         center.getY(),
+		                         center.getZ());
+		calculateEntering(far_away, center, rv_entering);
+	}
+
+	m_center = center;
+	m_is_placed = true;
+	m_entered_count += rv_entering.size();
+
+	for(unsigned int i = 0; i < rv_entering.size(); i++)
+		mv_slots[calculateSlot(rv_entering[i])].reset();
+
+	assert(invariant());
+}
+
+void RingSectorWindow :: setRingSector (const shared_ptr<const RingSector>& p_ring_sector)
+{
+	assert(p_ring_sector != NULL);
+	assert(isInWindow(p_ring_sector->m_index));
+
+	mv_slots[calculateSlot(p_ring_sector->m_index)] = p_ring_sector;
+
+	assert(invariant());
+}
+
+void RingSectorWindow :: removeAll ()
+{
+	for(unsigned int i = 0; i < mv_slots.size(); i++)
+		mv_slots[i].reset();
+	m_is_placed = false;
+
+	assert(invariant());
+}
+
+
+
+unsigned int RingSectorWindow :: calculateSlot (const RingSectorIndex& index) const
+{
+	int side = (int)(getSideLength());
+
+	// C++ % can be negative, so wrap it into [0, side)
+	int x = ((index.getX() % side) + side) % side;
+	int y = ((index.getY() % side) + side) % side;
+	int z = ((index.getZ() % side) + side) % side;
+
+	return (unsigned int)((x * side + y) * side + z);
+}
+
+bool RingSectorWindow :: invariant () const
+{
+	if(mv_slots.size() != getSideLength() * getSideLength() * getSideLength()) return false;
+	if(!m_is_placed)
+	{
+		for(unsigned int i = 0; i < mv_slots.size(); i++)
+			if(mv_slots[i] != NULL) return false;
+	}
+	return true;
+}
@@ -0,0 +1,353 @@
+//
+//  RingSectorWindow.h
+//
+
+#ifndef RING_SECTOR_WINDOW_H
+#define RING_SECTOR_WINDOW_H
+
+#include <memory>
+#include <vector>
+
+#include "RingSectorIndex.h"
+#include "RingSector.h"
+
+
+
+//
+//  RingSectorWindow
+//
+//  A class to hold the RingSectors in a cube of sectors around
+//    a center sector, such as the sectors drawn around the
+//    camera.  The cube extends a fixed number of sectors (the
+//    radius) from the center along each axis.
+//
+//  The RingSectors are stored in a 3D ring buffer: the sector
+//    with index (x, y, z) is always stored in the slot (x mod
+//    side, y mod side, z mod side), where side is the length
+//    of the cube.  When the center moves by one sector, the
+//    sectors that are still in the cube stay where they are,
+//    and each sector entering the cube takes the slot of a
+//    sector leaving it on the opposite face.  Moving the window
+//    therefore only touches the slabs of sectors entering it,
+//    so the cost is proportional to how far the center moves,
+//    not to the size of the cube.
+//
+//  A RingSectorWindow does not generate RingSectors.  Instead,
+//    moveTo reports the indexes of the sectors entering the
+//    window, and the caller supplies each one with
+//    setRingSector.
+//
+//  Class Invariant:
+//    <1> mv_slots.size() == getSideLength() ^ 3
+//    <2> !m_is_placed implies every slot is empty
+//
+
+class RingSectorWindow
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty RingSectorWindow with the radius
+//           used to draw ring sectors.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, empty RingSectorWindow is created with
+//               radius RING_SECTOR_DRAW_FROM_CAMERA_COUNT.
+//
+
+	RingSectorWindow ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an empty RingSectorWindow with the
+//           specified radius.
+//  Parameter(s):
+//    <1> radius: The number of sectors on each side of the
+//                center
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, empty RingSectorWindow is created with
+//               radius radius.
+//
+
+	RingSectorWindow (unsigned int radius);
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create a RingSectorWindow with the same radius
+//           as another.
+//  Parameter(s):
+//    <1> original: The RingSectorWindow to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new, empty RingSectorWindow is created with
+//               the same radius as original.  The RingSectors
+//               are not copied.
+//
+
+	RingSectorWindow (const RingSectorWindow& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy a RingSectorWindow without memory
+//           leaks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All dynamically allocated memory is freed.
+//
+
+	~RingSectorWindow ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To modify this RingSectorWindow to have the same
+//           radius as another.
+//  Parameter(s):
+//    <1> original: The RingSectorWindow to copy
+//  Precondition(s): N/A
+//  Returns: A reference to this RingSectorWindow.
+//  Side Effect: This RingSectorWindow is emptied and set to have
+//               the same radius as original.
+//
+
+	RingSectorWindow& operator= (const RingSectorWindow& original);
+
+//
+//  getRadius
+//
+//  Purpose: To determine the number of sectors on each side of
+//           the center in this RingSectorWindow.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The radius of this RingSectorWindow.
+//  Side Effect: N/A
+//
+
+	unsigned int getRadius () const;
+
+//
+//  getSideLength
+//
+//  Purpose: To determine the number of sectors along each edge
+//           of this RingSectorWindow.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: getRadius() * 2 + 1.
+//  Side Effect: N/A
+//
+
+	unsigned int getSideLength () const;
+
+//
+//  isPlaced
+//
+//  Purpose: To determine if this RingSectorWindow has been
+//           placed around a center sector.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether moveTo has been called since this
+//           RingSectorWindow was created or emptied.
+//  Side Effect: N/A
+//
+
+	bool isPlaced () const;
+
+//
+//  getCenter
+//
+//  Purpose: To determine the center sector of this
+//           RingSectorWindow.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isPlaced()
+//  Returns: The index of the center sector.
+//  Side Effect: N/A
+//
+
+	const RingSectorIndex& getCenter () const;
+
+//
+//  isInWindow
+//
+//  Purpose: To determine if the specified sector is inside this
+//           RingSectorWindow.
+//  Parameter(s):
+//    <1> index: The index of the sector
+//  Precondition(s): N/A
+//  Returns: Whether sector index is inside this
+//           RingSectorWindow.  If this RingSectorWindow is not
+//           placed, false is returned.
+//  Side Effect: N/A
+//
+
+	bool isInWindow (const RingSectorIndex& index) const;
+
+//
+//  isRingSectorSet
+//
+//  Purpose: To determine if the RingSector for the specified
+//           sector has been supplied.
+//  Parameter(s):
+//    <1> index: The index of the sector
+//  Precondition(s):
+//    <1> isInWindow(index)
+//  Returns: Whether setRingSector has been called for sector
+//           index since it entered this RingSectorWindow.
+//  Side Effect: N/A
+//
+
+	bool isRingSectorSet (const RingSectorIndex& index) const;
+
+//
+//  getRingSector
+//
+//  Purpose: To retrieve the RingSector for the specified
+//           sector.
+//  Parameter(s):
+//    <1> index: The index of the sector
+//  Precondition(s):
+//    <1> isInWindow(index)
+//    <2> isRingSectorSet(index)
+//  Returns: The RingSector for sector index.
+//  Side Effect: N/A
+//
+
+	const RingSector& getRingSector (const RingSectorIndex& index) const;
+
+//
+//  getEnteredCount
+//
+//  Purpose: To determine how many sectors have entered this
+//           RingSectorWindow.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The total number of sectors reported by moveTo
+//           since this RingSectorWindow was created.
+//  Side Effect: N/A
+//
+
+	unsigned long long getEnteredCount () const;
+
+//
+//  calculateEntering
+//
+//  Purpose: To determine which sectors would enter this
+//           RingSectorWindow if it moved from one center to
+//           another.
+//  Parameter(s):
+//    <1> from: The old center
+//    <2> to: The new center
+//    <3> rv_entering: A vector to add the entering sectors to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The index of every sector that is within the
+//               radius of this RingSectorWindow of to but not
+//               of from is added to rv_entering.  The work done
+//               is proportional to the number of sectors added.
+//
+
+	void calculateEntering (
+	                const RingSectorIndex& from,
+	                const RingSectorIndex& to,
+	                std::vector<RingSectorIndex>& rv_entering) const;
+
+//
+//  moveTo
+//
+//  Purpose: To move this RingSectorWindow to be centered on the
+//           specified sector.
+//  Parameter(s):
+//    <1> center: The index of the new center
+//    <2> rv_entering: A vector to store the sectors entering
+//                     the window in
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This RingSectorWindow is centered on sector
+//               center.  rv_entering is set to contain the
+//               indexes of the sectors now in the window that
+//               were not before.  If this RingSectorWindow was
+//               not placed, that is every sector in it.  The
+//               slots for those sectors are emptied; the caller
+//               should fill them with setRingSector.
+//
+
+	void moveTo (const RingSectorIndex& center,
+	             std::vector<RingSectorIndex>& rv_entering);
+
+//
+//  setRingSector
+//
+//  Purpose: To supply the RingSector for a sector in this
+//           RingSectorWindow.
+//  Parameter(s):
+//    <1> p_ring_sector: A pointer to the RingSector
+//  Precondition(s):
+//    <1> p_ring_sector != NULL
+//    <2> isInWindow(p_ring_sector->m_index)
+//  Returns: N/A
+//  Side Effect: p_ring_sector is stored for its sector.
+//
+
+	void setRingSector (
+	               const std::shared_ptr<const RingSector>& p_ring_sector);
+
+//
+//  removeAll
+//
+//  Purpose: To remove all RingSectors from this
+//           RingSectorWindow.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This RingSectorWindow is emptied and marked as
+//               not placed.  The next call to moveTo will report
+//               every sector as entering.
+//
+
+	void removeAll ();
+
+private:
+//
+//  calculateSlot
+//
+//  Purpose: To determine the slot that stores the specified
+//           sector.
+//  Parameter(s):
+//    <1> index: The index of the sector
+//  Precondition(s): N/A
+//  Returns: The position in mv_slots for sector index.
+//  Side Effect: N/A
+//
+
+	unsigned int calculateSlot (const RingSectorIndex& index) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+private:
+	unsigned int m_radius;
+	bool m_is_placed;
+	RingSectorIndex m_center;
+	std::vector<std::shared_ptr<const RingSector> > mv_slots;
+	unsigned long long m_entered_count;
+};
+
+
+
+#endif
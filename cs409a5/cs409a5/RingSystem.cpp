@@ -3,7 +3,11 @@
 //
 
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "../../ObjLibrary/Vector3.h"
@@ -12,9 +16,13 @@
 #include "RingSectorIndex.h"
 #include "RingParticle.h"
 #include "RingSector.h"
+#include "RingSectorCache.h"
+#include "RingSectorWindow.h"
+#include "RingDensityVolume.h"
 #include "CoordinateSystem.h"
 #include "FractalPerlinNoiseInterface.h"
 #include "FractalPerlinNoiseDummy.h"
+#include "GeometricCollisionsSwept.h"
 #include "RingSystem.h"
 
 using namespace std;
@@ -28,6 +36,13 @@ namespace
 
 	const double PERLIN_NOISE_FACTOR = 0.2;  // 2.0 / 3.0; for real perlin noise
 
+	const double HALF_PI     = 1.5707963267948966192313216916398;
+	const double TWO_OVER_PI = 0.63661977236758134307553505349006;
+
+	// the ring edges change over about 1 / m_density_factor
+	//  (5 km), so samples every 2 sectors are close enough
+	const double DENSITY_VOLUME_CELL_SIZE = RING_SECTOR_SIZE * 2.0;
+
 
 
 	void testFrequencyDistribution ()
@@ -76,7 +91,19 @@ RingSystem :: RingSystem ()
 		  m_density_factor(DENSITY_FACTOR_DEFAULT),
 		  mv_holes(),
 		  m_fractal_perlin_noise(),
-		  m_worley_points()
+		  m_worley_points(),
+		  m_sector_cache(),
+		  m_sector_cache_mutex(),
+		  m_sector_window(),
+		  mv_sectors_entering(),
+		  m_is_prefetch_enabled(true),
+		  m_is_camera_position_previous(false),
+		  m_camera_position_previous(),
+		  m_is_prefetch_index_previous(false),
+		  m_prefetch_index_previous(),
+		  m_prefetch(),
+		  m_is_density_volume_enabled(false),
+		  m_density_volume()
 {
 	//testFrequencyDistribution();
 
@@ -95,7 +122,19 @@ RingSystem :: RingSystem (double half_thickness,
 		  m_density_factor(density_factor),
 		  mv_holes(),
 		  m_fractal_perlin_noise(),
-		  m_worley_points()
+		  m_worley_points(),
+		  m_sector_cache(),
+		  m_sector_cache_mutex(),
+		  m_sector_window(),
+		  mv_sectors_entering(),
+		  m_is_prefetch_enabled(true),
+		  m_is_camera_position_previous(false),
+		  m_camera_position_previous(),
+		  m_is_prefetch_index_previous(false),
+		  m_prefetch_index_previous(),
+		  m_prefetch(),
+		  m_is_density_volume_enabled(false),
+		  m_density_volume()
 {
 	assert(half_thickness >= 0.0);
 	assert(inner_radius >= 0.0);
@@ -115,19 +154,34 @@ RingSystem :: RingSystem (const RingSystem& original)
 		  m_density_factor(original.m_density_factor),
 		  mv_holes(original.mv_holes),
 		  m_fractal_perlin_noise(original.m_fractal_perlin_noise),
-		  m_worley_points(original.m_worley_points)
+		  m_worley_points(original.m_worley_points),
+		  m_sector_cache(original.m_sector_cache),
+		  m_sector_cache_mutex(),
+		  m_sector_window(original.m_sector_window),
+		  mv_sectors_entering(),
+		  m_is_prefetch_enabled(original.m_is_prefetch_enabled),
+		  m_is_camera_position_previous(false),
+		  m_camera_position_previous(),
+		  m_is_prefetch_index_previous(false),
+		  m_prefetch_index_previous(),
+		  m_prefetch(),
+		  m_is_density_volume_enabled(original.m_is_density_volume_enabled),
+		  m_density_volume(original.m_density_volume)
 {
 	assert(invariant());
 }
 
 RingSystem :: ~RingSystem ()
 {
+	waitForPrefetch();
 }
 
 RingSystem& RingSystem :: operator= (const RingSystem& original)
 {
 	if(&original != this)
 	{
+		waitForPrefetch();
+
 		m_half_thickness       = original.m_half_thickness;
 		m_inner_radius         = original.m_inner_radius;
 		m_outer_radius_base    = original.m_outer_radius_base;
@@ -136,6 +190,13 @@ RingSystem& RingSystem :: operator= (const RingSystem& original)
 		mv_holes               = original.mv_holes;
 		m_fractal_perlin_noise = original.m_fractal_perlin_noise;
 		m_worley_points        = original.m_worley_points;
+		m_is_prefetch_enabled  = original.m_is_prefetch_enabled;
+		m_is_density_volume_enabled = original.m_is_density_volume_enabled;
+		m_density_volume            = original.m_density_volume;
+		m_sector_cache.removeAll();
+		m_sector_window.removeAll();
+		m_is_camera_position_previous = false;
+		m_is_prefetch_index_previous = false;
 	}
 
 	assert(invariant());
@@ -146,11 +207,38 @@ RingSystem& RingSystem :: operator= (const RingSystem& original)
 
 double RingSystem :: getDensityAtPosition (const Vector3& position) const
 {
-	static const double TWO_OVER_PI = 0.63661977236758134307553505349006;
-
 	if(DEBUGGING_SECTOR_DENSITY)
 		cout << "Calculating ring sector density at " << position << endl;
 
+	double curved_density;
+	if(m_density_volume.isEmpty())
+		curved_density = calculateCurvedDensity(position, true);
+	else if(m_density_volume.isInside(position))
+		curved_density = m_density_volume.getAt(position);
+	else
+		return 0.0;  // the volume covers everywhere that is not 0.0
+
+	// the noise cannot make the density more than 0.0 here, so
+	//  do not spend time calculating it
+	if(curved_density <= -PERLIN_NOISE_FACTOR)
+		return 0.0;
+
+	double randomized_density = curved_density +
+	                            m_fractal_perlin_noise.getAt(position / RING_SECTOR_SIZE) *
+	                            PERLIN_NOISE_FACTOR;
+
+	if(DEBUGGING_SECTOR_DENSITY)
+		cout << "\tAfter randomization: " << randomized_density << endl;
+
+	if(randomized_density < 0.0)
+		return 0.0;
+	else
+		return randomized_density * m_density_max;
+}
+
+double RingSystem :: calculateCurvedDensity (const Vector3& position,
+                                             bool is_including_holes) const
+{
 	double thickness_density  = m_half_thickness   - fabs((double)(position.y));
 	double inner_edge_density = position.getNorm() - m_inner_radius;
 
@@ -172,7 +260,7 @@ double RingSystem :: getDensityAtPosition (const Vector3& position) const
 	if(DEBUGGING_SECTOR_DENSITY)
 		cout << "\tBefore holes: " << combined_density << endl;
 
-	for(unsigned int i = 0; i < mv_holes.size(); i++)
+	for(unsigned int i = 0; is_including_holes && i < mv_holes.size(); i++)
 	{
 		double hole_distance = position.getDistance(mv_holes[i].m_position);
 		double hole_density  = hole_distance - mv_holes[i].m_radius;
@@ -189,17 +277,7 @@ double RingSystem :: getDensityAtPosition (const Vector3& position) const
 	if(DEBUGGING_SECTOR_DENSITY)
 		cout << "\tAfter curving: " << curved_density << endl;
 
-	double randomized_density = curved_density +
-	                            m_fractal_perlin_noise.getAt(position / RING_SECTOR_SIZE) *
-	                            PERLIN_NOISE_FACTOR;
-
-	if(DEBUGGING_SECTOR_DENSITY)
-		cout << "\tAfter randomization: " << randomized_density << endl;
-
-	if(randomized_density < 0.0)
-		return 0.0;
-	else
-		return randomized_density * m_density_max;
+	return curved_density;
 }
 
 void RingSystem :: draw (const CoordinateSystem& camera_coordinates) const
@@ -210,6 +288,11 @@ void RingSystem :: draw (const CoordinateSystem& camera_coordinates) const
 	if(DEBUGGING_CHOOSING_SECTORS)
 		cout << "Drawing around ring sector " << camera_index << endl;
 
+	// only the sectors entering the window need to be looked up
+	m_sector_window.moveTo(camera_index, mv_sectors_entering);
+	for(unsigned int i = 0; i < mv_sectors_entering.size(); i++)
+		m_sector_window.setRingSector(getRingSector(mv_sectors_entering[i]));
+
 	for(int dx = -RING_SECTOR_DRAW_FROM_CAMERA_COUNT; dx <= RING_SECTOR_DRAW_FROM_CAMERA_COUNT; dx++)
 	{
 		short x = camera_index.getX() + dx;
@@ -221,7 +304,7 @@ void RingSystem :: draw (const CoordinateSystem& camera_coordinates) const
 				short z = camera_index.getZ() + dz;
 				RingSectorIndex ring_sector_index(x, y, z);
 
-				const RingSector& ring_sector = getRingSector(ring_sector_index);
+				const RingSector& ring_sector = m_sector_window.getRingSector(ring_sector_index);
 				unsigned int particle_count = (unsigned int)ring_sector.mv_ring_particles.size();
 
 				if(DEBUGGING_CHOOSING_SECTORS && dx == 0 && dy == 0 && dz == 0)
@@ -239,6 +322,9 @@ void RingSystem :: draw (const CoordinateSystem& camera_coordinates) const
 			}
 		}
 	}
+
+	if(m_is_prefetch_enabled)
+		prefetchSectors(camera_position);
 }
 
 void RingSystem :: init (double half_thickness,
@@ -254,12 +340,16 @@ void RingSystem :: init (double half_thickness,
 	assert(density_factor >= 0.0);
 	assert(density_factor <= 1.0);
 
+	waitForPrefetch();
+
 	m_half_thickness    = half_thickness;
 	m_inner_radius      = inner_radius;
 	m_outer_radius_base = outer_radius_base;
 	m_density_max       = density_max;
 	m_density_factor    = density_factor;
 
+	if(m_is_density_volume_enabled)
+		bakeDensityVolume();
 	removeAllHoles();
 
 	assert(invariant());
@@ -269,20 +359,225 @@ void RingSystem :: addHole(const Vector3& position, double radius)
 {
 	assert(radius >= 0.0);
 
+	waitForPrefetch();
+
 	mv_holes.push_back(Hole(position, radius));
+	if(m_is_density_volume_enabled)
+		addHoleToDensityVolume(position, radius);
+	m_sector_cache.removeAll();
+	m_sector_window.removeAll();
+	m_is_prefetch_index_previous = false;
 
 	assert(invariant());
 }
 
 void RingSystem :: removeAllHoles ()
 {
+	waitForPrefetch();
+
 	mv_holes.clear();
+	if(m_is_density_volume_enabled)
+		m_density_volume.resetToBase();
+	m_sector_cache.removeAll();
+	m_sector_window.removeAll();
+	m_is_prefetch_index_previous = false;
+
+	assert(invariant());
+}
+
+
+const RingSectorCache& RingSystem :: getSectorCache () const
+{
+	return m_sector_cache;
+}
+
+const RingSectorWindow& RingSystem :: getSectorWindow () const
+{
+	return m_sector_window;
+}
+
+bool RingSystem :: isPrefetchEnabled () const
+{
+	return m_is_prefetch_enabled;
+}
+
+void RingSystem :: setPrefetchEnabled (bool is_enabled)
+{
+	if(!is_enabled)
+		waitForPrefetch();
+	m_is_prefetch_enabled = is_enabled;
+	m_is_camera_position_previous = false;
+	m_is_prefetch_index_previous = false;
+
+	assert(invariant());
+}
+
+bool RingSystem :: isDensityVolumeEnabled () const
+{
+	return m_is_density_volume_enabled;
+}
+
+void RingSystem :: setDensityVolumeEnabled (bool is_enabled)
+{
+	if(is_enabled == m_is_density_volume_enabled)
+		return;
+
+	waitForPrefetch();
+
+	m_is_density_volume_enabled = is_enabled;
+	if(is_enabled)
+		bakeDensityVolume();
+	else
+		m_density_volume.clear();
+
+	// the interpolated densities are not exactly the same
+	m_sector_cache.removeAll();
+	m_sector_window.removeAll();
+	m_is_prefetch_index_previous = false;
 
 	assert(invariant());
 }
 
 
-RingSector RingSystem :: getRingSector (const RingSectorIndex& index) const
+
+shared_ptr<const RingSector> RingSystem :: getRingSector (const RingSectorIndex& index) const
+{
+	{
+		lock_guard<mutex> lock(m_sector_cache_mutex);
+		shared_ptr<const RingSector> p_ring_sector = m_sector_cache.getRingSector(index);
+		if(p_ring_sector != NULL)
+			return p_ring_sector;
+	}
+
+	// generate without holding the lock so other threads are not
+	//  blocked; if two threads generate the same sector, the
+	//  results are identical and the later one replaces the other
+	shared_ptr<const RingSector> p_ring_sector = generateRingSector(index);
+
+	lock_guard<mutex> lock(m_sector_cache_mutex);
+	m_sector_cache.addRingSector(p_ring_sector);
+	return p_ring_sector;
+}
+
+void RingSystem :: prefetchSectors (const Vector3& camera_position) const
+{
+	assert(m_sector_window.isPlaced());
+
+	Vector3 camera_velocity;
+	if(m_is_camera_position_previous)
+		camera_velocity = camera_position - m_camera_position_previous;
+	m_camera_position_previous = camera_position;
+	m_is_camera_position_previous = true;
+
+	if(m_prefetch.valid())
+	{
+		// only one prefetch at a time
+		if(m_prefetch.wait_for(chrono::seconds(0)) != future_status::ready)
+			return;
+		m_prefetch.get();
+	}
+
+	RingSectorIndex predicted_index(camera_position + camera_velocity * RING_SECTOR_PREFETCH_FRAMES);
+
+	// skip the sectors already in the window or prefetched for
+	//  the last prediction
+	RingSectorIndex from = m_sector_window.getCenter();
+	if(m_is_prefetch_index_previous)
+		from = m_prefetch_index_previous;
+	if(predicted_index.getX() == from.getX() &&
+	   predicted_index.getY() == from.getY() &&
+	   predicted_index.getZ() == from.getZ())
+	{
+		return;
+	}
+	m_prefetch_index_previous = predicted_index;
+	m_is_prefetch_index_previous = true;
+
+	vector<RingSectorIndex> v_predicted;
+	m_sector_window.calculateEntering(from, predicted_index, v_predicted);
+
+	// the sectors are generated into the cache, so the window
+	//  finds them there when the camera reaches them
+	m_prefetch = async(launch::async, [this, v_predicted] ()
+	{
+		for(unsigned int i = 0; i < v_predicted.size(); i++)
+			getRingSector(v_predicted[i]);
+	});
+}
+
+void RingSystem :: waitForPrefetch () const
+{
+	if(m_prefetch.valid())
+		m_prefetch.get();
+}
+
+void RingSystem :: bakeDensityVolume ()
+{
+	assert(isDensityVolumeEnabled());
+
+	if(m_density_factor == 0.0)
+	{
+		// the density is the same everywhere
+		m_density_volume.clear();
+		return;
+	}
+
+	// Noise can raise the density by at most PERLIN_NOISE_FACTOR,
+	//  so it stays at 0.0 wherever the curved density is below
+	//  -PERLIN_NOISE_FACTOR.  This happens once a position is
+	//  this far outside an edge.
+	double padding = tan(PERLIN_NOISE_FACTOR * HALF_PI) / m_density_factor;
+	double radius  = m_outer_radius_base + m_half_thickness + padding;
+	double height  = m_half_thickness + padding;
+	m_density_volume.init(Vector3(-radius, -height, -radius),
+	                      Vector3( radius,  height,  radius),
+	                      DENSITY_VOLUME_CELL_SIZE);
+
+	for(unsigned int x = 0; x < m_density_volume.getNodeCountX(); x++)
+		for(unsigned int y = 0; y < m_density_volume.getNodeCountY(); y++)
+			for(unsigned int z = 0; z < m_density_volume.getNodeCountZ(); z++)
+			{
+				Vector3 position = m_density_volume.getNodePosition(x, y, z);
+				m_density_volume.setBaseValue(x, y, z, (float)(calculateCurvedDensity(position, false)));
+			}
+
+	for(unsigned int i = 0; i < mv_holes.size(); i++)
+		addHoleToDensityVolume(mv_holes[i].m_position, mv_holes[i].m_radius);
+}
+
+void RingSystem :: addHoleToDensityVolume (const Vector3& position,
+                                           double radius)
+{
+	assert(radius >= 0.0);
+
+	// The density without holes is never more than the half
+	//  thickness, so a hole cannot lower it any farther than
+	//  that outside the hole.  The curve is increasing, so
+	//  taking the minimum after curving gives the same result.
+	double reach = radius + m_half_thickness;
+	Vector3 reach_vector(reach, reach, reach);
+
+	unsigned int a_begin[3];
+	unsigned int a_end[3];
+	if(!m_density_volume.calculateNodeRange(position - reach_vector,
+	                                        position + reach_vector,
+	                                        a_begin, a_end))
+	{
+		return;
+	}
+
+	for(unsigned int x = a_begin[0]; x < a_end[0]; x++)
+		for(unsigned int y = a_begin[1]; y < a_end[1]; y++)
+			for(unsigned int z = a_begin[2]; z < a_end[2]; z++)
+			{
+				Vector3 node_position = m_density_volume.getNodePosition(x, y, z);
+				double hole_density   = node_position.getDistance(position) - radius;
+				double curved_density = atan(hole_density * m_density_factor) * TWO_OVER_PI;
+				m_density_volume.lowerValue(x, y, z, (float)(curved_density));
+			}
+}
+
+shared_ptr<const RingSector> RingSystem :: generateRingSector (const RingSectorIndex& index) const
 {
 	Vector3 center = index.getCenter();
 
@@ -292,55 +587,82 @@ RingSector RingSystem :: getRingSector (const RingSectorIndex& index) const
 	                                                                 index.getX(),
 	                                                                 index.getY(),
 	                                                                 index.getZ());
-	RingSector ring_sector;
-	ring_sector.m_index = index;
-	ring_sector.m_density = int_density;
-	ring_sector.mv_ring_particles.resize(int_density);
+	shared_ptr<RingSector> p_ring_sector = make_shared<RingSector>();
+	p_ring_sector->m_index = index;
+	p_ring_sector->m_density = int_density;
+	p_ring_sector->mv_ring_particles.resize(int_density);
+	p_ring_sector->mv_particle_x     .resize(int_density);
+	p_ring_sector->mv_particle_y     .resize(int_density);
+	p_ring_sector->mv_particle_z     .resize(int_density);
+	p_ring_sector->mv_particle_radius.resize(int_density);
 	for(unsigned int i = 0; i < int_density; i++)
 	{
 		const WorleyPoint3::Point3& point = v_points[i];
 		Vector3 position = Vector3(point.m_x, point.m_y, point.m_z) * RING_SECTOR_SIZE;// + center;
-		ring_sector.mv_ring_particles[i].init(position, v_points[i].m_seed);
+		RingParticle& r_particle = p_ring_sector->mv_ring_particles[i];
+		r_particle.init(position, v_points[i].m_seed);
+
+		p_ring_sector->mv_particle_x[i]      = (float)(r_particle.getPosition().x);
+		p_ring_sector->mv_particle_y[i]      = (float)(r_particle.getPosition().y);
+		p_ring_sector->mv_particle_z[i]      = (float)(r_particle.getPosition().z);
+		p_ring_sector->mv_particle_radius[i] = (float)(r_particle.getRadius());
 	}
 
-	return ring_sector;
+	return p_ring_sector;
 }
 
-bool RingSystem::handleRingParticleCollision(const Vector3& sphere_centre, double sphere_radius)
+bool RingSystem::handleRingParticleCollision(const Vector3& sphere_centre, double sphere_radius) const
 {
-    RingSectorIndex centre(sphere_centre);
+    return handleRingParticleCollision(sphere_centre, sphere_centre, sphere_radius);
+}
+
+bool RingSystem::handleRingParticleCollision(const Vector3& sphere_start,
+                                             const Vector3& sphere_end,
+                                             double sphere_radius) const
+{
+    assert(sphere_radius >= 0.0);
     
-    for(int dx = -1; dx <= 1; dx++)
+    // check every sector the bounding box of the moving sphere
+    //  touches, but only search the ones the sphere passes
+    //  through; a sector grown by the sphere radius contains
+    //  everything the sphere can hit in that sector
+    Vector3 radius_vector(sphere_radius, sphere_radius, sphere_radius);
+    RingSectorIndex index_min(sphere_start.getMinComponents(sphere_end) - radius_vector);
+    RingSectorIndex index_max(sphere_start.getMaxComponents(sphere_end) + radius_vector);
+    Vector3 sector_size = RING_SECTOR_HALF_SIZE + radius_vector;
+    
+    for(int x = index_min.getX(); x <= index_max.getX(); x++)
     {
-        short x = (centre.getX() + dx);
-        for(int dy = -1; dy <= 1; dy++)
+        for(int y = index_min.getY(); y <= index_max.getY(); y++)
         {
-            short y = (centre.getY() + dy);
-            for(int dz = -1; dz <= 1; dz++)
+            for(int z = index_min.getZ(); z <= index_max.getZ(); z++)
             {
-                short z = (centre.getZ() + dz);
+                RingSectorIndex index((short)(x), (short)(y), (short)(z));
                 
-                RingSectorIndex index(x, y, z);
-                const RingSector& ring_sector = getRingSector(index);
-                
-                if (!GeometricCollisions::sphereVsCuboid(sphere_centre,
-                                                        sphere_radius,
-                                                        index.getCenter(),
-                                                        RING_SECTOR_HALF_SIZE))
+                if (!GeometricCollisions::segmentVsCuboid(sphere_start,
+                                                         sphere_end,
+                                                         index.getCenter(),
+                                                         sector_size))
+                {
+                    continue;
+                }
+                shared_ptr<const RingSector> p_ring_sector = getRingSector(index);
+                const RingSector& ring_sector = *p_ring_sector;
+                unsigned int particle_count = (unsigned int)ring_sector.mv_particle_radius.size();
+                if (particle_count == 0)
                 {
                     continue;
                 }
-                unsigned int particle_count = (unsigned int)ring_sector.mv_ring_particles.size();
-                for(unsigned int i = 0; i < particle_count; i++)
+                if (GeometricCollisions::movingSphereVsSpheresFirst(sphere_start,
+                                                                    sphere_end,
+                                                                    sphere_radius,
+                                                                    &ring_sector.mv_particle_x[0],
+                                                                    &ring_sector.mv_particle_y[0],
+                                                                    &ring_sector.mv_particle_z[0],
+                                                                    &ring_sector.mv_particle_radius[0],
+                                                                    particle_count) < particle_count)
                 {
-                    RingParticle particle = ring_sector.mv_ring_particles[i];
-                    if (GeometricCollisions::sphereVsSphere(sphere_centre,
-                                                            sphere_radius,
-                                                            particle.getPosition(),
-                                                            particle.getRadius()))
-                    {
-                        return true;
-                    }
+                    return true;
                 }
             }
         }
@@ -352,7 +674,21 @@ std::vector<RingParticleData> RingSystem::getRingParticles(
                                            const Vector3& sphere_centre,
                                            double sphere_radius) const
 {
+    vector<RingSectorIndex> indexes;
+    appendRingSectorIndexes(sphere_centre, sphere_radius, indexes);
+    
     vector<RingParticleData> list;
+    for(unsigned int i = 0; i < indexes.size(); i++)
+        appendRingParticleData(*getRingSector(indexes[i]), list);
+    return list;
+}
+
+void RingSystem :: appendRingSectorIndexes (const Vector3& sphere_centre,
+                                            double sphere_radius,
+                                            vector<RingSectorIndex>& r_indexes)
+{
+    assert(sphere_radius >= 0.0);
+    
     RingSectorIndex centre(sphere_centre);
     
     for(int dx = -1; dx <= 1; dx++)
@@ -366,28 +702,31 @@ std::vector<RingParticleData> RingSystem::getRingParticles(
                 short z = (centre.getZ() + dz);
                 
                 RingSectorIndex index(x, y, z);
-                const RingSector& ring_sector = getRingSector(index);
                 
-                if (!GeometricCollisions::sphereVsCuboid(sphere_centre,
-                                                         sphere_radius,
-                                                         index.getCenter(),
-                                                         RING_SECTOR_HALF_SIZE))
-                {
-                    continue;
-                }
-                unsigned int particle_count = (unsigned int)ring_sector.mv_ring_particles.size();
-                for(unsigned int i = 0; i < particle_count; i++)
+                if (GeometricCollisions::sphereVsCuboid(sphere_centre,
+                                                        sphere_radius,
+                                                        index.getCenter(),
+                                                        RING_SECTOR_HALF_SIZE))
                 {
-                    RingParticleData temp = {
-                        ring_sector.mv_ring_particles[i].getPosition(),
-                        ring_sector.mv_ring_particles[i].getRadius()
-                    };
-                    list.push_back(temp);
+                    r_indexes.push_back(index);
                 }
             }
         }
     }
-    return list;
+}
+
+void RingSystem :: appendRingParticleData (const RingSector& ring_sector,
+                                           vector<RingParticleData>& r_particles)
+{
+    unsigned int particle_count = (unsigned int)ring_sector.mv_ring_particles.size();
+    for(unsigned int i = 0; i < particle_count; i++)
+    {
+        RingParticleData temp = {
+            ring_sector.mv_ring_particles[i].getPosition(),
+            ring_sector.mv_ring_particles[i].getRadius()
+        };
+        r_particles.push_back(temp);
+    }
 }
 
 bool RingSystem :: invariant () const
@@ -398,6 +737,7 @@ bool RingSystem :: invariant () const
 	if (m_density_max < 0.0) return false;
 	if (m_density_factor < 0.0) return false;
 	if (m_density_factor > 1.0) return false;
+	if (!m_is_density_volume_enabled && !m_density_volume.isEmpty()) return false;
 	return true;
 }
 
@@ -5,6 +5,9 @@
 #ifndef RING_SYSTEM_H
 #define RING_SYSTEM_H
 
+#include <future>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "../../ObjLibrary/Vector3.h"
@@ -13,6 +16,9 @@
 #include "RingParticleData.h"
 #include "RingParticle.h"
 #include "RingSector.h"
+#include "RingSectorCache.h"
+#include "RingSectorWindow.h"
+#include "RingDensityVolume.h"
 #include "CoordinateSystem.h"
 #include "WorleyPoint.h"
 #include "FractalPerlinNoiseInterface.h"
@@ -55,6 +61,21 @@
 //  A RingSystem also can can include 1 or more spherical holes.
 //    No ring particles are generated in these holes.
 //
+//  Generated ring sectors are kept in a RingSectorCache so that
+//    a sector near the camera or a ship is only generated once.
+//    The cache is emptied whenever the ring parameters or holes
+//    change.  The const functions may be called from several
+//    threads at once; access to the cache is serialized by a
+//    mutex.
+//
+//  The density can optionally be baked into a RingDensityVolume
+//    covering the ring, so that getDensityAtPosition only has
+//    to interpolate between stored samples and add the noise.
+//    The samples do not include the noise.  Adding a hole only
+//    updates the samples near it, and removing the holes puts
+//    back the samples baked without them.  Outside the volume,
+//    the density is always 0.0.
+//
 //  Class Invariant:
 //    <1> m_half_thickness >= 0.0
 //    <2> m_inner_radius >= 0.0
@@ -62,6 +83,7 @@
 //    <4> m_density_max >= 0.0
 //    <5> m_density_factor >= 0.0
 //    <6> m_density_factor <= 1.0
+//    <7> m_is_density_volume_enabled || m_density_volume.isEmpty()
 //
 
 class RingSystem
@@ -169,7 +191,9 @@ public:
     //  Parameter(s):
     //    <1> position: The position to query the denisyt at
     //  Precondition(s): N/A
-    //  Returns: The density of this RingSystem at position.
+    //  Returns: The density of this RingSystem at position.  If
+    //           the density volume is enabled, this is
+    //           interpolated from the baked samples.
     //  Side Effect: N/A
     //
     
@@ -186,7 +210,13 @@ public:
     //  Returns: N/A
     //  Side Effect: The ring particles in this RingSystem that are
     //               in view of a camera with coordinate system
-    //               camera_coordinates are displayed.
+    //               camera_coordinates are displayed.  The window
+    //               of ring sectors around the camera is moved to
+    //               follow it, and only the sectors entering the
+    //               window are retrieved.  If prefetching is
+    //               enabled, the sectors the camera is moving
+    //               towards may be generated on a background
+    //               thread.
     //
     
     void draw(const CoordinateSystem& camera_coordinates) const;
@@ -267,7 +297,30 @@ public:
     //  Returns: Whether a collision has occurred with the given sphere
     //  Side Effect: N/A
     //
-    bool handleRingParticleCollision(const Vector3& sphere_centre, double sphere_radius);
+    bool handleRingParticleCollision(const Vector3& sphere_centre, double sphere_radius) const;
+    
+    //
+    //  handleRingParticleCollision
+    //
+    //  Purpose: To determine if a sphere moving in a straight line
+    //           hits any ring particle along the way.
+    //  Parameter(s):
+    //    <1> sphere_start: The centre of the sphere at the start of
+    //                      its movement, such as the previous
+    //                      position of a PhysicsObject
+    //    <2> sphere_end: The centre of the sphere at the end of its
+    //                    movement
+    //    <3> sphere_radius: The radius of the sphere
+    //  Precondition(s):
+    //    <1> sphere_radius >= 0.0
+    //  Returns: Whether the sphere intersects a ring particle at
+    //           any point between sphere_start and sphere_end.
+    //  Side Effect: Any ring sectors the sphere passes through
+    //               that have not been generated are generated.
+    //
+    bool handleRingParticleCollision(const Vector3& sphere_start,
+                                     const Vector3& sphere_end,
+                                     double sphere_radius) const;
     
     //
     //  getRingParticles
@@ -292,23 +345,267 @@ public:
                                                const Vector3& sphere_centre,
                                                double sphere_radius) const;
     
-private:
+    //
+    //  appendRingSectorIndexes
+    //
+    //  Purpose: To determine which ring sectors getRingParticles
+    //           reads for the specified sphere.  This allows many
+    //           queries to share each ring sector.
+    //  Parameter(s):
+    //    <1> sphere_centre: The center of the sphere
+    //    <2> sphere_radius: The radius of the sphere
+    //    <3> r_indexes: The vector to add the sector indexes to
+    //  Precondition(s):
+    //    <1> sphere_radius >= 0.0
+    //  Returns: N/A
+    //  Side Effect: The indexes of the ring sectors that
+    //               getRingParticles(sphere_centre, sphere_radius)
+    //               would read are added to the end of r_indexes,
+    //               in the order that it would read them.
+    //
+    
+    static void appendRingSectorIndexes (
+                                    const Vector3& sphere_centre,
+                                    double sphere_radius,
+                                    std::vector<RingSectorIndex>& r_indexes);
+    
+    //
+    //  appendRingParticleData
+    //
+    //  Purpose: To determine the position and radius of all ring
+    //           particles in the specified ring sector.
+    //  Parameter(s):
+    //    <1> ring_sector: The ring sector
+    //    <2> r_particles: The vector to add the particles to
+    //  Precondition(s): N/A
+    //  Returns: N/A
+    //  Side Effect: A record for each ring particle in ring_sector
+    //               is added to the end of r_particles.
+    //
+    
+    static void appendRingParticleData (
+                          const RingSector& ring_sector,
+                          std::vector<RingParticleData>& r_particles);
+    
     //
     //  getRingSector
     //
+    //  Purpose: To retrieve the RingSector for a specifed sector in
+    //           the ring, generating it if it is not cached.
+    //  Parameter(s):
+    //    <1> index: The index of the ring sector to retrieve
+    //  Precondition(s): N/A
+    //  Returns: A pointer to the information for ring sector index,
+    //           including the ring particles.
+    //  Side Effect: If ring sector index is not in the sector
+    //               cache, it is generated and added to the cache.
+    //               Otherwise, it is marked as recently used.
+    //
+    
+    std::shared_ptr<const RingSector> getRingSector (
+                              const RingSectorIndex& index) const;
+    
+    //
+    //  getSectorCache
+    //
+    //  Purpose: To retrieve the cache of generated ring sectors
+    //           for this RingSystem.  This is intended for
+    //           checking the cache hit and miss counts.
+    //  Parameter(s): N/A
+    //  Precondition(s): N/A
+    //  Returns: The RingSectorCache for this RingSystem.
+    //  Side Effect: N/A
+    //
+    
+    const RingSectorCache& getSectorCache () const;
+    
+    //
+    //  getSectorWindow
+    //
+    //  Purpose: To retrieve the window of ring sectors drawn around
+    //           the camera.  This is intended for checking how
+    //           many sectors have entered the window.
+    //  Parameter(s): N/A
+    //  Precondition(s): N/A
+    //  Returns: The RingSectorWindow for this RingSystem.
+    //  Side Effect: N/A
+    //
+    
+    const RingSectorWindow& getSectorWindow () const;
+    
+    //
+    //  isPrefetchEnabled
+    //
+    //  Purpose: To determine if ring sectors ahead of the camera
+    //           are generated on a background thread.
+    //  Parameter(s): N/A
+    //  Precondition(s): N/A
+    //  Returns: Whether prefetching is enabled.
+    //  Side Effect: N/A
+    //
+    
+    bool isPrefetchEnabled () const;
+    
+    //
+    //  setPrefetchEnabled
+    //
+    //  Purpose: To change whether ring sectors ahead of the camera
+    //           are generated on a background thread.
+    //  Parameter(s):
+    //    <1> is_enabled: Whether prefetching should be enabled
+    //  Precondition(s): N/A
+    //  Returns: N/A
+    //  Side Effect: Prefetching is enabled if is_enabled == true
+    //               and disabled otherwise.  If it is disabled, any
+    //               prefetch in progress is finished first.
+    //
+    
+    void setPrefetchEnabled (bool is_enabled);
+    
+    //
+    //  isDensityVolumeEnabled
+    //
+    //  Purpose: To determine if the ring density is baked into a
+    //           volume of samples.
+    //  Parameter(s): N/A
+    //  Precondition(s): N/A
+    //  Returns: Whether the density volume is enabled.
+    //  Side Effect: N/A
+    //
+    
+    bool isDensityVolumeEnabled () const;
+    
+    //
+    //  setDensityVolumeEnabled
+    //
+    //  Purpose: To change whether the ring density is baked into a
+    //           volume of samples.
+    //  Parameter(s):
+    //    <1> is_enabled: Whether the density volume should be
+    //                    enabled
+    //  Precondition(s): N/A
+    //  Returns: N/A
+    //  Side Effect: If is_enabled == true and the volume is not
+    //               already enabled, the density for the current
+    //               ring parameters and holes is baked.  If
+    //               is_enabled == false, the volume is freed.  The
+    //               ring sectors are generated again, because
+    //               their densities may change slightly.
+    //
+    
+    void setDensityVolumeEnabled (bool is_enabled);
+    
+private:
+    //
+    //  generateRingSector
+    //
     //  Purpose: To generate the RingSector for a specifed sector in
     //           the ring.
     //  Parameter(s):
     //    <1> index: The index of the ring sector to generate
     //  Precondition(s): N/A
-    //  Returns: The information for ring sector index, including
-    //           the ring particles.
+    //  Returns: A pointer to a newly-generated RingSector with the
+    //           information for ring sector index, including the
+    //           ring particles.
     //  Side Effect: N/A
     //
     
-    RingSector getRingSector (
+    std::shared_ptr<const RingSector> generateRingSector (
                               const RingSectorIndex& index) const;
     
+    //
+    //  prefetchSectors
+    //
+    //  Purpose: To start generating the ring sectors that the
+    //           camera is moving towards.
+    //  Parameter(s):
+    //    <1> camera_position: The current camera position
+    //  Precondition(s):
+    //    <1> m_sector_window.isPlaced()
+    //  Returns: N/A
+    //  Side Effect: The camera velocity is estimated from the
+    //               camera position when this function was last
+    //               called.  If the camera will be in a different
+    //               sector after RING_SECTOR_PREFETCH_FRAMES more
+    //               frames at that velocity and no prefetch is in
+    //               progress, the sectors that would enter the
+    //               window by then are generated into the sector
+    //               cache on a background thread.  Sectors that
+    //               were prefetched for the previous prediction
+    //               are not requested again.
+    //
+    
+    void prefetchSectors (const Vector3& camera_position) const;
+    
+    //
+    //  waitForPrefetch
+    //
+    //  Purpose: To wait for any prefetch in progress to finish.
+    //           This must be done before changing anything the
+    //           ring particles are generated from.
+    //  Parameter(s): N/A
+    //  Precondition(s): N/A
+    //  Returns: N/A
+    //  Side Effect: If a prefetch is in progress, this function
+    //               blocks until it finishes.
+    //
+    
+    void waitForPrefetch () const;
+    
+    //
+    //  calculateCurvedDensity
+    //
+    //  Purpose: To calculate the ring density at the specified
+    //           position before the noise is added.
+    //  Parameter(s):
+    //    <1> position: The position to calculate the density at
+    //    <2> is_including_holes: Whether to include the holes
+    //  Precondition(s): N/A
+    //  Returns: The density at position, without noise, in the
+    //           range (-1.0, 1.0).
+    //  Side Effect: N/A
+    //
+    
+    double calculateCurvedDensity (const Vector3& position,
+                                   bool is_including_holes) const;
+    
+    //
+    //  bakeDensityVolume
+    //
+    //  Purpose: To sample the density without noise at every node
+    //           of the density volume.
+    //  Parameter(s): N/A
+    //  Precondition(s):
+    //    <1> isDensityVolumeEnabled()
+    //  Returns: N/A
+    //  Side Effect: The density volume is resized to cover every
+    //               position where the density can be more than
+    //               0.0, and the density with and without holes
+    //               is sampled at each node.  If m_density_factor
+    //               is 0.0, the ring has no edges and the volume
+    //               is left empty.
+    //
+    
+    void bakeDensityVolume ();
+    
+    //
+    //  addHoleToDensityVolume
+    //
+    //  Purpose: To lower the samples in the density volume near
+    //           the specified hole.
+    //  Parameter(s):
+    //    <1> position: The hole center
+    //    <2> radius: The hole radius
+    //  Precondition(s):
+    //    <1> radius >= 0.0
+    //  Returns: N/A
+    //  Side Effect: Each node close enough to the hole for it to
+    //               lower the density is updated.
+    //
+    
+    void addHoleToDensityVolume (const Vector3& position,
+                                 double radius);
+    
     //
     //  invariant
     //
@@ -352,6 +649,18 @@ private:
     
     FractalPerlinNoiseDummy m_fractal_perlin_noise;
     WorleyPoint3 m_worley_points;
+    mutable RingSectorCache m_sector_cache;
+    mutable std::mutex m_sector_cache_mutex;
+    mutable RingSectorWindow m_sector_window;
+    mutable std::vector<RingSectorIndex> mv_sectors_entering;
+    bool m_is_prefetch_enabled;
+    mutable bool m_is_camera_position_previous;
+    mutable Vector3 m_camera_position_previous;
+    mutable bool m_is_prefetch_index_previous;
+    mutable RingSectorIndex m_prefetch_index_previous;
+    mutable std::future<void> m_prefetch;
+    bool m_is_density_volume_enabled;
+    RingDensityVolume m_density_volume;
 };
 
 
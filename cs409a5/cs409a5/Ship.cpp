@@ -3,6 +3,8 @@
 //
 
 #include <cassert>
+#include <istream>
+#include <ostream>
 #include "GetGlut.h"
 
 #include "Pi.h"
@@ -12,6 +14,7 @@
 #include "TimeSystem.h"
 #include "WorldInterface.h"
 #include "PhysicsObject.h"
+#include "SnapshotStream.h"
 #include "Ship.h"
 
 #include "UnitAiSuperclass.h"
@@ -32,7 +35,7 @@ namespace
 
 const double Ship :: RADIUS         = 10.0;
 const float  Ship :: HEALTH_DEAD_AT =  0.001f;
-const float  Ship :: RELOAD_TIME    =  0.25f;
+const double Ship :: RELOAD_TIME    =  0.25;
 
 
 
@@ -258,17 +261,34 @@ void Ship :: markDead (bool instant)
 }
 
 void Ship :: update (WorldInterface& r_world)
+{
+    Vector3 turn_forward;
+    double turn_max_radians;
+    if (getTurn(turn_forward, turn_max_radians))
+        rotateTowards(turn_forward, turn_max_radians);
+    
+    updateAfterTurning(r_world);
+}
+
+bool Ship :: getTurn (Vector3& r_forward, double& r_max_radians) const
+{
+    if (!isUnitAiSet()) return false;
+    if (desired_velocity.isZero()) return false;
+    
+    double deltaRotation = max_rotation_rate * TimeSystem::getFrameDuration();
+    if (deltaRotation <= 0.0) return false;
+    
+    r_forward = desired_velocity.getNormalized();
+    r_max_radians = deltaRotation;
+    return true;
+}
+
+void Ship :: updateAfterTurning (WorldInterface& r_world)
 {
     if (isUnitAiSet())
     {
         if (!desired_velocity.isZero())
         {
-            double deltaRotation = max_rotation_rate * TimeSystem::getFrameDuration();
-            if(deltaRotation > 0.0)
-            {
-                rotateTowards(desired_velocity.getNormalized(), deltaRotation);
-            }
-            
             double delta = max_acceleration * TimeSystem::getFrameDuration();
             if(delta > 0.0)
             {
@@ -311,13 +331,79 @@ void Ship :: update (WorldInterface& r_world)
 	if(isAlive())
 	{
 		updateBasic();  // moves the Ship
-
 		m_reload_timer += TimeSystem::getFrameDuration();
 	}
 
 	assert(invariant());
 }
 
+void Ship :: writeState (std::ostream& r_out) const
+{
+    PhysicsObject::writeState(r_out);
+    
+    SnapshotStream::writeValue  (r_out, m_health);
+    SnapshotStream::writeValue  (r_out, m_reload_timer);
+    SnapshotStream::writeValue  (r_out, m_ammo);
+    SnapshotStream::writeValue  (r_out, m_is_dead);
+    SnapshotStream::writeValue  (r_out, max_speed);
+    SnapshotStream::writeValue  (r_out, max_acceleration);
+    SnapshotStream::writeValue  (r_out, max_rotation_rate);
+    SnapshotStream::writeVector3(r_out, desired_velocity);
+    SnapshotStream::writeValue  (r_out, wantsToFire);
+    
+    SnapshotStream::writeValue  (r_out, isUnitAiSet());
+    if (isUnitAiSet())
+        unitAi->writeState(r_out);
+}
+
+bool Ship :: readState (std::istream& r_in)
+{
+    if (!PhysicsObject::readState(r_in))
+        return false;
+    
+    float health;
+    double reload_timer;
+    int ammo;
+    bool is_dead;
+    float speed_max;
+    float acceleration;
+    float rotation_rate;
+    Vector3 velocity;
+    bool wants_to_fire;
+    bool is_unit_ai_set;
+    
+    if (!SnapshotStream::readValue  (r_in, health)        ||
+        !SnapshotStream::readValue  (r_in, reload_timer)  ||
+        !SnapshotStream::readValue  (r_in, ammo)          ||
+        !SnapshotStream::readValue  (r_in, is_dead)       ||
+        !SnapshotStream::readValue  (r_in, speed_max)     ||
+        !SnapshotStream::readValue  (r_in, acceleration)  ||
+        !SnapshotStream::readValue  (r_in, rotation_rate) ||
+        !SnapshotStream::readVector3(r_in, velocity)      ||
+        !SnapshotStream::readValue  (r_in, wants_to_fire) ||
+        !SnapshotStream::readValue  (r_in, is_unit_ai_set) ||
+        ammo < 0 ||
+        is_unit_ai_set != isUnitAiSet())
+    {
+        return false;
+    }
+    if (isUnitAiSet() && !unitAi->readState(r_in))
+        return false;
+    
+    m_health          = health;
+    m_reload_timer    = reload_timer;
+    m_ammo            = ammo;
+    m_is_dead         = is_dead;
+    max_speed         = speed_max;
+    max_acceleration  = acceleration;
+    max_rotation_rate = rotation_rate;
+    desired_velocity  = velocity;
+    wantsToFire       = wants_to_fire;
+    
+    assert(invariant());
+    return true;
+}
+
 double Ship::getSpeedMax () const
 {
     return max_speed;
@@ -376,7 +462,7 @@ void Ship::runAi (const WorldInterface& world)
 {
     assert (isUnitAiSet());
     
-    unitAi->run(world);
+    unitAi->runAtLevelOfDetail(world);
 }
 
 void Ship::setUnitAi (UnitAiSuperclass* p_unit_ai)
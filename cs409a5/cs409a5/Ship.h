@@ -82,7 +82,7 @@ public:
     //    firing.
     //
     
-    static const float RELOAD_TIME;
+    static const double RELOAD_TIME;
     
 public:
     //
@@ -363,6 +363,44 @@ public:
     
     void updateForPause ();
     
+    //
+    //  getTurn
+    //
+    //  Purpose: To determine how this Ship will turn during its
+    //           next update.
+    //  Parameter(s):
+    //    <1> r_forward: Set to the direction to turn towards
+    //    <2> r_max_radians: Set to the most this Ship can turn
+    //  Precondition(s): N/A
+    //  Returns: Whether this Ship will turn.  If false is
+    //           returned, r_forward and r_max_radians are not
+    //           changed.
+    //  Side Effect: N/A
+    //
+    
+    bool getTurn (Vector3& r_forward, double& r_max_radians) const;
+    
+    //
+    //  updateAfterTurning
+    //
+    //  Purpose: To do everything update does except turning this
+    //           Ship.  This allows many Ships to be turned together
+    //           with rotateTowardsBatch using the values from
+    //           getTurn, before any of them are updated.
+    //  Parameter(s):
+    //    <1> r_world: An interface to the world this Ship is in
+    //  Precondition(s):
+    //    <1> This Ship has already been turned as getTurn
+    //        specifies for this frame
+    //  Returns: N/A
+    //  Side Effect: This Ship is updated for one frame, except
+    //               that it is not turned.  Any queries about or
+    //               changes to the world it is in are resolved
+    //               through r_world.
+    //
+    
+    void updateAfterTurning (WorldInterface& r_world);
+    
     ///////////////////////////////////////////////////////////////
     //
     //  Virtual functions inherited from PhysicsObject
@@ -461,6 +499,45 @@ public:
     
     virtual void update (WorldInterface& r_world);
     
+    //
+    //  writeState
+    //
+    //  Purpose: To write the state of this Ship to the specified
+    //           binary stream.
+    //  Parameter(s):
+    //    <1> r_out: The stream to write to
+    //  Precondition(s):
+    //    <1> r_out was opened in binary mode
+    //  Returns: N/A
+    //  Side Effect: The PhysicsObject state of this Ship is
+    //               written to r_out, followed by its health,
+    //               ammunition, reload timer, maneuverability,
+    //               desired velocity, whether it wants to fire,
+    //               and the state of its unit AI, if it has one.
+    //
+    
+    virtual void writeState (std::ostream& r_out) const;
+    
+    //
+    //  readState
+    //
+    //  Purpose: To set this Ship to the state read from the
+    //           specified binary stream.
+    //  Parameter(s):
+    //    <1> r_in: The stream to read from
+    //  Precondition(s):
+    //    <1> r_in was opened in binary mode
+    //  Returns: Whether a valid state was read.
+    //  Side Effect: A state written by writeState is read from
+    //               r_in.  If it is valid, this Ship and its unit
+    //               AI are set to have that state.  A state
+    //               written by a Ship with a unit AI is only
+    //               valid for a Ship with the same kind of unit
+    //               AI.
+    //
+    
+    virtual bool readState (std::istream& r_in);
+    
     //
     //  getSpeedMax
     //
@@ -695,7 +772,7 @@ private:
     
 private:
     float m_health;
-    float m_reload_timer;
+    double m_reload_timer;
     int m_ammo;
     bool m_is_dead;
     float max_speed;
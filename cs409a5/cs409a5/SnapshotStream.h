@@ -0,0 +1,308 @@
+//
+//  SnapshotStream.h
+//
+//  Helper functions to read and write the values in a binary
+//    snapshot of the world state.
+//
+
+#ifndef SNAPSHOT_STREAM_H
+#define SNAPSHOT_STREAM_H
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "../../ObjLibrary/Vector3.h"
+
+#include "PhysicsObjectId.h"
+#include "NearbyShipData.h"
+#include "RingParticleData.h"
+
+
+
+//
+//  SnapshotStream
+//
+//  A namespace for the functions to read and write the values
+//    in a snapshot.  Values are stored as their raw bytes in
+//    the native byte order, so a snapshot can only be read by
+//    a program built for the same platform.  This is enough to
+//    save a state and replay it on the same machine, and
+//    comparing two snapshots byte-for-byte shows whether two
+//    runs reached exactly the same state.
+//
+//  These functions can only be used with streams opened in
+//    binary mode and with types that can be safely copied
+//    with memcpy.
+//
+
+namespace SnapshotStream
+{
+//
+//  writeValue
+//
+//  Purpose: To write the specified value to the specified
+//           stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//    <2> value: The value to write
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The bytes of value are written to r_out.
+//
+
+	template <typename T>
+	inline void writeValue (std::ostream& r_out, const T& value)
+	{
+		r_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+//
+//  writeVector3
+//
+//  Purpose: To write the specified Vector3 to the specified
+//           stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//    <2> vector: The Vector3 to write
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The components of vector are written to r_out.
+//
+
+	inline void writeVector3 (std::ostream& r_out, const Vector3& vector)
+	{
+		writeValue(r_out, vector.x);
+		writeValue(r_out, vector.y);
+		writeValue(r_out, vector.z);
+	}
+
+//
+//  readValue
+//
+//  Purpose: To read a value from the specified stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//    <2> r_value: The variable to store the value in
+//  Precondition(s): N/A
+//  Returns: Whether the value was read successfully.
+//  Side Effect: sizeof(T) bytes are read from r_in and, if they
+//               are all read, stored in r_value.
+//
+
+	template <typename T>
+	inline bool readValue (std::istream& r_in, T& r_value)
+	{
+		T value;
+		if(!r_in.read(reinterpret_cast<char*>(&value), sizeof(T)))
+			return false;
+		r_value = value;
+		return true;
+	}
+
+//
+//  readVector3
+//
+//  Purpose: To read a Vector3 from the specified stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//    <2> r_vector: The variable to store the Vector3 in
+//  Precondition(s): N/A
+//  Returns: Whether the Vector3 was read successfully.
+//  Side Effect: The components of a Vector3 are read from r_in
+//               and, if they are all read, stored in r_vector.
+//
+
+	inline bool readVector3 (std::istream& r_in, Vector3& r_vector)
+	{
+		Vector3 vector;
+		if(!readValue(r_in, vector.x) ||
+		   !readValue(r_in, vector.y) ||
+		   !readValue(r_in, vector.z))
+		{
+			return false;
+		}
+		r_vector = vector;
+		return true;
+	}
+
+//
+//  writeId
+//
+//  Purpose: To write the specified PhysicsObjectId to the
+//           specified stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//    <2> id: The PhysicsObjectId to write
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The fields of id are written to r_out one at a
+//               time, so that no padding bytes are written.
+//
+
+	inline void writeId (std::ostream& r_out, const PhysicsObjectId& id)
+	{
+		writeValue(r_out, id.m_type);
+		writeValue(r_out, id.m_fleet);
+		writeValue(r_out, id.m_index);
+	}
+
+//
+//  readId
+//
+//  Purpose: To read a PhysicsObjectId from the specified
+//           stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//    <2> r_id: The variable to store the PhysicsObjectId in
+//  Precondition(s): N/A
+//  Returns: Whether the PhysicsObjectId was read successfully.
+//  Side Effect: The fields of a PhysicsObjectId are read from
+//               r_in and, if they are all read, stored in r_id.
+//
+
+	inline bool readId (std::istream& r_in, PhysicsObjectId& r_id)
+	{
+		PhysicsObjectId id;
+		if(!readValue(r_in, id.m_type)  ||
+		   !readValue(r_in, id.m_fleet) ||
+		   !readValue(r_in, id.m_index))
+		{
+			return false;
+		}
+		r_id = id;
+		return true;
+	}
+
+//
+//  writeNearbyShips
+//
+//  Purpose: To write the specified list of NearbyShipData to
+//           the specified stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//    <2> ships: The list to write
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The length of ships is written to r_out,
+//               followed by the fields of each element.
+//
+
+	inline void writeNearbyShips (std::ostream& r_out,
+	                              const std::vector<NearbyShipData>& ships)
+	{
+		writeValue(r_out, (unsigned int)(ships.size()));
+		for(unsigned int i = 0; i < ships.size(); i++)
+		{
+			writeId     (r_out, ships[i].m_id);
+			writeVector3(r_out, ships[i].m_position);
+			writeValue  (r_out, ships[i].m_distance_squared);
+		}
+	}
+
+//
+//  readNearbyShips
+//
+//  Purpose: To read a list of NearbyShipData from the
+//           specified stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//    <2> r_ships: The variable to store the list in
+//  Precondition(s): N/A
+//  Returns: Whether the list was read successfully.
+//  Side Effect: A list written by writeNearbyShips is read from
+//               r_in and, if it is all read, stored in r_ships.
+//
+
+	inline bool readNearbyShips (std::istream& r_in,
+	                             std::vector<NearbyShipData>& r_ships)
+	{
+		unsigned int count;
+		if(!readValue(r_in, count))
+			return false;
+
+		std::vector<NearbyShipData> ships;
+		for(unsigned int i = 0; i < count; i++)
+		{
+			NearbyShipData ship;
+			if(!readId     (r_in, ship.m_id)       ||
+			   !readVector3(r_in, ship.m_position) ||
+			   !readValue  (r_in, ship.m_distance_squared))
+			{
+				return false;
+			}
+			ships.push_back(ship);
+		}
+		r_ships.swap(ships);
+		return true;
+	}
+
+//
+//  writeRingParticles
+//
+//  Purpose: To write the specified list of RingParticleData to
+//           the specified stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//    <2> particles: The list to write
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The length of particles is written to r_out,
+//               followed by the fields of each element.
+//
+
+	inline void writeRingParticles (
+	                 std::ostream& r_out,
+	                 const std::vector<RingParticleData>& particles)
+	{
+		writeValue(r_out, (unsigned int)(particles.size()));
+		for(unsigned int i = 0; i < particles.size(); i++)
+		{
+			writeVector3(r_out, particles[i].m_position);
+			writeValue  (r_out, particles[i].m_radius);
+		}
+	}
+
+//
+//  readRingParticles
+//
+//  Purpose: To read a list of RingParticleData from the
+//           specified stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//    <2> r_particles: The variable to store the list in
+//  Precondition(s): N/A
+//  Returns: Whether the list was read successfully.
+//  Side Effect: A list written by writeRingParticles is read
+//               from r_in and, if it is all read, stored in
+//               r_particles.
+//
+
+	inline bool readRingParticles (
+	                 std::istream& r_in,
+	                 std::vector<RingParticleData>& r_particles)
+	{
+		unsigned int count;
+		if(!readValue(r_in, count))
+			return false;
+
+		std::vector<RingParticleData> particles;
+		for(unsigned int i = 0; i < count; i++)
+		{
+			RingParticleData particle;
+			if(!readVector3(r_in, particle.m_position) ||
+			   !readValue  (r_in, particle.m_radius))
+			{
+				return false;
+			}
+			particles.push_back(particle);
+		}
+		r_particles.swap(particles);
+		return true;
+	}
+
+}  // end of namespace SnapshotStream
+
+
+
+#endif
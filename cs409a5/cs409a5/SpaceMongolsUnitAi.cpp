@@ -3,6 +3,8 @@
 //
 
 #include <cassert>
+#include <istream>
+#include <ostream>
 
 #include "WorldInterface.h"
 #include "PhysicsObjectId.h"
@@ -11,17 +13,24 @@
 #include "Ship.h"
 #include "Bullet.h"
 #include "UnitAiSuperclass.h"
+#include "PseudorandomGenerator.h"
+#include "TimeSystem.h"
+#include "SnapshotStream.h"
 #include "SpaceMongolsUnitAi.h"
 
-#include <limits>
-
 using namespace SpaceMongols;
+namespace
+{
+    // the time of the first scan has not been chosen yet
+    const long long SCAN_TIME_NOT_SET = -1;
+}
 
 
 
 UnitAiMoonGuard :: UnitAiMoonGuard (const AiShipReference& ship,
                                     const WorldInterface& world,
-                                    const PhysicsObjectId& id_moon)
+                                    const PhysicsObjectId& id_moon,
+                                    unsigned long long random_seed)
 		: UnitAiSuperclass(ship)
 {
 	assert(ship.isShip());
@@ -29,9 +38,16 @@ UnitAiMoonGuard :: UnitAiMoonGuard (const AiShipReference& ship,
 	assert(world.isAlive(id_moon));
 	assert(world.isPlanetoidMoon(id_moon));
 
-    steeringBehaviour = new FleetName::SteeringBehaviour(ship.getId());
+    PseudorandomGenerator random(random_seed);
+    nextScanTime = SCAN_TIME_NOT_SET;
+    scanPhase = random.getNextIndex(SCAN_PHASE_COUNT);
+    steeringBehaviour = new FleetName::SteeringBehaviour(ship.getId(), random.getState());
     moon = id_moon;
-    scanCount = rand() % SCAN_COUNT_MAX;
+    randomSeed = random_seed;
+    thinkVelocity = Vector3::ZERO;
+    thinkMoonPosition = Vector3::ZERO;
+    thinkMoonDirection = Vector3::ZERO;
+    isScanRequested = false;
     
 }
 
@@ -41,9 +57,17 @@ UnitAiMoonGuard :: UnitAiMoonGuard (const UnitAiMoonGuard& original,
 {
 	assert(ship.isShip());
 
-    steeringBehaviour = new FleetName::SteeringBehaviour(ship.getId());
+    // a clone controls a different ship, so it gets its own seed
+    randomSeed = PseudorandomGenerator::calculateMixedSeed(original.randomSeed, ship.getId());
+    PseudorandomGenerator random(randomSeed);
+    nextScanTime = SCAN_TIME_NOT_SET;
+    scanPhase = random.getNextIndex(SCAN_PHASE_COUNT);
+    steeringBehaviour = new FleetName::SteeringBehaviour(ship.getId(), random.getState());
     moon = original.moon;
-    scanCount = rand() % SCAN_COUNT_MAX;
+    thinkVelocity = Vector3::ZERO;
+    thinkMoonPosition = Vector3::ZERO;
+    thinkMoonDirection = Vector3::ZERO;
+    isScanRequested = false;
 }
 
 UnitAiMoonGuard :: ~UnitAiMoonGuard ()
@@ -78,7 +102,25 @@ void UnitAiMoonGuard :: run (const WorldInterface& world)
 {
 	assert(world.isAlive(getShipId()));
 
-    scan(world);
+    long long now    = TimeSystem::getFrameStartTimeNanoseconds();
+    long long period = TimeSystem::toNanoseconds(SCAN_PERIOD);
+    if (nextScanTime == SCAN_TIME_NOT_SET)
+        nextScanTime = now + period * scanPhase / SCAN_PHASE_COUNT;
+    
+    // at reduced detail this only runs about once a second, so
+    //  always look around first
+    if (!isFullDetail() || now >= nextScanTime)
+    {
+        scan(world);
+        nextScanTime += period;
+        if (nextScanTime <= now) nextScanTime = now + period;
+    }
+    else if (!isScanRequested &&
+             now + TimeSystem::getFrameDurationNanoseconds() >= nextScanTime)
+    {
+        // the next run will scan, so ask for it to be ready
+        requestScan(world);
+    }
     
     Vector3 v = getShip().getVelocity();
     if (nearestEnemyShip != PhysicsObjectId::ID_NOTHING)
@@ -96,77 +138,207 @@ void UnitAiMoonGuard :: run (const WorldInterface& world)
                                             PLANETOID_AVOID_DISTANCE);
         //printf("Patrolling...\n");
     }
+    Vector3 v_unavoided = v;
     v = avoidShips(world, v);
     v = avoidRingParticles(world, v);
     
     getShipAi().setDesiredVelocity(v);
+    thinkVelocity = v;
+    thinkMoonPosition = world.getPosition(moon);
+    thinkMoonDirection = getShip().getPosition() - thinkMoonPosition;
+    if (!thinkMoonDirection.isZero()) thinkMoonDirection.normalize();
+    
+    // with nothing to chase or avoid, there is nothing to decide
+    //  until the next scan, and nothing is urgent enough that the
+    //  scan cannot be put off a little for busier ships
+    if (isFullDetail() &&
+        nearestEnemyShip == PhysicsObjectId::ID_NOTHING &&
+        v == v_unavoided)
+    {
+        double to_scan = TimeSystem::toSeconds(nextScanTime - now);
+        waitForBudget(to_scan, to_scan + SCAN_PERIOD);
+    }
+}
+
+void UnitAiMoonGuard :: writeState (std::ostream& r_out) const
+{
+    UnitAiSuperclass::writeState(r_out);
+    
+    steeringBehaviour->writeState(r_out);
+    SnapshotStream::writeId           (r_out, moon);
+    SnapshotStream::writeNearbyShips  (r_out, nearbyShips);
+    SnapshotStream::writeRingParticles(r_out, nearbyRingParticles);
+    SnapshotStream::writeId           (r_out, nearestPlanetoid);
+    SnapshotStream::writeId           (r_out, nearestShip);
+    SnapshotStream::writeId           (r_out, nearestEnemyShip);
+    SnapshotStream::writeValue        (r_out, nextScanTime);
+    SnapshotStream::writeValue        (r_out, scanPhase);
+    SnapshotStream::writeValue        (r_out, randomSeed);
+    SnapshotStream::writeVector3      (r_out, thinkVelocity);
+    SnapshotStream::writeVector3      (r_out, thinkMoonPosition);
+    SnapshotStream::writeVector3      (r_out, thinkMoonDirection);
+    SnapshotStream::writeValue        (r_out, isScanRequested);
+}
+
+bool UnitAiMoonGuard :: readState (std::istream& r_in)
+{
+    if (!UnitAiSuperclass::readState(r_in))
+        return false;
+    
+    FleetName::SteeringBehaviour steering(*steeringBehaviour);
+    PhysicsObjectId id_moon;
+    std::vector<NearbyShipData> ships;
+    std::vector<RingParticleData> ring_particles;
+    PhysicsObjectId nearest_planetoid;
+    PhysicsObjectId nearest_ship;
+    PhysicsObjectId nearest_enemy_ship;
+    long long next_scan_time;
+    unsigned int scan_phase;
+    unsigned long long random_seed;
+    Vector3 think_velocity;
+    Vector3 think_moon_position;
+    Vector3 think_moon_direction;
+    bool is_scan_requested;
+    
+    if (!steering.readState(r_in)                                       ||
+        !SnapshotStream::readId           (r_in, id_moon)               ||
+        !SnapshotStream::readNearbyShips  (r_in, ships)                 ||
+        !SnapshotStream::readRingParticles(r_in, ring_particles)        ||
+        !SnapshotStream::readId           (r_in, nearest_planetoid)     ||
+        !SnapshotStream::readId           (r_in, nearest_ship)          ||
+        !SnapshotStream::readId           (r_in, nearest_enemy_ship)    ||
+        !SnapshotStream::readValue        (r_in, next_scan_time)        ||
+        !SnapshotStream::readValue        (r_in, scan_phase)            ||
+        !SnapshotStream::readValue        (r_in, random_seed)           ||
+        !SnapshotStream::readVector3      (r_in, think_velocity)        ||
+        !SnapshotStream::readVector3      (r_in, think_moon_position)   ||
+        !SnapshotStream::readVector3      (r_in, think_moon_direction)  ||
+        !SnapshotStream::readValue        (r_in, is_scan_requested))
+    {
+        return false;
+    }
+    
+    if (id_moon.m_type != PhysicsObjectId::TYPE_PLANETOID ||
+        (next_scan_time < 0 && next_scan_time != SCAN_TIME_NOT_SET) ||
+        scan_phase >= SCAN_PHASE_COUNT)
+    {
+        return false;
+    }
+    
+    *steeringBehaviour = steering;
+    moon = id_moon;
+    nearbyShips.swap(ships);
+    nearbyRingParticles.swap(ring_particles);
+    nearestPlanetoid = nearest_planetoid;
+    nearestShip = nearest_ship;
+    nearestEnemyShip = nearest_enemy_ship;
+    nextScanTime = next_scan_time;
+    scanPhase = scan_phase;
+    randomSeed = random_seed;
+    thinkVelocity = think_velocity;
+    thinkMoonPosition = think_moon_position;
+    thinkMoonDirection = think_moon_direction;
+    isScanRequested = is_scan_requested;
+    return true;
 }
 
+void UnitAiMoonGuard::extrapolate(const WorldInterface& world)
+{
+    assert(world.isAlive(getShipId()));
+    
+    // the next run will scan, so ask for it to be ready
+    if (!isScanRequested && isRunDueNextFrame()) requestScan(world);
+    
+    // the patrol goes around the moon, so turn the old velocity
+    //  the same way the ship has gone around it
+    Vector3 to = getShip().getPosition() - thinkMoonPosition;
+    if (thinkMoonDirection.isZero() || to.isZero()) return;
+    to.normalize();
+    
+    // rotate by the angle between the directions around their
+    //  cross product, without needing any trigonometry
+    double cos_angle = thinkMoonDirection.dotProduct(to);
+    if (cos_angle <= -1.0 + 1.0e-6) return;
+    Vector3 axis = thinkMoonDirection.crossProduct(to);
+    Vector3 v = thinkVelocity * cos_angle +
+                axis.crossProduct(thinkVelocity) +
+                axis * (axis.dotProduct(thinkVelocity) / (1.0 + cos_angle));
+    getShipAi().setDesiredVelocity(v);
+}
+
+// The scan is requested the run before it is needed, so the
+//  world can answer it together with the scans of all the
+//  other ships.  If there was no run before, such as at
+//  reduced detail or after a wait, or the answer was not found
+//  this frame, the world is queried directly instead.
 void UnitAiMoonGuard::scan(const WorldInterface& world)
 {
-    scanCount++;
-    if (scanCount == SCAN_COUNT_MAX)
+    //printf("Scanning...\n");
+    bool is_answered = false;
+    if (isScanRequested && world.isPerceptionReady(getShipId()))
+    {
+        // hand the old lists back to be reused for the next
+        //  answer instead of copying the new ones
+        PerceptionData perception;
+        perception.mv_ships.swap(nearbyShips);
+        perception.mv_ring_particles.swap(nearbyRingParticles);
+        world.takePerception(getShipId(), perception);
+        nearbyShips.swap(perception.mv_ships);
+        nearbyRingParticles.swap(perception.mv_ring_particles);
+        nearestPlanetoid = perception.m_nearest_planetoid;
+        is_answered = (perception.m_frame_number == TimeSystem::getFrameNumber());
+    }
+    if (!is_answered)
     {
-        //printf("Scanning...\n");
         Vector3 ship_pos = getShip().getPosition();
-        
-        nearbyShips = world.getShipIds(ship_pos, SCAN_DISTANCE_SHIP);
-        getClosestShip(world);
-        getClosestEnemyShip(world);
+        world.getShipsInSphere(ship_pos, SCAN_DISTANCE_SHIP, nearbyShips);
         
         Vector3 position = ship_pos + (getShip().getForward() * 500.f);
         nearbyRingParticles = world.getRingParticles(position, SCAN_DISTANCE_RING_PARTICLE);
         
         nearestPlanetoid = world.getNearestPlanetoidId(ship_pos);
-        
-        scanCount = 0;
     }
+    isScanRequested = false;
+    getClosestShip();
+    getClosestEnemyShip();
 }
 
-void UnitAiMoonGuard::getClosestShip(const WorldInterface& world)
+void UnitAiMoonGuard::requestScan(const WorldInterface& world)
 {
-    PhysicsObjectId nearestShip;
     Vector3 ship_pos = getShip().getPosition();
-    
-    double min_distance = std::numeric_limits<double>::max();
+    Vector3 position = ship_pos + (getShip().getForward() * 500.f);
+    world.requestPerception(getShipId(),
+                            ship_pos,
+                            SCAN_DISTANCE_SHIP,
+                            position,
+                            SCAN_DISTANCE_RING_PARTICLE);
+    isScanRequested = true;
+}
+
+// nearbyShips is sorted nearest first, so the first match is
+//  the closest
+void UnitAiMoonGuard::getClosestShip()
+{
     nearestShip = PhysicsObjectId::ID_NOTHING;
-    for (int i = 0; i < nearbyShips.size(); i++)
+    for (unsigned int i = 0; i < nearbyShips.size(); i++)
     {
-        if (!world.isAlive(nearbyShips[i])) continue;
-        if (nearbyShips[i] == getShipId()) continue;
+        if (nearbyShips[i].m_id == getShipId()) continue;
         
-        double temp = ship_pos.getDistanceSquared(world.getPosition(nearbyShips[i]));
-        if (temp < min_distance)
-        {
-            min_distance = temp;
-            nearestShip = nearbyShips[i];
-        }
+        nearestShip = nearbyShips[i].m_id;
+        break;
     }
-    
-    this->nearestShip = nearestShip;
 }
 
-void UnitAiMoonGuard::getClosestEnemyShip(const WorldInterface& world)
+void UnitAiMoonGuard::getClosestEnemyShip()
 {
-    PhysicsObjectId nearestShip;
-    Vector3 ship_pos = getShip().getPosition();
-    
-    double min_distance = std::numeric_limits<double>::max();
-    nearestShip = PhysicsObjectId::ID_NOTHING;
-    for (int i = 0; i < nearbyShips.size(); i++)
+    nearestEnemyShip = PhysicsObjectId::ID_NOTHING;
+    for (unsigned int i = 0; i < nearbyShips.size(); i++)
     {
-        if (!world.isAlive(nearbyShips[i])) continue;
-        if (nearbyShips[i].m_fleet == getShipId().m_fleet) continue;
+        if (nearbyShips[i].m_id.m_fleet == getShipId().m_fleet) continue;
         
-        double temp = ship_pos.getDistanceSquared(world.getPosition(nearbyShips[i]));
-        if (temp < min_distance)
-        {
-            min_distance = temp;
-            nearestShip = nearbyShips[i];
-        }
+        nearestEnemyShip = nearbyShips[i].m_id;
+        break;
     }
-    
-    this->nearestEnemyShip = nearestShip;
 }
 
 void UnitAiMoonGuard::shootAtShip(const WorldInterface& world, const PhysicsObjectId& target)
@@ -5,6 +5,7 @@
 #ifndef SPACE_MONGOLS_UNIT_AI_H
 #define SPACE_MONGOLS_UNIT_AI_H
 
+#include <iosfwd>
 #include <vector>
 
 #include "PhysicsObjectId.h"
@@ -37,6 +38,13 @@ namespace SpaceMongols
     //    leaves the moon or is destroyed, the Ship will start
     //    flying around the moon again.
     //
+    //  The Ship looks around every SCAN_PERIOD seconds.  While
+    //    it is chasing an enemy or avoiding something, it is run
+    //    every frame in between to steer.  Otherwise, it has
+    //    nothing to decide until the next scan, so it waits for
+    //    it.  That scan can be put off by up to another
+    //    SCAN_PERIOD while the unit AIs are short of time.
+    //
     
     const double VERY_LARGE_ANGLE               = 1.0e6;
     
@@ -52,7 +60,8 @@ namespace SpaceMongols
     
     const double SHOOT_ANGLE_RADIANS_MAX        = 0.1;
     
-    const unsigned int SCAN_COUNT_MAX           = 5;
+    const double SCAN_PERIOD                    = 1.0 / 12.0;
+    const unsigned int SCAN_PHASE_COUNT         = 5;
 
     
     class UnitAiMoonGuard : public UnitAiSuperclass
@@ -60,12 +69,25 @@ namespace SpaceMongols
     private:
         FleetName::SteeringBehaviour* steeringBehaviour;
         PhysicsObjectId moon;
-        std::vector<PhysicsObjectId> nearbyShips;
+        std::vector<NearbyShipData> nearbyShips;
         std::vector<RingParticleData> nearbyRingParticles;
         PhysicsObjectId nearestPlanetoid;
         PhysicsObjectId nearestShip;
         PhysicsObjectId nearestEnemyShip;
-        int scanCount;
+        // when to scan next, and which part of SCAN_PERIOD the
+        //  first scan is in, so the ships do not all scan in the
+        //  same frame
+        long long nextScanTime;
+        unsigned int scanPhase;
+        unsigned long long randomSeed;
+        // what run last told the ship to do, where the moon was,
+        //  and which way the ship was from it, for extrapolate
+        Vector3 thinkVelocity;
+        Vector3 thinkMoonPosition;
+        Vector3 thinkMoonDirection;
+        // whether a scan has been requested from the world and
+        //  not used yet
+        bool isScanRequested;
         
     public:
         //
@@ -78,6 +100,8 @@ namespace SpaceMongols
         //    <1> ship: The Ship to be controlled
         //    <2> world: The World the Ship is in
         //    <3> id_moon: The moon to guard
+        //    <4> random_seed: The seed for the random choices made
+        //                     by the new UnitAiMoonGuard
         //  Precondition(s):
         //    <1> ship.isShip()
         //    <2> id_moon.m_type == PhysicsObjectId::TYPE_PLANETOID
@@ -86,12 +110,16 @@ namespace SpaceMongols
         //  Returns: N/A
         //  Side Effect: A new UnitAiMoonGuard is created to control
         //               Ship ship as it guards the moon with id
-        //               id_moon in World world.
+        //               id_moon in World world.  Two
+        //               UnitAiMoonGuards created with the same
+        //               seed make the same choices in the same
+        //               situations.
         //
         
         UnitAiMoonGuard (const AiShipReference& ship,
                          const WorldInterface& world,
-                         const PhysicsObjectId& id_moon);
+                         const PhysicsObjectId& id_moon,
+                         unsigned long long random_seed);
         
         //
         //  Modified Copy Constructor
@@ -207,10 +235,65 @@ namespace SpaceMongols
         
         virtual void run (const WorldInterface& world);
         
+        //
+        //  writeState
+        //
+        //  Purpose: To write the state of this UnitAiMoonGuard to the
+        //           specified binary stream.
+        //  Parameter(s):
+        //    <1> r_out: The stream to write to
+        //  Precondition(s):
+        //    <1> r_out was opened in binary mode
+        //  Returns: N/A
+        //  Side Effect: The UnitAiSuperclass state is written to
+        //               r_out, followed by the steering behaviour,
+        //               the moon, the results of the last scan, the
+        //               scan timing, and what the last run decided.
+        //
+        
+        virtual void writeState (std::ostream& r_out) const;
+        
+        //
+        //  readState
+        //
+        //  Purpose: To set this UnitAiMoonGuard to the state read from
+        //           the specified binary stream.
+        //  Parameter(s):
+        //    <1> r_in: The stream to read from
+        //  Precondition(s):
+        //    <1> r_in was opened in binary mode
+        //  Returns: Whether a valid state was read.
+        //  Side Effect: A state written by writeState is read from
+        //               r_in.  If it is valid, this UnitAiMoonGuard is
+        //               set to have that state.
+        //
+        
+        virtual bool readState (std::istream& r_in);
+        
+    protected:
+        //
+        //  extrapolate
+        //
+        //  Purpose: To keep the controlled Ship patrolling between
+        //           runs at reduced detail.
+        //  Parameter(s):
+        //    <1> world: The World that the Ship is in
+        //  Precondition(s):
+        //    <1> world.isAlive(getShipId())
+        //  Returns: N/A
+        //  Side Effect: The desired velocity from the last run is
+        //               rotated around where the moon was by as far
+        //               as the Ship has moved around it since then,
+        //               and set as the desired velocity for the Ship.
+        //
+        
+        virtual void extrapolate (const WorldInterface& world);
+        
     private:
         void scan (const WorldInterface& world);
-        void getClosestShip(const WorldInterface& world);
-        void getClosestEnemyShip(const WorldInterface& world);
+        void requestScan (const WorldInterface& world);
+        void getClosestShip();
+        void getClosestEnemyShip();
         void shootAtShip(const WorldInterface& world,
                          const PhysicsObjectId& target);
         Vector3 chargeAtTarget(const WorldInterface& world,
@@ -0,0 +1,167 @@
+//
+//  ThreadPool.cpp
+//
+
+#include <cassert>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+
+ThreadPool :: ThreadPool ()
+		: mv_workers(),
+		  m_mutex(),
+		  m_batch_started(),
+		  m_batch_finished(),
+		  mp_task(NULL),
+		  m_task_count(0),
+		  m_next_task(0),
+		  m_active_worker_count(0),
+		  m_batch_number(0),
+		  m_is_stopping(false)
+{
+	unsigned int hardware_count = thread::hardware_concurrency();
+	if(hardware_count > 1)
+		startWorkers(hardware_count - 1);
+
+	assert(invariant());
+}
+
+ThreadPool :: ThreadPool (unsigned int worker_count)
+		: mv_workers(),
+		  m_mutex(),
+		  m_batch_started(),
+		  m_batch_finished(),
+		  mp_task(NULL),
+		  m_task_count(0),
+		  m_next_task(0),
+		  m_active_worker_count(0),
+		  m_batch_number(0),
+		  m_is_stopping(false)
+{
+	startWorkers(worker_count);
+
+	assert(invariant());
+}
+
+ThreadPool :: ~ThreadPool ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_batch_started.notify_all();
+
+	for(unsigned int i = 0; i < mv_workers.size(); i++)
+		mv_workers[i].join();
+}
+
+
+
+unsigned int ThreadPool :: getWorkerCount () const
+{
+	return (unsigned int)(mv_workers.size());
+}
+
+
+
+void ThreadPool :: runParallel (unsigned int task_count, const Task& task)
+{
+	assert(mp_task == NULL);
+
+	if(task_count == 0)
+		return;
+
+	if(mv_workers.empty() || task_count == 1)
+	{
+		for(unsigned int i = 0; i < task_count; i++)
+			task(i);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		mp_task               = &task;
+		m_task_count          = task_count;
+		m_next_task           = 0;
+		m_active_worker_count = (unsigned int)(mv_workers.size());
+		m_batch_number++;
+	}
+	m_batch_started.notify_all();
+
+	runTasks();
+
+	unique_lock<mutex> lock(m_mutex);
+	while(m_active_worker_count > 0)
+		m_batch_finished.wait(lock);
+	mp_task = NULL;
+
+	assert(invariant());
+}
+
+
+
+void ThreadPool :: startWorkers (unsigned int worker_count)
+{
+	assert(mv_workers.empty());
+
+	mv_workers.reserve(worker_count);
+	for(unsigned int i = 0; i < worker_count; i++)
+		mv_workers.push_back(thread(&ThreadPool::runWorker, this));
+}
+
+void ThreadPool :: runWorker ()
+{
+	unsigned int last_batch_number = 0;
+
+	while(true)
+	{
+		{
+			unique_lock<mutex> lock(m_mutex);
+			while(!m_is_stopping && m_batch_number == last_batch_number)
+				m_batch_started.wait(lock);
+			if(m_is_stopping)
+				return;
+			last_batch_number = m_batch_number;
+		}
+
+		runTasks();
+
+		bool is_last;
+		{
+			lock_guard<mutex> lock(m_mutex);
+			assert(m_active_worker_count > 0);
+			m_active_worker_count--;
+			is_last = (m_active_worker_count == 0);
+		}
+		if(is_last)
+			m_batch_finished.notify_one();
+	}
+}
+
+void ThreadPool :: runTasks ()
+{
+	assert(mp_task != NULL);
+
+	while(true)
+	{
+		unsigned int index = m_next_task.fetch_add(1);
+		if(index >= m_task_count)
+			return;
+		(*mp_task)(index);
+	}
+}
+
+bool ThreadPool :: invariant () const
+{
+	if(m_active_worker_count > mv_workers.size()) return false;
+	return true;
+}
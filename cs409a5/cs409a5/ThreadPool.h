@@ -0,0 +1,213 @@
+//
+//  ThreadPool.h
+//
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+//
+//  ThreadPool
+//
+//  A class to run many independent tasks at once using a fixed
+//    set of worker threads.  The worker threads are created
+//    with the ThreadPool and wait between batches of tasks, so
+//    starting a batch does not create any threads.
+//
+//  A batch of tasks is identified by a task function and a
+//    number of tasks.  The task function is called once with
+//    each index from 0 to the number of tasks minus 1, in no
+//    particular order.  The thread that starts the batch also
+//    runs tasks, and it does not return until every task has
+//    finished.  Idle threads take the next unstarted task, so
+//    slow tasks do not hold up the others.
+//
+//  A ThreadPool with no worker threads runs every task on the
+//    calling thread in increasing order.
+//
+//  Class Invariant:
+//    <1> m_active_worker_count <= mv_workers.size()
+//
+
+class ThreadPool
+{
+public:
+//
+//  Task
+//
+//  The type of function run for each task.  The parameter is
+//    the index of the task.
+//
+
+	typedef std::function<void (unsigned int)> Task;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a ThreadPool with one worker thread for
+//           each hardware thread other than the calling one.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ThreadPool is created.  If the number of
+//               hardware threads cannot be determined, it has
+//               no worker threads.
+//
+
+	ThreadPool ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a ThreadPool with the specified number of
+//           worker threads.
+//  Parameter(s):
+//    <1> worker_count: The number of worker threads
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new ThreadPool is created with worker_count
+//               worker threads.
+//
+
+	ThreadPool (unsigned int worker_count);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy a ThreadPool without memory
+//           leaks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All worker threads are stopped and joined.
+//
+
+	~ThreadPool ();
+
+//
+//  getWorkerCount
+//
+//  Purpose: To determine the number of worker threads in this
+//           ThreadPool.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of worker threads.  This does not count
+//           the thread that starts a batch of tasks.
+//  Side Effect: N/A
+//
+
+	unsigned int getWorkerCount () const;
+
+//
+//  runParallel
+//
+//  Purpose: To run a batch of tasks using this ThreadPool.
+//  Parameter(s):
+//    <1> task_count: The number of tasks
+//    <2> task: The function to run for each task
+//  Precondition(s):
+//    <1> runParallel is not already running on this ThreadPool
+//    <2> task does not call runParallel on this ThreadPool
+//  Returns: N/A
+//  Side Effect: task is called once for each index from 0 to
+//               task_count - 1, possibly on several threads at
+//               once.  This function does not return until all
+//               the calls have returned.
+//
+
+	void runParallel (unsigned int task_count, const Task& task);
+
+private:
+//
+//  startWorkers
+//
+//  Purpose: To create the worker threads for this ThreadPool.
+//  Parameter(s):
+//    <1> worker_count: The number of worker threads
+//  Precondition(s):
+//    <1> mv_workers.empty()
+//  Returns: N/A
+//  Side Effect: worker_count worker threads are started.  They
+//               wait for a batch of tasks.
+//
+
+	void startWorkers (unsigned int worker_count);
+
+//
+//  runWorker
+//
+//  Purpose: To run the main loop for a worker thread.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The calling thread waits for each batch of
+//               tasks and helps run it.  This function returns
+//               when this ThreadPool is destroyed.
+//
+
+	void runWorker ();
+
+//
+//  runTasks
+//
+//  Purpose: To run unstarted tasks from the current batch until
+//           none remain.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> mp_task != NULL
+//  Returns: N/A
+//  Side Effect: Tasks from the current batch are run on the
+//               calling thread.
+//
+
+	void runTasks ();
+
+//
+//  invariant
+//
+//  Purpose: To determine if the class invariant is true.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+
+	bool invariant () const;
+
+//
+//  Copy Constructor
+//  Assignment Operator
+//
+//  These functions have intentionally not been implemented.
+//    Threads cannot be copied.
+//
+
+	ThreadPool (const ThreadPool& original);
+	ThreadPool& operator= (const ThreadPool& original);
+
+private:
+	std::vector<std::thread> mv_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_batch_started;
+	std::condition_variable m_batch_finished;
+
+	const Task* mp_task;
+	unsigned int m_task_count;
+	std::atomic<unsigned int> m_next_task;
+	unsigned int m_active_worker_count;
+	unsigned int m_batch_number;
+	bool m_is_stopping;
+};
+
+
+
+#endif
@@ -2,8 +2,14 @@
 //  World.cpp
 //
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <vector>
 
 #include "GetGlut.h"
 #include "../../ObjLibrary/ObjModel.h"
@@ -16,20 +22,61 @@
 #include "WorldInterface.h"
 #include "World.h"
 #include "SpaceMongolsUnitAi.h"
+#include "PseudorandomGenerator.h"
+#include "SnapshotStream.h"
+#include "TimeSystem.h"
+#include "GeometricCollisionsSwept.h"
 
 using namespace std;
+namespace
+{
+    // "A5SN" when read as bytes on a little-endian machine
+    const unsigned int SNAPSHOT_MAGIC   = 0x4e533541;
+    const unsigned int SNAPSHOT_VERSION = 8;
+    
+    //
+    //  getPooledObject
+    //
+    //  Purpose: To find the object with the specified id in an
+    //           array of objects managed by a ProjectilePool.
+    //  Returns: A pointer to the object, or NULL if there is no
+    //           current object with that id.
+    //
+    
+    template <typename T>
+    const T* getPooledObject(const ProjectilePool& pool,
+                             const vector<T>& objects,
+                             const PhysicsObjectId& id)
+    {
+        if (!pool.isCurrent(id.m_index)) return NULL;
+        
+        const T& object = objects[pool.getSlot(id.m_index)];
+        if (object.getId() != id) return NULL;
+        return &object;
+    }
+}
 
 
 
 World :: World ()
 		: mp_explosion_manager(new ExplosionManager())
 {
+    initObjectTable();
+    fleet_registry.init(FLEET_COUNT);
+    ai_scheduler.init(SHIP_COUNT, thread_pool.getWorkerCount() + 1);
+    perception_service.init(SHIP_COUNT + 1);
+
 	assert(invariant());
 }
 
 World :: World (const World& original)
 		: mp_explosion_manager(original.mp_explosion_manager->getClone())
 {
+    initObjectTable();
+    fleet_registry.init(FLEET_COUNT);
+    ai_scheduler.init(SHIP_COUNT, thread_pool.getWorkerCount() + 1);
+    perception_service.init(SHIP_COUNT + 1);
+
 	assert(invariant());
 }
 
@@ -55,14 +102,28 @@ World& World :: operator= (const World& original)
 
 bool World :: isInitialized () const
 {
+	if(is_headless)
+		return true;
+
 	assert(mp_explosion_manager != NULL);
 	return mp_explosion_manager->isInitialized();
 }
 
+bool World :: isHeadless () const
+{
+	return is_headless;
+}
+
+const World::UpdateTimes& World :: getLastUpdateTimes () const
+{
+	return last_update_times;
+}
+
 void World :: draw (const Vector3& camera_forward,
                               const Vector3& camera_up) const
 {
 	assert(isInitialized());
+	assert(!isHeadless());
 	assert(camera_forward.isNormal());
 	assert(camera_up.isNormal());
 	assert(camera_forward.isOrthogonal(camera_up));
@@ -89,10 +150,16 @@ void World :: draw (const Vector3& camera_forward,
     {
         if (ships[i].isAlive()) ships[i].draw();
     }
-    // Draw bullets
-    for (int i = 0; i < BULLET_COUNT; i++)
+    // Draw bullets and missiles
+    for (unsigned int i = 0; i < bullet_pool.getLiveCount(); i++)
     {
-        if (bullets[i].isAlive()) bullets[i].draw();
+        const Bullet& bullet = bullets[bullet_pool.getLiveSlot(i)];
+        if (bullet.isAlive()) bullet.draw();
+    }
+    for (unsigned int i = 0; i < missile_pool.getLiveCount(); i++)
+    {
+        const Missile& missile = missiles[missile_pool.getLiveSlot(i)];
+        if (missile.isAlive()) missile.draw();
     }
     
     // Draw ring
@@ -122,92 +189,8 @@ void World :: init ()
 {
 	if(!isInitialized())
 	{
-        // Skybox Init
-        ObjModel sb;
-        sb.load("Models/Skybox.obj");
-        skybox = sb.getDisplayList();
-        
-        // Planet Init
-        ObjModel p;
-        p.load(planetInfo.filename);
-        planet_dl = p.getDisplayList();
-        PhysicsObjectId p_id = PhysicsObjectId(PhysicsObjectId::TYPE_PLANETOID,
-                                             PhysicsObjectId::FLEET_NATURE,
-                                             0);
-        planet.initPlanetoid(p_id, planetInfo.position, planetInfo.radius, planet_dl, planetInfo.radius);
-        
-        // Moon Init
-        for (int i = 0; i < MOON_COUNT; i++)
-        {
-            ObjModel m;
-            m.load(moonInfo[i].filename);
-            moon_dl[i] = m.getDisplayList();
-            PhysicsObjectId m_id = PhysicsObjectId(PhysicsObjectId::TYPE_PLANETOID,
-                                                   PhysicsObjectId::FLEET_NATURE,
-                                                   i + 1);
-            moons[i].initPlanetoid(m_id, moonInfo[i].position, moonInfo[i].radius, moon_dl[i], moonInfo[i].radius);
-         }
-        
-        // Ring init
-        RingParticle::load();
-        g_rings.init(RING_HALF_THICKNESS,
-                     RING_INNER_RADIUS,
-                     RING_OUTER_RADIUS_BASE,
-                     RING_DENSITY_MAX,
-                     RING_DENSITY_FACTOR);
-        
-        for(unsigned int i = 0; i < MOON_COUNT; i++)
-        {
-            g_rings.addHole(moons[i].getPosition(),
-                            moons[i].getRadius() + RING_MOON_PADDING);
-        }
-        ObjModel r;
-        r.load("Models/Ring.obj");
-        ring_dl = r.getDisplayList();
-        
-        // Ship Init
-        ObjModel s;
-        s.load("Models/Grapple.obj");
-        ship_dl = s.getDisplayList();
-        for (int i = 0; i < SHIP_COUNT; i++)
-        {
-            PhysicsObjectId s_id = PhysicsObjectId(PhysicsObjectId::TYPE_SHIP,
-                                                   PhysicsObjectId::FLEET_ENEMY,
-                                                   i);
-            
-            int moonIndex = rand() % MOON_COUNT;
-            Vector3 pos = moonInfo[moonIndex].position
-                            + Vector3::getRandomUnitVector()
-                            * (moonInfo[moonIndex].radius + 500.0);
-            
-            ships[i].initPhysics(s_id, pos, 10.f, Vector3::getRandomUnitVector(), ship_dl, 10.f);
-            ships[i].setUnitAi(new SpaceMongols::UnitAiMoonGuard(ships[i],
-                                                                 *this,
-                                                                 moons[moonIndex].getId()));
-            ships[i].setHealth(1);
-            ships[i].setAmmo(0);
-            ships[i].setSpeed(250.f);
-            ships[i].setManeuverability(250.0f, 250.0f, 0.33 * M_PI);
-        }
-        
-        // Player Ship Init
-        PhysicsObjectId ps_id = PhysicsObjectId(PhysicsObjectId::TYPE_SHIP,
-                                                PhysicsObjectId::FLEET_PLAYER,
-                                                0);
-        Vector3 pos = moons[0].getPosition() + Vector3(0.f, 15000.f, 0.f);
-        player_ship.initPhysics(ps_id, pos, 10.f, Vector3::getRandomUnitVector(), ship_dl, 10.f);
-        player_ship.setHealth(10);
-        player_ship.setAmmo(8);
-        player_ship.setSpeed(250.f);
-        
-        //Bullet init
-        ObjModel b;
-        b.load("Models/Bolt.obj");
-        bullet_dl = b.getDisplayList();
-        for (int i = 0; i < BULLET_COUNT; i++)
-        {
-            bullets[i].initPhysics(PhysicsObjectId::TYPE_BULLET, {0, 0, 0}, 10.f, {0, 0, 0}, bullet_dl, 10.f);
-        }
+        loadModels();
+        initObjects();
 
 		assert(mp_explosion_manager != NULL);
 		mp_explosion_manager->init(EXPLOSION_FILENAME.c_str(), 15);
@@ -216,6 +199,17 @@ void World :: init ()
 	assert(invariant());
 }
 
+void World :: initHeadless ()
+{
+	if(!isInitialized())
+	{
+        is_headless = true;
+        initObjects();
+	}
+
+	assert(invariant());
+}
+
 void World :: reset ()
 {
 	assert(isInitialized());
@@ -230,155 +224,785 @@ void World :: updateAll ()
 {
 	assert(isInitialized());
     
+    chrono::steady_clock::time_point start_time = chrono::steady_clock::now();
+    
+    bool is_player_alive = player_ship.isAlive();
     player_ship.update(*this);
-    Vector3 position = player_ship.getPosition() + (player_ship.getForward() * 500.f);
+    if (is_player_alive && !player_ship.isAlive()) fleet_registry.markShipDead(player_ship.getId());
+    updateNearbyShipGrid();
     
-    vector<PhysicsObjectId> ship_list = getShipIds(player_ship.getPosition(), 10000.0);
+    // Nothing moves while the AIs run, so they all see the same
+    //  world.  Each AI only writes the desired velocity and fire
+    //  flag of its own ship, which are not applied until the
+    //  ships are updated below in index order.
+    //
+    //  Only the AIs in the window planned by ai_scheduler run.
+    //    The size of the window was decided before this frame
+    //    started, so which AIs run does not depend on how long
+    //    they take now, and a replay can run the same ones.
+    //    An AI that is waiting for a time, or that is at
+    //    reduced detail between extrapolations, is put to
+    //    sleep in ai_scheduler and skipped until then.  An
+    //    AI that is waiting for budget is also held back by
+    //    ai_scheduler until a frame that runs every AI.
+    //
+    //  The perception requests made by AIs since the last frame
+    //    are answered together first, so that AIs scanning the
+    //    same area share the spatial queries.
+    //
+    const WorldInterface& world = *this;
+    bool is_ai_budget_limited = (ai_scheduler.getBudget() != AiScheduler::BUDGET_UNLIMITED);
+    chrono::steady_clock::time_point ai_start_time = chrono::steady_clock::now();
+    if (is_ai_budget_limited)
+        TimeSystem::markAiStart(TimeSystem::toSeconds(ai_scheduler.getBudget()));
+    perception_service.answerAll(world, g_rings, TimeSystem::getFrameNumber());
+    thread_pool.runParallel(ai_scheduler.getRunSlotCount(), [this, &world] (unsigned int i)
+    {
+        unsigned int slot = ai_scheduler.getRunSlot(i);
+        if (ships[slot].isAlive())
+        {
+            long long run_start = TimeSystem::getCurrentTimeNanoseconds();
+            ships[slot].runAi(world);
+            ai_scheduler.recordCost(slot, TimeSystem::getCurrentTimeNanoseconds() - run_start);
+            
+            const UnitAiSuperclass& unit_ai = ships[slot].getUnitAi();
+            if (unit_ai.isSleeping())
+                ai_scheduler.setWakeTime(slot, unit_ai.getSleepEndTime());
+            if (unit_ai.isWaitingForBudget())
+                ai_scheduler.setBudgetWaitEnd(slot, unit_ai.getBudgetWaitEndTime());
+            else
+                ai_scheduler.setBudgetWaitEnd(slot, AiScheduler::WAKE_NONE);
+        }
+        else
+        {
+            ai_scheduler.clearCost(slot);
+            ai_scheduler.setBudgetWaitEnd(slot, AiScheduler::WAKE_NONE);
+        }
+    });
+    long long ai_overshoot = 0;
+    if (is_ai_budget_limited)
+        ai_overshoot = TimeSystem::toNanoseconds(TimeSystem::getAiTimeOvershot());
+    ai_scheduler.endFrame(ai_overshoot,
+                          TimeSystem::getFrameStartTimeNanoseconds() +
+                          TimeSystem::getFrameDurationNanoseconds());
+    chrono::steady_clock::time_point ai_end_time = chrono::steady_clock::now();
+    
+    // Each ship, bullet, and missile moves itself during its own
+    //  update.  Copying their positions into separate arrays to
+    //  move them all at once was measured to be slower, because
+    //  the copying costs more than the moves it would batch.
+    //
+    //  The ships are all turned together first, though.  No
+    //    ship's update depends on how any other ship is facing,
+    //    so this gives the same result as turning each at the
+    //    start of its own update.
+    turn_objects.clear();
+    turn_forwards.clear();
+    turn_max_radians.clear();
     for (int i = 0; i < SHIP_COUNT; i++)
     {
         if (!ships[i].isAlive()) continue;
         
-        ships[i].runAi(*this);
-        ships[i].update(*this);
+        Vector3 forward;
+        double max_radians;
+        if (ships[i].getTurn(forward, max_radians))
+        {
+            turn_objects.push_back(&ships[i]);
+            turn_forwards.push_back(forward);
+            turn_max_radians.push_back(max_radians);
+        }
+    }
+    if (!turn_objects.empty())
+    {
+        PhysicsObject::rotateTowardsBatch(&turn_objects[0],
+                                          &turn_forwards[0],
+                                          &turn_max_radians[0],
+                                          (unsigned int)(turn_objects.size()));
+    }
+    
+    for (int i = 0; i < SHIP_COUNT; i++)
+    {
+        if (!ships[i].isAlive()) continue;
+        
+        ships[i].updateAfterTurning(*this);
+        if (!ships[i].isAlive())
+            fleet_registry.markShipDead(ships[i].getId());
+    }
+    updateNearbyShipGrid();
+    
+    for (unsigned int i = 0; i < bullet_pool.getLiveCount(); i++)
+    {
+        bullets[bullet_pool.getLiveSlot(i)].update(*this);
     }
     
-    for (int i = 0; i < BULLET_COUNT; i++)
+    for (unsigned int i = 0; i < missile_pool.getLiveCount(); i++)
     {
-        bullets[i].update(*this);
+        missiles[missile_pool.getLiveSlot(i)].update(*this);
     }
+    removeDeadProjectiles();
+    chrono::steady_clock::time_point collision_start_time = chrono::steady_clock::now();
     
     handleCollisions();
+    chrono::steady_clock::time_point explosion_start_time = chrono::steady_clock::now();
 
 	assert(mp_explosion_manager != NULL);
 	mp_explosion_manager->update();
+    chrono::steady_clock::time_point end_time = chrono::steady_clock::now();
+    
+    last_update_times.m_ai         = chrono::duration<double>(ai_end_time - ai_start_time).count();
+    last_update_times.m_movement   = chrono::duration<double>((ai_start_time - start_time) +
+                                                              (collision_start_time - ai_end_time)).count();
+    last_update_times.m_collisions = chrono::duration<double>(explosion_start_time - collision_start_time).count();
+    last_update_times.m_explosions = chrono::duration<double>(end_time - explosion_start_time).count();
 
 	assert(invariant());
 }
 
+unsigned long long World :: getRandomSeed () const
+{
+	return random_seed;
+}
+
+void World :: setRandomSeed (unsigned long long seed)
+{
+	assert(!isInitialized());
+
+	random_seed = seed;
+}
+
+void World :: setAiBudget (double seconds)
+{
+	assert(seconds > 0.0);
+
+	long long budget = TimeSystem::toNanoseconds(seconds);
+	if (budget < 1)
+		budget = 1;
+	ai_scheduler.setBudget(budget);
+}
+
+void World :: setAiBudgetUnlimited ()
+{
+	ai_scheduler.setBudget(AiScheduler::BUDGET_UNLIMITED);
+}
+
+void World :: setRingDensityVolumeEnabled (bool is_enabled)
+{
+	assert(isInitialized());
+
+	g_rings.setDensityVolumeEnabled(is_enabled);
+
+	assert(invariant());
+}
+
+unsigned int World :: getPlannedAiCount () const
+{
+	return ai_scheduler.getPlannedSlotCount();
+}
+
+unsigned int World :: getRunAiCount () const
+{
+	return ai_scheduler.getRunSlotCount();
+}
+
+void World :: setPlannedAiCount (unsigned int count)
+{
+	assert(count >= 1);
+	assert(count <= SHIP_COUNT);
+
+	ai_scheduler.setPlannedSlotCount(count);
+}
+
+const PerceptionStats& World :: getPerceptionStats () const
+{
+	return perception_service.getStats();
+}
+
+void World :: applyPlayerInput (const PlayerInput& input)
+{
+	assert(isInitialized());
+    
+    double turn_rate = PLAYER_TURN_RATE;
+    if (input.isHeld(PlayerInput::FAST))
+    {
+        player_ship.setSpeed(PLAYER_SPEED_FAST);
+    }
+    else if (input.isHeld(PlayerInput::SLOW))
+    {
+        player_ship.setSpeed(PLAYER_SPEED_SLOW);
+        turn_rate *= PLAYER_TURN_SLOW_FACTOR;
+    }
+    else
+    {
+        player_ship.setSpeed(PLAYER_SPEED_NORMAL);
+    }
+    
+    if (input.isHeld(PlayerInput::TURN_RIGHT))
+        player_ship.rotateAroundUp(-turn_rate);
+    if (input.isHeld(PlayerInput::TURN_LEFT))
+        player_ship.rotateAroundUp(turn_rate);
+    if (input.isHeld(PlayerInput::TURN_UP))
+        player_ship.rotateAroundRight(turn_rate);
+    if (input.isHeld(PlayerInput::TURN_DOWN))
+        player_ship.rotateAroundRight(-turn_rate);
+    
+    if (input.isHeld(PlayerInput::FIRE) &&
+        player_ship.isAlive() && player_ship.isReloaded())
+    {
+        addBullet(player_ship.getPosition(),
+                  player_ship.getForward(),
+                  player_ship.getId());
+        player_ship.markReloading();
+    }
+}
+
+void World :: writeSnapshot (ostream& r_out,
+                             bool is_ai_estimates_written) const
+{
+	assert(isInitialized());
+    
+    SnapshotStream::writeValue(r_out, SNAPSHOT_MAGIC);
+    SnapshotStream::writeValue(r_out, SNAPSHOT_VERSION);
+    SnapshotStream::writeValue(r_out, (unsigned int)(MOON_COUNT));
+    SnapshotStream::writeValue(r_out, (unsigned int)(SHIP_COUNT));
+    SnapshotStream::writeValue(r_out, random_seed);
+    SnapshotStream::writeValue(r_out, random.getState());
+    SnapshotStream::writeValue(r_out, is_ai_estimates_written);
+    
+    planet.writeState(r_out);
+    for (int i = 0; i < MOON_COUNT; i++)
+        moons[i].writeState(r_out);
+    player_ship.writeState(r_out);
+    for (int i = 0; i < SHIP_COUNT; i++)
+        ships[i].writeState(r_out);
+    
+    // only the projectiles in use matter
+    bullet_pool.writeState(r_out);
+    for (unsigned int i = 0; i < bullet_pool.getLiveCount(); i++)
+        bullets[bullet_pool.getLiveSlot(i)].writeState(r_out);
+    missile_pool.writeState(r_out);
+    for (unsigned int i = 0; i < missile_pool.getLiveCount(); i++)
+        missiles[missile_pool.getLiveSlot(i)].writeState(r_out);
+    fleet_registry.writeState(r_out);
+    ai_scheduler.writeState(r_out);
+    perception_service.writeState(r_out);
+    if (is_ai_estimates_written)
+        ai_scheduler.writeEstimates(r_out);
+}
+
+bool World :: readSnapshot (istream& r_in)
+{
+	assert(isInitialized());
+    
+    // the parts are read straight into the objects, so keep a
+    //  copy of the current state to go back to if one is bad
+    stringstream backup(ios::in | ios::out | ios::binary);
+    writeSnapshot(backup, true);
+    if (readSnapshotParts(r_in))
+        return true;
+    
+    if (!readSnapshotParts(backup))
+        assert(false);  // a snapshot of this World is always valid for it
+    return false;
+}
+
 ///////////////////////////////////////////////////////////////
 //
 //  Helper function not inherited from anywhere
 //
 
+bool World :: readSnapshotParts (istream& r_in)
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int moon_count;
+    unsigned int ship_count;
+    unsigned long long seed;
+    unsigned long long random_state;
+    bool is_ai_estimates;
+    
+    if (!SnapshotStream::readValue(r_in, magic)        ||
+        !SnapshotStream::readValue(r_in, version)      ||
+        !SnapshotStream::readValue(r_in, moon_count)   ||
+        !SnapshotStream::readValue(r_in, ship_count)   ||
+        !SnapshotStream::readValue(r_in, seed)         ||
+        !SnapshotStream::readValue(r_in, random_state) ||
+        !SnapshotStream::readValue(r_in, is_ai_estimates))
+    {
+        return false;
+    }
+    
+    if (magic        != SNAPSHOT_MAGIC   ||
+        version      != SNAPSHOT_VERSION ||
+        moon_count   != MOON_COUNT       ||
+        ship_count   != SHIP_COUNT)
+    {
+        return false;
+    }
+    
+    if (!planet.readState(r_in))
+        return false;
+    for (int i = 0; i < MOON_COUNT; i++)
+        if (!moons[i].readState(r_in))
+            return false;
+    if (!player_ship.readState(r_in))
+        return false;
+    for (int i = 0; i < SHIP_COUNT; i++)
+        if (!ships[i].readState(r_in))
+            return false;
+    
+    if (!bullet_pool.readState(r_in))
+        return false;
+    bullets.resize(bullet_pool.getCapacity());
+    for (unsigned int i = 0; i < bullet_pool.getLiveCount(); i++)
+    {
+        Bullet& bullet = bullets[bullet_pool.getLiveSlot(i)];
+        if (!bullet.readState(r_in))
+            return false;
+        if (bullet_dl.isReady())
+            bullet.setDisplayList(bullet_dl, PROJECTILE_DISPLAY_SCALE);
+    }
+    
+    if (!missile_pool.readState(r_in))
+        return false;
+    missiles.resize(missile_pool.getCapacity());
+    for (unsigned int i = 0; i < missile_pool.getLiveCount(); i++)
+    {
+        Missile& missile = missiles[missile_pool.getLiveSlot(i)];
+        if (!missile.readState(r_in))
+            return false;
+        if (missile_dl.isReady())
+            missile.setDisplayList(missile_dl, PROJECTILE_DISPLAY_SCALE);
+    }
+    
+    if (!fleet_registry.readState(r_in))
+        return false;
+    if (!ai_scheduler.readState(r_in))
+        return false;
+    if (!perception_service.readState(r_in, TimeSystem::getFrameNumber()))
+        return false;
+    if (is_ai_estimates && !ai_scheduler.readEstimates(r_in))
+        return false;
+    
+    random_seed = seed;
+    random.setState(random_state);
+    updateNearbyShipGrid();
+    
+	assert(invariant());
+    return true;
+}
+
 bool World :: invariant () const
 {
 	if(mp_explosion_manager == NULL) return false;
 	return true;
 }
 
+void World::loadModels()
+{
+    ObjModel sb;
+    sb.load("Models/Skybox.obj");
+    skybox = sb.getDisplayList();
+    
+    ObjModel p;
+    p.load(planetInfo.filename);
+    planet_dl = p.getDisplayList();
+    
+    for (int i = 0; i < MOON_COUNT; i++)
+    {
+        ObjModel m;
+        m.load(moonInfo[i].filename);
+        moon_dl[i] = m.getDisplayList();
+    }
+    
+    RingParticle::load();
+    ObjModel r;
+    r.load("Models/Ring.obj");
+    ring_dl = r.getDisplayList();
+    
+    ObjModel s;
+    s.load("Models/Grapple.obj");
+    ship_dl = s.getDisplayList();
+    
+    ObjModel b;
+    b.load("Models/Bolt.obj");
+    bullet_dl = b.getDisplayList();
+    
+    ObjModel m;
+    m.load("Models/Missile.obj");
+    missile_dl = m.getDisplayList();
+}
+
+void World::initObjects()
+{
+    random.setState(random_seed);
+    
+    // Planet Init
+    PhysicsObjectId p_id = PhysicsObjectId(PhysicsObjectId::TYPE_PLANETOID,
+                                           PhysicsObjectId::FLEET_NATURE,
+                                           0);
+    planet.initPlanetoid(p_id, planetInfo.position, planetInfo.radius, planet_dl, planetInfo.radius);
+    
+    // Moon Init
+    for (int i = 0; i < MOON_COUNT; i++)
+    {
+        PhysicsObjectId m_id = PhysicsObjectId(PhysicsObjectId::TYPE_PLANETOID,
+                                               PhysicsObjectId::FLEET_NATURE,
+                                               i + 1);
+        moons[i].initPlanetoid(m_id, moonInfo[i].position, moonInfo[i].radius, moon_dl[i], moonInfo[i].radius);
+    }
+    
+    // Ring init
+    g_rings.init(RING_HALF_THICKNESS,
+                 RING_INNER_RADIUS,
+                 RING_OUTER_RADIUS_BASE,
+                 RING_DENSITY_MAX,
+                 RING_DENSITY_FACTOR);
+    
+    for(unsigned int i = 0; i < MOON_COUNT; i++)
+    {
+        g_rings.addHole(moons[i].getPosition(),
+                        moons[i].getRadius() + RING_MOON_PADDING);
+    }
+    
+    // Ship Init
+    for (int i = 0; i < SHIP_COUNT; i++)
+    {
+        PhysicsObjectId s_id = PhysicsObjectId(PhysicsObjectId::TYPE_SHIP,
+                                               PhysicsObjectId::FLEET_ENEMY,
+                                               i);
+        
+        int moonIndex = random.getNextIndex(MOON_COUNT);
+        Vector3 pos = moonInfo[moonIndex].position
+                        + random.getNextUnitVector()
+                        * (moonInfo[moonIndex].radius + 500.0);
+        
+        ships[i].initPhysics(s_id, pos, 10.f, random.getNextUnitVector(), ship_dl, 10.f);
+        ships[i].setUnitAi(new SpaceMongols::UnitAiMoonGuard(ships[i],
+                                                             *this,
+                                                             moons[moonIndex].getId(),
+                                                             PseudorandomGenerator::calculateMixedSeed(random_seed, s_id)));
+        ships[i].setHealth(1);
+        ships[i].setAmmo(0);
+        ships[i].setSpeed(250.f);
+        ships[i].setManeuverability(250.0f, 250.0f, 0.33 * M_PI);
+    }
+    
+    // Player Ship Init
+    PhysicsObjectId ps_id = PhysicsObjectId(PhysicsObjectId::TYPE_SHIP,
+                                            PhysicsObjectId::FLEET_PLAYER,
+                                            0);
+    Vector3 pos = moons[0].getPosition() + Vector3(0.f, 15000.f, 0.f);
+    player_ship.initPhysics(ps_id, pos, 10.f, random.getNextUnitVector(), ship_dl, 10.f);
+    player_ship.setHealth(10);
+    player_ship.setAmmo(8);
+    player_ship.setSpeed(250.f);
+    
+    // Bullets and missiles are set up as they are fired
+    
+    updateNearbyShipGrid();
+    initFleetRegistry();
+}
+
 void World::handleCollisions()
 {
-    handleShipCollisions(player_ship);
+    updateShipGrid();
+    
+    // Collisions are handled in two passes.  Finding them only
+    //  reads the world, so the ships and bullets are split into
+    //  chunks that are checked in parallel, each writing the
+    //  contacts it finds to its own buffer.  The buffers are
+    //  then resolved one after another in chunk order, which
+    //  is the order checking everything on one thread would
+    //  have found them in.
+    collision_ships.clear();
+    if (player_ship.isAlive() && !player_ship.isDying())
+    {
+        collision_ships.push_back(&player_ship);
+    }
     
     for (int i = 0; i < SHIP_COUNT; i++)
     {
         if (!ships[i].isAlive()) continue;
         if (ships[i].isDying()) continue;
-        handleShipCollisions(ships[i]);
+        collision_ships.push_back(&ships[i]);
+    }
+    
+    // Find the ships near every bullet and missile with one
+    //  query.  The results are grouped by query, so each
+    //  projectile gets a contiguous range of them.
+    projectile_query_min.clear();
+    projectile_query_max.clear();
+    projectile_query_objects.clear();
+    for (unsigned int i = 0; i < bullet_pool.getLiveCount(); i++)
+    {
+        Bullet& bullet = bullets[bullet_pool.getLiveSlot(i)];
+        if (!bullet.isAlive()) continue;
+        projectile_query_min.push_back(getSweptMin(bullet));
+        projectile_query_max.push_back(getSweptMax(bullet));
+        projectile_query_objects.push_back(&bullet);
+    }
+    
+    for (unsigned int i = 0; i < missile_pool.getLiveCount(); i++)
+    {
+        Missile& missile = missiles[missile_pool.getLiveSlot(i)];
+        if (!missile.isAlive()) continue;
+        projectile_query_min.push_back(getSweptMin(missile));
+        projectile_query_max.push_back(getSweptMax(missile));
+        projectile_query_objects.push_back(&missile);
     }
     
-    for (int i = 0; i < BULLET_COUNT; i++)
+    projectile_ship_pairs.clear();
+    if (!projectile_query_objects.empty())
     {
-        if (!bullets[i].isAlive()) continue;
-        handleBulletCollisions(bullets[i]);
+        ship_grid.appendCollisionsBatch(&projectile_query_min[0],
+                                        &projectile_query_max[0],
+                                        (unsigned int)(projectile_query_objects.size()),
+                                        projectile_ship_pairs);
+    }
+    
+    projectile_pair_begin.clear();
+    unsigned int pair_end = 0;
+    for (unsigned int q = 0; q < projectile_query_objects.size(); q++)
+    {
+        projectile_pair_begin.push_back(pair_end);
+        while (pair_end < projectile_ship_pairs.size() && projectile_ship_pairs[pair_end].m_query == q)
+        {
+            pair_end++;
+        }
+    }
+    projectile_pair_begin.push_back(pair_end);
+    
+    unsigned int ship_count = (unsigned int)(collision_ships.size());
+    unsigned int item_count = ship_count + (unsigned int)(projectile_query_objects.size());
+    unsigned int chunk_count = (thread_pool.getWorkerCount() + 1) * COLLISION_CHUNKS_PER_THREAD;
+    if (chunk_count > item_count) chunk_count = item_count;
+    if (contact_buffers.size() < chunk_count)
+    {
+        contact_buffers.resize(chunk_count);
+        nearby_ship_buffers.resize(chunk_count);
+    }
+    
+    thread_pool.runParallel(chunk_count, [this, ship_count, item_count, chunk_count] (unsigned int c)
+    {
+        vector<Contact>& r_contacts = contact_buffers[c];
+        vector<PhysicsObjectId>& r_nearby_ships = nearby_ship_buffers[c];
+        r_contacts.clear();
+        
+        unsigned int item_begin = item_count *  c      / chunk_count;
+        unsigned int item_end   = item_count * (c + 1) / chunk_count;
+        for (unsigned int i = item_begin; i < item_end; i++)
+        {
+            if (i < ship_count)
+            {
+                detectShipCollisions(*collision_ships[i], r_nearby_ships, r_contacts);
+            }
+            else
+            {
+                unsigned int q = i - ship_count;
+                detectProjectileCollisions(*projectile_query_objects[q],
+                                           projectile_pair_begin[q],
+                                           projectile_pair_begin[q + 1],
+                                           r_nearby_ships,
+                                           r_contacts);
+            }
+        }
+    });
+    
+    for (unsigned int c = 0; c < chunk_count; c++)
+    {
+        resolveContacts(contact_buffers[c]);
     }
 }
 
-void World::handleShipCollisions(Ship& ship)
+void World::detectShipCollisions(const Ship& ship,
+                                 vector<PhysicsObjectId>& r_nearby_ships,
+                                 vector<Contact>& r_contacts) const
 {
+    assert(ship.isAlive());
+    
+    // Everything is tested along the path the ship moved this
+    //  frame, not just where it ended up, so nothing is missed
+    //  however long the frame was.
+    
     // Ring Particles
-    if (g_rings.handleRingParticleCollision(ship.getPosition(), ship.getRadius()))
+    if (g_rings.handleRingParticleCollision(ship.getPositionPrevious(),
+                                            ship.getPosition(),
+                                            ship.getRadius()))
     {
-        resolvePlanetoidCollision(ship);
+        Contact contact = { ship.getId(), PhysicsObjectId::ID_NOTHING, CONTACT_SHIP_PLANETOID };
+        r_contacts.push_back(contact);
     }
     
     // Planetoids
-    if (GeometricCollisions::sphereVsSphere(ship.getPosition(),
-                                            ship.getRadius(),
-                                            planet.getPosition(),
-                                            planet.getRadius()))
+    if (GeometricCollisions::segmentVsSphere(ship.getPositionPrevious(),
+                                             ship.getPosition(),
+                                             planet.getPosition(),
+                                             planet.getRadius() + ship.getRadius()))
     {
-        resolvePlanetoidCollision(ship);
+        Contact contact = { ship.getId(), planet.getId(), CONTACT_SHIP_PLANETOID };
+        r_contacts.push_back(contact);
     }
     
     for (int j = 0; j < MOON_COUNT; j++)
     {
-        if (GeometricCollisions::sphereVsSphere(ship.getPosition(),
-                                                ship.getRadius(),
-                                                moons[j].getPosition(),
-                                                moons[j].getRadius()))
+        if (GeometricCollisions::segmentVsSphere(ship.getPositionPrevious(),
+                                                 ship.getPosition(),
+                                                 moons[j].getPosition(),
+                                                 moons[j].getRadius() + ship.getRadius()))
         {
-            resolvePlanetoidCollision(ship);
+            Contact contact = { ship.getId(), moons[j].getId(), CONTACT_SHIP_PLANETOID };
+            r_contacts.push_back(contact);
         }
     }
     
     // Ships
-    for (int j = 0; j < SHIP_COUNT; j++)
-    {
-        if (ship.getId() >= ships[j].getId()) continue;
-        if (!ships[j].isAlive()) continue;
-        if (ships[j].isDying()) continue;
-        if (GeometricCollisions::sphereVsSphere(ship.getPosition(),
-                                                ship.getRadius(),
-                                                ships[j].getPosition(),
-                                                ships[j].getRadius()))
+    //  Only the ships near this one are checked.  They are
+    //  sorted so collisions resolve in the same order as
+    //  checking every ship would.  A ship that is already dying
+    //  cannot recover before the contact is resolved, so it is
+    //  skipped here.
+    r_nearby_ships.clear();
+    ship_grid.appendCollisions(getSweptMin(ship), getSweptMax(ship), r_nearby_ships);
+    sort(r_nearby_ships.begin(), r_nearby_ships.end());
+    for (unsigned int j = 0; j < r_nearby_ships.size(); j++)
+    {
+        if (ship.getId() >= r_nearby_ships[j]) continue;
+        const Ship& other = getShip(r_nearby_ships[j]);
+        if (!other.isAlive()) continue;
+        if (other.isDying()) continue;
+        if (GeometricCollisions::movingSphereVsMovingSphere(ship.getPositionPrevious(),
+                                                            ship.getPosition(),
+                                                            ship.getRadius(),
+                                                            other.getPositionPrevious(),
+                                                            other.getPosition(),
+                                                            other.getRadius()))
         {
-            resolveShipCollision(ship, ships[j]);
+            Contact contact = { ship.getId(), other.getId(), CONTACT_SHIP_SHIP };
+            r_contacts.push_back(contact);
         }
     }
 }
 
-void World::handleBulletCollisions(Bullet& bullet)
+void World::detectProjectileCollisions(const PhysicsObject& projectile,
+                                       unsigned int pair_begin,
+                                       unsigned int pair_end,
+                                       vector<PhysicsObjectId>& r_nearby_ships,
+                                       vector<Contact>& r_contacts) const
 {
+    assert(pair_begin <= pair_end);
+    assert(pair_end <= projectile_ship_pairs.size());
+    
+    // A projectile moves many times its target's radius each
+    //  frame, so it is tested along the segment from where it
+    //  was to where it is.
+    
     // Ring Particles
-    if (g_rings.handleRingParticleCollision(bullet.getPosition(), 0.0f))
+    if (g_rings.handleRingParticleCollision(projectile.getPositionPrevious(),
+                                            projectile.getPosition(),
+                                            projectile.getRadius()))
     {
-        resolvePlanetoidCollision(bullet);
+        Contact contact = { projectile.getId(), PhysicsObjectId::ID_NOTHING, CONTACT_PROJECTILE_PLANETOID };
+        r_contacts.push_back(contact);
     }
     
     // Planetoids
-    if (GeometricCollisions::sphereVsSphere(bullet.getPosition(),
-                                            0.0f,
-                                            planet.getPosition(),
-                                            planet.getRadius()))
+    if (GeometricCollisions::segmentVsSphere(projectile.getPositionPrevious(),
+                                             projectile.getPosition(),
+                                             planet.getPosition(),
+                                             planet.getRadius() + projectile.getRadius()))
     {
-        resolvePlanetoidCollision(bullet);
+        Contact contact = { projectile.getId(), planet.getId(), CONTACT_PROJECTILE_PLANETOID };
+        r_contacts.push_back(contact);
     }
     
     for (int j = 0; j < MOON_COUNT; j++)
     {
-        if (GeometricCollisions::sphereVsSphere(bullet.getPosition(),
-                                                0.0f,
-                                                moons[j].getPosition(),
-                                                moons[j].getRadius()))
+        if (GeometricCollisions::segmentVsSphere(projectile.getPositionPrevious(),
+                                                 projectile.getPosition(),
+                                                 moons[j].getPosition(),
+                                                 moons[j].getRadius() + projectile.getRadius()))
         {
-            resolvePlanetoidCollision(bullet);
+            Contact contact = { projectile.getId(), moons[j].getId(), CONTACT_PROJECTILE_PLANETOID };
+            r_contacts.push_back(contact);
         }
     }
     
-    // Player Ship
-    if (player_ship.isAlive() && !player_ship.isDying()) {
-        if (GeometricCollisions::sphereVsSphere(bullet.getPosition(),
-                                                0.0f,
-                                                player_ship.getPosition(),
-                                                player_ship.getRadius()))
+    // Ships, including the player ship
+    r_nearby_ships.clear();
+    for (unsigned int p = pair_begin; p < pair_end; p++)
+    {
+        r_nearby_ships.push_back(projectile_ship_pairs[p].m_id);
+    }
+    sort(r_nearby_ships.begin(), r_nearby_ships.end());
+    for (unsigned int j = 0; j < r_nearby_ships.size(); j++)
+    {
+        const Ship& other = getShip(r_nearby_ships[j]);
+        if (!other.isAlive()) continue;
+        if (other.isDying()) continue;
+        if (GeometricCollisions::movingSphereVsMovingSphere(projectile.getPositionPrevious(),
+                                                            projectile.getPosition(),
+                                                            projectile.getRadius(),
+                                                            other.getPositionPrevious(),
+                                                            other.getPosition(),
+                                                            other.getRadius()))
         {
-            resolveBulletCollision(bullet, player_ship);
-            //printf("Player Health: %f\n", player_ship.getHealth());
+            Contact contact = { projectile.getId(), other.getId(), CONTACT_PROJECTILE_SHIP };
+            r_contacts.push_back(contact);
         }
     }
-    
-    // Ships
-    for (int j = 0; j < SHIP_COUNT; j++)
-    {
-        if (!ships[j].isAlive()) continue;
-        if (ships[j].isDying()) continue;
-        if (GeometricCollisions::sphereVsSphere(bullet.getPosition(),
-                                                0.0f,
-                                                ships[j].getPosition(),
-                                                ships[j].getRadius()))
+}
+
+void World::resolveContacts(const vector<Contact>& contacts)
+{
+    bool is_checking = false;
+    for (unsigned int c = 0; c < contacts.size(); c++)
+    {
+        const Contact& contact = contacts[c];
+        
+        // A ship that an earlier contact left dying would not
+        //  have been checked at all, so none of its own contacts
+        //  count.  Once its contacts start, they all count.
+        if (c == 0 || contact.m_id1 != contacts[c - 1].m_id1)
+        {
+            is_checking = true;
+            if (contact.m_id1.m_type == PhysicsObjectId::TYPE_SHIP)
+            {
+                const Ship& ship = getShip(contact.m_id1);
+                is_checking = ship.isAlive() && !ship.isDying();
+            }
+        }
+        if (!is_checking) continue;
+        
+        switch (contact.m_kind)
         {
-            resolveBulletCollision(bullet, ships[j]);
+        case CONTACT_SHIP_PLANETOID:
+            resolvePlanetoidCollision(getShip(contact.m_id1));
+            break;
+        case CONTACT_SHIP_SHIP:
+            {
+                Ship& other = getShip(contact.m_id2);
+                if (!other.isAlive()) break;
+                if (other.isDying()) break;
+                resolveShipCollision(getShip(contact.m_id1), other);
+            }
+            break;
+        case CONTACT_PROJECTILE_PLANETOID:
+            resolvePlanetoidCollision(getProjectile(contact.m_id1));
+            break;
+        case CONTACT_PROJECTILE_SHIP:
+            {
+                Ship& other = getShip(contact.m_id2);
+                if (!other.isAlive()) break;
+                if (other.isDying()) break;
+                
+                // getProjectile checks the id is current
+                PhysicsObject& projectile = getProjectile(contact.m_id1);
+                if (contact.m_id1.m_type == PhysicsObjectId::TYPE_BULLET)
+                    resolveBulletCollision(static_cast<Bullet&>(projectile), other);
+                else
+                    resolveMissileCollision(static_cast<Missile&>(projectile), other);
+            }
+            break;
         }
     }
 }
@@ -402,4 +1026,253 @@ void World::resolveBulletCollision(Bullet& b, Ship& obj)
     
     b.markDead(false);
     obj.addHealth(-1.0f);
+    if (obj.isDying()) awardKill(b.getSourceId(), obj);
+}
+
+void World::resolveMissileCollision(Missile& m, Ship& obj)
+{
+    if (m.getSourceId() == obj.getId()) return;
+    
+    m.markDead(false);
+    obj.addHealth(-MISSILE_DAMAGE);
+    if (obj.isDying()) awardKill(m.getSourceId(), obj);
+}
+
+void World::awardKill(const PhysicsObjectId& source_id, const Ship& obj)
+{
+    unsigned int fleet = source_id.m_fleet;
+    if (fleet == PhysicsObjectId::FLEET_NATURE) return;
+    if (fleet == obj.getId().m_fleet) return;
+    if (fleet >= fleet_registry.getFleetCount()) return;
+    
+    fleet_registry.addScore(fleet, SCORE_PER_KILL);
+}
+
+void World::removeDeadProjectiles()
+{
+    // Removing a slot moves the last live slot into its place,
+    //  so going backwards means every slot is still checked.
+    for (unsigned int i = bullet_pool.getLiveCount(); i > 0; i--)
+    {
+        unsigned int slot = bullet_pool.getLiveSlot(i - 1);
+        if (!bullets[slot].isAlive()) bullet_pool.remove(slot);
+    }
+    
+    for (unsigned int i = missile_pool.getLiveCount(); i > 0; i--)
+    {
+        unsigned int slot = missile_pool.getLiveSlot(i - 1);
+        if (!missiles[slot].isAlive())
+        {
+            fleet_registry.removeMissile(missiles[slot].getId());
+            missile_pool.remove(slot);
+        }
+    }
+}
+
+void World::updateNearbyShipGrid()
+{
+    if (player_ship.isAlive())
+    {
+        nearby_ship_grid.move(player_ship.getId(), player_ship.getPosition());
+    }
+    else
+    {
+        nearby_ship_grid.remove(player_ship.getId(), player_ship.getPosition());
+    }
+    
+    for (int i = 0; i < SHIP_COUNT; i++)
+    {
+        if (ships[i].isAlive())
+        {
+            nearby_ship_grid.move(ships[i].getId(), ships[i].getPosition());
+        }
+        else
+        {
+            nearby_ship_grid.remove(ships[i].getId(), ships[i].getPosition());
+        }
+    }
+}
+
+void World::appendNearbyShips(const Vector3& sphere_center,
+                              double sphere_radius,
+                              vector<NearbyShipData>& r_results) const
+{
+    assert(sphere_radius >= 0.0);
+    
+    // Each ship is a point in the grid, so the grid finds the
+    //  ships in the cube around the sphere and the exact test
+    //  is done here, with positions read straight from the
+    //  ships instead of through WorldInterface.
+    struct SphereVisitor : public CollisionSystemInterface::Visitor
+    {
+        const World& m_world;
+        const Vector3& m_center;
+        double m_radius_squared;
+        vector<NearbyShipData>& mr_results;
+        
+        SphereVisitor (const World& world,
+                       const Vector3& center,
+                       double radius_squared,
+                       vector<NearbyShipData>& r_results)
+                : m_world(world),
+                  m_center(center),
+                  m_radius_squared(radius_squared),
+                  mr_results(r_results)
+        {}
+        
+        virtual void visit (const PhysicsObjectId& id)
+        {
+            const PhysicsObject* p_ship = m_world.getObject(id);
+            assert(p_ship != NULL);
+            if (!p_ship->isAlive()) return;
+            
+            double distance_squared = m_center.getDistanceSquared(p_ship->getPosition());
+            if (distance_squared < m_radius_squared)
+            {
+                NearbyShipData data = { id, p_ship->getPosition(), distance_squared };
+                mr_results.push_back(data);
+            }
+        }
+    };
+    
+    SphereVisitor visitor(*this, sphere_center, sphere_radius * sphere_radius, r_results);
+    Vector3 half_size(sphere_radius, sphere_radius, sphere_radius);
+    nearby_ship_grid.visitCollisions(sphere_center - half_size,
+                                     sphere_center + half_size,
+                                     visitor);
+}
+
+unsigned int World::getPerceptionSlot(const PhysicsObjectId& id_ship) const
+{
+    if (id_ship == player_ship.getId()) return SHIP_COUNT;
+    
+    assert(id_ship.m_index < SHIP_COUNT);
+    assert(ships[id_ship.m_index].getId() == id_ship);
+    return id_ship.m_index;
+}
+
+void World::updateShipGrid()
+{
+    if (player_ship.isAlive() && !player_ship.isDying())
+    {
+        ship_grid.move(player_ship.getId(),
+                       getSweptMin(player_ship),
+                       getSweptMax(player_ship));
+    }
+    else
+    {
+        ship_grid.remove(player_ship.getId(), player_ship.getPosition());
+    }
+    
+    for (unsigned int i = 0; i < SHIP_COUNT; i++)
+    {
+        if (ships[i].isAlive() && !ships[i].isDying())
+        {
+            ship_grid.move(ships[i].getId(),
+                           getSweptMin(ships[i]),
+                           getSweptMax(ships[i]));
+        }
+        else
+        {
+            ship_grid.remove(ships[i].getId(), ships[i].getPosition());
+        }
+    }
+}
+
+Vector3 World::getSweptMin(const PhysicsObject& object)
+{
+    return object.getPositionPreviousMin().getMinComponents(object.getPositionMin());
+}
+
+Vector3 World::getSweptMax(const PhysicsObject& object)
+{
+    return object.getPositionPreviousMax().getMaxComponents(object.getPositionMax());
+}
+
+Ship& World::getShip(const PhysicsObjectId& id)
+{
+    const World& const_this = *this;
+    return const_cast<Ship&>(const_this.getShip(id));
+}
+
+const Ship& World::getShip(const PhysicsObjectId& id) const
+{
+    assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
+    
+    const PhysicsObject* p_object = getObject(id);
+    assert(p_object != NULL);
+    
+    // everything in the ship part of the table is a Ship
+    return *static_cast<const Ship*>(p_object);
+}
+
+PhysicsObject& World::getProjectile(const PhysicsObjectId& id)
+{
+    assert(id.m_type == PhysicsObjectId::TYPE_BULLET ||
+           id.m_type == PhysicsObjectId::TYPE_MISSILE);
+    assert(getObject(id) != NULL);
+    
+    if (id.m_type == PhysicsObjectId::TYPE_BULLET)
+        return bullets[bullet_pool.getSlot(id.m_index)];
+    else
+        return missiles[missile_pool.getSlot(id.m_index)];
+}
+
+void World::initObjectTable()
+{
+    for (unsigned int t = 0; t < OBJECT_TABLE_TYPE_COUNT; t++)
+    {
+        for (unsigned int f = 0; f < OBJECT_TABLE_FLEET_COUNT; f++)
+        {
+            object_table[t][f].clear();
+        }
+    }
+    
+    // these must match the ids assigned in init
+    vector<PhysicsObject*>& planetoids = object_table[PhysicsObjectId::TYPE_PLANETOID]
+                                                     [PhysicsObjectId::FLEET_NATURE];
+    planetoids.push_back(&planet);
+    for (int i = 0; i < MOON_COUNT; i++)
+    {
+        planetoids.push_back(&moons[i]);
+    }
+    
+    object_table[PhysicsObjectId::TYPE_SHIP][PhysicsObjectId::FLEET_PLAYER].push_back(&player_ship);
+    vector<PhysicsObject*>& enemy_ships = object_table[PhysicsObjectId::TYPE_SHIP]
+                                                      [PhysicsObjectId::FLEET_ENEMY];
+    for (int i = 0; i < SHIP_COUNT; i++)
+    {
+        enemy_ships.push_back(&ships[i]);
+    }
+}
+
+void World::initFleetRegistry()
+{
+    fleet_registry.init(FLEET_COUNT);
+    
+    fleet_registry.setCommandShip(player_ship.getId(), player_ship.isAlive());
+    for (int i = 0; i < SHIP_COUNT; i++)
+    {
+        if (ships[i].isAlive()) fleet_registry.addFighter(ships[i].getId());
+    }
+}
+
+const PhysicsObject* World::getObject(const PhysicsObjectId& id) const
+{
+    // the pools also reject ids from projectiles that are gone
+    if (id.m_type == PhysicsObjectId::TYPE_BULLET)
+        return getPooledObject(bullet_pool, bullets, id);
+    if (id.m_type == PhysicsObjectId::TYPE_MISSILE)
+        return getPooledObject(missile_pool, missiles, id);
+    
+    if (id.m_type  >= OBJECT_TABLE_TYPE_COUNT)  return NULL;
+    if (id.m_fleet >= OBJECT_TABLE_FLEET_COUNT) return NULL;
+    
+    const vector<PhysicsObject*>& slots = object_table[id.m_type][id.m_fleet];
+    if (id.m_index >= slots.size()) return NULL;
+    
+    // objects that have not been initialized do not have their ids yet
+    const PhysicsObject* p_object = slots[id.m_index];
+    if (p_object->getId() != id) return NULL;
+    return p_object;
 }
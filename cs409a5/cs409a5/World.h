@@ -5,15 +5,27 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <iosfwd>
+#include <vector>
+
 #include "../../ObjLibrary/Vector3.h"
 
 #include "ExplosionManagerInterface.h"
 #include "WorldInterface.h"
 #include "GeometricCollisions.h"
+#include "CollisionSystemGrid.h"
 #include "Planetoid.h"
 #include "RingSystem.h"
 #include "Ship.h"
 #include "Bullet.h"
+#include "Missile.h"
+#include "ProjectilePool.h"
+#include "FleetRegistry.h"
+#include "AiScheduler.h"
+#include "PerceptionService.h"
+#include "ThreadPool.h"
+#include "PseudorandomGenerator.h"
+#include "PlayerInput.h"
 
 //
 //  World
@@ -32,16 +44,69 @@
 //
 //    between the glutInit() and glutMainLoop() functions.
 //
+//  Every random choice made while initializing and updating a
+//    World comes from a PseudorandomGenerator seeded with the
+//    World's random seed.  Two Worlds with the same seed that
+//    are given the same player input with the same frame times
+//    stay bit-for-bit identical.  The state of the physics
+//    objects and unit AIs can be saved with writeSnapshot,
+//    and compared or restored with readSnapshot.
+//
 //  Class Invariant():
 //    <1> mp_explosion_manager != NULL
 //
 
 class World : public WorldInterface
 {
+public:
+//
+//  UpdateTimes
+//
+//  A record of how long, in seconds, each phase of the most
+//    recent call to updateAll took.  Movement includes updating
+//    the player ship, the NPC ships, and the bullets.
+//
+
+    struct UpdateTimes
+    {
+        double m_ai;
+        double m_movement;
+        double m_collisions;
+        double m_explosions;
+    };
+
 private:
     static const unsigned int MOON_COUNT = 10;
     static const unsigned int SHIP_COUNT = 250;
-    static const unsigned int BULLET_COUNT = 100;
+    static const unsigned int OBJECT_TABLE_TYPE_COUNT  = PhysicsObjectId::TYPE_SHIP + 1;
+    static const unsigned int FLEET_COUNT = PhysicsObjectId::FLEET_ENEMY + 1;
+    static const unsigned int OBJECT_TABLE_FLEET_COUNT = FLEET_COUNT;
+    static const unsigned int COLLISION_CHUNKS_PER_THREAD = 4;
+    
+    //
+    //  Contact
+    //
+    //  A collision found by the detection pass of
+    //    handleCollisions, waiting to be resolved.  m_id1 is the
+    //    ship or projectile that was being checked and m_id2 is
+    //    what it hit.  A ring particle has no id, so a contact with
+    //    one has an m_id2 of PhysicsObjectId::ID_NOTHING.
+    //
+    
+    enum ContactKind
+    {
+        CONTACT_SHIP_PLANETOID,
+        CONTACT_SHIP_SHIP,
+        CONTACT_PROJECTILE_PLANETOID,
+        CONTACT_PROJECTILE_SHIP
+    };
+    
+    struct Contact
+    {
+        PhysicsObjectId m_id1;
+        PhysicsObjectId m_id2;
+        ContactKind m_kind;
+    };
     
     struct objInfo
     {
@@ -89,6 +154,17 @@ private:
     const double RING_DENSITY_MAX       = 6.0;
     const double RING_DENSITY_FACTOR    = 0.0002;
     
+    const double PLAYER_SPEED_NORMAL    = 250.0;
+    const double PLAYER_SPEED_FAST      = 2500.0;
+    const double PLAYER_SPEED_SLOW      = 50.0;
+    const double PLAYER_TURN_RATE       = 0.05;  // radians per frame
+    const double PLAYER_TURN_SLOW_FACTOR = 0.2;
+    
+    const float  PROJECTILE_DISPLAY_SCALE = 10.f;
+    const float  MISSILE_DAMAGE         = 2.0f;
+    const float  SCORE_PER_KILL         = 1.0f;
+    const double NEARBY_SHIP_CELL_SIZE  = 5000.0;
+    
 public:
     Ship player_ship;
     
@@ -99,14 +175,39 @@ private:
     Planetoid moons[MOON_COUNT];
     RingSystem g_rings;
     Ship ships[SHIP_COUNT];
-    Bullet bullets[BULLET_COUNT];
-    int nextBullet = 0;
+    ProjectilePool bullet_pool;
+    std::vector<Bullet> bullets;
+    ProjectilePool missile_pool;
+    std::vector<Missile> missiles;
+    std::vector<PhysicsObject*> turn_objects;
+    std::vector<Vector3> turn_forwards;
+    std::vector<double> turn_max_radians;
+    CollisionSystemGrid ship_grid;
+    CollisionSystemGrid nearby_ship_grid = CollisionSystemGrid(NEARBY_SHIP_CELL_SIZE);
+    FleetRegistry fleet_registry;
+    AiScheduler ai_scheduler;
+    mutable PerceptionService perception_service;
+    std::vector<Ship*> collision_ships;
+    std::vector<Vector3> projectile_query_min;
+    std::vector<Vector3> projectile_query_max;
+    std::vector<PhysicsObject*> projectile_query_objects;
+    std::vector<CollisionSystemInterface::CollisionPair> projectile_ship_pairs;
+    std::vector<unsigned int> projectile_pair_begin;
+    std::vector<std::vector<Contact> > contact_buffers;
+    std::vector<std::vector<PhysicsObjectId> > nearby_ship_buffers;
+    ThreadPool thread_pool;
+    bool is_headless = false;
+    unsigned long long random_seed = PseudorandomGenerator::SEED_DEFAULT;
+    PseudorandomGenerator random;
+    UpdateTimes last_update_times = { 0.0, 0.0, 0.0, 0.0 };
+    std::vector<PhysicsObject*> object_table[OBJECT_TABLE_TYPE_COUNT][OBJECT_TABLE_FLEET_COUNT];
     
     DisplayList planet_dl;
     DisplayList moon_dl[MOON_COUNT];
     DisplayList ring_dl;
     DisplayList ship_dl;
     DisplayList bullet_dl;
+    DisplayList missile_dl;
     
 public:
 //
@@ -178,6 +279,35 @@ public:
 
 	bool isInitialized () const;
 
+//
+//  isHeadless
+//
+//  Purpose: To determine if this World was initialized without
+//           graphics.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this World was initialized with
+//           initHeadless.
+//  Side Effect: N/A
+//
+
+	bool isHeadless () const;
+
+//
+//  getLastUpdateTimes
+//
+//  Purpose: To determine how long each phase of the most recent
+//           update took.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The phase times for the most recent call to
+//           updateAll.  If updateAll has not been called, all
+//           the times are 0.0.
+//  Side Effect: N/A
+//
+
+	const UpdateTimes& getLastUpdateTimes () const;
+
 //
 //  draw
 //
@@ -189,9 +319,10 @@ public:
 //    <2> camera_up: The camera up vector
 //  Precondition(s):
 //    <1> isInitialized()
-//    <2> camera_forward.isNormal()
-//    <3> camera_up.isNormal()
-//    <4> camera_forward.isOrthogonal(camera_up)
+//    <2> !isHeadless()
+//    <3> camera_forward.isNormal()
+//    <4> camera_up.isNormal()
+//    <5> camera_forward.isOrthogonal(camera_up)
 //  Returns: N/A
 //  Side Effect: All explosions are drawn.
 //
@@ -214,6 +345,23 @@ public:
 
 	void init ();
 
+//
+//  initHeadless
+//
+//  Purpose: To initialize this World without graphics.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The physics objects and ring in this World are
+//               initialized as for init, but no models or
+//               textures are loaded and no OpenGL functions are
+//               called.  This World cannot be drawn afterwards.
+//               If this World was already initialized, there is
+//               no effect.
+//
+
+	void initHeadless ();
+
 //
 //  reset
 //
@@ -237,11 +385,244 @@ public:
 //  Precondition(s):
 //    <1> isInitialized()
 //  Returns: N/A
-//  Side Effect: All explosions are updated for one frame.
+//  Side Effect: The unit AIs for all living ships are run in
+//               parallel, each seeing the World as it was at
+//               the start of the frame.  Then all objects and
+//               explosions are updated for one frame.
 //
 
 	void updateAll ();
 
+//
+//  getRandomSeed
+//
+//  Purpose: To determine the seed for the random choices made
+//           by this World.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The random seed for this World.
+//  Side Effect: N/A
+//
+
+	unsigned long long getRandomSeed () const;
+
+//
+//  setRandomSeed
+//
+//  Purpose: To change the seed for the random choices made by
+//           this World.
+//  Parameter(s):
+//    <1> seed: The new random seed
+//  Precondition(s):
+//    <1> !isInitialized()
+//  Returns: N/A
+//  Side Effect: This World is set to use random seed seed when
+//               it is initialized.
+//
+
+	void setRandomSeed (unsigned long long seed);
+
+//
+//  applyPlayerInput
+//
+//  Purpose: To control the player ship for the current frame.
+//  Parameter(s):
+//    <1> input: The controls held by the player
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The speed of the player ship is set and it is
+//               rotated according to input.  If input includes
+//               FIRE and the player ship is alive and reloaded,
+//               a bullet is fired.  This function should be
+//               called once before each call to updateAll.
+//
+
+	void applyPlayerInput (const PlayerInput& input);
+
+//
+//  setAiBudget
+//
+//  Purpose: To limit the time spent running unit AIs each
+//           frame.
+//  Parameter(s):
+//    <1> seconds: The elapsed time allowed for unit AIs in
+//                 each frame
+//  Precondition(s):
+//    <1> seconds > 0.0
+//  Returns: N/A
+//  Side Effect: Starting with the next call to updateAll, only
+//               as many unit AIs as are expected to finish in
+//               seconds are run each frame, taking turns in
+//               round-robin order.  Every unit AI still runs at
+//               least once every
+//               AiScheduler::WAIT_FRAMES_MAX_DEFAULT frames.
+//               The ships whose AIs do not run keep their
+//               previous orders.
+//
+
+	void setAiBudget (double seconds);
+
+//
+//  setAiBudgetUnlimited
+//
+//  Purpose: To remove the limit on the time spent running unit
+//           AIs each frame.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Starting with the next call to updateAll, every
+//               unit AI is run every frame.  This is the
+//               default.
+//
+
+	void setAiBudgetUnlimited ();
+
+//
+//  setRingDensityVolumeEnabled
+//
+//  Purpose: To change whether the ring density is baked into a
+//           volume of samples instead of being calculated
+//           exactly.
+//  Parameter(s):
+//    <1> is_enabled: Whether the density volume should be used
+//  Precondition(s):
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The ring density is baked or freed as for
+//               RingSystem::setDensityVolumeEnabled.  The
+//               interpolated density rounds to a different
+//               particle count for a few sectors, so a World
+//               with the volume enabled does not match a replay
+//               recorded without it.  The volume is disabled by
+//               default.
+//
+
+	void setRingDensityVolumeEnabled (bool is_enabled);
+
+//
+//  getPlannedAiCount
+//
+//  Purpose: To determine how many unit AI slots will be run in
+//           the next call to updateAll.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of ship slots in the window of unit AIs
+//           for the next frame.  The slots of dead ships are
+//           included.
+//  Side Effect: N/A
+//
+
+	unsigned int getPlannedAiCount () const;
+
+//
+//  getRunAiCount
+//
+//  Purpose: To determine how many unit AIs will actually be run
+//           in the next call to updateAll.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of ship slots in the window of unit AIs
+//           for the next frame whose AIs are not waiting for a
+//           time.  The slots of dead ships are included.
+//  Side Effect: N/A
+//
+
+	unsigned int getRunAiCount () const;
+
+//
+//  setPlannedAiCount
+//
+//  Purpose: To replace the number of unit AI slots that will be
+//           run in the next call to updateAll.  This is
+//           intended for replaying a recording, where each
+//           frame must run exactly the AIs that it ran when it
+//           was recorded.
+//  Parameter(s):
+//    <1> count: The number of slots
+//  Precondition(s):
+//    <1> count >= 1
+//    <2> count <= the number of ships, not including the
+//        player ship
+//  Returns: N/A
+//  Side Effect: The next call to updateAll will run the unit
+//               AIs for count ship slots.
+//
+
+	void setPlannedAiCount (unsigned int count);
+
+//
+//  getPerceptionStats
+//
+//  Purpose: To determine how many perception requests were
+//           answered at the start of the last call to
+//           updateAll, and how much work they shared.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The statistics for the perception requests
+//           answered in the last call to updateAll.
+//  Side Effect: N/A
+//
+
+	const PerceptionStats& getPerceptionStats () const;
+
+//
+//  writeSnapshot
+//
+//  Purpose: To write the state of this World to the specified
+//           binary stream.
+//  Parameter(s):
+//    <1> r_out: The stream to write to
+//    <2> is_ai_estimates_written: Whether to write how long
+//                                 the unit AIs are expected to
+//                                 take
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> r_out was opened in binary mode
+//  Returns: N/A
+//  Side Effect: A snapshot is written to r_out.  It contains a
+//               header with a format version, the random seed
+//               and generator state, the state of the planet,
+//               moons, ships, bullets, and missiles, the state
+//               of the unit AIs, the fleets, the pending
+//               perception requests and answers, and which
+//               unit AIs are asleep or waiting.  If
+//               is_ai_estimates_written is true, the cost
+//               estimates used to fit the unit AIs in the AI
+//               budget are also written.  These are measured
+//               times, so two runs never have the same ones;
+//               leave them out to compare snapshots.  The
+//               explosions and ring are not written.  Values
+//               are written in native byte order.
+//
+
+	void writeSnapshot (std::ostream& r_out,
+	                    bool is_ai_estimates_written) const;
+
+//
+//  readSnapshot
+//
+//  Purpose: To set this World to the state read from the
+//           specified binary stream.
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s):
+//    <1> isInitialized()
+//    <2> r_in was opened in binary mode
+//  Returns: Whether a valid snapshot was read.
+//  Side Effect: A snapshot written by writeSnapshot is read
+//               from r_in and this World is set to the state it
+//               contains.  If it does not contain the AI cost
+//               estimates, the ones in this World are kept.
+//               If the snapshot is not valid for this World or
+//               is cut short, this World is not changed.  The
+//               TimeSystem is not part of the snapshot, so it
+//               should be at the same time as when the
+//               snapshot was written.
+//
+
+	bool readSnapshot (std::istream& r_in);
+
 ///////////////////////////////////////////////////////////////
 //
 //  Virtual functions inherited from WorldInterface
@@ -302,8 +683,7 @@ public:
 //  Precondition(s): N/A
 //  Returns: The number of fleets in the world.  This includes
 //           the "nature" fleet that PhysicsObjects such as
-//           planetoids are on.  This implementation always
-//           returns 0.
+//           planetoids are on.
 //  Side Effect: N/A
 //
 
@@ -318,8 +698,9 @@ public:
 //  Precondition(s):
 //    <1> fleet <  getFleetCount()
 //    <2> fleet != PhysicsObjectId::FLEET_NATURE
-//  Returns: The current score of fleet fleet.  This
-//           implementation always returns 0.0.
+//  Returns: The current score of fleet fleet.  A fleet scores
+//           SCORE_PER_KILL each time one of its bullets or
+//           missiles destroys a ship from another fleet.
 //  Side Effect: N/A
 //
 
@@ -337,7 +718,8 @@ public:
 //    <1> fleet <  getFleetCount()
 //    <2> fleet != PhysicsObjectId::FLEET_NATURE
 //  Returns: Whether fleet fleet has a living command ship.
-//           This implementation always returns false.
+//           The enemy fleet has no command ship, so it is
+//           treated as alive while any of its fighters are.
 //  Side Effect: N/A
 //
 
@@ -353,8 +735,10 @@ public:
 //  Precondition(s):
 //    <1> fleet <  getFleetCount()
 //    <2> fleet != PhysicsObjectId::FLEET_NATURE
-//  Returns: The id for the command ship for fleet fleet.  This
-//           implementation always returns ID_NOTHING.
+//  Returns: The id for the command ship for fleet fleet.  The
+//           player ship is the command ship for the player
+//           fleet.  Other fleets have no command ship, so
+//           ID_NOTHING is returned for them.
 //  Side Effect: N/A
 //
 
@@ -371,13 +755,13 @@ public:
 //  Precondition(s):
 //    <1> fleet <  getFleetCount()
 //    <2> fleet != PhysicsObjectId::FLEET_NATURE
-//  Returns: A STL vector of the ids for the living fighters in
-//           fleet fleet.  This implementation always returns an
-//           empty vector.
+//  Returns: A reference to a STL vector of the ids for the
+//           living fighters in fleet fleet.  The list is taken
+//           from fleet_registry without checking any ships.
 //  Side Effect: N/A
 //
 
-	virtual std::vector<PhysicsObjectId> getFleetFighterIds (
+	virtual const std::vector<PhysicsObjectId>& getFleetFighterIds (
 	                                   unsigned int fleet) const;
 
 //
@@ -390,13 +774,13 @@ public:
 //  Precondition(s):
 //    <1> fleet <  getFleetCount()
 //    <2> fleet != PhysicsObjectId::FLEET_NATURE
-//  Returns: A STL vector of the ids for the living missiles in
-//           fleet fleet.  This implementation always returns an
-//           empty vector.
+//  Returns: A reference to a STL vector of the ids for the
+//           living missiles in fleet fleet.  The list is taken
+//           from fleet_registry without checking any missiles.
 //  Side Effect: N/A
 //
 
-	virtual std::vector<PhysicsObjectId> getFleetMissileIds (
+	virtual const std::vector<PhysicsObjectId>& getFleetMissileIds (
 	                                  unsigned int fleet) const;
 
 //
@@ -468,7 +852,7 @@ public:
 //           a sphere of radius sphere_radius centered on
 //           position sphere_center.  The same ids may appear in
 //           the vector more than once.  This implementation
-//           always returns an empty vector.
+//           never repeats an id.
 //  Side Effect: N/A
 //
 
@@ -476,6 +860,172 @@ public:
 	                               const Vector3& sphere_center,
 	                               double sphere_radius) const;
 
+//
+//  getShipsInSphere
+//
+//  Purpose: To determine the ids and positions of all ships
+//           within the specified sphere.  Unlike getShipIds,
+//           the results are sorted and include positions, so
+//           they can be used without further queries.
+//  Parameter(s):
+//    <1> sphere_center: The center of the sphere
+//    <2> sphere_radius: The radius of the sphere
+//    <3> r_results: The vector to store the results in
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//  Returns: N/A
+//  Side Effect: r_results is set to contain one record for each
+//               living ship within a sphere of radius
+//               sphere_radius centered on position
+//               sphere_center, sorted nearest first.  Ships at
+//               the same distance are sorted by id.
+//
+
+	virtual void getShipsInSphere (
+	                   const Vector3& sphere_center,
+	                   double sphere_radius,
+	                   std::vector<NearbyShipData>& r_results) const;
+
+//
+//  getNearestShips
+//
+//  Purpose: To determine the ids and positions of the ships
+//           nearest to the specified position.
+//  Parameter(s):
+//    <1> position: The position to check from
+//    <2> count: The maximum number of ships to find
+//    <3> distance_max: The maximum distance to check
+//    <4> r_results: The vector to store the results in
+//  Precondition(s):
+//    <1> distance_max >= 0.0
+//  Returns: N/A
+//  Side Effect: r_results is set to contain the count living
+//               ships nearest to position position that are
+//               less than distance_max from it, sorted nearest
+//               first.  If there are fewer than count such
+//               ships, all of them are included.  A ship at
+//               position itself is included, so a ship looking
+//               for its neighbours should ask for one more
+//               result than it wants.
+//
+
+	virtual void getNearestShips (
+	                   const Vector3& position,
+	                   unsigned int count,
+	                   double distance_max,
+	                   std::vector<NearbyShipData>& r_results) const;
+
+//
+//  getNearestEnemyShipId
+//
+//  Purpose: To determine the id of the nearest ship that is not
+//           part of the specified fleet.
+//  Parameter(s):
+//    <1> position: The position to check from
+//    <2> fleet: The fleet the ship should not be part of
+//    <3> distance_max: The maximum distance to check
+//  Precondition(s):
+//    <1> distance_max >= 0.0
+//  Returns: The id of the living ship nearest to position
+//           position that is less than distance_max from it
+//           and is not part of fleet fleet.  If there is no
+//           such ship, PhysicsObjectId::ID_NOTHING is returned.
+//  Side Effect: N/A
+//
+
+	virtual PhysicsObjectId getNearestEnemyShipId (
+	                   const Vector3& position,
+	                   unsigned int fleet,
+	                   double distance_max) const;
+
+//
+//  requestPerception
+//
+//  Purpose: To ask for the ships and ring particles near a ship
+//           to be found.  Requests from all ships are answered
+//           together before the unit AIs run in the next frame,
+//           so overlapping scans can share their work.  This is
+//           much faster than calling getShipsInSphere,
+//           getRingParticles, and getNearestPlanetoidId
+//           separately from each unit AI.
+//  Parameter(s):
+//    <1> id_ship: The id of the ship making the request
+//    <2> ship_sphere_center: The center of the sphere to find
+//                            ships in
+//    <3> ship_sphere_radius: The radius of the sphere to find
+//                            ships in
+//    <4> ring_sphere_center: The center of the sphere to find
+//                            ring particles in
+//    <5> ring_sphere_radius: The radius of the sphere to find
+//                            ring particles in
+//  Precondition(s):
+//    <1> isAlive(id_ship)
+//    <2> id_ship.m_type == PhysicsObjectId::TYPE_SHIP
+//    <3> ship_sphere_radius >= 0.0
+//    <4> ring_sphere_radius >= 0.0
+//  Returns: N/A
+//  Side Effect: A request is recorded for ship id_ship,
+//               replacing any earlier request from it that has
+//               not been answered.  Requests for different
+//               ships may be made from different threads at the
+//               same time.
+//
+
+	virtual void requestPerception (
+	                   const PhysicsObjectId& id_ship,
+	                   const Vector3& ship_sphere_center,
+	                   double ship_sphere_radius,
+	                   const Vector3& ring_sphere_center,
+	                   double ring_sphere_radius) const;
+
+//
+//  isPerceptionReady
+//
+//  Purpose: To determine if there is an answer to a perception
+//           request from the specified ship.
+//  Parameter(s):
+//    <1> id_ship: The id of the ship
+//  Precondition(s):
+//    <1> isAlive(id_ship)
+//    <2> id_ship.m_type == PhysicsObjectId::TYPE_SHIP
+//  Returns: Whether a request from ship id_ship has been
+//           answered and the answer has not been taken yet.
+//  Side Effect: N/A
+//
+
+	virtual bool isPerceptionReady (
+	                   const PhysicsObjectId& id_ship) const;
+
+//
+//  takePerception
+//
+//  Purpose: To retrieve the answer to the most recent
+//           perception request from the specified ship.
+//  Parameter(s):
+//    <1> id_ship: The id of the ship
+//    <2> r_perception: A PerceptionData to put the answer in
+//  Precondition(s):
+//    <1> isAlive(id_ship)
+//    <2> id_ship.m_type == PhysicsObjectId::TYPE_SHIP
+//    <3> isPerceptionReady(id_ship)
+//  Returns: N/A
+//  Side Effect: r_perception is set to the ships within the
+//               ship sphere, sorted as for getShipsInSphere,
+//               the ring particles that getRingParticles would
+//               return for the ring sphere, and the planetoid
+//               nearest the center of the ship sphere, all as
+//               they were when the request was answered, and
+//               the number of the frame it was answered in.  The
+//               answer is swapped rather than copied, so the
+//               earlier contents of r_perception are reused
+//               for a later answer.  The answer is no longer
+//               ready.
+//
+
+	virtual void takePerception (
+	                   const PhysicsObjectId& id_ship,
+	                   PerceptionData& r_perception) const;
+
 //
 //  isAlive
 //
@@ -949,40 +1499,88 @@ private:
 //  Parameter(s): N/A
 //  Precondition(s): N/A
 //  Returns: N/A
-//  Side Effect: N/A
+//  Side Effect: All collisions are found using thread_pool and
+//               then resolved on this thread.  The results are
+//               the same however many threads are used.
 //
 
     void handleCollisions();
 
 //
-//  handleShipCollisions
+//  detectShipCollisions
 //
-//  Purpose: A function which handles all collisions for ships
+//  Purpose: A function which finds all collisions for a ship
 //  Parameter(s):
 //    <1> ship: The ship we are testing collisions against
-//  Precondition(s): N/A
+//    <2> r_nearby_ships: A scratch list used to hold the ships
+//                        near this one
+//    <3> r_contacts: The list to add the contacts found to
+//  Precondition(s):
+//    <1> ship.isAlive()
 //  Returns: N/A
-//  Side Effect: Identifies whether a collision has occurred
-//               for the given ship and calls the appropriate
-//               resolution function.
+//  Side Effect: A contact is added to r_contacts for each
+//               collision anywhere along the path the given
+//               ship moved this frame, in the order they
+//               should be resolved.  Nothing else is changed,
+//               so this function may be called for several
+//               ships at once.
 //
     
-    void handleShipCollisions(Ship& ship);
+    void detectShipCollisions(const Ship& ship,
+                              std::vector<PhysicsObjectId>& r_nearby_ships,
+                              std::vector<Contact>& r_contacts) const;
 
 //
-//  handleBulletCollisions
+//  detectProjectileCollisions
 //
-//  Purpose: A function which handles all collisions for bullets
+//  Purpose: A function which finds all collisions for a bullet
+//           or missile
 //  Parameter(s):
-//    <1> bullet: The bullet we are testing collisions against
+//    <1> projectile: The projectile we are testing collisions
+//                    against
+//    <2> pair_begin: The first element of
+//                    projectile_ship_pairs for the ships near
+//                    the projectile
+//    <3> pair_end: One past the last element of
+//                  projectile_ship_pairs for the ships near the
+//                  projectile
+//    <4> r_nearby_ships: A scratch list used to hold the ships
+//                        near the projectile
+//    <5> r_contacts: The list to add the contacts found to
+//  Precondition(s):
+//    <1> pair_begin <= pair_end
+//    <2> pair_end <= projectile_ship_pairs.size()
+//  Returns: N/A
+//  Side Effect: A contact is added to r_contacts for each
+//               collision anywhere along the path the given
+//               projectile moved this frame, in the order they
+//               should be resolved.  Nothing else is changed,
+//               so this function may be called for several
+//               projectiles at once.
+//
+
+    void detectProjectileCollisions(const PhysicsObject& projectile,
+                                    unsigned int pair_begin,
+                                    unsigned int pair_end,
+                                    std::vector<PhysicsObjectId>& r_nearby_ships,
+                                    std::vector<Contact>& r_contacts) const;
+
+//
+//  resolveContacts
+//
+//  Purpose: A function which resolves a list of contacts
+//  Parameter(s):
+//    <1> contacts: The contacts to resolve, grouped by m_id1
 //  Precondition(s): N/A
 //  Returns: N/A
-//  Side Effect: Identifies whether a collision has occurred
-//               for the given bullet and calls the appropriate
-//               resolution function.
+//  Side Effect: Each contact is resolved in order.  A ship's
+//               contacts are skipped if it was already dying
+//               when they were reached, and a contact with a
+//               ship is skipped if that ship is dying by the
+//               time it is reached.
 //
 
-    void handleBulletCollisions(Bullet& bullet);
+    void resolveContacts(const std::vector<Contact>& contacts);
 
 //
 //  resolvePlanetoidCollision
@@ -1028,6 +1626,292 @@ private:
 //
     
     void resolveBulletCollision(Bullet& b, Ship& obj);
+
+//
+//  resolveMissileCollision
+//
+//  Purpose: A function which resolves a collision between a
+//           missile and a ship
+//  Parameter(s):
+//    <1> m: The missile involved in the collision
+//    <2> obj: The ship involved in the collision
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Marks the missile as dying and subtracts
+//               MISSILE_DAMAGE from the ship's health
+//
+
+    void resolveMissileCollision(Missile& m, Ship& obj);
+
+//
+//  awardKill
+//
+//  Purpose: A function which gives a fleet the score for
+//           destroying a ship
+//  Parameter(s):
+//    <1> source_id: The ship that fired the fatal projectile
+//    <2> obj: The ship that was destroyed
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If source_id is from a fleet other than nature
+//               and the fleet of obj, SCORE_PER_KILL is added to
+//               its score in fleet_registry.
+//
+
+    void awardKill(const PhysicsObjectId& source_id, const Ship& obj);
+
+//
+//  removeDeadProjectiles
+//
+//  Purpose: A function which frees the pool slots of all
+//           bullets and missiles that have died
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each dead bullet and missile is removed from
+//               its pool, so its id is no longer valid and its
+//               slot can be reused.
+//
+
+    void removeDeadProjectiles();
+
+//
+//  updateNearbyShipGrid
+//
+//  Purpose: A function which updates the grid used to answer
+//           the ship queries in WorldInterface
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each living ship is moved in nearby_ship_grid
+//               to its current position, and each dead ship is
+//               removed from it.  This must be called whenever
+//               ships move, or the queries may miss them.
+//
+
+    void updateNearbyShipGrid();
+
+//
+//  appendNearbyShips
+//
+//  Purpose: A function which finds all the ships within the
+//           specified sphere using nearby_ship_grid
+//  Parameter(s):
+//    <1> sphere_center: The center of the sphere
+//    <2> sphere_radius: The radius of the sphere
+//    <3> r_results: The vector to add the results to
+//  Precondition(s):
+//    <1> sphere_radius >= 0.0
+//  Returns: N/A
+//  Side Effect: A record for each living ship strictly within
+//               the sphere is added to the end of r_results,
+//               in no particular order.  Only the grid cells
+//               overlapping the sphere are checked.
+//
+
+    void appendNearbyShips(const Vector3& sphere_center,
+                           double sphere_radius,
+                           std::vector<NearbyShipData>& r_results) const;
+
+//
+//  getPerceptionSlot
+//
+//  Purpose: A function which finds the perception_service slot
+//           for a ship
+//  Parameter(s):
+//    <1> id_ship: The id of the ship
+//  Precondition(s):
+//    <1> id_ship is the id of the player ship or one of ships
+//  Returns: SHIP_COUNT for the player ship, and the index in
+//           ships for any other ship.
+//  Side Effect: N/A
+//
+
+    unsigned int getPerceptionSlot(const PhysicsObjectId& id_ship) const;
+
+//
+//  updateShipGrid
+//
+//  Purpose: A function which moves every ship in the ship
+//           collision grid to its current position
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Each living ship that is not dying is moved in
+//               ship_grid to the bounding box of the path it
+//               moved along this frame.  All other ships are
+//               removed from ship_grid.
+//
+
+    void updateShipGrid();
+
+//
+//  getSweptMin
+//
+//  Purpose: A function which finds the minimum corner of the
+//           bounding box of a PhysicsObject over this frame
+//  Parameter(s):
+//    <1> object: The PhysicsObject
+//  Precondition(s): N/A
+//  Returns: The minimum corner of the box containing object at
+//           both its previous and current positions.
+//  Side Effect: N/A
+//
+
+    static Vector3 getSweptMin(const PhysicsObject& object);
+
+//
+//  getSweptMax
+//
+//  Purpose: A function which finds the maximum corner of the
+//           bounding box of a PhysicsObject over this frame
+//  Parameter(s):
+//    <1> object: The PhysicsObject
+//  Precondition(s): N/A
+//  Returns: The maximum corner of the box containing object at
+//           both its previous and current positions.
+//  Side Effect: N/A
+//
+
+    static Vector3 getSweptMax(const PhysicsObject& object);
+
+//
+//  getShip
+//
+//  Purpose: A function which finds the ship with the specified
+//           id
+//  Parameter(s):
+//    <1> id: The id of the ship
+//  Precondition(s):
+//    <1> id.m_type == PhysicsObjectId::TYPE_SHIP
+//    <2> id identifies the player ship or one of the NPC ships
+//  Returns: A reference to the ship with id id
+//  Side Effect: N/A
+//
+
+    Ship& getShip(const PhysicsObjectId& id);
+    const Ship& getShip(const PhysicsObjectId& id) const;
+
+//
+//  getProjectile
+//
+//  Purpose: A function which finds the bullet or missile with
+//           the specified id
+//  Parameter(s):
+//    <1> id: The id of the projectile
+//  Precondition(s):
+//    <1> id.m_type == PhysicsObjectId::TYPE_BULLET ||
+//        id.m_type == PhysicsObjectId::TYPE_MISSILE
+//    <2> getObject(id) != NULL
+//  Returns: A reference to the projectile with id id
+//  Side Effect: N/A
+//
+
+    PhysicsObject& getProjectile(const PhysicsObjectId& id);
+
+//
+//  initObjectTable
+//
+//  Purpose: A function which fills the object table with the
+//           physics objects in this World
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: object_table is set to have, for each object
+//               type and fleet, a pointer to the object with
+//               each index.  The table depends only on the
+//               addresses of the objects, so it does not need
+//               to change when the objects are initialized.
+//               Bullets and missiles are not in the table; they
+//               are found through their pools instead.
+//
+
+    void initObjectTable();
+
+//
+//  initFleetRegistry
+//
+//  Purpose: A function which fills fleet_registry with the
+//           ships in this World when the game starts
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: fleet_registry is emptied and all the scores
+//               are set to 0.  The player ship is set as the
+//               command ship for its fleet, and every other
+//               living ship is added as a fighter.  After this,
+//               fleet_registry is updated as ships and missiles
+//               appear and die, and is never rebuilt.
+//
+
+    void initFleetRegistry();
+
+//
+//  getObject
+//
+//  Purpose: A function which finds the physics object with the
+//           specified id in constant time
+//  Parameter(s):
+//    <1> id: The id of the object
+//  Precondition(s): N/A
+//  Returns: A pointer to the object with id id, or NULL if
+//           there is no such object in this World.
+//  Side Effect: N/A
+//
+
+    const PhysicsObject* getObject(const PhysicsObjectId& id) const;
+
+//
+//  loadModels
+//
+//  Purpose: A function which loads the models for everything
+//           in this World
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> OpenGL has been initialized
+//  Returns: N/A
+//  Side Effect: The models are loaded and their display lists
+//               are stored in this World.  The ring particle
+//               models are also loaded.
+//
+
+    void loadModels();
+
+//
+//  initObjects
+//
+//  Purpose: A function which places the planet, moons, ring,
+//           and ships in this World
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All physics objects are initialized with the
+//               display lists currently stored in this World,
+//               which are empty if loadModels has not been
+//               called.  The ring and its holes are set up.
+//
+
+    void initObjects();
+
+//
+//  readSnapshotParts
+//
+//  Purpose: A function which reads a snapshot into this World
+//           one part at a time
+//  Parameter(s):
+//    <1> r_in: The stream to read from
+//  Precondition(s):
+//    <1> r_in was opened in binary mode
+//  Returns: Whether a valid snapshot was read.
+//  Side Effect: Each part of the snapshot is read into the
+//               object it came from, until one is not valid.
+//               If false is returned, the parts read before
+//               that point have their new state, so this World
+//               may be left half-loaded.  readSnapshot uses
+//               this with a backup to avoid that.
+//
+
+    bool readSnapshotParts(std::istream& r_in);
     
     void drawSkybox() const;
 };
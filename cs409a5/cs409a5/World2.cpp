@@ -2,8 +2,10 @@
 //  World2.cpp
 //
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 #include "../../ObjLibrary/ObjModel.h"
 #include "../../ObjLibrary/Vector3.h"
@@ -37,53 +39,47 @@ vector<RingParticleData> World :: getRingParticles (const Vector3& sphere_center
 
 unsigned int World :: getFleetCount () const
 {
-    cout << "Error: World::getFleetCount is not implemented" << endl;
-    return 0;
+    return fleet_registry.getFleetCount();
 }
 
 float World :: getFleetScore (unsigned int fleet) const
 {
-    cout << "Error: World::getFleetScore is not implemented" << endl;
     assert(fleet <  getFleetCount());
     assert(fleet != PhysicsObjectId::FLEET_NATURE);
     
-    return 0;
+    return fleet_registry.getScore(fleet);
 }
 
 bool World :: isFleetAlive (unsigned int fleet) const
 {
-    cout << "Error: World::isFleetAlive is not implemented" << endl;
     assert(fleet <  getFleetCount());
     assert(fleet != PhysicsObjectId::FLEET_NATURE);
     
-    return false;
+    return fleet_registry.isAlive(fleet);
 }
 
 PhysicsObjectId World :: getFleetCommandShipId (unsigned int fleet) const
 {
-    cout << "Error: World::getFleetCommandShipId is not implemented" << endl;
     assert(fleet <  getFleetCount());
     assert(fleet != PhysicsObjectId::FLEET_NATURE);
     
-    return PhysicsObjectId::ID_NOTHING;
+    return fleet_registry.getCommandShipId(fleet);
 }
 
-vector<PhysicsObjectId> World :: getFleetFighterIds (unsigned int fleet) const
+const vector<PhysicsObjectId>& World :: getFleetFighterIds (unsigned int fleet) const
 {
-    cout << "Error: World::getFleetFighterIds is not implemented" << endl;
     assert(fleet <  getFleetCount());
     assert(fleet != PhysicsObjectId::FLEET_NATURE);
     
-    return vector<PhysicsObjectId>();
+    return fleet_registry.getFighterIds(fleet);
 }
 
-vector<PhysicsObjectId> World :: getFleetMissileIds (unsigned int fleet) const
+const vector<PhysicsObjectId>& World :: getFleetMissileIds (unsigned int fleet) const
 {
-    cout << "Error: World::getFleetMissileIds is not implemented" << endl;
     assert(fleet <  getFleetCount());
     assert(fleet != PhysicsObjectId::FLEET_NATURE);
     
-    return vector<PhysicsObjectId>();
+    return fleet_registry.getMissileIds(fleet);
 }
 
 PhysicsObjectId World :: getPlanetId () const
@@ -123,207 +119,207 @@ vector<PhysicsObjectId> World :: getShipIds (const Vector3& sphere_center,
 {
     assert(sphere_radius >= 0.0);
     
-    vector<PhysicsObjectId> list;
+    vector<NearbyShipData> nearby;
+    appendNearbyShips(sphere_center, sphere_radius, nearby);
     
-    // Playership
-    if (player_ship.isAlive())
-    {
-        double temp = sphere_center.getDistanceSquared(player_ship.getPosition());
-        if (temp < sphere_radius * sphere_radius)
-        {
-            list.push_back(player_ship.getId());
-        }
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
+    vector<PhysicsObjectId> list;
+    list.reserve(nearby.size());
+    for (unsigned int i = 0; i < nearby.size(); i++)
     {
-        Ship s = ships[i];
-        if (!s.isAlive()) continue;
-        
-        double temp = sphere_center.getDistanceSquared(s.getPosition());
-        if (temp < sphere_radius * sphere_radius)
-        {
-            list.push_back(s.getId());
-        }
+        list.push_back(nearby[i].m_id);
     }
     
     return list;
 }
 
-bool World :: isAlive (const PhysicsObjectId& id) const
+void World :: getShipsInSphere (const Vector3& sphere_center,
+                                double sphere_radius,
+                                vector<NearbyShipData>& r_results) const
+{
+    assert(sphere_radius >= 0.0);
+    
+    r_results.clear();
+    appendNearbyShips(sphere_center, sphere_radius, r_results);
+    sort(r_results.begin(), r_results.end(), isNearbyShipCloser);
+}
+
+void World :: getNearestShips (const Vector3& position,
+                               unsigned int count,
+                               double distance_max,
+                               vector<NearbyShipData>& r_results) const
 {
-    if (player_ship.getId() == id) return player_ship.isAlive();
-    if (planet.getId() == id)
+    assert(distance_max >= 0.0);
+    
+    r_results.clear();
+    if (count == 0) return;
+    
+    // If a sphere contains at least count ships, the nearest
+    //  count ships are all inside it.  Start with a sphere about
+    //  one grid cell across and double it until that is true.
+    double radius = NEARBY_SHIP_CELL_SIZE;
+    while (true)
     {
-        return planet.isAlive();
+        if (radius > distance_max) radius = distance_max;
+        
+        r_results.clear();
+        appendNearbyShips(position, radius, r_results);
+        if (r_results.size() >= count) break;
+        if (radius >= distance_max) break;
+        if (r_results.size() >= nearby_ship_grid.getObjectCount()) break;
+        
+        radius *= 2.0;
     }
-    for (int i = 0; i < MOON_COUNT; i++)
+    
+    if (r_results.size() > count)
     {
-        if (moons[i].getId() == id) return moons[i].isAlive();
+        partial_sort(r_results.begin(), r_results.begin() + count, r_results.end(), isNearbyShipCloser);
+        r_results.resize(count);
     }
-    for (int i = 0; i < SHIP_COUNT; i++)
+    else
     {
-        if (ships[i].getId() == id) return ships[i].isAlive();
+        sort(r_results.begin(), r_results.end(), isNearbyShipCloser);
     }
-    for (int i = 0; i < BULLET_COUNT; i++)
+}
+
+PhysicsObjectId World :: getNearestEnemyShipId (const Vector3& position,
+                                                unsigned int fleet,
+                                                double distance_max) const
+{
+    assert(distance_max >= 0.0);
+    
+    vector<NearbyShipData> nearby;
+    double radius = NEARBY_SHIP_CELL_SIZE;
+    while (true)
     {
-        if (bullets[i].getId() == id) return bullets[i].isAlive();
+        if (radius > distance_max) radius = distance_max;
+        
+        nearby.clear();
+        appendNearbyShips(position, radius, nearby);
+        
+        const NearbyShipData* p_best = NULL;
+        for (unsigned int i = 0; i < nearby.size(); i++)
+        {
+            if (nearby[i].m_id.m_fleet == fleet) continue;
+            if (p_best == NULL || isNearbyShipCloser(nearby[i], *p_best))
+            {
+                p_best = &nearby[i];
+            }
+        }
+        
+        if (p_best != NULL) return p_best->m_id;
+        if (radius >= distance_max) break;
+        if (nearby.size() >= nearby_ship_grid.getObjectCount()) break;
+        
+        radius *= 2.0;
     }
     
-    return false;
+    return PhysicsObjectId::ID_NOTHING;
+}
+
+void World :: requestPerception (const PhysicsObjectId& id_ship,
+                                 const Vector3& ship_sphere_center,
+                                 double ship_sphere_radius,
+                                 const Vector3& ring_sphere_center,
+                                 double ring_sphere_radius) const
+{
+    assert(isAlive(id_ship));
+    assert(id_ship.m_type == PhysicsObjectId::TYPE_SHIP);
+    assert(ship_sphere_radius >= 0.0);
+    assert(ring_sphere_radius >= 0.0);
+    
+    perception_service.request(getPerceptionSlot(id_ship),
+                               ship_sphere_center,
+                               ship_sphere_radius,
+                               ring_sphere_center,
+                               ring_sphere_radius);
+}
+
+bool World :: isPerceptionReady (const PhysicsObjectId& id_ship) const
+{
+    assert(isAlive(id_ship));
+    assert(id_ship.m_type == PhysicsObjectId::TYPE_SHIP);
+    
+    return perception_service.isReady(getPerceptionSlot(id_ship));
+}
+
+void World :: takePerception (const PhysicsObjectId& id_ship,
+                              PerceptionData& r_perception) const
+{
+    assert(isAlive(id_ship));
+    assert(id_ship.m_type == PhysicsObjectId::TYPE_SHIP);
+    assert(isPerceptionReady(id_ship));
+    
+    perception_service.takeResult(getPerceptionSlot(id_ship), r_perception);
+}
+
+bool World :: isAlive (const PhysicsObjectId& id) const
+{
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return false;
+    return p_object->isAlive();
 }
 
 Vector3 World :: getPosition (const PhysicsObjectId& id) const
 {
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getPosition();
-    if (planet.getId() == id) return planet.getPosition();
-    for (int i = 0; i < MOON_COUNT; i++)
-    {
-        if (moons[i].getId() == id) return moons[i].getPosition();
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getPosition();
-    }
-    for (int i = 0; i < BULLET_COUNT; i++)
-    {
-        if (bullets[i].getId() == id) return bullets[i].getPosition();
-    }
-    
-    return Vector3::ZERO;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return Vector3::ZERO;
+    return p_object->getPosition();
 }
 
 double World :: getRadius (const PhysicsObjectId& id) const
 {
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getRadius();
-    if (planet.getId() == id) return planet.getRadius();
-    for (int i = 0; i < MOON_COUNT; i++)
-    {
-        if (moons[i].getId() == id) return moons[i].getRadius();
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getRadius();
-    }
-    for (int i = 0; i < BULLET_COUNT; i++)
-    {
-        if (bullets[i].getId() == id) return bullets[i].getRadius();
-    }
-    
-    return 0.0;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return 0.0;
+    return p_object->getRadius();
 }
 
 Vector3 World :: getVelocity (const PhysicsObjectId& id) const
 {
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getVelocity();
-    if (planet.getId() == id) return planet.getVelocity();
-    for (int i = 0; i < MOON_COUNT; i++)
-    {
-        if (moons[i].getId() == id) return moons[i].getVelocity();
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getVelocity();
-    }
-    for (int i = 0; i < BULLET_COUNT; i++)
-    {
-        if (bullets[i].getId() == id) return bullets[i].getVelocity();
-    }
-    
-    return Vector3::ZERO;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return Vector3::ZERO;
+    return p_object->getVelocity();
 }
 
 double World :: getSpeed (const PhysicsObjectId& id) const
 {
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getSpeed();
-    if (planet.getId() == id) return planet.getSpeed();
-    for (int i = 0; i < MOON_COUNT; i++)
-    {
-        if (moons[i].getId() == id) return moons[i].getSpeed();
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getSpeed();
-    }
-    for (int i = 0; i < BULLET_COUNT; i++)
-    {
-        if (bullets[i].getId() == id) return bullets[i].getSpeed();
-    }
-    
-    return 0.0;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return 0.0;
+    return p_object->getSpeed();
 }
 
 Vector3 World :: getForward (const PhysicsObjectId& id) const
 {
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getForward();
-    if (planet.getId() == id) return planet.getForward();
-    for (int i = 0; i < MOON_COUNT; i++)
-    {
-        if (moons[i].getId() == id) return moons[i].getForward();
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getForward();
-    }
-    for (int i = 0; i < BULLET_COUNT; i++)
-    {
-        if (bullets[i].getId() == id) return bullets[i].getForward();
-    }
-    
-    return Vector3::UNIT_X_PLUS;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return Vector3::UNIT_X_PLUS;
+    return p_object->getForward();
 }
 
 Vector3 World :: getUp (const PhysicsObjectId& id) const
 {
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getUp();
-    if (planet.getId() == id) return planet.getUp();
-    for (int i = 0; i < MOON_COUNT; i++)
-    {
-        if (moons[i].getId() == id) return moons[i].getUp();
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getUp();
-    }
-    for (int i = 0; i < BULLET_COUNT; i++)
-    {
-        if (bullets[i].getId() == id) return bullets[i].getUp();
-    }
-    
-    return Vector3::UNIT_Y_PLUS;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return Vector3::UNIT_Y_PLUS;
+    return p_object->getUp();
 }
 
 Vector3 World :: getRight (const PhysicsObjectId& id) const
 {
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getRight();
-    if (planet.getId() == id) return planet.getRight();
-    for (int i = 0; i < MOON_COUNT; i++)
-    {
-        if (moons[i].getId() == id) return moons[i].getRight();
-    }
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getRight();
-    }
-    for (int i = 0; i < BULLET_COUNT; i++)
-    {
-        if (bullets[i].getId() == id) return bullets[i].getRight();
-    }
-    
-    return Vector3::UNIT_Z_PLUS;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return Vector3::UNIT_Z_PLUS;
+    return p_object->getRight();
 }
 
 bool World :: isPlanetoidMoon (const PhysicsObjectId& id) const
@@ -376,16 +372,8 @@ double World :: getShipSpeedMax (const PhysicsObjectId& id) const
     assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getSpeedMax();
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id)
-        {
-            return ships[i].getSpeedMax();
-        }
-    }
-    
-    return 1.0;
+    if (getObject(id) == NULL) return 1.0;
+    return getShip(id).getSpeedMax();
 }
 
 double World :: getShipAcceleration (const PhysicsObjectId& id) const
@@ -393,16 +381,8 @@ double World :: getShipAcceleration (const PhysicsObjectId& id) const
     assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getAcceleration();
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id)
-        {
-            return ships[i].getAcceleration();
-        }
-    }
-    
-    return 0.0;
+    if (getObject(id) == NULL) return 0.0;
+    return getShip(id).getAcceleration();
 }
 
 double World :: getShipRotationRate (const PhysicsObjectId& id) const
@@ -410,16 +390,8 @@ double World :: getShipRotationRate (const PhysicsObjectId& id) const
     assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getRotationRate();
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id)
-        {
-            return ships[i].getRotationRate();
-        }
-    }
-    
-    return 0.0;
+    if (getObject(id) == NULL) return 0.0;
+    return getShip(id).getRotationRate();
 }
 
 float World :: getShipHealthCurrent (const PhysicsObjectId& id) const
@@ -427,12 +399,8 @@ float World :: getShipHealthCurrent (const PhysicsObjectId& id) const
     assert(id.m_type == PhysicsObjectId::TYPE_SHIP);
     assert(isAlive(id));
     
-    if (player_ship.getId() == id) return player_ship.getHealth();
-    for (int i = 0; i < SHIP_COUNT; i++)
-    {
-        if (ships[i].getId() == id) return ships[i].getHealth();
-    }
-    return 0.0;
+    if (getObject(id) == NULL) return 0.0;
+    return getShip(id).getHealth();
 }
 
 float World :: getShipHealthMaximum (const PhysicsObjectId& id) const
@@ -446,20 +414,22 @@ float World :: getShipHealthMaximum (const PhysicsObjectId& id) const
 
 bool World :: isMissileOutOfFuel (const PhysicsObjectId& id) const
 {
-    cout << "Error: World::isMissileOutOfFuel is not implemented" << endl;
     assert(id.m_type == PhysicsObjectId::TYPE_MISSILE);
     assert(isAlive(id));
     
-    return 0.0f;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return true;
+    return static_cast<const Missile*>(p_object)->isOutOfFuel();
 }
 
 PhysicsObjectId World :: getMissileTarget (const PhysicsObjectId& id) const
 {
-    cout << "Error: World::getMissileTarget is not implemented" << endl;
     assert(id.m_type == PhysicsObjectId::TYPE_MISSILE);
     assert(isAlive(id));
     
-    return PhysicsObjectId::ID_NOTHING;
+    const PhysicsObject* p_object = getObject(id);
+    if (p_object == NULL) return PhysicsObjectId::ID_NOTHING;
+    return static_cast<const Missile*>(p_object)->getTargetId();
 }
 
 
@@ -481,9 +451,18 @@ PhysicsObjectId World :: addBullet (const Vector3& position,
 {
     assert(forward.isNormal());
     
-    bullets[nextBullet].fire(position, forward, source_id);
-    PhysicsObjectId b_id = bullets[nextBullet].getId();
-    nextBullet = (nextBullet + 1) % BULLET_COUNT;
+    if (bullet_pool.isFull()) return PhysicsObjectId::ID_NOTHING;
+    
+    unsigned int slot = bullet_pool.add();
+    if (bullets.size() < bullet_pool.getCapacity())
+        bullets.resize(bullet_pool.getCapacity());
+    
+    PhysicsObjectId b_id = PhysicsObjectId(PhysicsObjectId::TYPE_BULLET,
+                                           PhysicsObjectId::FLEET_NATURE,
+                                           bullet_pool.getIndex(slot));
+    Bullet& bullet = bullets[slot];
+    bullet.initPhysics(b_id, position, Bullet::RADIUS, Vector3::ZERO, bullet_dl, PROJECTILE_DISPLAY_SCALE);
+    bullet.fire(position, forward, source_id, random);
     
     assert(invariant());
     return b_id;
@@ -494,9 +473,23 @@ PhysicsObjectId World :: addMissile (const Vector3& position,
                                      const PhysicsObjectId& source_id,
                                      const PhysicsObjectId& target_id)
 {
-    cout << "Error: World::addMissile is not implemented" << endl;
     assert(forward.isNormal());
     
+    if (missile_pool.isFull()) return PhysicsObjectId::ID_NOTHING;
+    
+    unsigned int slot = missile_pool.add();
+    if (missiles.size() < missile_pool.getCapacity())
+        missiles.resize(missile_pool.getCapacity());
+    
+    // a missile belongs to the fleet that fired it
+    PhysicsObjectId m_id = PhysicsObjectId(PhysicsObjectId::TYPE_MISSILE,
+                                           source_id.m_fleet,
+                                           missile_pool.getIndex(slot));
+    Missile& missile = missiles[slot];
+    missile.initPhysics(m_id, position, Missile::RADIUS, Vector3::ZERO, missile_dl, PROJECTILE_DISPLAY_SCALE);
+    missile.fire(position, forward, source_id, target_id, random);
+    fleet_registry.addMissile(m_id);
+    
     assert(invariant());
-    return PhysicsObjectId::ID_NOTHING;
+    return m_id;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 //
 
 #include <cassert>
+#include <cstdlib>  // for NULL
 #include <vector>
 
 #include "PseudorandomGrid.h"